@@ -270,6 +270,10 @@ class SimpleAssignmentAst : public SimpleStatementBase<AssignmentAst> {
         _expr.reset(expr);
     }
 
+    void set_expr(ExprPtr expr) {
+        _expr = expr;
+    }
+
     SimpleVariable* get_variable() {
         return &_var;
     }
@@ -278,6 +282,10 @@ class SimpleAssignmentAst : public SimpleStatementBase<AssignmentAst> {
         return _expr.get();
     }
 
+    ExprPtr get_expr_ptr() {
+        return _expr;
+    }
+
     void accept_statement_visitor(StatementVisitor *visitor) {
         visitor->visit_assignment(this);
     }
@@ -285,15 +293,17 @@ class SimpleAssignmentAst : public SimpleStatementBase<AssignmentAst> {
     ~SimpleAssignmentAst() { }
 
   private:
-    SimpleVariable            _var;
-    std::unique_ptr<ExprAst>  _expr;
+    SimpleVariable  _var;
+    ExprPtr         _expr;
 };
 
 class SimpleVariableAst : public VariableAst {
   public:
-    SimpleVariableAst() : _var() { }
-    SimpleVariableAst(const SimpleVariable& var) : _var(var) { }
-    SimpleVariableAst(const char *var) : _var(var) { }
+    SimpleVariableAst() : _var(), _id(0) { }
+    SimpleVariableAst(const SimpleVariable& var, unsigned long long id = 0) : 
+        _var(var), _id(id) 
+    { }
+    SimpleVariableAst(const char *var) : _var(var), _id(0) { }
 
     void set_variable(const SimpleVariable& var) {
         _var = var;
@@ -311,16 +321,23 @@ class SimpleVariableAst : public VariableAst {
         return new SimpleVariableAst(_var);
     }
 
+    unsigned long long get_id() {
+        return _id;
+    }
+
     ~SimpleVariableAst() { }
 
   private:
-    SimpleVariable  _var;
+    SimpleVariable      _var;
+    unsigned long long  _id;
 };
 
 class SimpleConstAst : public ConstAst {
   public:
-    SimpleConstAst() : _value(0) { }
-    SimpleConstAst(int value) : _value(value) { }
+    SimpleConstAst() : _value(0), _id(0) { }
+    SimpleConstAst(int value, unsigned long long id = 0) : 
+        _value(value), _id(id) 
+    { }
 
     void set_value(int value) {
         _value = value;
@@ -338,20 +355,30 @@ class SimpleConstAst : public ConstAst {
         return new SimpleConstAst(_value.get_int());
     }
 
+    unsigned long long get_id() {
+        return _id;
+    }
+
     ~SimpleConstAst() { }
 
   private:
-    SimpleConstant  _value;
+    SimpleConstant      _value;
+    unsigned long long  _id;
 };
 
 class SimpleBinaryOpAst : public BinaryOpAst {
   public:
     SimpleBinaryOpAst() : 
-        _lhs(), _rhs(), _op(' ')
+        _lhs(), _rhs(), _op(' '), _id(0)
     { }
 
     SimpleBinaryOpAst(char op, ExprAst *lhs, ExprAst *rhs) :
-        _lhs(lhs), _rhs(rhs), _op(op)
+        _lhs(lhs), _rhs(rhs), _op(op), _id(0)
+    { }
+
+    SimpleBinaryOpAst(char op, ExprPtr lhs, ExprPtr rhs, 
+            unsigned long long id = 0) :
+        _lhs(lhs), _rhs(rhs), _op(op), _id(id)
     { }
 
     void set_lhs(ExprAst *lhs) {
@@ -382,15 +409,21 @@ class SimpleBinaryOpAst : public BinaryOpAst {
         return new SimpleBinaryOpAst(_op, _lhs->clone(), _rhs->clone());
     }
 
+    unsigned long long get_id() {
+        return _id;
+    }
+
     void accept_expr_visitor(ExprVisitor *visitor) {
         visitor->visit_binary_op(this);
     }
 
     ~SimpleBinaryOpAst() { }
   private:
-    std::unique_ptr<ExprAst>    _lhs;
-    std::unique_ptr<ExprAst>    _rhs;
-    char                        _op;
+    // operands may be shared with other expressions, see ExprStore
+    ExprPtr             _lhs;
+    ExprPtr             _rhs;
+    char                _op;
+    unsigned long long  _id;
 };
 
 } // namespace impl
@@ -0,0 +1,199 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include "impl/attribute_index.h"
+#include "impl/condition.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+static std::string int_to_key(int value) {
+    std::stringstream out;
+    out << value;
+    return out.str();
+}
+
+/*
+ * Extracts one attribute of a condition. Call statements are told apart
+ * from the other statements by visiting the statement itself.
+ */
+class AttributeKeyVisitor : public ConditionVisitor, public StatementVisitor {
+  public:
+    AttributeKeyVisitor(AttributeType type, std::string& key) :
+        _type(type), _key(key), _found(false)
+    { }
+
+    bool get_attribute(SimpleCondition *condition) {
+        condition->accept_condition_visitor(this);
+        return _found;
+    }
+
+    void visit_proc_condition(ProcCondition *condition) {
+        if(_type == ATTR_PROC_NAME) {
+            set_key(condition->get_proc_ast()->get_name());
+        }
+    }
+
+    void visit_statement_condition(StatementCondition *condition) {
+        StatementAst *statement = condition->get_statement_ast();
+
+        if(_type == ATTR_STMT_NO) {
+            if(statement->get_line() != 0) {
+                set_key(int_to_key(statement->get_line()));
+            }
+        } else if(_type == ATTR_PROC_NAME) {
+            statement->accept_statement_visitor(this);
+        }
+    }
+
+    void visit_variable_condition(VariableCondition *condition) {
+        if(_type == ATTR_VAR_NAME) {
+            set_key(condition->get_variable()->get_name());
+        }
+    }
+
+    void visit_constant_condition(ConstantCondition *condition) {
+        if(_type == ATTR_VALUE) {
+            set_key(int_to_key(condition->get_constant()->get_int()));
+        }
+    }
+
+    void visit_pattern_condition(PatternCondition *condition) { }
+
+    void visit_call(CallAst *call) {
+        set_key(call->get_proc_called()->get_name());
+    }
+
+    void visit_assignment(AssignmentAst *assign) { }
+    void visit_conditional(ConditionalAst *condition) { }
+    void visit_while(WhileAst *loop) { }
+
+  private:
+    void set_key(const std::string& key) {
+        _key = key;
+        _found = true;
+    }
+
+    AttributeType   _type;
+    std::string&    _key;
+    bool            _found;
+};
+
+bool is_name_attribute(AttributeType type) {
+    return type == ATTR_PROC_NAME || type == ATTR_VAR_NAME;
+}
+
+AttributeIndex::AttributeIndex(SimpleRoot ast, ConditionPoolPtr pool) : 
+    _pool(pool), _indexes(ATTR_COUNT) 
+{
+    for(SimpleRoot::iterator it = ast.begin(); it != ast.end(); ++it) {
+        ProcAst *proc = *it;
+        index_condition(ATTR_PROC_NAME, _pool->get_proc_condition(proc));
+        index_statement_list(proc->get_statement());
+    }
+}
+
+bool AttributeIndex::get_attribute(AttributeType type, 
+        SimpleCondition *condition, std::string& key)
+{
+    AttributeKeyVisitor visitor(type, key);
+    return visitor.get_attribute(condition);
+}
+
+ConditionSet AttributeIndex::lookup(AttributeType type, 
+        const std::string& key)
+{
+    KeyIndex& index = _indexes[type];
+    KeyIndex::iterator it = index.find(key);
+
+    if(it == index.end()) {
+        return ConditionSet();
+    }
+    return it->second;
+}
+
+void AttributeIndex::visit_assignment(AssignmentAst *assign) {
+    index_variable(assign->get_variable());
+    assign->get_expr()->accept_expr_visitor(this);
+}
+
+void AttributeIndex::visit_conditional(ConditionalAst *condition) {
+    index_variable(condition->get_variable());
+    index_statement_list(condition->get_then_branch());
+    index_statement_list(condition->get_else_branch());
+}
+
+void AttributeIndex::visit_while(WhileAst *loop) {
+    index_variable(loop->get_variable());
+    index_statement_list(loop->get_body());
+}
+
+void AttributeIndex::visit_call(CallAst *call) {
+    index_condition(ATTR_PROC_NAME, _pool->get_statement_condition(call));
+}
+
+void AttributeIndex::visit_const(ConstAst *constant) {
+    std::string key = int_to_key(constant->get_constant()->get_int());
+
+    if(_indexes[ATTR_VALUE].count(key) == 0) {
+        index_condition(ATTR_VALUE, 
+                _pool->get_constant_condition(*constant->get_constant()));
+    }
+}
+
+void AttributeIndex::visit_variable(VariableAst *var) {
+    index_variable(var->get_variable());
+}
+
+void AttributeIndex::visit_binary_op(BinaryOpAst *bin) {
+    bin->get_lhs()->accept_expr_visitor(this);
+    bin->get_rhs()->accept_expr_visitor(this);
+}
+
+void AttributeIndex::index_statement_list(StatementAst *statement) {
+    while(statement != NULL) {
+        index_statement(statement);
+        statement = statement->next();
+    }
+}
+
+void AttributeIndex::index_statement(StatementAst *statement) {
+    index_condition(ATTR_STMT_NO, _pool->get_statement_condition(statement));
+    statement->accept_statement_visitor(this);
+}
+
+void AttributeIndex::index_variable(SimpleVariable *var) {
+    if(_indexes[ATTR_VAR_NAME].count(var->get_name()) == 0) {
+        index_condition(ATTR_VAR_NAME, _pool->get_variable_condition(*var));
+    }
+}
+
+void AttributeIndex::index_condition(AttributeType type, 
+        ConditionPtr condition)
+{
+    std::string key;
+    if(get_attribute(type, condition.get(), key)) {
+        _indexes[type][key].insert(condition);
+    }
+}
+
+} // namespace impl
+} // namespace simple
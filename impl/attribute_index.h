@@ -0,0 +1,103 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "simple/ast.h"
+#include "simple/condition.h"
+#include "simple/condition_set.h"
+#include "impl/condition_pool.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * The attributes that can be compared in a with clause. Names are
+ * compared as strings and integers by their decimal representation, so
+ * that every attribute value can be used as the same kind of hash key.
+ *
+ * ATTR_PROC_NAME   procedure name of a procedure, or the name of the
+ *                  procedure called by a call statement
+ * ATTR_VAR_NAME    name of a variable
+ * ATTR_VALUE       value of a constant
+ * ATTR_STMT_NO     line number of a statement
+ */
+enum AttributeType {
+    ATTR_PROC_NAME = 0,
+    ATTR_VAR_NAME,
+    ATTR_VALUE,
+    ATTR_STMT_NO,
+    ATTR_COUNT
+};
+
+/*
+ * Whether the attribute values are names, as opposed to integers. Only
+ * attributes of the same kind can be compared with each other.
+ */
+bool is_name_attribute(AttributeType type);
+
+/*
+ * Hash indexes from attribute values to the conditions that have them,
+ * one index per attribute, built once when the program is loaded.
+ */
+class AttributeIndex : public StatementVisitor, public ExprVisitor {
+  public:
+    AttributeIndex(SimpleRoot ast, 
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool()));
+
+    /*
+     * Get the value of the given attribute of a condition as a key. 
+     * Return false if the condition does not have such an attribute,
+     * e.g. the procedure name of an assignment.
+     */
+    bool get_attribute(AttributeType type, SimpleCondition *condition,
+            std::string& key);
+
+    /*
+     * All conditions in the program whose attribute has the given value.
+     */
+    ConditionSet lookup(AttributeType type, const std::string& key);
+
+    void visit_assignment(AssignmentAst *assign);
+    void visit_conditional(ConditionalAst *condition);
+    void visit_while(WhileAst *loop);
+    void visit_call(CallAst *call);
+
+    void visit_const(ConstAst *constant);
+    void visit_variable(VariableAst *var);
+    void visit_binary_op(BinaryOpAst *bin);
+
+  private:
+    typedef std::unordered_map<std::string, ConditionSet> KeyIndex;
+
+    void index_statement_list(StatementAst *statement);
+    void index_statement(StatementAst *statement);
+    void index_variable(SimpleVariable *var);
+    void index_condition(AttributeType type, ConditionPtr condition);
+
+    ConditionPoolPtr      _pool;
+    std::vector<KeyIndex> _indexes;
+};
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,244 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <functional>
+#include <set>
+#include "impl/batch_planner.h"
+#include "impl/linker.h"
+#include "impl/result_cache.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+BatchPlanner::BatchPlanner(PredicatePtr wildcard_pred, 
+        const SolverTable& solvers, const PredicateTable& predicates,
+        const StatisticsCatalog& statistics, ThreadPoolPtr pool) :
+    _wildcard_pred(wildcard_pred), _pool(pool), _solver_names(), 
+    _domain_sizes(), _lock(), _clauses(), _stats()
+{ 
+    for(SolverTable::const_iterator it = solvers.begin(); 
+            it != solvers.end(); ++it)
+    {
+        _solver_names[it->second.get()] = it->first;
+    }
+
+    for(PredicateTable::const_iterator it = predicates.begin();
+            it != predicates.end(); ++it)
+    {
+        _domain_sizes[it->second.get()] = 
+            statistics.get_domain_size(it->first);
+    }
+}
+
+void BatchPlanner::plan(const std::vector<PqlQuerySet*>& queries) {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    // the shared clauses and stats of the previous batch are dropped
+    _clauses.clear();
+    _stats = BatchStats();
+
+    for(std::vector<PqlQuerySet*>::const_iterator qit = queries.begin();
+            qit != queries.end(); ++qit)
+    {
+        PqlQuerySet *query = *qit;
+
+        // a shape is counted once per query
+        std::set<std::string> shapes;
+        for(ClauseSet::iterator it = query->clauses.begin();
+                it != query->clauses.end(); ++it)
+        {
+            std::string shape = get_shape(*query, it->get());
+            if(shape.empty() || !shapes.insert(shape).second) {
+                continue;
+            }
+
+            SharedClause& shared = _clauses[shape];
+            if(shared.uses++ == 0) {
+                estimate_cost(*query, it->get(), shared);
+            }
+        }
+
+        ++_stats.queries;
+    }
+
+    _stats.shared_clauses = 0;
+    for(std::map<std::string, SharedClause>::iterator it = _clauses.begin();
+            it != _clauses.end(); ++it)
+    {
+        if(it->second.is_shared()) {
+            ++_stats.shared_clauses;
+        }
+    }
+}
+
+bool BatchPlanner::is_shared(PqlQuerySet& query, PqlClause *clause) {
+    std::string shape = get_shape(query, clause);
+
+    std::lock_guard<std::mutex> guard(_lock);
+    std::map<std::string, SharedClause>::iterator it = _clauses.find(shape);
+    return it != _clauses.end() && it->second.is_shared();
+}
+
+bool BatchPlanner::apply_clause(PqlQuerySet& query, PqlClause *clause,
+        QueryProcessor& processor)
+{
+    std::string shape = get_shape(query, clause);
+    if(shape.empty()) {
+        return false;
+    }
+
+    SharedClause *shared;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+
+        std::map<std::string, SharedClause>::iterator it = 
+            _clauses.find(shape);
+        if(it == _clauses.end() || !it->second.is_shared()) {
+            return false;
+        }
+        shared = &it->second;
+    }
+
+    // Concurrent queries needing the same clause wait for the first one
+    // instead of solving it again, while the other clauses go on. If 
+    // solving throws, e.g. when cancelled, the next query tries again.
+    std::call_once(shared->once, &BatchPlanner::compute, this, 
+            std::ref(query), clause, std::ref(*shared));
+
+    ConditionSet domain = shared->domain;
+    SharedClause::LinksPtr links = shared->links;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        ++_stats.reuses;
+    }
+
+    PqlVariableTerm *left = 
+        dynamic_cast<PqlVariableTerm*>(clause->get_left_term());
+    PqlVariableTerm *right = 
+        dynamic_cast<PqlVariableTerm*>(clause->get_right_term());
+
+    if(left != NULL && right != NULL) {
+        processor.link_qvars(left, right, *links);
+    } else {
+        PqlVariableTerm *term = left != NULL ? left : right;
+        processor.set_qvar(processor.get_slot(term), domain);
+    }
+    return true;
+}
+
+BatchStats BatchPlanner::get_stats() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _stats;
+}
+
+/*
+ * The shape of a clause that can be shared, or an empty string.
+ */
+std::string BatchPlanner::get_shape(PqlQuerySet& query, PqlClause *clause) {
+    PqlVariableTerm *left = 
+        dynamic_cast<PqlVariableTerm*>(clause->get_left_term());
+    PqlVariableTerm *right = 
+        dynamic_cast<PqlVariableTerm*>(clause->get_right_term());
+
+    if(left == NULL && right == NULL) {
+        return "";
+    }
+
+    if(left != NULL && right != NULL && 
+            left->get_query_variable() == right->get_query_variable()) 
+    {
+        return "";
+    }
+
+    return canonical_clause(query, clause, _solver_names);
+}
+
+size_t BatchPlanner::get_domain_size(PqlQuerySet& query, 
+        PqlVariableTerm *term)
+{
+    PredicatePtr predicate = query.predicates[term->get_query_variable()];
+    std::map<SimplePredicate*, size_t>::iterator it = 
+        _domain_sizes.find(predicate.get());
+
+    if(it == _domain_sizes.end()) {
+        return predicate->global_set().get_size();
+    }
+    return it->second;
+}
+
+void BatchPlanner::estimate_cost(PqlQuerySet& query, PqlClause *clause,
+        SharedClause& shared)
+{
+    PqlVariableTerm *left = 
+        dynamic_cast<PqlVariableTerm*>(clause->get_left_term());
+    PqlVariableTerm *right = 
+        dynamic_cast<PqlVariableTerm*>(clause->get_right_term());
+
+    if(left == NULL || right == NULL) {
+        // one solve or probe per condition of the synonym either way
+        PqlVariableTerm *term = left != NULL ? left : right;
+        shared.shared_cost = get_domain_size(query, term);
+        shared.query_cost = shared.shared_cost;
+        return;
+    }
+
+    size_t left_size = get_domain_size(query, left);
+    size_t right_size = get_domain_size(query, right);
+
+    shared.query_cost = left_size + right_size;
+    shared.shared_cost = clause->get_solver()->as_keyed() != NULL ?
+        left_size + right_size : left_size * right_size;
+}
+
+/*
+ * Solve the clause alone, with a fresh linker in which its synonyms
+ * start from the global sets of their predicates. The shared clause is
+ * left alone if solving is cancelled.
+ */
+void BatchPlanner::compute(PqlQuerySet& query, PqlClause *clause,
+        SharedClause& shared)
+{
+    std::shared_ptr<SimpleQueryLinker> linker(
+            new SimpleQueryLinker(query.qvar_names.size()));
+    QueryProcessor processor(linker, query.predicates, _wildcard_pred, _pool,
+            query.qvar_names);
+
+    PqlVariableTerm *left = 
+        dynamic_cast<PqlVariableTerm*>(clause->get_left_term());
+    PqlVariableTerm *right = 
+        dynamic_cast<PqlVariableTerm*>(clause->get_right_term());
+
+    if(left != NULL && right != NULL) {
+        SharedClause::LinksPtr links(new std::vector<ConditionPair>());
+        processor.collect_links(clause->get_solver(), left, right, *links);
+        shared.links = links;
+    } else {
+        processor.solve_clause(clause);
+
+        PqlVariableTerm *term = left != NULL ? left : right;
+        shared.domain = processor.get_qvar(processor.get_slot(term));
+    }
+
+    std::lock_guard<std::mutex> guard(_lock);
+    ++_stats.computed;
+}
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,163 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "simple/condition_set.h"
+#include "simple/predicate.h"
+#include "simple/query.h"
+#include "simple/solver.h"
+#include "impl/processor.h"
+#include "impl/statistics.h"
+#include "impl/thread_pool.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+struct BatchStats {
+  public:
+    BatchStats() : 
+        queries(0), shared_clauses(0), computed(0), reuses(0)
+    { }
+
+    size_t  queries;
+
+    // clause shapes that are worth sharing among the queries of the batch
+    size_t  shared_clauses;
+
+    // shared clauses solved so far, once each
+    size_t  computed;
+
+    // clauses of the queries answered by a shared result
+    size_t  reuses;
+};
+
+/*
+ * Finds the clauses that the queries of a batch have in common, e.g.
+ * Parent*(w, a) or Modifies(a, "x") for the same kinds of synonyms in
+ * every query, so that each of them is solved once for the whole batch.
+ *
+ * Clauses are compared by their shape (see canonical_clause()). A shape
+ * that occurs in two or more queries is shared if solving it once is 
+ * cheaper than solving it in every query, by the domain sizes of the
+ * statistics catalog. A shared clause is solved the first time a query 
+ * needs it, over the global sets of the predicates of its synonyms:
+ *
+ * - a clause with one synonym gives the conditions of that synonym, 
+ *   which restrict the synonym in every query that has the clause;
+ * - a clause with two distinct synonyms gives the pairs of conditions it
+ *   relates, which link the two synonyms of every query that has the 
+ *   clause, skipping the pairs that earlier clauses have ruled out.
+ *
+ * Clauses without synonyms, or with the same synonym on both sides, are
+ * cheap to solve or depend on the query, and are never shared.
+ *
+ * Linking two synonyms over their global sets validates every pair, 
+ * e.g. |stmt|^2 pairs for Next*(s1, s2), unless the solver is keyed. A
+ * query usually reaches the clause with one of the synonyms restricted 
+ * by its other clauses, and then pays about one solve per condition of
+ * either synonym. Such a clause is only shared if the pairs are no more
+ * than that for all the queries having it.
+ *
+ * All the queries have to be parsed on the same knowledge base, whose
+ * solver and predicate tables name the relations and design entities.
+ * A planner may be used by several evaluators at once.
+ */
+class BatchPlanner {
+  public:
+    BatchPlanner(PredicatePtr wildcard_pred, const SolverTable& solvers,
+            const PredicateTable& predicates, 
+            const StatisticsCatalog& statistics,
+            ThreadPoolPtr pool = ThreadPoolPtr());
+
+    /*
+     * Count the clause shapes of all the queries of the batch, replacing
+     * the shared clauses and stats of any previous batch. Must not be 
+     * called while the queries of the previous batch are evaluated.
+     */
+    void plan(const std::vector<PqlQuerySet*>& queries);
+
+    bool is_shared(PqlQuerySet& query, PqlClause *clause);
+
+    /*
+     * Restrict or link the synonyms of the clause in the processor of the
+     * query by the shared result of the clause, solving it first if no
+     * query has needed it yet. Returns false without doing anything if 
+     * the clause is not shared.
+     */
+    bool apply_clause(PqlQuerySet& query, PqlClause *clause, 
+            QueryProcessor& processor);
+
+    BatchStats get_stats() const;
+
+  private:
+    struct SharedClause {
+        SharedClause() : 
+            uses(0), shared_cost(0), query_cost(0), once(), 
+            domain(), links() 
+        { }
+
+        typedef std::shared_ptr< std::vector<ConditionPair> > LinksPtr;
+
+        bool is_shared() const {
+            return uses > 1 && shared_cost <= uses * query_cost;
+        }
+
+        // number of queries with the clause
+        size_t      uses;
+
+        // estimated cost of solving the clause once over the global sets,
+        // and of solving it within one query
+        size_t      shared_cost;
+        size_t      query_cost;
+
+        // solved at most once, outside of the planner lock
+        std::once_flag  once;
+        ConditionSet    domain;
+        LinksPtr        links;
+    };
+
+    std::string get_shape(PqlQuerySet& query, PqlClause *clause);
+
+    void estimate_cost(PqlQuerySet& query, PqlClause *clause,
+            SharedClause& shared);
+
+    size_t get_domain_size(PqlQuerySet& query, PqlVariableTerm *term);
+
+    void compute(PqlQuerySet& query, PqlClause *clause, 
+            SharedClause& shared);
+
+    PredicatePtr    _wildcard_pred;
+    ThreadPoolPtr   _pool;
+    std::map<QuerySolver*, std::string> _solver_names;
+    std::map<SimplePredicate*, size_t>  _domain_sizes;
+
+    mutable std::mutex  _lock;
+    std::map<std::string, SharedClause> _clauses;
+    BatchStats          _stats;
+};
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,335 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <set>
+#include "impl/bip_graph.h"
+#include "impl/cancellation.h"
+#include "impl/flow_collector.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+class LoopContainerVisitor : public ContainerVisitor {
+  public:
+    LoopContainerVisitor() : is_loop(false) { }
+
+    void visit_conditional(ConditionalAst *condition) {
+        is_loop = false;
+    }
+
+    void visit_while(WhileAst *loop) {
+        is_loop = true;
+    }
+
+    bool is_loop;
+};
+
+/*
+ * Whether control leaves the procedure once the statement is done,
+ * i.e. the statement is the last one of its procedure, or the last one
+ * of an if branch that leaves the procedure. The last statement of a
+ * while body goes back to the while instead.
+ */
+static bool leaves_proc(StatementAst *statement) {
+    while(statement->next() == NULL) {
+        ContainerAst *parent = statement->get_parent();
+        if(parent == NULL) {
+            return true;
+        }
+
+        LoopContainerVisitor visitor;
+        parent->accept_container_visitor(&visitor);
+        if(visitor.is_loop) {
+            return false;
+        }
+
+        statement = parent;
+    }
+
+    return false;
+}
+
+static void visit_edges(const std::vector<size_t>& edges, 
+        BitVector& visited, std::vector<size_t>& stack)
+{
+    for(size_t i = 0; i < edges.size(); ++i) {
+        if(!visited.test(edges[i])) {
+            visited.set(edges[i]);
+            stack.push_back(edges[i]);
+        }
+    }
+}
+
+BipGraph::BipGraph(SimpleRoot ast, 
+        std::shared_ptr<NextQuerySolver> next_solver,
+        std::shared_ptr<CallGraph> call_graph) :
+    _nodes(), _procs(), _statement_nodes()
+{
+    if(!call_graph) {
+        call_graph.reset(new CallGraph(ast));
+    }
+
+    std::vector<BipProc> procs;
+    std::map<ProcAst*, size_t> proc_indexes;
+    std::vector<CallAst*> calls;
+    std::vector<bool> conditionals;
+
+    for(SimpleRoot::iterator it = ast.begin(); it != ast.end(); ++it) {
+        FlowStatementCollector collector;
+        collector.collect((*it)->get_statement());
+
+        BipProc proc(*it);
+        proc.entry = _nodes.size();
+
+        for(size_t i = 0; i < collector.statements.size(); ++i) {
+            _statement_nodes[collector.statements[i]] = _nodes.size();
+            proc.nodes.push_back(_nodes.size());
+            _nodes.push_back(BipNode(collector.statements[i], 
+                        collector.assignments[i], *it));
+            calls.push_back(collector.calls[i]);
+            conditionals.push_back(collector.conditionals[i]);
+        }
+
+        proc.exit = _nodes.size();
+        proc.nodes.push_back(_nodes.size());
+        _nodes.push_back(BipNode(NULL, NULL, *it));
+        calls.push_back(NULL);
+        conditionals.push_back(false);
+
+        proc_indexes[*it] = procs.size();
+        procs.push_back(proc);
+    }
+
+    for(size_t i = 0; i < _nodes.size(); ++i) {
+        StatementAst *statement = _nodes[i].statement;
+        if(statement == NULL) {
+            continue;
+        }
+
+        StatementSet next = next_solver->solve_next_statement(statement);
+        for(StatementSet::iterator it = next.begin(); it != next.end(); ++it) {
+            if(*it != NULL) {
+                add_edge(i, _statement_nodes[*it], 
+                        &BipNode::flow_next, &BipNode::flow_prev);
+            }
+        }
+
+        // an if statement itself always goes on to one of its branches
+        if(!conditionals[i] && leaves_proc(statement)) {
+            add_edge(i, procs[proc_indexes[_nodes[i].proc]].exit,
+                    &BipNode::flow_next, &BipNode::flow_prev);
+        }
+    }
+
+    for(size_t i = 0; i < _nodes.size(); ++i) {
+        if(calls[i] == NULL || proc_indexes.count(calls[i]->get_proc_called()) == 0) {
+            continue;
+        }
+
+        size_t callee = proc_indexes[calls[i]->get_proc_called()];
+
+        add_edge(i, procs[callee].entry, 
+                &BipNode::call_next, &BipNode::call_prev);
+
+        std::vector<size_t> after_call = _nodes[i].flow_next;
+        for(size_t j = 0; j < after_call.size(); ++j) {
+            add_edge(procs[callee].exit, after_call[j],
+                    &BipNode::return_next, &BipNode::return_prev);
+        }
+    }
+
+    // the procedures are numbered in AST order by both graphs
+    const std::vector<size_t>& order = call_graph->get_topological_order();
+    for(size_t i = 0; i < order.size(); ++i) {
+        _procs.push_back(procs[order[i]]);
+    }
+}
+
+void BipGraph::add_edge(size_t from, size_t to, 
+        std::vector<size_t> BipNode::*next, std::vector<size_t> BipNode::*prev)
+{
+    (_nodes[from].*next).push_back(to);
+    (_nodes[to].*prev).push_back(from);
+}
+
+size_t BipGraph::get_size() const {
+    return _nodes.size();
+}
+
+const BipNode& BipGraph::get_node(size_t node) const {
+    return _nodes[node];
+}
+
+bool BipGraph::find_node(StatementAst *statement, size_t& node) const {
+    std::map<StatementAst*, size_t>::const_iterator it = 
+        _statement_nodes.find(statement);
+
+    if(it == _statement_nodes.end()) {
+        return false;
+    }
+
+    node = it->second;
+    return true;
+}
+
+const std::vector<BipProc>& BipGraph::get_procs() const {
+    return _procs;
+}
+
+void BipGraph::push_bip_edges(size_t node, bool forward, 
+        std::vector<size_t>& pending) const
+{
+    const BipNode& current = _nodes[node];
+
+    if(forward) {
+        // a call is followed by its callee rather than the statement
+        // after it, which is reached from the callee exit instead
+        if(!current.call_next.empty()) {
+            pending.insert(pending.end(), 
+                    current.call_next.begin(), current.call_next.end());
+        } else {
+            pending.insert(pending.end(), 
+                    current.flow_next.begin(), current.flow_next.end());
+            pending.insert(pending.end(), 
+                    current.return_next.begin(), current.return_next.end());
+        }
+    } else {
+        for(size_t i = 0; i < current.flow_prev.size(); ++i) {
+            if(_nodes[current.flow_prev[i]].call_next.empty()) {
+                pending.push_back(current.flow_prev[i]);
+            }
+        }
+
+        pending.insert(pending.end(), 
+                current.call_prev.begin(), current.call_prev.end());
+        pending.insert(pending.end(), 
+                current.return_prev.begin(), current.return_prev.end());
+    }
+}
+
+std::vector<size_t> BipGraph::get_bip_edges(size_t node, bool forward) const {
+    std::vector<size_t> result;
+    std::vector<size_t> pending;
+    BitVector visited(_nodes.size());
+
+    push_bip_edges(node, forward, pending);
+
+    while(!pending.empty()) {
+        size_t current = pending.back();
+        pending.pop_back();
+
+        if(visited.test(current)) {
+            continue;
+        }
+        visited.set(current);
+
+        // exit nodes are not statements, so look through them
+        if(_nodes[current].statement != NULL) {
+            result.push_back(current);
+        } else {
+            push_bip_edges(current, forward, pending);
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+bool BipGraph::has_bip_edge(size_t node, bool forward) const {
+    std::vector<size_t> pending;
+    std::set<size_t> visited;
+
+    push_bip_edges(node, forward, pending);
+
+    while(!pending.empty()) {
+        size_t current = pending.back();
+        pending.pop_back();
+
+        if(_nodes[current].statement != NULL) {
+            return true;
+        } else if(visited.insert(current).second) {
+            push_bip_edges(current, forward, pending);
+        }
+    }
+    return false;
+}
+
+bool BipGraph::has_any_bip_edge() const {
+    for(size_t node = 0; node < _nodes.size(); ++node) {
+        if(_nodes[node].statement != NULL && has_bip_edge(node, true)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+BitVector BipGraph::get_reachable(size_t node, bool forward) const {
+    typedef std::vector<size_t> BipNode::*Edges;
+
+    Edges flow = forward ? &BipNode::flow_next : &BipNode::flow_prev;
+    Edges up = forward ? &BipNode::return_next : &BipNode::call_prev;
+    Edges down = forward ? &BipNode::call_next : &BipNode::return_prev;
+
+    BitVector up_visited(_nodes.size());
+    BitVector down_visited(_nodes.size());
+    std::vector<size_t> up_stack;
+    std::vector<size_t> down_stack;
+
+    visit_edges(_nodes[node].*flow, up_visited, up_stack);
+    visit_edges(_nodes[node].*up, up_visited, up_stack);
+    visit_edges(_nodes[node].*down, down_visited, down_stack);
+
+    while(!up_stack.empty()) {
+        check_cancellation();
+
+        size_t current = up_stack.back();
+        up_stack.pop_back();
+
+        visit_edges(_nodes[current].*flow, up_visited, up_stack);
+        visit_edges(_nodes[current].*up, up_visited, up_stack);
+        visit_edges(_nodes[current].*down, down_visited, down_stack);
+    }
+
+    while(!down_stack.empty()) {
+        check_cancellation();
+
+        size_t current = down_stack.back();
+        down_stack.pop_back();
+
+        // everything reachable from a node of the first pass has been 
+        // found already
+        if(up_visited.test(current)) {
+            continue;
+        }
+
+        visit_edges(_nodes[current].*flow, down_visited, down_stack);
+        visit_edges(_nodes[current].*down, down_visited, down_stack);
+    }
+
+    up_visited.union_with(down_visited);
+    for(size_t i = 0; i < _procs.size(); ++i) {
+        up_visited.reset(_procs[i].exit);
+    }
+    return up_visited;
+}
+
+} // namespace impl
+} // namespace simple
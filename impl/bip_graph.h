@@ -0,0 +1,160 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+#include "simple/ast.h"
+#include "impl/bit_vector.h"
+#include "impl/call_graph.h"
+#include "impl/solvers/next.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * A node of the interprocedural control flow graph. Every statement is a
+ * node, and every procedure has one extra exit node with a NULL 
+ * statement that all the paths leaving the procedure go through.
+ */
+struct BipNode {
+  public:
+    BipNode(StatementAst *statement, AssignmentAst *assignment, 
+            ProcAst *proc) :
+        statement(statement), assignment(assignment), proc(proc),
+        flow_next(), flow_prev(), call_next(), call_prev(),
+        return_next(), return_prev()
+    { }
+
+    StatementAst    *statement;
+    AssignmentAst   *assignment;    // NULL unless an assignment
+    ProcAst         *proc;
+
+    // Next within the procedure. The flow edges of a call statement are
+    // its summary edges: a procedure in Simple can always run to its end,
+    // so the statements following a call are reachable from it without
+    // looking into the callee.
+    std::vector<size_t> flow_next;
+    std::vector<size_t> flow_prev;
+
+    // From a call statement to the first statement of its callee.
+    std::vector<size_t> call_next;
+    std::vector<size_t> call_prev;
+
+    // From the exit node of a procedure to the flow successors of every
+    // call to it.
+    std::vector<size_t> return_next;
+    std::vector<size_t> return_prev;
+};
+
+/*
+ * A procedure of the interprocedural control flow graph.
+ */
+struct BipProc {
+  public:
+    BipProc(ProcAst *proc) : proc(proc), entry(0), exit(0), nodes() { }
+
+    ProcAst             *proc;
+    size_t              entry;
+    size_t              exit;
+    std::vector<size_t> nodes;
+};
+
+/*
+ * The interprocedural control flow graph used by the NextBip and 
+ * AffectsBip relations, built once from the Next relation and the call
+ * statements of the program.
+ *
+ * Calls are not inlined. Each call gets an edge into its callee and 
+ * every procedure exit gets return edges back to its callers, while the
+ * summary edge over a call keeps paths in the caller from having to go
+ * through the callee. A path is valid if every return matches the last
+ * unmatched call, except that a path may start inside a procedure and
+ * return to any of its callers.
+ */
+class BipGraph {
+  public:
+    BipGraph(SimpleRoot ast, std::shared_ptr<NextQuerySolver> next_solver,
+            std::shared_ptr<CallGraph> call_graph = std::shared_ptr<CallGraph>());
+
+    size_t get_size() const;
+
+    const BipNode& get_node(size_t node) const;
+
+    /*
+     * Find the node of a statement. Return false if the statement is not
+     * part of the program.
+     */
+    bool find_node(StatementAst *statement, size_t& node) const;
+
+    /*
+     * The procedures in the topological order of the call graph, so that
+     * every procedure comes after all the procedures it calls.
+     */
+    const std::vector<BipProc>& get_procs() const;
+
+    /*
+     * The successors of a node in the NextBip relation, or the 
+     * predecessors if forward is false. Exit nodes are looked through,
+     * so only statement nodes are returned.
+     */
+    std::vector<size_t> get_bip_edges(size_t node, bool forward) const;
+
+    /*
+     * Whether get_bip_edges() of the node is not empty, stopping at the
+     * first statement node found.
+     */
+    bool has_bip_edge(size_t node, bool forward) const;
+
+    /*
+     * Whether some statement node has a NextBip successor.
+     */
+    bool has_any_bip_edge() const;
+
+    /*
+     * All the statement nodes reachable from a node by a valid path of
+     * at least one step, or reaching it if forward is false.
+     *
+     * This takes two passes in the style of interprocedural reachability
+     * with summary edges. The first pass may leave procedures through 
+     * return edges, i.e. go up the call graph, but steps over calls with
+     * the summary edges. The second pass starts from everything found
+     * by the first, and may only go down into callees. Every node is 
+     * visited at most once per pass, so the cost is linear in the size 
+     * of the graph regardless of the number of call paths.
+     */
+    BitVector get_reachable(size_t node, bool forward) const;
+
+  private:
+    void push_bip_edges(size_t node, bool forward, 
+            std::vector<size_t>& pending) const;
+
+    void add_edge(size_t from, size_t to, 
+            std::vector<size_t> BipNode::*next, std::vector<size_t> BipNode::*prev);
+
+    std::vector<BipNode>    _nodes;
+    std::vector<BipProc>    _procs;
+    std::map<StatementAst*, size_t> _statement_nodes;
+};
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,107 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impl/bit_vector.h"
+
+namespace simple {
+namespace impl {
+
+BitVector::BitVector(size_t size) : 
+    _words((size + WORD_BITS - 1) / WORD_BITS, 0), _size(size)
+{ }
+
+size_t BitVector::get_size() const {
+    return _size;
+}
+
+void BitVector::set(size_t index) {
+    _words[index / WORD_BITS] |= Word(1) << (index % WORD_BITS);
+}
+
+void BitVector::reset(size_t index) {
+    _words[index / WORD_BITS] &= ~(Word(1) << (index % WORD_BITS));
+}
+
+bool BitVector::test(size_t index) const {
+    return (_words[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+bool BitVector::union_with(const BitVector& other) {
+    bool changed = false;
+    for(size_t i = 0; i < _words.size(); ++i) {
+        Word word = _words[i] | other._words[i];
+        if(word != _words[i]) {
+            _words[i] = word;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void BitVector::intersect_with(const BitVector& other) {
+    for(size_t i = 0; i < _words.size(); ++i) {
+        _words[i] &= other._words[i];
+    }
+}
+
+void BitVector::subtract(const BitVector& other) {
+    for(size_t i = 0; i < _words.size(); ++i) {
+        _words[i] &= ~other._words[i];
+    }
+}
+
+bool BitVector::is_empty() const {
+    for(size_t i = 0; i < _words.size(); ++i) {
+        if(_words[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t BitVector::count() const {
+    size_t result = 0;
+    for(size_t i = 0; i < _words.size(); ++i) {
+        result += __builtin_popcountl(_words[i]);
+    }
+    return result;
+}
+
+std::vector<size_t> BitVector::get_indexes() const {
+    std::vector<size_t> result;
+    for(size_t i = 0; i < _words.size(); ++i) {
+        Word word = _words[i];
+        while(word != 0) {
+            size_t bit = __builtin_ctzl(word);
+            result.push_back(i * WORD_BITS + bit);
+            word &= word - 1;
+        }
+    }
+    return result;
+}
+
+bool BitVector::operator ==(const BitVector& other) const {
+    return _size == other._size && _words == other._words;
+}
+
+bool BitVector::operator !=(const BitVector& other) const {
+    return !(*this == other);
+}
+
+} // namespace impl
+} // namespace simple
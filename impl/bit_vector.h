@@ -0,0 +1,71 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace simple {
+namespace impl {
+
+/*
+ * A fixed size set of small integers stored as a bit vector, for the
+ * dataflow and closure computations of the solvers. Operations between
+ * two vectors require them to have the same size.
+ */
+class BitVector {
+  public:
+    BitVector(size_t size = 0);
+
+    size_t get_size() const;
+
+    void set(size_t index);
+    void reset(size_t index);
+    bool test(size_t index) const;
+
+    /*
+     * Add all the bits of other, and return whether any bit was added.
+     */
+    bool union_with(const BitVector& other);
+
+    void intersect_with(const BitVector& other);
+    void subtract(const BitVector& other);
+
+    bool is_empty() const;
+    size_t count() const;
+
+    /*
+     * The indexes of all set bits, in increasing order.
+     */
+    std::vector<size_t> get_indexes() const;
+
+    bool operator ==(const BitVector& other) const;
+    bool operator !=(const BitVector& other) const;
+
+  private:
+    typedef unsigned long Word;
+
+    static const size_t WORD_BITS = sizeof(Word) * 8;
+
+    std::vector<Word>   _words;
+    size_t              _size;
+};
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,195 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "impl/call_graph.h"
+#include "impl/condition.h"
+#include "impl/flow_collector.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+CallGraph::CallGraph(SimpleRoot ast, ConditionPoolPtr pool) :
+    _procs(), _proc_ids(), _conditions(), 
+    _calls(), _called_by(), _calls_closure(), _called_by_closure(),
+    _order(), _any_call(false), 
+    _indexes(), _low_links(), _on_stack(), _stack(), _next_index(0)
+{
+    for(SimpleRoot::iterator it = ast.begin(); it != ast.end(); ++it) {
+        _proc_ids[*it] = _procs.size();
+        _procs.push_back(*it);
+        _conditions.push_back(pool->get_proc_condition(*it));
+    }
+
+    size_t size = _procs.size();
+    _calls.resize(size, BitVector(size));
+    _called_by.resize(size, BitVector(size));
+    _calls_closure.resize(size, BitVector(size));
+    _called_by_closure.resize(size, BitVector(size));
+
+    for(size_t i = 0; i < size; ++i) {
+        FlowStatementCollector collector;
+        collector.collect(_procs[i]->get_statement());
+
+        for(size_t j = 0; j < collector.calls.size(); ++j) {
+            size_t callee;
+            if(collector.calls[j] != NULL &&
+                    find_proc(collector.calls[j]->get_proc_called(), callee))
+            {
+                _calls[i].set(callee);
+                _called_by[callee].set(i);
+                _any_call = true;
+            }
+        }
+    }
+
+    _indexes.resize(size, -1);
+    _low_links.resize(size, -1);
+    _on_stack.resize(size, false);
+
+    for(size_t i = 0; i < size; ++i) {
+        if(_indexes[i] < 0) {
+            find_components(i);
+        }
+    }
+
+    for(size_t i = 0; i < size; ++i) {
+        std::vector<size_t> callees = _calls_closure[i].get_indexes();
+        for(size_t j = 0; j < callees.size(); ++j) {
+            _called_by_closure[callees[j]].set(i);
+        }
+    }
+
+    _indexes.clear();
+    _low_links.clear();
+    _on_stack.clear();
+}
+
+void CallGraph::find_components(size_t id) {
+    _indexes[id] = _low_links[id] = _next_index++;
+    _stack.push_back(id);
+    _on_stack[id] = true;
+
+    std::vector<size_t> callees = _calls[id].get_indexes();
+    for(size_t i = 0; i < callees.size(); ++i) {
+        size_t callee = callees[i];
+
+        if(_indexes[callee] < 0) {
+            find_components(callee);
+            _low_links[id] = std::min(_low_links[id], _low_links[callee]);
+        } else if(_on_stack[callee]) {
+            _low_links[id] = std::min(_low_links[id], _indexes[callee]);
+        }
+    }
+
+    if(_low_links[id] != _indexes[id]) {
+        return;
+    }
+
+    // pop the component, whose callees outside it are all done
+    std::vector<size_t> component;
+    size_t member;
+    do {
+        member = _stack.back();
+        _stack.pop_back();
+        _on_stack[member] = false;
+        component.push_back(member);
+    } while(member != id);
+
+    BitVector members(_procs.size());
+    for(size_t i = 0; i < component.size(); ++i) {
+        members.set(component[i]);
+    }
+
+    BitVector row(_procs.size());
+    bool recursive = component.size() > 1 || _calls[id].test(id);
+
+    for(size_t i = 0; i < component.size(); ++i) {
+        std::vector<size_t> callees = _calls[component[i]].get_indexes();
+        for(size_t j = 0; j < callees.size(); ++j) {
+            if(!members.test(callees[j])) {
+                row.set(callees[j]);
+                row.union_with(_calls_closure[callees[j]]);
+            }
+        }
+    }
+
+    if(recursive) {
+        row.union_with(members);
+    }
+
+    for(size_t i = component.size(); i-- > 0; ) {
+        _calls_closure[component[i]] = row;
+        _order.push_back(component[i]);
+    }
+}
+
+size_t CallGraph::get_size() const {
+    return _procs.size();
+}
+
+bool CallGraph::find_proc(ProcAst *proc, size_t& id) const {
+    std::map<ProcAst*, size_t>::const_iterator it = _proc_ids.find(proc);
+
+    if(it == _proc_ids.end()) {
+        return false;
+    }
+
+    id = it->second;
+    return true;
+}
+
+ProcAst* CallGraph::get_proc(size_t id) const {
+    return _procs[id];
+}
+
+const BitVector& CallGraph::get_calls(size_t id, bool forward) const {
+    return forward ? _calls[id] : _called_by[id];
+}
+
+const BitVector& CallGraph::get_closure(size_t id, bool forward) const {
+    return forward ? _calls_closure[id] : _called_by_closure[id];
+}
+
+bool CallGraph::has_calls(ProcAst *proc, bool forward) const {
+    size_t id;
+    return find_proc(proc, id) && !get_calls(id, forward).is_empty();
+}
+
+bool CallGraph::has_any_call() const {
+    return _any_call;
+}
+
+const std::vector<size_t>& CallGraph::get_topological_order() const {
+    return _order;
+}
+
+ConditionSet CallGraph::to_conditions(const BitVector& row) const {
+    ConditionSet result;
+
+    std::vector<size_t> ids = row.get_indexes();
+    for(size_t i = 0; i < ids.size(); ++i) {
+        result.insert(_conditions[ids[i]]);
+    }
+    return result;
+}
+
+} // namespace impl
+} // namespace simple
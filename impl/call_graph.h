@@ -0,0 +1,120 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include "simple/ast.h"
+#include "simple/condition_set.h"
+#include "impl/bit_vector.h"
+#include "impl/condition_pool.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * The call graph of a program over dense procedure ids, numbered in the
+ * order of the procedures in the AST.
+ *
+ * The transitive closure is computed once at construction. The strongly
+ * connected components of the graph are found with Tarjan's algorithm,
+ * which emits each component after all the components it calls, so the
+ * closure row of a component is just the union of the rows of its 
+ * callees, plus its own procedures if it is recursive. Calls and Calls*
+ * are then bit tests and row scans.
+ */
+class CallGraph {
+  public:
+    CallGraph(SimpleRoot ast, 
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool()));
+
+    size_t get_size() const;
+
+    /*
+     * Find the id of a procedure. Return false if the procedure is not
+     * part of the program.
+     */
+    bool find_proc(ProcAst *proc, size_t& id) const;
+
+    ProcAst* get_proc(size_t id) const;
+
+    /*
+     * The procedures called directly by a procedure, or calling it 
+     * directly if forward is false.
+     */
+    const BitVector& get_calls(size_t id, bool forward) const;
+
+    /*
+     * The procedures called directly or indirectly by a procedure, or
+     * calling it if forward is false.
+     */
+    const BitVector& get_closure(size_t id, bool forward) const;
+
+    /*
+     * Whether a procedure calls some procedure, or is called by one if
+     * forward is false, directly or not. False for a procedure that is
+     * not part of the program.
+     */
+    bool has_calls(ProcAst *proc, bool forward) const;
+
+    /*
+     * Whether some procedure calls another one.
+     */
+    bool has_any_call() const;
+
+    /*
+     * The procedures ordered so that every procedure comes after all
+     * the procedures it calls, except for the calls within a recursive
+     * component, whose procedures are kept next to each other.
+     */
+    const std::vector<size_t>& get_topological_order() const;
+
+    /*
+     * The procedure conditions of a row, sharing one condition per
+     * procedure instead of allocating new ones for every query.
+     */
+    ConditionSet to_conditions(const BitVector& row) const;
+
+  private:
+    void find_components(size_t id);
+
+    std::vector<ProcAst*>   _procs;
+    std::map<ProcAst*, size_t> _proc_ids;
+    std::vector<ConditionPtr>  _conditions;
+
+    std::vector<BitVector>  _calls;
+    std::vector<BitVector>  _called_by;
+    std::vector<BitVector>  _calls_closure;
+    std::vector<BitVector>  _called_by_closure;
+
+    std::vector<size_t>     _order;
+    bool                    _any_call;
+
+    // Tarjan's algorithm state, only used during construction
+    std::vector<long>       _indexes;
+    std::vector<long>       _low_links;
+    std::vector<bool>       _on_stack;
+    std::vector<size_t>     _stack;
+    long                    _next_index;
+};
+
+} // namespace impl
+} // namespace simple
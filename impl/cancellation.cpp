@@ -0,0 +1,92 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impl/cancellation.h"
+
+namespace simple {
+namespace impl {
+
+// Number of check_cancellation() calls between two reads of the clock.
+const unsigned int CLOCK_CHECK_INTERVAL = 64;
+
+static thread_local CancellationToken *current_token = NULL;
+static thread_local unsigned int check_countdown = 0;
+
+CancellationToken::CancellationToken() :
+    _cancelled(false), _has_deadline(false), _deadline()
+{ }
+
+CancellationToken::CancellationToken(long timeout_ms) :
+    _cancelled(false), _has_deadline(true), 
+    _deadline(Clock::now() + std::chrono::milliseconds(timeout_ms))
+{ }
+
+void CancellationToken::cancel() {
+    _cancelled = true;
+}
+
+bool CancellationToken::is_cancelled() {
+    if(_cancelled) {
+        return true;
+    }
+
+    if(_has_deadline && Clock::now() >= _deadline) {
+        _cancelled = true;
+        return true;
+    }
+
+    return false;
+}
+
+void CancellationToken::check() {
+    if(is_cancelled()) {
+        throw QueryTimeoutError();
+    }
+}
+
+CancellationScope::CancellationScope(CancellationToken *token) :
+    _previous(current_token)
+{
+    current_token = token;
+    check_countdown = 0;
+}
+
+CancellationScope::~CancellationScope() {
+    current_token = _previous;
+}
+
+CancellationToken* current_cancellation_token() {
+    return current_token;
+}
+
+void check_cancellation() {
+    if(current_token == NULL) {
+        return;
+    }
+
+    if(check_countdown > 0) {
+        --check_countdown;
+        return;
+    }
+
+    check_countdown = CLOCK_CHECK_INTERVAL;
+    current_token->check();
+}
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,104 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+
+namespace simple {
+namespace impl {
+
+/*
+ * Thrown from inside query evaluation when the cancellation token of the
+ * current query has fired. It unwinds the processor, linker and solvers
+ * back to the QueryEvaluator, which turns it into a timeout result.
+ */
+class QueryTimeoutError : public std::exception { };
+
+/*
+ * A cancellation token shared by everything that works on one query. 
+ * The token fires either when cancel() is called, possibly from another
+ * thread, or once its deadline has passed.
+ */
+class CancellationToken {
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    /*
+     * A token without deadline that only fires on cancel().
+     */
+    CancellationToken();
+
+    /*
+     * A token that fires timeout_ms milliseconds from now.
+     */
+    explicit CancellationToken(long timeout_ms);
+
+    void cancel();
+
+    bool is_cancelled();
+
+    /*
+     * Throw QueryTimeoutError if the token has fired.
+     */
+    void check();
+
+  private:
+    std::atomic<bool>   _cancelled;
+    bool                _has_deadline;
+    Clock::time_point   _deadline;
+    
+    CancellationToken(const CancellationToken&);
+    CancellationToken& operator =(const CancellationToken&);
+};
+
+typedef std::shared_ptr<CancellationToken> CancellationTokenPtr;
+
+/*
+ * Install a token as the current token of the calling thread for the
+ * lifetime of the scope object. Scopes nest; the previous token is
+ * restored on destruction. A NULL token disables cancellation checks.
+ */
+class CancellationScope {
+  public:
+    CancellationScope(CancellationToken *token);
+
+    ~CancellationScope();
+
+  private:
+    CancellationToken *_previous;
+};
+
+/*
+ * The token installed on the calling thread, or NULL.
+ */
+CancellationToken* current_cancellation_token();
+
+/*
+ * Checkpoint for long running loops. Throws QueryTimeoutError if the
+ * current thread has a token installed and it has fired. The deadline is
+ * only compared against the clock every few calls, so this is cheap
+ * enough to call once per loop iteration.
+ */
+void check_cancellation();
+
+} // namespace impl
+} // namespace simple
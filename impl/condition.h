@@ -100,6 +100,7 @@ class SimpleConstantCondition : public ConstantCondition {
 class SimplePatternCondition : public PatternCondition {
   public:
     SimplePatternCondition(ExprAst *pattern) : _pattern(pattern) { }
+    SimplePatternCondition(ExprPtr pattern) : _pattern(pattern) { }
 
     ExprAst* get_expr_ast() {
         return _pattern.get();
@@ -111,7 +112,7 @@ class SimplePatternCondition : public PatternCondition {
 
     ~SimplePatternCondition() { }
   private:
-    std::unique_ptr<ExprAst> _pattern;
+    ExprPtr _pattern;
 };
 
 } // namespace impl
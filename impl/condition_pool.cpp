@@ -0,0 +1,203 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impl/condition_pool.h"
+#include "impl/condition.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * Look up the id of a condition by the entity it refers to.
+ */
+class ConditionPool::IdFinder : public ConditionVisitor {
+  public:
+    IdFinder(const ConditionPool *pool) : 
+        _pool(pool), _found(false), _id(0) 
+    { }
+
+    void visit_statement_condition(StatementCondition *condition) {
+        find(_pool->_statements, condition->get_statement_ast());
+    }
+
+    void visit_proc_condition(ProcCondition *condition) {
+        find(_pool->_procs, condition->get_proc_ast());
+    }
+
+    void visit_variable_condition(VariableCondition *condition) {
+        find(_pool->_variables, condition->get_variable()->get_name());
+    }
+
+    void visit_constant_condition(ConstantCondition *condition) {
+        find(_pool->_constants, condition->get_constant()->get_int());
+    }
+
+    void visit_pattern_condition(PatternCondition *condition) { }
+
+    bool get_id(size_t& id) {
+        id = _id;
+        return _found;
+    }
+
+  private:
+    template <typename Key>
+    void find(const std::unordered_map<Key, size_t>& ids, const Key& key) {
+        typename std::unordered_map<Key, size_t>::const_iterator it = 
+            ids.find(key);
+
+        if(it != ids.end()) {
+            _found = true;
+            _id = it->second;
+        }
+    }
+
+    const ConditionPool *_pool;
+    bool    _found;
+    size_t  _id;
+};
+
+ConditionPool::ConditionPool() :
+    _conditions(), _statements(), _procs(), _variables(), _constants()
+{ }
+
+ConditionPool::ConditionPool(SimpleRoot ast) :
+    _conditions(), _statements(), _procs(), _variables(), _constants()
+{
+    for(SimpleRoot::iterator it = ast.begin(); it != ast.end(); ++it) {
+        _procs[*it] = add_condition(new SimpleProcCondition(*it));
+        index_statement_list((*it)->get_statement());
+    }
+}
+
+ConditionPtr ConditionPool::get_statement_condition(StatementAst *statement) {
+    std::unordered_map<StatementAst*, size_t>::iterator it =
+        _statements.find(statement);
+
+    if(it != _statements.end()) {
+        return _conditions[it->second];
+    } else {
+        return new SimpleStatementCondition(statement);
+    }
+}
+
+ConditionPtr ConditionPool::get_proc_condition(ProcAst *proc) {
+    std::unordered_map<ProcAst*, size_t>::iterator it = _procs.find(proc);
+
+    if(it != _procs.end()) {
+        return _conditions[it->second];
+    } else {
+        return new SimpleProcCondition(proc);
+    }
+}
+
+ConditionPtr ConditionPool::get_variable_condition(SimpleVariable var) {
+    std::unordered_map<std::string, size_t>::iterator it = 
+        _variables.find(var.get_name());
+
+    if(it != _variables.end()) {
+        return _conditions[it->second];
+    } else {
+        return new SimpleVariableCondition(var);
+    }
+}
+
+ConditionPtr ConditionPool::get_constant_condition(SimpleConstant constant) {
+    std::unordered_map<int, size_t>::iterator it = 
+        _constants.find(constant.get_int());
+
+    if(it != _constants.end()) {
+        return _conditions[it->second];
+    } else {
+        return new SimpleConstantCondition(constant);
+    }
+}
+
+size_t ConditionPool::get_size() const {
+    return _conditions.size();
+}
+
+bool ConditionPool::find_id(SimpleCondition *condition, size_t& id) const {
+    IdFinder finder(this);
+    condition->accept_condition_visitor(&finder);
+    return finder.get_id(id);
+}
+
+ConditionPtr ConditionPool::get_condition(size_t id) const {
+    return _conditions[id];
+}
+
+size_t ConditionPool::add_condition(SimpleCondition *condition) {
+    _conditions.push_back(ConditionPtr(condition));
+    return _conditions.size() - 1;
+}
+
+void ConditionPool::index_statement_list(StatementAst *statement) {
+    while(statement != NULL) {
+        _statements[statement] = add_condition(
+                new SimpleStatementCondition(statement));
+        statement->accept_statement_visitor(this);
+        statement = statement->next();
+    }
+}
+
+void ConditionPool::index_variable(SimpleVariable *var) {
+    if(_variables.count(var->get_name()) == 0) {
+        _variables[var->get_name()] = add_condition(
+                new SimpleVariableCondition(*var));
+    }
+}
+
+void ConditionPool::visit_assignment(AssignmentAst *assign) {
+    index_variable(assign->get_variable());
+    assign->get_expr()->accept_expr_visitor(this);
+}
+
+void ConditionPool::visit_conditional(ConditionalAst *condition) {
+    index_variable(condition->get_variable());
+    index_statement_list(condition->get_then_branch());
+    index_statement_list(condition->get_else_branch());
+}
+
+void ConditionPool::visit_while(WhileAst *loop) {
+    index_variable(loop->get_variable());
+    index_statement_list(loop->get_body());
+}
+
+void ConditionPool::visit_call(CallAst *call) { }
+
+void ConditionPool::visit_variable(VariableAst *var) {
+    index_variable(var->get_variable());
+}
+
+void ConditionPool::visit_const(ConstAst *val) {
+    int value = val->get_constant()->get_int();
+    if(_constants.count(value) == 0) {
+        _constants[value] = add_condition(
+                new SimpleConstantCondition(*val->get_constant()));
+    }
+}
+
+void ConditionPool::visit_binary_op(BinaryOpAst *bin) {
+    bin->get_lhs()->accept_expr_visitor(this);
+    bin->get_rhs()->accept_expr_visitor(this);
+}
+
+} // namespace impl
+} // namespace simple
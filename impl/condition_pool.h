@@ -0,0 +1,101 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "simple/ast.h"
+#include "simple/condition_set.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * The canonical conditions of a program, with exactly one condition per
+ * statement, procedure, variable and constant. 
+ *
+ * Solvers return conditions from the pool instead of allocating a new
+ * one for every result, so answering a query only copies shared 
+ * pointers. The pool is filled at construction and never changes 
+ * afterwards, so it can be read from several threads. An entity that is
+ * not part of the program gets a fresh condition, like before.
+ *
+ * The pooled conditions are also numbered densely from 0, so that other
+ * components can keep per-condition state in bit vectors.
+ */
+class ConditionPool : public StatementVisitor, public ExprVisitor {
+  public:
+    /*
+     * An empty pool, which allocates a new condition for every lookup.
+     */
+    ConditionPool();
+
+    ConditionPool(SimpleRoot ast);
+
+    ConditionPtr get_statement_condition(StatementAst *statement);
+    ConditionPtr get_proc_condition(ProcAst *proc);
+    ConditionPtr get_variable_condition(SimpleVariable var);
+    ConditionPtr get_constant_condition(SimpleConstant constant);
+
+    size_t get_size() const;
+
+    /*
+     * Get the id of a condition equal to one in the pool. Return false
+     * for a condition that is not part of the program.
+     */
+    bool find_id(SimpleCondition *condition, size_t& id) const;
+
+    ConditionPtr get_condition(size_t id) const;
+
+    void visit_assignment(AssignmentAst *assign);
+    void visit_conditional(ConditionalAst *condition);
+    void visit_while(WhileAst *loop);
+    void visit_call(CallAst *call);
+
+    void visit_variable(VariableAst *var);
+    void visit_const(ConstAst *val);
+    void visit_binary_op(BinaryOpAst *bin);
+
+  private:
+    class IdFinder;
+
+    void index_statement_list(StatementAst *statement);
+    void index_variable(SimpleVariable *var);
+    size_t add_condition(SimpleCondition *condition);
+
+    std::vector<ConditionPtr>                   _conditions;
+
+    // the id of every pooled entity
+    std::unordered_map<StatementAst*, size_t>   _statements;
+    std::unordered_map<ProcAst*, size_t>        _procs;
+    std::unordered_map<std::string, size_t>     _variables;
+    std::unordered_map<int, size_t>             _constants;
+
+    ConditionPool(const ConditionPool&);
+    ConditionPool& operator =(const ConditionPool&);
+};
+
+typedef std::shared_ptr<ConditionPool> ConditionPoolPtr;
+
+} // namespace impl
+} // namespace simple
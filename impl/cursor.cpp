@@ -0,0 +1,89 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impl/cursor.h"
+#include "simple/util/ast_utils.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+using namespace simple::util;
+
+StatementChainCursor::StatementChainCursor(ConditionPoolPtr pool, 
+        StatementAst *statement, ChainDirection direction) :
+    _pool(pool), _current(statement), _direction(direction)
+{ }
+
+bool StatementChainCursor::next(ConditionPtr& condition) {
+    if(_current == NULL) {
+        return false;
+    }
+
+    switch(_direction) {
+        case CHAIN_NEXT:
+            _current = _current->next();
+        break;
+        case CHAIN_PREV:
+            _current = _current->prev();
+        break;
+        case CHAIN_PARENT:
+            _current = _current->get_parent();
+        break;
+    }
+
+    if(_current == NULL) {
+        return false;
+    }
+
+    condition = _pool->get_statement_condition(_current);
+    return true;
+}
+
+DescendantCursor::DescendantCursor(ConditionPoolPtr pool, 
+        StatementAst *statement) :
+    _pool(pool), _pending()
+{
+    push_children(statement);
+}
+
+bool DescendantCursor::next(ConditionPtr& condition) {
+    while(!_pending.empty() && _pending.back() == NULL) {
+        _pending.pop_back();
+    }
+
+    if(_pending.empty()) {
+        return false;
+    }
+
+    StatementAst *statement = _pending.back();
+    _pending.back() = statement->next();
+    push_children(statement);
+
+    condition = _pool->get_statement_condition(statement);
+    return true;
+}
+
+void DescendantCursor::push_children(StatementAst *statement) {
+    // pushed in reverse, so that the first list is walked first
+    std::vector<StatementAst*> lists = get_nested_lists(statement);
+    _pending.insert(_pending.end(), lists.rbegin(), lists.rend());
+}
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,75 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include "simple/ast.h"
+#include "simple/solver.h"
+#include "impl/condition_pool.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+enum ChainDirection {
+    CHAIN_NEXT,
+    CHAIN_PREV,
+    CHAIN_PARENT
+};
+
+/*
+ * Walks from a statement along a chain of statements, yielding every 
+ * statement after it in its statement list, before it, or every 
+ * container it is nested in.
+ */
+class StatementChainCursor : public ConditionCursor {
+  public:
+    StatementChainCursor(ConditionPoolPtr pool, StatementAst *statement,
+            ChainDirection direction);
+
+    bool next(ConditionPtr& condition);
+
+  private:
+    ConditionPoolPtr    _pool;
+    StatementAst        *_current;
+    ChainDirection      _direction;
+};
+
+/*
+ * Walks the statements nested in a statement, depth first, one at a 
+ * time; nothing for a statement that is not a container.
+ */
+class DescendantCursor : public ConditionCursor {
+  public:
+    DescendantCursor(ConditionPoolPtr pool, StatementAst *statement);
+
+    bool next(ConditionPtr& condition);
+
+  private:
+    void push_children(StatementAst *statement);
+
+    ConditionPoolPtr    _pool;
+
+    // the statement lists still to be walked, by their next statement
+    std::vector<StatementAst*> _pending;
+};
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,373 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <set>
+#include "impl/evaluator.h"
+#include "impl/batch_planner.h"
+#include "impl/generic_join.h"
+#include "impl/linker.h"
+#include "impl/processor.h"
+#include "impl/result_cache.h"
+#include "impl/tuple_stream.h"
+#include "simple/util/query_utils.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+using namespace simple::util;
+
+QueryEvaluator::QueryEvaluator(PredicatePtr wildcard_pred, ThreadPoolPtr pool) :
+    _wildcard_pred(wildcard_pred), _pool(pool), _profiling(false),
+    _solver_names(), _cache(), _planner(), _generation(0)
+{ }
+
+void QueryEvaluator::set_profiling(bool enabled) {
+    _profiling = enabled;
+}
+
+void QueryEvaluator::set_solver_names(const SolverTable& solvers) {
+    for(SolverTable::const_iterator it = solvers.begin(); 
+            it != solvers.end(); ++it)
+    {
+        _solver_names[it->second.get()] = it->first;
+    }
+}
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+            Clock::now() - start).count();
+}
+
+/*
+ * Current domain size of a qvar without initializing it in the linker.
+ */
+static size_t domain_size(SimpleQueryLinker *linker, 
+        QueryProcessor *processor, const std::string& qvar)
+{
+    if(linker->is_initialized(qvar)) {
+        return linker->get_conditions(qvar).get_size();
+    } else {
+        return processor->get_predicate(qvar)->global_set().get_size();
+    }
+}
+
+/*
+ * The linker work done while solving a clause.
+ */
+static void count_linker_work(ClauseProfile& clause_profile,
+        const LinkerStats& before, const LinkerStats& after)
+{
+    clause_profile.links_created = after.links_created - before.links_created;
+    clause_profile.conditions_removed = 
+        after.conditions_removed - before.conditions_removed;
+    clause_profile.conditions_cascaded = 
+        after.conditions_cascaded - before.conditions_cascaded;
+}
+
+/*
+ * The join is reported as a single clause over all of its qvars.
+ */
+static void solve_join_profiled(SimpleQueryLinker *linker, 
+        QueryProcessor& processor, const std::vector<PqlClause*>& clauses,
+        QueryProfile *profile)
+{
+    ClauseProfile clause_profile;
+    clause_profile.solver = "generic_join";
+    clause_profile.form = "Join(qvar, ...)";
+
+    std::set<std::string> qvars;
+    for(std::vector<PqlClause*>::const_iterator it = clauses.begin();
+            it != clauses.end(); ++it)
+    {
+        std::vector<std::string> clause_vars = clause_qvars(*it);
+        qvars.insert(clause_vars.begin(), clause_vars.end());
+    }
+
+    for(std::set<std::string>::iterator it = qvars.begin(); 
+            it != qvars.end(); ++it)
+    {
+        clause_profile.domains.push_back(DomainProfile(*it,
+                    domain_size(linker, &processor, *it)));
+    }
+
+    LinkerStats stats_before = linker->get_stats();
+    Clock::time_point start = Clock::now();
+
+    processor.solve_join(clauses);
+
+    clause_profile.wall_time_ms = elapsed_ms(start);
+    count_linker_work(clause_profile, stats_before, linker->get_stats());
+
+    for(std::vector<DomainProfile>::iterator it = 
+            clause_profile.domains.begin(); 
+            it != clause_profile.domains.end(); ++it)
+    {
+        it->size_after = domain_size(linker, &processor, it->qvar);
+    }
+
+    profile->add_clause(clause_profile);
+}
+
+void QueryEvaluator::set_result_cache(std::shared_ptr<QueryResultCache> cache,
+        size_t generation)
+{
+    _cache = cache;
+    _generation = generation;
+}
+
+void QueryEvaluator::set_batch_planner(std::shared_ptr<BatchPlanner> planner) {
+    _planner = planner;
+}
+
+/*
+ * A synonym that is not selected and appears in a single clause only 
+ * affects whether the query has a result at all, so that clause can stop
+ * at the first condition it finds for it.
+ */
+static void mark_existential_qvars(PqlQuerySet& query, 
+        QueryProcessor& processor)
+{
+    std::set<QVarSlot> selected;
+    PqlSelector *selector = query.selector.get();
+
+    if(is_selector<PqlSingleVarSelector>(selector)) {
+        selected.insert(processor.get_slot(
+                    selector_cast<PqlSingleVarSelector>(selector)
+                    ->get_qvar_name()));
+    } else if(is_selector<PqlTupleSelector>(selector)) {
+        std::vector<std::string> qvars = 
+            selector_cast<PqlTupleSelector>(selector)->get_tuples();
+        for(size_t i = 0; i < qvars.size(); ++i) {
+            selected.insert(processor.get_slot(qvars[i]));
+        }
+    }
+
+    std::map<QVarSlot, size_t> uses;
+    for(ClauseSet::iterator it = query.clauses.begin();
+            it != query.clauses.end(); ++it)
+    {
+        PqlVariableTerm *left = 
+            dynamic_cast<PqlVariableTerm*>((*it)->get_left_term());
+        PqlVariableTerm *right = 
+            dynamic_cast<PqlVariableTerm*>((*it)->get_right_term());
+
+        if(left != NULL) {
+            ++uses[processor.get_slot(left)];
+        }
+        if(right != NULL && (left == NULL || 
+                    processor.get_slot(right) != processor.get_slot(left)))
+        {
+            ++uses[processor.get_slot(right)];
+        }
+    }
+
+    for(std::map<QVarSlot, size_t>::iterator it = uses.begin();
+            it != uses.end(); ++it)
+    {
+        if(it->second == 1 && selected.count(it->first) == 0) {
+            processor.set_existential(it->first);
+        }
+    }
+}
+
+QueryResult QueryEvaluator::evaluate(PqlQuerySet& query) {
+    return evaluate(query, (CancellationToken*) NULL);
+}
+
+QueryResult QueryEvaluator::evaluate(PqlQuerySet& query, long timeout_ms) {
+    CancellationToken token(timeout_ms);
+    return evaluate(query, &token);
+}
+
+QueryResult QueryEvaluator::evaluate(PqlQuerySet& query, 
+        CancellationToken *token)
+{
+    return evaluate(query, (TupleWriter*) NULL, token);
+}
+
+QueryResult QueryEvaluator::evaluate(PqlQuerySet& query, 
+        TupleWriter *writer, CancellationToken *token)
+{
+    CancellationScope scope(token);
+    QueryResult result;
+
+    // streamed rows and profiles are particular to one evaluation
+    std::string cache_key;
+    if(_cache && writer == NULL && !_profiling) {
+        cache_key = canonical_query(query, _solver_names);
+
+        if(!cache_key.empty() && 
+                _cache->lookup(_generation, cache_key, result)) 
+        {
+            return result;
+        }
+    }
+
+    std::unique_ptr<QueryProfile> profile(
+            _profiling ? new QueryProfile() : NULL);
+    Clock::time_point start = Clock::now();
+
+    try {
+        solve_query(query, result, writer, profile.get());
+    } catch(QueryTimeoutError& e) {
+        // drop whatever partial result has been collected
+        result = QueryResult();
+        result.status = QUERY_TIMEOUT;
+    }
+
+    if(profile) {
+        profile->set_total_time(elapsed_ms(start));
+        profile->set_timed_out(result.status == QUERY_TIMEOUT);
+        result.profile = profile->to_json();
+    }
+
+    if(!cache_key.empty() && result.status == QUERY_OK) {
+        _cache->insert(_generation, cache_key, result);
+    }
+
+    return result;
+}
+
+void QueryEvaluator::solve_query(PqlQuerySet& query, QueryResult& result,
+        TupleWriter *writer, QueryProfile *profile)
+{
+    if(query.is_unsatisfiable) {
+        return;
+    }
+
+    std::shared_ptr<SimpleQueryLinker> linker(
+            new SimpleQueryLinker(query.qvar_names.size()));
+    QueryProcessor processor(linker, query.predicates, _wildcard_pred, _pool,
+            query.qvar_names);
+    mark_existential_qvars(query, processor);
+
+    // clauses in a cycle of query variables are joined at the end, 
+    // over the domains left by all the other clauses
+    std::vector<PqlClause*> join_clauses;
+    std::vector<PqlClause*> clauses;
+    split_cyclic_clauses(query.clauses, join_clauses, clauses);
+
+    for(std::vector<PqlClause*>::iterator it = clauses.begin();
+            it != clauses.end(); ++it)
+    {
+        check_cancellation();
+
+        if(profile == NULL) {
+            if(!_planner || !_planner->apply_clause(query, *it, processor)) {
+                processor.solve_clause(*it);
+            }
+        } else {
+            PqlClause *clause = *it;
+            ClauseProfile clause_profile;
+
+            if(_solver_names.count(clause->get_solver()) > 0) {
+                clause_profile.solver = _solver_names[clause->get_solver()];
+            }
+            clause_profile.form = clause_form(clause);
+            clause_profile.left_term = term_to_string(clause->get_left_term());
+            clause_profile.right_term = term_to_string(clause->get_right_term());
+
+            std::vector<std::string> qvars = clause_qvars(clause);
+            for(std::vector<std::string>::iterator qit = qvars.begin();
+                    qit != qvars.end(); ++qit)
+            {
+                clause_profile.domains.push_back(DomainProfile(*qit,
+                            domain_size(linker.get(), &processor, *qit)));
+            }
+
+            LinkerStats stats_before = linker->get_stats();
+            CountingSolver solver(clause->get_solver());
+            Clock::time_point start = Clock::now();
+
+            if(_planner && _planner->apply_clause(query, clause, processor)) {
+                clause_profile.batched = true;
+            } else {
+                processor.solve_clause(clause, &solver);
+            }
+
+            clause_profile.wall_time_ms = elapsed_ms(start);
+            clause_profile.validate_calls = solver.get_validate_count();
+            clause_profile.solve_left_calls = solver.get_solve_left_count();
+            clause_profile.solve_right_calls = solver.get_solve_right_count();
+            clause_profile.probe_calls = solver.get_probe_count();
+            count_linker_work(clause_profile, stats_before, 
+                    linker->get_stats());
+
+            for(std::vector<DomainProfile>::iterator dit = 
+                    clause_profile.domains.begin();
+                    dit != clause_profile.domains.end(); ++dit)
+            {
+                dit->size_after = domain_size(linker.get(), &processor, dit->qvar);
+            }
+
+            profile->add_clause(clause_profile);
+        }
+
+        if(!linker->is_valid_state()) {
+            return;
+        }
+    }
+
+    if(!join_clauses.empty()) {
+        check_cancellation();
+
+        if(profile == NULL) {
+            processor.solve_join(join_clauses);
+        } else {
+            solve_join_profiled(linker.get(), processor, join_clauses, profile);
+        }
+
+        if(!linker->is_valid_state()) {
+            return;
+        }
+    }
+
+    PqlSelector *selector = query.selector.get();
+
+    if(is_selector<PqlBooleanSelector>(selector)) {
+        result.is_true = true;
+    } else if(is_selector<PqlSingleVarSelector>(selector)) {
+        result.conditions = processor.get_qvar(
+                selector_cast<PqlSingleVarSelector>(selector)->get_qvar_name());
+        result.is_true = !result.conditions.is_empty();
+    } else if(is_selector<PqlTupleSelector>(selector)) {
+        std::vector<std::string> qvars = 
+            selector_cast<PqlTupleSelector>(selector)->get_tuples();
+
+        // make sure every selected qvar is initialized in the linker
+        for(std::vector<std::string>::iterator qit = qvars.begin();
+                qit != qvars.end(); ++qit)
+        {
+            processor.get_qvar(*qit);
+        }
+
+        TupleListWriter list_writer(result.tuples);
+        TupleProducer producer(linker.get(), qvars);
+
+        result.tuple_count = producer.produce(
+                writer != NULL ? writer : &list_writer);
+        result.is_true = result.tuple_count > 0;
+    }
+}
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,162 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include "simple/query.h"
+#include "simple/solver.h"
+#include "simple/tuple.h"
+#include "simple/predicate.h"
+#include "simple/condition_set.h"
+#include "impl/thread_pool.h"
+#include "impl/cancellation.h"
+#include "impl/profiler.h"
+#include "impl/tuple_stream.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+class BatchPlanner;
+class QueryResultCache;
+
+enum QueryStatus {
+    QUERY_OK,
+    QUERY_TIMEOUT
+};
+
+struct QueryResult {
+  public:
+    QueryResult() : 
+        status(QUERY_OK), is_true(false), conditions(), tuples(), 
+        tuple_count(0), profile()
+    { }
+
+    QueryStatus     status;
+
+    /*
+     * The answer of a BOOLEAN query. For the other selectors this tells
+     * whether the result is non-empty. Always false on timeout.
+     */
+    bool            is_true;
+
+    // Result of a single variable selector
+    ConditionSet    conditions;
+
+    // Result of a tuple selector, empty if the rows were streamed to a
+    // TupleWriter instead
+    TupleList       tuples;
+
+    // Number of rows of a tuple selector
+    size_t          tuple_count;
+
+    // JSON execution profile, only filled in when profiling is enabled
+    std::string     profile;
+};
+
+/*
+ * Evaluate a parsed PqlQuerySet from start to end: solve all clauses
+ * with a fresh linker and extract the selected result.
+ *
+ * Two variable clauses whose query variables form a cycle are solved
+ * last, together, with a worst case optimal GenericJoin; all other 
+ * clauses are solved one at a time through the linker.
+ *
+ * Synonyms that are not selected and appear in a single clause are only
+ * solved until a first condition is found for them.
+ *
+ * A query flagged as unsatisfiable, e.g. by the QueryRewriter, gets an
+ * empty or FALSE result without solving any clause.
+ *
+ * The evaluation can be bounded by a timeout or an external cancellation
+ * token. When the token fires, evaluation is abandoned at the next check
+ * point and a result with status QUERY_TIMEOUT is returned. The linker
+ * and all intermediate results are owned by the evaluate() call, so they
+ * are released as soon as it returns.
+ *
+ * With profiling enabled, every clause is timed and its solver calls,
+ * qvar domain sizes and linker work are recorded into a JSON profile
+ * attached to the result.
+ *
+ * With a result cache set, the results of queries evaluated without a
+ * tuple writer or profiling are looked up by their canonical form first,
+ * and completed results are stored back into the cache.
+ *
+ * With a batch planner set, the clauses that the queries of the batch
+ * share are solved once by the planner and reused by every query.
+ */
+class QueryEvaluator {
+  public:
+    QueryEvaluator(PredicatePtr wildcard_pred, 
+            ThreadPoolPtr pool = ThreadPoolPtr());
+
+    QueryResult evaluate(PqlQuerySet& query);
+
+    QueryResult evaluate(PqlQuerySet& query, long timeout_ms);
+
+    QueryResult evaluate(PqlQuerySet& query, CancellationToken *token);
+
+    /*
+     * Evaluate the query and write the rows of a tuple selector to the 
+     * writer as they are produced, instead of collecting them in the
+     * result. On timeout, the rows already written stay written.
+     */
+    QueryResult evaluate(PqlQuerySet& query, TupleWriter *writer,
+            CancellationToken *token = NULL);
+
+    void set_profiling(bool enabled);
+
+    /*
+     * Solver names to report in the profile. Solvers that are not in 
+     * the table are reported without a name.
+     */
+    void set_solver_names(const SolverTable& solvers);
+
+    /*
+     * Share results through the cache, for queries on the program of the
+     * given generation. The solver names have to be set for the queries
+     * to be identified by their relations.
+     */
+    void set_result_cache(std::shared_ptr<QueryResultCache> cache,
+            size_t generation);
+
+    /*
+     * Take the clauses shared with the other queries of a batch from the
+     * planner, which has planned the batch of the evaluated queries.
+     */
+    void set_batch_planner(std::shared_ptr<BatchPlanner> planner);
+
+  private:
+    void solve_query(PqlQuerySet& query, QueryResult& result, 
+            TupleWriter *writer, QueryProfile *profile);
+
+    PredicatePtr    _wildcard_pred;
+    ThreadPoolPtr   _pool;
+    bool            _profiling;
+    std::map<QuerySolver*, std::string> _solver_names;
+    std::shared_ptr<QueryResultCache>   _cache;
+    std::shared_ptr<BatchPlanner>       _planner;
+    size_t          _generation;
+};
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,135 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <functional>
+#include "impl/ast.h"
+#include "impl/expr_store.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+static std::atomic<unsigned long long> next_store_id(1);
+
+ExprStore::ExprStore() :
+    _store_id(next_store_id++), _next_node(1),
+    _variables(), _constants(), _binary_ops()
+{ }
+
+ExprPtr ExprStore::make_variable(const SimpleVariable& var) {
+    SimpleVariable name(var);
+    ExprPtr& node = _variables[name.get_name()];
+
+    if(!node) {
+        node.reset(new SimpleVariableAst(var, next_id()));
+    }
+    return node;
+}
+
+ExprPtr ExprStore::make_const(int value) {
+    ExprPtr& node = _constants[value];
+
+    if(!node) {
+        node.reset(new SimpleConstAst(value, next_id()));
+    }
+    return node;
+}
+
+ExprPtr ExprStore::make_binary_op(char op, ExprPtr lhs, ExprPtr rhs) {
+    // operands that are not nodes of this store are interned first
+    if(!is_own_node(lhs.get())) {
+        lhs = intern(lhs.get());
+    }
+    if(!is_own_node(rhs.get())) {
+        rhs = intern(rhs.get());
+    }
+
+    ExprPtr& node = _binary_ops[BinaryOpKey(op, lhs->get_id(), rhs->get_id())];
+
+    if(!node) {
+        node.reset(new SimpleBinaryOpAst(op, lhs, rhs, next_id()));
+    }
+    return node;
+}
+
+/*
+ * Rebuilds an expression bottom up through the store.
+ */
+class InternExprVisitor : public ExprVisitor {
+  public:
+    InternExprVisitor(ExprStore *store) : _store(store), _result() { }
+
+    void visit_const(ConstAst *constant) {
+        _result = _store->make_const(constant->get_constant()->get_int());
+    }
+
+    void visit_variable(VariableAst *var) {
+        _result = _store->make_variable(*var->get_variable());
+    }
+
+    void visit_binary_op(BinaryOpAst *bin) {
+        bin->get_lhs()->accept_expr_visitor(this);
+        ExprPtr lhs = _result;
+
+        bin->get_rhs()->accept_expr_visitor(this);
+        ExprPtr rhs = _result;
+
+        _result = _store->make_binary_op(bin->get_op(), lhs, rhs);
+    }
+
+    ExprPtr return_result() {
+        return _result;
+    }
+
+  private:
+    ExprStore   *_store;
+    ExprPtr     _result;
+};
+
+ExprPtr ExprStore::intern(ExprAst *expr) {
+    InternExprVisitor visitor(this);
+    expr->accept_expr_visitor(&visitor);
+    return visitor.return_result();
+}
+
+size_t ExprStore::get_size() const {
+    return _variables.size() + _constants.size() + _binary_ops.size();
+}
+
+bool ExprStore::is_own_node(ExprAst *expr) {
+    unsigned long long id = expr->get_id();
+    return id != 0 && (id >> 32) == _store_id;
+}
+
+unsigned long long ExprStore::next_id() {
+    return (_store_id << 32) | _next_node++;
+}
+
+size_t ExprStore::BinaryOpKeyHash::operator ()(const BinaryOpKey& key) const {
+    std::hash<unsigned long long> hasher;
+
+    size_t seed = key.op;
+    seed ^= hasher(key.lhs) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= hasher(key.rhs) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+} // namespace impl
+} // namespace simple
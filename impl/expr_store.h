@@ -0,0 +1,99 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include "simple/ast.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * Hash-consing store for expression nodes.
+ *
+ * Every node created through the store is looked up by its structure
+ * first: a variable by name, a constant by value and a binary operation 
+ * by its operator and the ids of its (already interned) operands. Two
+ * structurally identical subtrees are therefore always the very same 
+ * shared node, no matter how many assignments contain them, and 
+ * comparing two interned expressions is an id compare.
+ *
+ * Ids are stable for the lifetime of the store. The upper half of an id
+ * identifies the store and the lower half the node, so ids of different
+ * stores never collide. Interned nodes are shared and must not be
+ * modified. The store is not thread safe; it is meant to be filled while
+ * a program is parsed.
+ */
+class ExprStore {
+  public:
+    ExprStore();
+
+    ExprPtr make_variable(const SimpleVariable& var);
+
+    ExprPtr make_const(int value);
+
+    ExprPtr make_binary_op(char op, ExprPtr lhs, ExprPtr rhs);
+
+    /*
+     * Intern a copy of an expression tree built outside the store. The
+     * given tree is left untouched.
+     */
+    ExprPtr intern(ExprAst *expr);
+
+    /*
+     * Number of distinct nodes in the store.
+     */
+    size_t get_size() const;
+
+  private:
+    struct BinaryOpKey {
+        BinaryOpKey(char op, unsigned long long lhs, unsigned long long rhs) :
+            op(op), lhs(lhs), rhs(rhs)
+        { }
+
+        bool operator ==(const BinaryOpKey& other) const {
+            return op == other.op && lhs == other.lhs && rhs == other.rhs;
+        }
+
+        char                op;
+        unsigned long long  lhs;
+        unsigned long long  rhs;
+    };
+
+    struct BinaryOpKeyHash {
+        size_t operator ()(const BinaryOpKey& key) const;
+    };
+
+    bool is_own_node(ExprAst *expr);
+    unsigned long long next_id();
+
+    unsigned long long  _store_id;
+    unsigned long long  _next_node;
+
+    std::unordered_map<std::string, ExprPtr>    _variables;
+    std::unordered_map<int, ExprPtr>            _constants;
+    std::unordered_map<BinaryOpKey, ExprPtr, BinaryOpKeyHash> _binary_ops;
+};
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,106 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+#include "simple/ast.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * Collects the statements of a procedure in program order, remembering
+ * which of them are assignments, calls and if statements.
+ */
+class FlowStatementCollector : public StatementVisitor {
+  public:
+    FlowStatementCollector() : 
+        statements(), assignments(), calls(), conditionals()
+    { }
+
+    void collect(StatementAst *statement) {
+        while(statement != NULL) {
+            statements.push_back(statement);
+            assignments.push_back(NULL);
+            calls.push_back(NULL);
+            conditionals.push_back(false);
+
+            statement->accept_statement_visitor(this);
+            statement = statement->next();
+        }
+    }
+
+    void visit_assignment(AssignmentAst *assign) {
+        assignments[find_last(assign)] = assign;
+    }
+
+    void visit_call(CallAst *call) {
+        calls[find_last(call)] = call;
+    }
+
+    void visit_conditional(ConditionalAst *condition) {
+        conditionals[find_last(condition)] = true;
+        collect(condition->get_then_branch());
+        collect(condition->get_else_branch());
+    }
+
+    void visit_while(WhileAst *loop) {
+        collect(loop->get_body());
+    }
+
+    std::vector<StatementAst*>  statements;
+    std::vector<AssignmentAst*> assignments;
+    std::vector<CallAst*>       calls;
+    std::vector<bool>           conditionals;
+
+  private:
+    size_t find_last(StatementAst *statement) {
+        size_t i = statements.size();
+        while(statements[--i] != statement) { }
+        return i;
+    }
+};
+
+/*
+ * Collects the names of the variables used in an expression.
+ */
+class UsedVariableCollector : public ExprVisitor {
+  public:
+    UsedVariableCollector() : variables() { }
+
+    void visit_const(ConstAst *constant) { }
+
+    void visit_variable(VariableAst *var) {
+        variables.insert(var->get_variable()->get_name());
+    }
+
+    void visit_binary_op(BinaryOpAst *bin) {
+        bin->get_lhs()->accept_expr_visitor(this);
+        bin->get_rhs()->accept_expr_visitor(this);
+    }
+
+    std::set<std::string> variables;
+};
+
+} // namespace impl
+} // namespace simple
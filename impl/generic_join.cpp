@@ -0,0 +1,375 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include "impl/generic_join.h"
+#include "impl/cancellation.h"
+#include "impl/profiler.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+GenericJoin::GenericJoin(const std::vector<ConditionSet>& domains,
+        const std::vector<JoinRelation>& relations) :
+    _domains(domains.size()), _relations(relations), 
+    _indexes(relations.size()), _order(), _constraints(), _candidates(), 
+    _bound(domains.size(), 0), _used_ids(domains.size()), _count(0)
+{
+    // ids are positions in the sorted domains
+    for(size_t i = 0; i < domains.size(); ++i) {
+        _domains[i].assign(domains[i].begin(), domains[i].end());
+        _used_ids[i].resize(_domains[i].size(), false);
+    }
+
+    for(size_t i = 0; i < _relations.size(); ++i) {
+        build_index(i);
+    }
+
+    choose_order();
+}
+
+size_t GenericJoin::run() {
+    if(!_order.empty()) {
+        join_level(0);
+    }
+    return _count;
+}
+
+void GenericJoin::get_links(size_t relation, 
+        std::vector<ConditionPair>& links) const
+{
+    const JoinRelation& join_relation = _relations[relation];
+    const RelationIndex& index = _indexes[relation];
+
+    for(size_t left = 0; left < index.forward.size(); ++left) {
+        const IdList& rights = index.forward[left];
+
+        for(size_t i = 0; i < rights.size(); ++i) {
+            if(index.used[left][i]) {
+                links.push_back(ConditionPair(
+                            _domains[join_relation.left][left],
+                            _domains[join_relation.right][rights[i]]));
+            }
+        }
+    }
+}
+
+ConditionSet GenericJoin::get_domain(size_t variable) const {
+    ConditionSet result;
+    for(size_t id = 0; id < _domains[variable].size(); ++id) {
+        if(_used_ids[variable][id]) {
+            result.insert(_domains[variable][id]);
+        }
+    }
+    return result;
+}
+
+const std::vector<size_t>& GenericJoin::get_order() const {
+    return _order;
+}
+
+/*
+ * Only one direction is solved, from the smaller domain, and the other
+ * direction is its transpose. The solver results are sorted the same way
+ * as the domains, so the lists come out sorted.
+ */
+void GenericJoin::build_index(size_t relation) {
+    const JoinRelation& join_relation = _relations[relation];
+    RelationIndex& index = _indexes[relation];
+
+    size_t left_size = _domains[join_relation.left].size();
+    size_t right_size = _domains[join_relation.right].size();
+
+    index.forward.resize(left_size);
+    index.backward.resize(right_size);
+
+    bool forward = left_size <= right_size;
+    size_t from = forward ? join_relation.left : join_relation.right;
+    size_t to = forward ? join_relation.right : join_relation.left;
+    std::vector<IdList>& lists = forward ? index.forward : index.backward;
+    std::vector<IdList>& transpose = forward ? index.backward : index.forward;
+
+    for(size_t id = 0; id < _domains[from].size(); ++id) {
+        check_cancellation();
+
+        SimpleCondition *condition = _domains[from][id].get();
+        ConditionSet result = forward ? 
+            join_relation.solver->solve_right(condition) :
+            join_relation.solver->solve_left(condition);
+
+        for(ConditionSet::iterator it = result.begin(); it != result.end(); ++it) {
+            ConditionId other;
+            if(find_id(to, *it, other)) {
+                lists[id].push_back(other);
+                transpose[other].push_back(id);
+            }
+        }
+    }
+
+    index.used.resize(left_size);
+    for(size_t id = 0; id < left_size; ++id) {
+        index.used[id].resize(index.forward[id].size(), false);
+    }
+}
+
+void GenericJoin::choose_order() {
+    size_t num_variables = _domains.size();
+    std::vector<bool> chosen(num_variables, false);
+
+    while(_order.size() < num_variables) {
+        size_t best = num_variables;
+        size_t best_links = 0;
+
+        for(size_t variable = 0; variable < num_variables; ++variable) {
+            if(chosen[variable]) {
+                continue;
+            }
+
+            size_t links = 0;
+            for(size_t r = 0; r < _relations.size(); ++r) {
+                if((_relations[r].left == variable && chosen[_relations[r].right]) ||
+                        (_relations[r].right == variable && chosen[_relations[r].left]))
+                {
+                    ++links;
+                }
+            }
+
+            if(best == num_variables || links > best_links ||
+                    (links == best_links && 
+                     _domains[variable].size() < _domains[best].size()))
+            {
+                best = variable;
+                best_links = links;
+            }
+        }
+
+        std::vector<Constraint> constraints;
+        for(size_t r = 0; r < _relations.size(); ++r) {
+            if(_relations[r].left == best && chosen[_relations[r].right]) {
+                constraints.push_back(Constraint(r, false));
+            } else if(_relations[r].right == best && chosen[_relations[r].left]) {
+                constraints.push_back(Constraint(r, true));
+            }
+        }
+
+        chosen[best] = true;
+        _order.push_back(best);
+        _constraints.push_back(constraints);
+    }
+
+    _candidates.resize(num_variables);
+}
+
+void GenericJoin::join_level(size_t level) {
+    size_t variable = _order[level];
+    const std::vector<Constraint>& constraints = _constraints[level];
+    IdList& candidates = _candidates[level];
+
+    if(constraints.empty()) {
+        candidates.clear();
+        for(size_t id = 0; id < _domains[variable].size(); ++id) {
+            candidates.push_back(id);
+        }
+    } else {
+        std::vector<const IdList*> lists;
+        for(std::vector<Constraint>::const_iterator it = constraints.begin();
+                it != constraints.end(); ++it)
+        {
+            const JoinRelation& relation = _relations[it->first];
+            const RelationIndex& index = _indexes[it->first];
+
+            if(it->second) {
+                lists.push_back(&index.forward[_bound[relation.left]]);
+            } else {
+                lists.push_back(&index.backward[_bound[relation.right]]);
+            }
+        }
+
+        leapfrog_intersect(lists, candidates);
+    }
+
+    for(size_t i = 0; i < candidates.size(); ++i) {
+        check_cancellation();
+
+        _bound[variable] = candidates[i];
+        if(level + 1 == _order.size()) {
+            record();
+        } else {
+            join_level(level + 1);
+        }
+    }
+}
+
+void GenericJoin::record() {
+    ++_count;
+
+    for(size_t variable = 0; variable < _bound.size(); ++variable) {
+        _used_ids[variable][_bound[variable]] = true;
+    }
+
+    for(size_t r = 0; r < _relations.size(); ++r) {
+        ConditionId left = _bound[_relations[r].left];
+        const IdList& rights = _indexes[r].forward[left];
+
+        size_t position = std::lower_bound(rights.begin(), rights.end(), 
+                _bound[_relations[r].right]) - rights.begin();
+        _indexes[r].used[left][position] = true;
+    }
+}
+
+bool GenericJoin::find_id(size_t variable, const ConditionPtr& condition,
+        ConditionId& id) const
+{
+    const std::vector<ConditionPtr>& domain = _domains[variable];
+    std::vector<ConditionPtr>::const_iterator it = 
+        std::lower_bound(domain.begin(), domain.end(), condition);
+
+    if(it == domain.end() || !(*it == condition)) {
+        return false;
+    }
+
+    id = it - domain.begin();
+    return true;
+}
+
+void leapfrog_intersect(const std::vector<const std::vector<unsigned int>*>& lists,
+        std::vector<unsigned int>& result)
+{
+    result.clear();
+
+    for(size_t i = 0; i < lists.size(); ++i) {
+        if(lists[i]->empty()) {
+            return;
+        }
+    }
+
+    if(lists.size() == 1) {
+        result = *lists[0];
+        return;
+    }
+
+    std::vector<size_t> positions(lists.size(), 0);
+    unsigned int target = (*lists[0])[0];
+
+    // the number of lists in a row that are at the target
+    size_t matched = 1;
+    size_t current = 1;
+
+    while(true) {
+        const std::vector<unsigned int>& list = *lists[current];
+        size_t& position = positions[current];
+
+        position = std::lower_bound(list.begin() + position, list.end(), 
+                target) - list.begin();
+        if(position == list.size()) {
+            return;
+        }
+
+        if(list[position] == target) {
+            ++matched;
+        } else {
+            target = list[position];
+            matched = 1;
+        }
+
+        if(matched == lists.size()) {
+            result.push_back(target);
+
+            if(++position == list.size()) {
+                return;
+            }
+            target = list[position];
+            matched = 1;
+        }
+
+        current = (current + 1) % lists.size();
+    }
+}
+
+static size_t find_root(std::vector<size_t>& parents, size_t node) {
+    while(parents[node] != node) {
+        parents[node] = parents[parents[node]];
+        node = parents[node];
+    }
+    return node;
+}
+
+void split_cyclic_clauses(const ClauseSet& clauses, 
+        std::vector<PqlClause*>& join_clauses,
+        std::vector<PqlClause*>& other_clauses)
+{
+    std::map<std::string, size_t> ids;
+    std::vector<size_t> parents;
+    std::set<std::pair<size_t, size_t> > edges;
+    std::map<PqlClause*, size_t> clause_nodes;
+
+    for(ClauseSet::const_iterator it = clauses.begin(); it != clauses.end(); ++it) {
+        std::vector<std::string> qvars = clause_qvars(it->get());
+        if(qvars.size() != 2) {
+            continue;
+        }
+
+        size_t nodes[2];
+        for(size_t i = 0; i < 2; ++i) {
+            if(ids.count(qvars[i]) == 0) {
+                ids[qvars[i]] = parents.size();
+                parents.push_back(parents.size());
+            }
+            nodes[i] = ids[qvars[i]];
+        }
+
+        edges.insert(std::make_pair(std::min(nodes[0], nodes[1]), 
+                    std::max(nodes[0], nodes[1])));
+        parents[find_root(parents, nodes[0])] = find_root(parents, nodes[1]);
+        clause_nodes[it->get()] = nodes[0];
+    }
+
+    std::vector<size_t> num_nodes(parents.size(), 0);
+    std::vector<size_t> num_edges(parents.size(), 0);
+
+    for(size_t node = 0; node < parents.size(); ++node) {
+        ++num_nodes[find_root(parents, node)];
+    }
+    for(std::set<std::pair<size_t, size_t> >::iterator it = edges.begin();
+            it != edges.end(); ++it)
+    {
+        ++num_edges[find_root(parents, it->first)];
+    }
+
+    for(ClauseSet::const_iterator it = clauses.begin(); it != clauses.end(); ++it) {
+        std::map<PqlClause*, size_t>::iterator node = clause_nodes.find(it->get());
+
+        if(node != clause_nodes.end()) {
+            size_t root = find_root(parents, node->second);
+            if(num_edges[root] >= num_nodes[root]) {
+                join_clauses.push_back(it->get());
+                continue;
+            }
+        }
+
+        other_clauses.push_back(it->get());
+    }
+}
+
+} // namespace impl
+} // namespace simple
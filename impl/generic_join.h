@@ -0,0 +1,148 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include "simple/condition_set.h"
+#include "simple/query.h"
+#include "simple/solver.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * A two variable clause of a multi-way join, relating the variables at
+ * two positions of the join.
+ */
+struct JoinRelation {
+  public:
+    JoinRelation(QuerySolver *solver, size_t left, size_t right) :
+        solver(solver), left(left), right(right)
+    { }
+
+    QuerySolver *solver;
+    size_t      left;
+    size_t      right;
+};
+
+/*
+ * A worst case optimal multi-way join (generic join), for clauses whose
+ * query variables form a cycle, e.g. 
+ *
+ * Follows*(a, b) and Parent*(w, a) and Parent*(w, b)
+ *
+ * Solving such clauses pairwise materializes every pair of every clause
+ * and then prunes them through the linker, while most of the pairs may
+ * not be part of any answer.
+ *
+ * Instead, every relation is indexed once as sorted lists of condition
+ * ids in both directions, and the join binds one variable at a time. The
+ * candidates of a variable are the leapfrog intersection of the lists 
+ * of all the relations between it and the variables bound before it, 
+ * so that no partial assignment is ever extended that some relation 
+ * already rules out.
+ *
+ * The result is the set of pairs of each relation, and the conditions of
+ * each variable, that take part in at least one complete assignment.
+ */
+class GenericJoin {
+  public:
+    GenericJoin(const std::vector<ConditionSet>& domains,
+            const std::vector<JoinRelation>& relations);
+
+    /*
+     * Enumerate all assignments, returning how many there are.
+     */
+    size_t run();
+
+    /*
+     * The pairs of a relation that are part of an assignment, in the
+     * order of the relation's left and right variables.
+     */
+    void get_links(size_t relation, std::vector<ConditionPair>& links) const;
+
+    ConditionSet get_domain(size_t variable) const;
+
+    /*
+     * The variables in the order they are bound: the one with the 
+     * smallest domain first, then always the one with the most 
+     * relations to the variables already chosen.
+     */
+    const std::vector<size_t>& get_order() const;
+
+  private:
+    typedef unsigned int ConditionId;
+    typedef std::vector<ConditionId> IdList;
+
+    /*
+     * The pairs of a relation as sorted id lists in both directions, 
+     * and which of the forward entries are part of an assignment.
+     */
+    struct RelationIndex {
+        std::vector<IdList>             forward;
+        std::vector<IdList>             backward;
+        std::vector<std::vector<bool> > used;
+    };
+
+    // a list constraining a variable: the relation and whether the
+    // variable is on its right side
+    typedef std::pair<size_t, bool> Constraint;
+
+    void build_index(size_t relation);
+    void choose_order();
+    void join_level(size_t level);
+    void record();
+    bool find_id(size_t variable, const ConditionPtr& condition, 
+            ConditionId& id) const;
+
+    std::vector<std::vector<ConditionPtr> > _domains;
+    std::vector<JoinRelation>   _relations;
+    std::vector<RelationIndex>  _indexes;
+
+    std::vector<size_t>                     _order;
+    std::vector<std::vector<Constraint> >   _constraints;
+    std::vector<IdList>                     _candidates;
+
+    std::vector<ConditionId>                _bound;
+    std::vector<std::vector<bool> >         _used_ids;
+    size_t                                  _count;
+};
+
+/*
+ * Intersect sorted lists of ids by leapfrogging: the list with the 
+ * smallest current id seeks to the largest current id until all lists
+ * agree.
+ */
+void leapfrog_intersect(const std::vector<const std::vector<unsigned int>*>& lists,
+        std::vector<unsigned int>& result);
+
+/*
+ * Split the clauses into those to be solved by a GenericJoin and the 
+ * rest. The join takes the two variable clauses of every connected 
+ * group of query variables whose clauses form a cycle, i.e. that has at 
+ * least as many distinct variable pairs as variables.
+ */
+void split_cyclic_clauses(const ClauseSet& clauses, 
+        std::vector<PqlClause*>& join_clauses,
+        std::vector<PqlClause*>& other_clauses);
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,304 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include "impl/knowledge_base.h"
+#include "impl/predicate.h"
+#include "impl/parser/parser.h"
+#include "impl/parser/pql_parser.h"
+#include "impl/parser/iterator_tokenizer.h"
+#include "impl/solvers/follows.h"
+#include "impl/solvers/ifollows.h"
+#include "impl/solvers/parent.h"
+#include "impl/solvers/iparent.h"
+#include "impl/solvers/modifies.h"
+#include "impl/solvers/uses.h"
+#include "impl/solvers/call.h"
+#include "impl/solvers/icall.h"
+#include "impl/solvers/next.h"
+#include "impl/solvers/inext.h"
+#include "impl/solvers/affects.h"
+#include "impl/solvers/iaffects.h"
+#include "impl/solvers/next_bip.h"
+#include "impl/solvers/inext_bip.h"
+#include "impl/solvers/affects_bip.h"
+#include "impl/solvers/memoized.h"
+#include "impl/call_graph.h"
+#include "simple/util/solver_generator.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+using namespace simple::parser;
+
+static std::atomic<size_t> next_generation(1);
+
+SimpleKnowledgeBase::SimpleKnowledgeBase(SimpleRoot ast, 
+        const LineTable& line_table, std::shared_ptr<ExprStore> expr_store) :
+    _ast(ast), _line_table(line_table), 
+    _condition_pool(new ConditionPool(ast)), _solver_table(), _pred_table(),
+    _wildcard_pred(new SimpleWildCardPredicate(ast, _condition_pool)),
+    _pattern_index(new PatternIndex(ast)),
+    _attribute_index(new AttributeIndex(ast, _condition_pool)),
+    _expr_store(expr_store),
+    _call_graph(new CallGraph(ast, _condition_pool)),
+    _modifies_solver(new ModifiesSolver(ast, _condition_pool)),
+    _uses_solver(new UsesSolver(ast, _condition_pool)),
+    _statistics(_condition_pool), _memoized_solvers(), _rewriter(), 
+    _generation(next_generation++)
+{ 
+    create_solvers();
+    create_predicates();
+    index_relations();
+
+    _rewriter.reset(new QueryRewriter(
+                QueryRewriter::create_default(_solver_table)));
+}
+
+void SimpleKnowledgeBase::create_solvers() {
+    _solver_table["follows"].reset(
+            new SimpleSolverGenerator<FollowSolver>(new FollowSolver(_ast, _condition_pool)));
+    _solver_table["ifollows"].reset(
+            new LazySolverGenerator<IFollowSolver>(new IFollowSolver(_ast, _condition_pool)));
+    _solver_table["parent"].reset(
+            new SimpleSolverGenerator<ParentSolver>(new ParentSolver(_ast, _condition_pool)));
+    _solver_table["iparent"].reset(
+            new LazySolverGenerator<IParentSolver>(new IParentSolver(_ast, _condition_pool)));
+    _solver_table["modifies"].reset(
+            new SimpleSolverGenerator<ModifiesSolver>(_modifies_solver));
+    _solver_table["uses"].reset(
+            new SimpleSolverGenerator<UsesSolver>(_uses_solver));
+
+    _solver_table["calls"].reset(
+            new SimpleSolverGenerator<CallSolver>(
+                new CallSolver(_ast, _call_graph)));
+    _solver_table["icalls"].reset(
+            new SimpleSolverGenerator<ICallSolver>(
+                new ICallSolver(_ast, _call_graph)));
+
+    _solver_table["next"].reset(
+            new SimpleSolverGenerator<NextSolver>(
+                new NextSolver(_ast, _condition_pool)));
+
+    std::shared_ptr<NextSolver> next_solver(
+            new NextSolver(_ast, _condition_pool));
+    _solver_table["inext"].reset(
+            new SimpleSolverGenerator<INextSolver>(
+                new INextSolver(_ast, next_solver, _condition_pool)));
+
+    std::shared_ptr<AffectsSolver> affects_solver(
+            new AffectsSolver(_ast, next_solver, _modifies_solver, 
+                _condition_pool));
+    _solver_table["affects"].reset(
+            new SimpleSolverGenerator<AffectsSolver>(affects_solver));
+    _solver_table["iaffects"].reset(
+            new SimpleSolverGenerator<IAffectsSolver>(
+                new IAffectsSolver(_ast, affects_solver, _condition_pool)));
+
+    std::shared_ptr<BipGraph> bip_graph(new BipGraph(_ast, next_solver, _call_graph));
+    _solver_table["nextbip"].reset(
+            new SimpleSolverGenerator<NextBipSolver>(
+                new NextBipSolver(_ast, bip_graph, _condition_pool)));
+    _solver_table["inextbip"].reset(
+            new SimpleSolverGenerator<INextBipSolver>(
+                new INextBipSolver(_ast, bip_graph, _condition_pool)));
+
+    std::shared_ptr<AffectsBipSolver> affects_bip_solver(
+            new AffectsBipSolver(_ast, bip_graph, _condition_pool));
+    _solver_table["affectsbip"].reset(
+            new SimpleSolverGenerator<AffectsBipSolver>(affects_bip_solver));
+    _solver_table["iaffectsbip"].reset(
+            new SimpleSolverGenerator<IAffectsSolver>(
+                new IAffectsSolver(_ast, affects_bip_solver, 
+                    _condition_pool)));
+}
+
+/*
+ * Fill in the statistics catalog, counting the relations with an index
+ * right away and leaving the others to be solved when asked for. The 
+ * solve calls of every relation are memoized across queries.
+ */
+void SimpleKnowledgeBase::index_relations() {
+    _statistics.set_relation("follows", 
+            collect_follows_statistics(_line_table, _condition_pool));
+    _statistics.set_relation("parent", 
+            collect_parent_statistics(_line_table, _condition_pool));
+    _statistics.set_relation("modifies", collect_variable_statistics(
+                _modifies_solver->get_var_index(), _condition_pool));
+    _statistics.set_relation("uses", collect_variable_statistics(
+                _uses_solver->get_var_index(), _condition_pool));
+    _statistics.set_relation("calls", 
+            collect_call_statistics(*_call_graph, _condition_pool, false));
+    _statistics.set_relation("icalls", 
+            collect_call_statistics(*_call_graph, _condition_pool, true));
+
+    for(SolverTable::iterator it = _solver_table.begin(); 
+            it != _solver_table.end(); ++it)
+    {
+        // given the solver before it is memoized, so that collecting the
+        // statistics does not fill the memo
+        if(!_statistics.has_relation(it->first)) {
+            _statistics.set_relation_solver(it->first, it->second);
+        }
+
+        std::shared_ptr<MemoizedSolver> memoized(
+                new MemoizedSolver(it->second, _condition_pool));
+        _memoized_solvers[it->first] = memoized;
+        it->second = memoized;
+    }
+
+    for(PredicateTable::iterator it = _pred_table.begin();
+            it != _pred_table.end(); ++it)
+    {
+        _statistics.set_domain_size(it->first, 
+                it->second->global_set().get_size());
+    }
+
+    _statistics.set_call_depth(compute_call_depth(*_call_graph));
+}
+
+void SimpleKnowledgeBase::create_predicates() {
+    _pred_table["procedure"].reset(new SimpleProcPredicate(_ast, _condition_pool));
+    _pred_table["statement"].reset(new SimpleStatementPredicate(_ast, _condition_pool));
+    _pred_table["assignment"].reset(new SimpleAssignmentPredicate(_ast, _condition_pool));
+    _pred_table["while"].reset(new SimpleWhilePredicate(_ast, _condition_pool));
+    _pred_table["conditional"].reset(new SimpleConditionalPredicate(_ast, _condition_pool));
+    _pred_table["call"].reset(new SimpleCallPredicate(_ast, _condition_pool));
+    _pred_table["variable"].reset(new SimpleVariablePredicate(_ast, _condition_pool));
+    _pred_table["constant"].reset(new SimpleConstantPredicate(_ast, _condition_pool));
+}
+
+SimpleRoot SimpleKnowledgeBase::get_ast() {
+    return _ast;
+}
+
+const LineTable& SimpleKnowledgeBase::get_line_table() {
+    return _line_table;
+}
+
+const SolverTable& SimpleKnowledgeBase::get_solver_table() {
+    return _solver_table;
+}
+
+const PredicateTable& SimpleKnowledgeBase::get_predicate_table() {
+    return _pred_table;
+}
+
+PredicatePtr SimpleKnowledgeBase::get_wildcard_predicate() {
+    return _wildcard_pred;
+}
+
+std::shared_ptr<PatternIndex> SimpleKnowledgeBase::get_pattern_index() {
+    return _pattern_index;
+}
+
+std::shared_ptr<AttributeIndex> SimpleKnowledgeBase::get_attribute_index() {
+    return _attribute_index;
+}
+
+ConditionPoolPtr SimpleKnowledgeBase::get_condition_pool() {
+    return _condition_pool;
+}
+
+std::shared_ptr<ExprStore> SimpleKnowledgeBase::get_expr_store() {
+    return _expr_store;
+}
+
+const StatisticsCatalog& SimpleKnowledgeBase::get_statistics() {
+    return _statistics;
+}
+
+std::shared_ptr<MemoizedSolver> 
+SimpleKnowledgeBase::get_memoized_solver(const std::string& name) {
+    std::map<std::string, std::shared_ptr<MemoizedSolver> >::iterator it =
+        _memoized_solvers.find(name);
+
+    if(it != _memoized_solvers.end()) {
+        return it->second;
+    } else {
+        return std::shared_ptr<MemoizedSolver>();
+    }
+}
+
+size_t SimpleKnowledgeBase::get_generation() const {
+    return _generation;
+}
+
+PqlQuerySet SimpleKnowledgeBase::parse_query(const std::string& query) {
+    std::string source = query;
+
+    std::shared_ptr<SimpleTokenizer> tokenizer(
+            new IteratorTokenizer<std::string::iterator>(
+                source.begin(), source.end()));
+
+    SimplePqlParser parser(tokenizer, _ast, _line_table, 
+            _solver_table, _pred_table, _pattern_index, _attribute_index,
+            _condition_pool);
+
+    PqlQuerySet query_set = parser.parse_query();
+
+    // placeholders are only bound by prepared queries
+    if(!parser.get_parameter_kinds().empty()) {
+        throw PqlParserError();
+    }
+
+    _rewriter->rewrite(query_set);
+    return query_set;
+}
+
+std::shared_ptr<PreparedQuery> 
+SimpleKnowledgeBase::prepare_query(const std::string& query) {
+    std::chrono::steady_clock::time_point start = 
+        std::chrono::steady_clock::now();
+    std::string source = query;
+
+    std::shared_ptr<SimpleTokenizer> tokenizer(
+            new IteratorTokenizer<std::string::iterator>(
+                source.begin(), source.end()));
+
+    SimplePqlParser parser(tokenizer, _ast, _line_table, 
+            _solver_table, _pred_table, _pattern_index, _attribute_index,
+            _condition_pool);
+
+    PqlQuerySet query_set = parser.parse_query();
+
+    double elapsed = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+    return std::shared_ptr<PreparedQuery>(new PreparedQuery(query_set,
+                parser.get_parameter_kinds(), _ast, _line_table, 
+                _condition_pool, _rewriter, elapsed));
+}
+
+std::shared_ptr<SimpleKnowledgeBase> 
+create_knowledge_base(const std::string& source) {
+    std::string program = source;
+    std::shared_ptr<ExprStore> expr_store(new ExprStore());
+
+    SimpleParser parser(new IteratorTokenizer<std::string::iterator>(
+                program.begin(), program.end()), expr_store);
+    SimpleRoot ast = parser.parse_program();
+
+    return std::shared_ptr<SimpleKnowledgeBase>(
+            new SimpleKnowledgeBase(ast, parser.get_line_table(), expr_store));
+}
+
+} // namespace impl
+} // namespace simple
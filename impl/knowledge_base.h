@@ -0,0 +1,154 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include "simple/ast.h"
+#include "simple/solver.h"
+#include "simple/predicate.h"
+#include "simple/query.h"
+#include "impl/attribute_index.h"
+#include "impl/call_graph.h"
+#include "impl/condition_pool.h"
+#include "impl/expr_store.h"
+#include "impl/pattern_index.h"
+#include "impl/prepared_query.h"
+#include "impl/rewriter.h"
+#include "impl/statistics.h"
+#include "impl/solvers/memoized.h"
+#include "impl/solvers/modifies.h"
+#include "impl/solvers/uses.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * All the design abstractions of one parsed SIMPLE program: the solvers
+ * keyed by the relation names the PQL parser looks up (with an "i" 
+ * prefix for the transitive closures, e.g. "ifollows" for Follows*),
+ * the predicates keyed by design entity, the line table, the index
+ * of assignment expressions for pattern clauses and the attribute 
+ * index for with clauses. All of them hand out the same canonical
+ * condition object for the same entity.
+ *
+ * The solve calls of the relations are memoized, so that all the 
+ * queries on the program share their answers.
+ */
+class SimpleKnowledgeBase {
+  public:
+    SimpleKnowledgeBase(SimpleRoot ast, const LineTable& line_table,
+            std::shared_ptr<ExprStore> expr_store = 
+                std::shared_ptr<ExprStore>());
+
+    SimpleRoot get_ast();
+
+    const LineTable& get_line_table();
+
+    const SolverTable& get_solver_table();
+
+    const PredicateTable& get_predicate_table();
+
+    PredicatePtr get_wildcard_predicate();
+
+    std::shared_ptr<PatternIndex> get_pattern_index();
+
+    std::shared_ptr<AttributeIndex> get_attribute_index();
+
+    /*
+     * The canonical conditions shared by all solvers, predicates and
+     * indexes of this knowledge base.
+     */
+    ConditionPoolPtr get_condition_pool();
+
+    /*
+     * The store the assignment expressions were hash-consed into, if any.
+     */
+    std::shared_ptr<ExprStore> get_expr_store();
+
+    /*
+     * The sizes of the relations and predicates of the program. The 
+     * relations without an index are solved in full the first time 
+     * their sizes are asked for.
+     */
+    const StatisticsCatalog& get_statistics();
+
+    /*
+     * The memo of the solve calls of a relation, to set its budget or 
+     * turn it off and to read its hit rate. Null for an unknown name.
+     */
+    std::shared_ptr<MemoizedSolver> get_memoized_solver(
+            const std::string& name);
+
+    /*
+     * A number identifying the program of this knowledge base, unique
+     * among all knowledge bases created by the process. Results cached
+     * for one generation are never handed out for another.
+     */
+    size_t get_generation() const;
+
+    /*
+     * Parse a PQL query against this program, and rewrite it with the
+     * relation properties of the solvers. The query set refers to the 
+     * solvers and predicates of the knowledge base, which therefore has
+     * to outlive it.
+     */
+    PqlQuerySet parse_query(const std::string& query);
+
+    /*
+     * Parse a PQL query with '?' placeholders in place of literals once,
+     * to be executed with different values bound to them. The query is
+     * rewritten every time it is bound.
+     */
+    std::shared_ptr<PreparedQuery> prepare_query(const std::string& query);
+
+  private:
+    void create_solvers();
+    void create_predicates();
+    void index_relations();
+
+    SimpleRoot      _ast;
+    LineTable       _line_table;
+    ConditionPoolPtr _condition_pool;
+    SolverTable     _solver_table;
+    PredicateTable  _pred_table;
+    PredicatePtr    _wildcard_pred;
+    std::shared_ptr<PatternIndex>   _pattern_index;
+    std::shared_ptr<AttributeIndex> _attribute_index;
+    std::shared_ptr<ExprStore>      _expr_store;
+    std::shared_ptr<CallGraph>      _call_graph;
+    std::shared_ptr<ModifiesSolver> _modifies_solver;
+    std::shared_ptr<UsesSolver>     _uses_solver;
+    StatisticsCatalog               _statistics;
+    std::map<std::string, std::shared_ptr<MemoizedSolver> > _memoized_solvers;
+    std::shared_ptr<QueryRewriter>  _rewriter;
+    size_t                          _generation;
+};
+
+/*
+ * Parse a SIMPLE program, with its expressions hash-consed into a new
+ * ExprStore, and build its knowledge base.
+ */
+std::shared_ptr<SimpleKnowledgeBase> 
+create_knowledge_base(const std::string& source);
+
+} // namespace impl
+} // namespace simple
@@ -17,15 +17,70 @@
  */
 
 #include "impl/linker.h"
+#include "impl/cancellation.h"
 
 namespace simple {
 namespace impl {
 
 using namespace simple;
 
+SimpleQueryLinker::SimpleQueryLinker(size_t num_qvars) :
+    _slots(), _qvar_table(), _initialized(), _qvar_link_table(),
+    _link_matrix(), _condition_link_table(), _removals(), 
+    _valid_state(true), _stats() 
+{
+    add_slots(num_qvars);
+}
+
+QVarSlot SimpleQueryLinker::get_slot(const std::string& qvar) {
+    std::map<std::string, QVarSlot>::iterator it = _slots.find(qvar);
+    if(it != _slots.end()) {
+        return it->second;
+    }
+
+    QVarSlot slot = _slots.size();
+    _slots[qvar] = slot;
+
+    if(slot >= get_num_slots()) {
+        add_slots(slot + 1);
+    }
+    return slot;
+}
+
+size_t SimpleQueryLinker::get_num_slots() const {
+    return _qvar_table.size();
+}
+
+/*
+ * Grow all the tables to the given number of slots. Only happens when 
+ * names beyond the slots allocated up front are looked up.
+ */
+void SimpleQueryLinker::add_slots(size_t num_slots) {
+    if(num_slots <= get_num_slots()) {
+        return;
+    }
+
+    _qvar_table.resize(num_slots);
+    _initialized.resize(num_slots, false);
+    _qvar_link_table.resize(num_slots);
+
+    _link_matrix.resize(num_slots);
+    _condition_link_table.resize(num_slots);
+    for(size_t i = 0; i < num_slots; ++i) {
+        _link_matrix[i].resize(num_slots, false);
+        _condition_link_table[i].resize(num_slots);
+    }
+}
+
 void SimpleQueryLinker::update_links(
         const std::string& qvar1, const std::string& qvar2, 
         const std::vector<ConditionPair>& links)
+{
+    update_links(get_slot(qvar1), get_slot(qvar2), links);
+}
+
+void SimpleQueryLinker::update_links(QVarSlot qvar1, QVarSlot qvar2, 
+        const std::vector<ConditionPair>& links)
 {
     if(!is_initialized(qvar1) || !is_initialized(qvar2)) {
         throw QueryLinkerError();
@@ -37,17 +92,25 @@ void SimpleQueryLinker::update_links(
     for(std::vector<ConditionPair>::const_iterator it = links.begin();
         it != links.end(); ++it) 
     {
+        check_cancellation();
+
         if(add_link(qvar1, qvar2, it->first, it->second)) {
             new_set1.insert(it->first);
             new_set2.insert(it->second);
         }
     }
 
+    // Register the link first, so that removals cascading from one side
+    // also break the links just added on the other.
+    if(!_link_matrix[qvar1][qvar2]) {
+        _link_matrix[qvar1][qvar2] = true;
+        _link_matrix[qvar2][qvar1] = true;
+        _qvar_link_table[qvar1].push_back(qvar2);
+        _qvar_link_table[qvar2].push_back(qvar1);
+    }
+
     update_results(qvar1, new_set1);
     update_results(qvar2, new_set2);
-
-    _qvar_link_table[qvar1].insert(qvar2);
-    _qvar_link_table[qvar2].insert(qvar1);
 }
 
 /*
@@ -55,13 +118,13 @@ void SimpleQueryLinker::update_links(
  * The adding is only successful if both of the query variables
  * already has the respective conditions in their result set.
  */
-bool SimpleQueryLinker::add_link(
-        const std::string& qvar1, const std::string& qvar2, 
+bool SimpleQueryLinker::add_link(QVarSlot qvar1, QVarSlot qvar2, 
         const ConditionPtr& condition1, const ConditionPtr& condition2)
 {
     if(has_condition(qvar1, condition1) && has_condition(qvar2, condition2)) {
-        _condition_link_table[QVarPair(qvar1, qvar2)][condition1].insert(condition2);
-        _condition_link_table[QVarPair(qvar2, qvar1)][condition2].insert(condition1);
+        _condition_link_table[qvar1][qvar2][condition1].insert(condition2);
+        _condition_link_table[qvar2][qvar1][condition2].insert(condition1);
+        ++_stats.links_created;
         return true;
     } else {
         return false;
@@ -70,27 +133,45 @@ bool SimpleQueryLinker::add_link(
 
 void SimpleQueryLinker::update_results(const std::string& qvar, 
         const ConditionSet& new_set)
+{
+    update_results(get_slot(qvar), new_set);
+}
+
+void SimpleQueryLinker::update_results(QVarSlot qvar, 
+        const ConditionSet& new_set)
 {
     if(!is_initialized(qvar)) {
         _qvar_table[qvar] = new_set;
+        _initialized[qvar] = true;
     } else {
         ConditionSet difference = _qvar_table[qvar].difference_with(new_set);
-        if(!difference.is_empty()) {
-            for(ConditionSet::iterator it = difference.begin(); 
-                    it != difference.end(); ++it )
-            {
-                remove_condition(qvar, *it);
-            }
+        for(ConditionSet::iterator it = difference.begin(); 
+                it != difference.end(); ++it )
+        {
+            schedule_removal(qvar, *it, false);
         }
+        propagate_removals();
     }
 }
 
 TupleList SimpleQueryLinker::make_tuples(
         const std::vector<std::string>& variables) 
+{
+    std::vector<QVarSlot> slots;
+    for(std::vector<std::string>::const_iterator it = variables.begin();
+            it != variables.end(); ++it)
+    {
+        slots.push_back(get_slot(*it));
+    }
+    return make_tuples(slots);
+}
+
+TupleList SimpleQueryLinker::make_tuples(
+        const std::vector<QVarSlot>& variables) 
 {
     TupleList result;
 
-    std::string first_qvar = *variables.begin();
+    QVarSlot first_qvar = *variables.begin();
     
     if(!is_initialized(first_qvar)) {
         throw QueryLinkerError();
@@ -99,6 +180,8 @@ TupleList SimpleQueryLinker::make_tuples(
     for(ConditionSet::iterator cit = _qvar_table[first_qvar].begin();
         cit != _qvar_table[first_qvar].end(); ++cit)
     {
+        check_cancellation();
+
         TupleList tuples = make_tuples(first_qvar, *cit, 
                 ++variables.begin(), variables.end());
 
@@ -113,25 +196,27 @@ TupleList SimpleQueryLinker::make_tuples(
 }
 
 TupleList SimpleQueryLinker::make_tuples(
-        const std::string& current_qvar,
+        QVarSlot current_qvar,
         const ConditionPtr& current_condition,
-        std::vector<std::string>::const_iterator next_qit,
-        std::vector<std::string>::const_iterator end)
+        std::vector<QVarSlot>::const_iterator next_qit,
+        std::vector<QVarSlot>::const_iterator end)
 {
     if(!is_initialized(current_qvar)) {
         throw QueryLinkerError();
     }
 
+    check_cancellation();
+
     TupleList result;
 
     if(next_qit == end) {
         result.insert(ConditionTuplePtr(
                     new SimpleConditionTuple(current_condition)));
     } else {
-        std::string next_qvar = *next_qit++;
+        QVarSlot next_qvar = *next_qit++;
 
         if(has_link(current_qvar, next_qvar)) {
-            ConditionSet linked_conditions = get_linked_conditions(
+            const ConditionSet& linked_conditions = get_linked_conditions(
                     current_qvar, next_qvar, current_condition);
 
             for(ConditionSet::iterator cit = linked_conditions.begin();
@@ -177,109 +262,214 @@ void SimpleQueryLinker::merge_tuples(const ConditionPtr& target_condition,
     }
 }
 
-
 void SimpleQueryLinker::remove_condition(
         const std::string& qvar, const ConditionPtr& condition)
 {
-    if(_qvar_table[qvar].has_element(condition)) {
-        _qvar_table[qvar].remove(condition);
+    remove_condition(get_slot(qvar), condition);
+}
 
-        /*
-         * If it is a removal of the last condition in a qvar and
-         * makes it empty, the whole PQL is then fall into an invalid state.
-         */
-        if(_qvar_table[qvar].is_empty()) {
-            invalidate_state();
-        }
+void SimpleQueryLinker::remove_condition(
+        QVarSlot qvar, const ConditionPtr& condition)
+{
+    schedule_removal(qvar, condition, false);
+    propagate_removals();
+}
+
+void SimpleQueryLinker::break_link(
+        const std::string& qvar1, const std::string& qvar2,
+        const ConditionPtr& condition1, const ConditionPtr& condition2)
+{
+    break_link(get_slot(qvar1), get_slot(qvar2), condition1, condition2);
+}
+
+void SimpleQueryLinker::break_link(QVarSlot qvar1, QVarSlot qvar2,
+        const ConditionPtr& condition1, const ConditionPtr& condition2)
+{
+    remove_support(qvar1, qvar2, condition1, condition2);
+    remove_support(qvar2, qvar1, condition2, condition1);
+    propagate_removals();
+}
+
+/*
+ * Remove a condition from its qvar and queue it, so that its links are
+ * broken by propagate_removals(). A condition is only ever queued once,
+ * as it is no longer in the qvar afterwards.
+ */
+void SimpleQueryLinker::schedule_removal(
+        QVarSlot qvar, const ConditionPtr& condition, bool cascaded)
+{
+    if(!has_condition(qvar, condition)) {
+        return;
+    }
+
+    ConditionSet& conditions = _qvar_table[qvar];
+    conditions.remove(condition);
+    if(cascaded) {
+        ++_stats.conditions_cascaded;
+    } else {
+        ++_stats.conditions_removed;
+    }
+
+    /*
+     * If it is a removal of the last condition in a qvar and
+     * makes it empty, the whole PQL is then fall into an invalid state.
+     */
+    if(conditions.is_empty()) {
+        invalidate_state();
+    }
+
+    _removals.push_back(QVarCondition(qvar, condition));
+}
+
+/*
+ * Arc consistency in the style of AC-4. The support of a condition 
+ * towards a linked qvar is the set of conditions it is linked to there. 
+ * Removing a condition drops it from the support of everything it is 
+ * linked to, and a condition whose support towards some linked qvar 
+ * runs out is removed in turn. The worklist replaces the recursion 
+ * between removals, and since every link is deleted as soon as either
+ * end goes away, each link is examined at most twice.
+ */
+void SimpleQueryLinker::propagate_removals() {
+    while(!_removals.empty()) {
+        check_cancellation();
+
+        QVarCondition removal = _removals.front();
+        _removals.pop_front();
 
-        /*
-         * Iterate through the query variables that have linkage with this query variable
-         */
-        for(std::set<std::string>::iterator qit = _qvar_link_table[qvar].begin();
-            qit != _qvar_link_table[qvar].end(); ++qit)
+        QVarSlot qvar = removal.first;
+        const ConditionPtr& condition = removal.second;
+        const std::vector<QVarSlot>& linked_qvars = _qvar_link_table[qvar];
+
+        for(std::vector<QVarSlot>::const_iterator qit = linked_qvars.begin();
+            qit != linked_qvars.end(); ++qit)
         {
-            // clear the current link table and move that to local variable
-            ConditionSet linked_set = std::move(
-                    _condition_link_table[QVarPair(qvar, *qit)][condition]);
+            LinkMap& links = _condition_link_table[qvar][*qit];
 
-            if(linked_set.is_empty()) {
+            LinkMap::iterator cit = links.find(condition);
+            if(cit == links.end()) {
                 continue;
             }
 
-            /*
-             * Iterate through the conditions in the iterated query variable that
-             * are linked to this condition.
-             */
-            for(ConditionSet::iterator cit = linked_set.begin();
-                cit != linked_set.end(); ++cit)
+            ConditionSet linked_set = std::move(cit->second);
+            links.erase(cit);
+            _stats.links_removed += linked_set.get_size();
+
+            for(ConditionSet::iterator it = linked_set.begin();
+                it != linked_set.end(); ++it)
             {
-                break_link(*qit, qvar, *cit, condition);
+                remove_support(*qit, qvar, *it, condition);
             }
         }
     }
 }
 
 /*
- * Simple breaking of the link of condition1 in qvar with condition2.
- * if condition1 does not have any other link in qvar, return true 
- * to indicate that the break is complete.
+ * Drop condition2 of qvar2 from the support of condition1 of qvar1, 
+ * scheduling condition1 for removal if that was its last link to qvar2.
  */
-void SimpleQueryLinker::break_link(
-        const std::string& qvar1, const std::string& qvar2,
+void SimpleQueryLinker::remove_support(QVarSlot qvar1, QVarSlot qvar2,
         const ConditionPtr& condition1, const ConditionPtr& condition2)
 {
-    ConditionSet& set = _condition_link_table[QVarPair(qvar1, qvar2)][condition1];
-    set.remove(condition2);
-    if(set.is_empty()) {
-        /*
-         * If there is no other condition link in condition1 to
-         * other conditions in qvar2, then condition1 is 
-         * invalidated and needs to be removed as well.
-         */
-        remove_condition(qvar1, condition1);
+    LinkMap& links = _condition_link_table[qvar1][qvar2];
+
+    LinkMap::iterator it = links.find(condition1);
+    if(it == links.end() || !it->second.has_element(condition2)) {
+        return;
+    }
+
+    it->second.remove(condition2);
+    ++_stats.links_removed;
+
+    if(it->second.is_empty()) {
+        links.erase(it);
+        schedule_removal(qvar1, condition1, true);
     }
 }
 
 bool SimpleQueryLinker::is_initialized(const std::string& qvar) {
-    return _qvar_table.count(qvar) > 0;
+    std::map<std::string, QVarSlot>::iterator it = _slots.find(qvar);
+    return it != _slots.end() && is_initialized(it->second);
 }
 
-bool SimpleQueryLinker::has_condition(const std::string& qvar, const ConditionPtr& condition) {
+bool SimpleQueryLinker::is_initialized(QVarSlot qvar) {
+    return qvar < get_num_slots() && _initialized[qvar];
+}
+
+bool SimpleQueryLinker::has_condition(const std::string& qvar, 
+        const ConditionPtr& condition) 
+{
+    return has_condition(get_slot(qvar), condition);
+}
+
+bool SimpleQueryLinker::has_condition(QVarSlot qvar, 
+        const ConditionPtr& condition) 
+{
     return _qvar_table[qvar].has_element(condition);
 }
 
 bool SimpleQueryLinker::has_link(const std::string& qvar1,
               const std::string& qvar2)
 {
-    return _qvar_link_table[qvar1].count(qvar2) > 0;
+    return has_link(get_slot(qvar1), get_slot(qvar2));
+}
+
+bool SimpleQueryLinker::has_link(QVarSlot qvar1, QVarSlot qvar2) {
+    return _link_matrix[qvar1][qvar2];
 }
 
-ConditionSet SimpleQueryLinker::get_linked_conditions(
+const ConditionSet& SimpleQueryLinker::get_linked_conditions(
         const std::string& qvar1, const std::string& qvar2,
         const ConditionPtr& condition1) 
 {
-    if(_condition_link_table[QVarPair(qvar1, qvar2)].count(condition1) > 0) {
-        return _condition_link_table[QVarPair(qvar1, qvar2)][condition1];
+    return get_linked_conditions(get_slot(qvar1), get_slot(qvar2), condition1);
+}
+
+const ConditionSet& SimpleQueryLinker::get_linked_conditions(
+        QVarSlot qvar1, QVarSlot qvar2, const ConditionPtr& condition1) 
+{
+    static const ConditionSet empty_set;
+
+    const LinkMap& links = _condition_link_table[qvar1][qvar2];
+    LinkMap::const_iterator it = links.find(condition1);
+
+    if(it != links.end()) {
+        return it->second;
     } else {
-        return ConditionSet();
+        return empty_set;
     }
 }
 
 bool SimpleQueryLinker::has_indirect_links(
-        const std::string& qvar1, const std::string& qvar2,
-        std::set<std::string> visited_qvars)
+        const std::string& qvar1, const std::string& qvar2)
+{
+    return has_indirect_links(get_slot(qvar1), get_slot(qvar2));
+}
+
+bool SimpleQueryLinker::has_indirect_links(QVarSlot qvar1, QVarSlot qvar2) {
+    std::vector<bool> visited_qvars(get_num_slots(), false);
+    return has_indirect_links(qvar1, qvar2, visited_qvars);
+}
+
+/*
+ * A depth first search over the linked qvars, sharing the visited flags
+ * across the whole search.
+ */
+bool SimpleQueryLinker::has_indirect_links(QVarSlot qvar1, QVarSlot qvar2,
+        std::vector<bool>& visited_qvars)
 {
     if(has_link(qvar1, qvar2)) {
         return true;
     } else {
-        for(std::set<std::string>::iterator qit = _qvar_link_table[qvar1].begin();
-            qit != _qvar_link_table[qvar1].end(); ++qit)
-        {
+        const std::vector<QVarSlot>& linked_qvars = _qvar_link_table[qvar1];
 
-            std::string mid_qvar = *qit;
+        for(std::vector<QVarSlot>::const_iterator qit = linked_qvars.begin();
+            qit != linked_qvars.end(); ++qit)
+        {
+            QVarSlot mid_qvar = *qit;
 
-            if(visited_qvars.count(mid_qvar) == 0) {
-                visited_qvars.insert(mid_qvar);
+            if(!visited_qvars[mid_qvar]) {
+                visited_qvars[mid_qvar] = true;
                 if(has_indirect_links(mid_qvar, qvar2, visited_qvars)) {
                     return true;
                 }
@@ -291,23 +481,37 @@ bool SimpleQueryLinker::has_indirect_links(
 
 ConditionSet SimpleQueryLinker::get_indirect_links(
         const std::string& qvar1, const std::string& qvar2,
-        const ConditionPtr& condition1, 
-        std::set<std::string> visited_qvars)
+        const ConditionPtr& condition1)
+{
+    return get_indirect_links(get_slot(qvar1), get_slot(qvar2), condition1);
+}
+
+ConditionSet SimpleQueryLinker::get_indirect_links(
+        QVarSlot qvar1, QVarSlot qvar2, const ConditionPtr& condition1)
+{
+    return get_indirect_links(qvar1, qvar2, condition1,
+            std::vector<bool>(get_num_slots(), false));
+}
+
+ConditionSet SimpleQueryLinker::get_indirect_links(
+        QVarSlot qvar1, QVarSlot qvar2, const ConditionPtr& condition1, 
+        std::vector<bool> visited_qvars)
 {
     if(has_link(qvar1, qvar2)) {
         return get_linked_conditions(qvar1, qvar2, condition1);
     } else {
         ConditionSet result;
+        const std::vector<QVarSlot>& linked_qvars = _qvar_link_table[qvar1];
 
-        for(std::set<std::string>::iterator qit = _qvar_link_table[qvar1].begin();
-            qit != _qvar_link_table[qvar1].end(); ++qit)
+        for(std::vector<QVarSlot>::const_iterator qit = linked_qvars.begin();
+            qit != linked_qvars.end(); ++qit)
         {
-            std::string mid_qvar = *qit;
+            QVarSlot mid_qvar = *qit;
 
-            if(visited_qvars.count(mid_qvar) == 0) {
-                visited_qvars.insert(mid_qvar);
+            if(!visited_qvars[mid_qvar]) {
+                visited_qvars[mid_qvar] = true;
 
-                ConditionSet direct_links = get_linked_conditions(
+                const ConditionSet& direct_links = get_linked_conditions(
                         qvar1, mid_qvar, condition1);
                 for(ConditionSet::iterator cit = direct_links.begin();
                     cit != direct_links.end(); ++cit)
@@ -324,6 +528,12 @@ ConditionSet SimpleQueryLinker::get_indirect_links(
 bool SimpleQueryLinker::validate(
         const std::string& qvar1, const std::string& qvar2, 
         const ConditionPtr& condition1, const ConditionPtr& condition2)
+{
+    return validate(get_slot(qvar1), get_slot(qvar2), condition1, condition2);
+}
+
+bool SimpleQueryLinker::validate(QVarSlot qvar1, QVarSlot qvar2, 
+        const ConditionPtr& condition1, const ConditionPtr& condition2)
 {
     if(has_link(qvar1, qvar2)) {
         return get_linked_conditions(qvar1, qvar2, condition1)
@@ -333,23 +543,47 @@ bool SimpleQueryLinker::validate(
      }
 }
 
-ConditionSet SimpleQueryLinker::get_conditions(
+const ConditionSet& SimpleQueryLinker::get_conditions(
         const std::string& qvar, SimplePredicate *pred) 
+{
+    return get_conditions(get_slot(qvar), pred);
+}
+
+const ConditionSet& SimpleQueryLinker::get_conditions(
+        QVarSlot qvar, SimplePredicate *pred) 
 {
     if(!is_initialized(qvar)) {
         _qvar_table[qvar] = pred->global_set();
+        _initialized[qvar] = true;
     }
     return _qvar_table[qvar];
 }
 
-ConditionSet SimpleQueryLinker::get_conditions(const std::string& qvar) {
+const ConditionSet& SimpleQueryLinker::get_conditions(const std::string& qvar) {
+    static const ConditionSet empty_set;
+
+    std::map<std::string, QVarSlot>::iterator it = _slots.find(qvar);
+    if(it != _slots.end()) {
+        return get_conditions(it->second);
+    } else {
+        return empty_set;
+    }
+}
+
+const ConditionSet& SimpleQueryLinker::get_conditions(QVarSlot qvar) {
     return _qvar_table[qvar];
 }
 
-std::map<ConditionPtr, ConditionSet> SimpleQueryLinker::get_links(
+const std::map<ConditionPtr, ConditionSet>& SimpleQueryLinker::get_links(
         const std::string& qvar1, const std::string& qvar2)
 {
-    return _condition_link_table[QVarPair(qvar1, qvar2)];
+    return get_links(get_slot(qvar1), get_slot(qvar2));
+}
+
+const std::map<ConditionPtr, ConditionSet>& SimpleQueryLinker::get_links(
+        QVarSlot qvar1, QVarSlot qvar2)
+{
+    return _condition_link_table[qvar1][qvar2];
 }
 
 bool SimpleQueryLinker::is_valid_state() {
@@ -360,6 +594,10 @@ void SimpleQueryLinker::invalidate_state() {
     _valid_state = false;
 }
 
+const LinkerStats& SimpleQueryLinker::get_stats() {
+    return _stats;
+}
+
 
 
 }
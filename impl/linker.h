@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <deque>
 #include <map>
 #include <string>
 #include <utility>
@@ -29,95 +30,212 @@ namespace impl {
 
 using namespace simple;
 
-typedef std::pair<std::string, std::string> QVarPair;
+typedef std::pair<QVarSlot, ConditionPtr> QVarCondition;
 
 class QueryLinkerError : public std::exception { };
 
+/*
+ * Running counters of the work done by the linker, used by the query
+ * profiler.
+ */
+struct LinkerStats {
+  public:
+    LinkerStats() : 
+        links_created(0), links_removed(0), conditions_removed(0),
+        conditions_cascaded(0)
+    { }
+
+    size_t links_created;
+
+    // each direction of a link counts once
+    size_t links_removed;
+
+    // removed by the caller, e.g. when a clause narrows a qvar
+    size_t conditions_removed;
+
+    // removed as their last link to a linked qvar was broken
+    size_t conditions_cascaded;
+};
+
+/*
+ * The linker keeps every query variable in a dense slot, and all of its
+ * tables are flat arrays and adjacency matrices indexed by slot. The 
+ * methods taking qvar names resolve them with get_slot() and forward to
+ * the slot based overloads, which are the ones the query processor uses.
+ */
 class SimpleQueryLinker : public QueryLinker {
   public:
-    SimpleQueryLinker() : _valid_state(true) { }
+    /*
+     * num_qvars is the number of slots to allocate up front, e.g. the
+     * number of synonyms of the query. Further slots are added on 
+     * demand by get_slot().
+     */
+    SimpleQueryLinker(size_t num_qvars = 0);
+
+    QVarSlot get_slot(const std::string& qvar);
+
+    size_t get_num_slots() const;
 
     void update_links(const std::string& qvar1, 
                    const std::string& qvar2, 
                    const std::vector<ConditionPair>& links);
 
+    void update_links(QVarSlot qvar1, QVarSlot qvar2, 
+                   const std::vector<ConditionPair>& links);
+
     void update_results(const std::string& qvar,
                        const ConditionSet& conditions);
 
+    void update_results(QVarSlot qvar, const ConditionSet& conditions);
+
     TupleList make_tuples(const std::vector<std::string>& variables);
 
-    TupleList make_tuples(
-            const std::string& current_qvar,
-            const ConditionPtr& current_condition,
-            std::vector<std::string>::const_iterator next_qit,
-            std::vector<std::string>::const_iterator end);
+    TupleList make_tuples(const std::vector<QVarSlot>& variables);
 
-    bool add_link(const std::string& qvar1, const std::string& qvar2, 
+    bool add_link(QVarSlot qvar1, QVarSlot qvar2, 
                   const ConditionPtr& condition1, const ConditionPtr& condition2);
 
+    /*
+     * Remove a condition from a qvar, along with every condition that
+     * loses its last link to some linked qvar as a result.
+     */
     void remove_condition(const std::string& qvar, 
                           const ConditionPtr& condition);
 
+    void remove_condition(QVarSlot qvar, const ConditionPtr& condition);
+
     /*
-     * Break the link of condition1 in qvar1 with condition2 in qvar2. 
+     * Break the link of condition1 in qvar1 with condition2 in qvar2,
+     * removing any of the two that is left without links to the other
+     * qvar.
      */
     void break_link(const std::string& qvar1, 
                     const std::string& qvar2,
                     const ConditionPtr& condition1, 
                     const ConditionPtr& condition2);
 
+    void break_link(QVarSlot qvar1, QVarSlot qvar2,
+                    const ConditionPtr& condition1, 
+                    const ConditionPtr& condition2);
+
     bool is_initialized(const std::string& qvar);
 
+    bool is_initialized(QVarSlot qvar);
+
     bool has_condition(const std::string& qvar, 
                        const ConditionPtr& condition);
 
+    bool has_condition(QVarSlot qvar, const ConditionPtr& condition);
+
     bool has_link(const std::string& qvar1,
                   const std::string& qvar2);
 
-    ConditionSet get_linked_conditions(
+    bool has_link(QVarSlot qvar1, QVarSlot qvar2);
+
+    const ConditionSet& get_linked_conditions(
                     const std::string& qvar1,
                     const std::string& qvar2,
                     const ConditionPtr& condition1);
 
+    const ConditionSet& get_linked_conditions(
+                    QVarSlot qvar1, QVarSlot qvar2,
+                    const ConditionPtr& condition1);
+
     void merge_tuples(const ConditionPtr& target_condition,
             const TupleList& tuples, TupleList& result);
 
-    ConditionSet get_conditions(const std::string& qvar,
+    const ConditionSet& get_conditions(const std::string& qvar,
             SimplePredicate *pred);
 
-    ConditionSet get_conditions(const std::string& qvar);
+    const ConditionSet& get_conditions(QVarSlot qvar, SimplePredicate *pred);
+
+    /*
+     * The conditions of an initialized qvar, or the empty set. Like
+     * the other accessors below it returns a view into the linker.
+     */
+    const ConditionSet& get_conditions(const std::string& qvar);
+
+    const ConditionSet& get_conditions(QVarSlot qvar);
 
-    std::map<ConditionPtr, ConditionSet> get_links(
+    const std::map<ConditionPtr, ConditionSet>& get_links(
             const std::string& qvar1,
             const std::string& qvar2);
 
-    bool has_indirect_links(
-            const std::string& qvar1, const std::string& qvar2,
-            std::set<std::string> visited_qvars = std::set<std::string>());
+    const std::map<ConditionPtr, ConditionSet>& get_links(
+            QVarSlot qvar1, QVarSlot qvar2);
+
+    bool has_indirect_links(const std::string& qvar1, const std::string& qvar2);
+
+    bool has_indirect_links(QVarSlot qvar1, QVarSlot qvar2);
 
     ConditionSet get_indirect_links(
             const std::string& qvar1, const std::string& qvar2,
-            const ConditionPtr& condition1, 
-            std::set<std::string> visited_qvars = std::set<std::string>());
+            const ConditionPtr& condition1);
+
+    ConditionSet get_indirect_links(QVarSlot qvar1, QVarSlot qvar2,
+            const ConditionPtr& condition1);
 
     bool validate(const std::string& qvar1, const std::string& qvar2, 
             const ConditionPtr& condition1, const ConditionPtr& condition2);
 
+    bool validate(QVarSlot qvar1, QVarSlot qvar2, 
+            const ConditionPtr& condition1, const ConditionPtr& condition2);
 
     bool is_valid_state();
     void invalidate_state();
+
+    const LinkerStats& get_stats();
   private:
-    std::map< QVarPair, 
-        std::map<ConditionPtr, ConditionSet> >
-    _condition_link_table;
+    typedef std::map<ConditionPtr, ConditionSet> LinkMap;
+
+    void add_slots(size_t num_slots);
+
+    TupleList make_tuples(
+            QVarSlot current_qvar,
+            const ConditionPtr& current_condition,
+            std::vector<QVarSlot>::const_iterator next_qit,
+            std::vector<QVarSlot>::const_iterator end);
+
+    bool has_indirect_links(QVarSlot qvar1, QVarSlot qvar2,
+            std::vector<bool>& visited_qvars);
+
+    ConditionSet get_indirect_links(QVarSlot qvar1, QVarSlot qvar2,
+            const ConditionPtr& condition1, 
+            std::vector<bool> visited_qvars);
 
-    std::map< std::string, std::set<std::string> >
-    _qvar_link_table;
-    
-    std::map< std::string, ConditionSet > 
-    _qvar_table;
+    void schedule_removal(QVarSlot qvar, const ConditionPtr& condition,
+            bool cascaded);
+
+    void propagate_removals();
+
+    void remove_support(QVarSlot qvar1, QVarSlot qvar2,
+                        const ConditionPtr& condition1, 
+                        const ConditionPtr& condition2);
+
+    std::map<std::string, QVarSlot> _slots;
+
+    /*
+     * The tables handing out views are deques, which keep their
+     * elements in place when slots are added.
+     */
+
+    // the conditions of each qvar, and whether it is initialized
+    std::deque<ConditionSet>    _qvar_table;
+    std::vector<bool>           _initialized;
+
+    // the qvars linked with each qvar, as lists and as a matrix
+    std::vector< std::vector<QVarSlot> >    _qvar_link_table;
+    std::vector< std::vector<bool> >        _link_matrix;
+
+    // the links of every condition of one qvar to the conditions of
+    // another, indexed by the two slots
+    std::deque< std::deque<LinkMap> >       _condition_link_table;
+
+    std::deque<QVarCondition> _removals;
 
     bool _valid_state;
+
+    LinkerStats _stats;
 };
 
 class SimpleConditionTuple : public ConditionTuple {
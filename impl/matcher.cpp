@@ -18,12 +18,16 @@
 
 #include <vector>
 #include "impl/matcher.h"
+#include "impl/parallel_join.h"
+#include "impl/cancellation.h"
 
 namespace simple {
 namespace impl {
 
 
-SimpleQueryMatcher::SimpleQueryMatcher(QuerySolver *solver) : _solver(solver) { } 
+SimpleQueryMatcher::SimpleQueryMatcher(QuerySolver *solver, ThreadPoolPtr pool) : 
+    _solver(solver), _pool(pool) 
+{ } 
 
 
 void SimpleQueryMatcher::solve_both_diff_qvar(
@@ -31,18 +35,12 @@ void SimpleQueryMatcher::solve_both_diff_qvar(
     /* output */    ConditionSet& new_left, ConditionSet& new_right,
                     std::vector<ConditionPair>& result_pairs) 
 {
-    for(ConditionSet::iterator left_it = left.begin(); 
-            left_it != left.end(); ++left_it)
-    {
-        for(ConditionSet::iterator right_it = right.begin();
-              right_it != right.end(); ++right_it)
-        {
-            if(_solver->validate(left_it->get(), right_it->get())) {
-                new_left.insert(*left_it);
-                new_right.insert(*right_it);
-                result_pairs.push_back(ConditionPair(*left_it, *right_it));
-            }
-        }
+    size_t offset = result_pairs.size();
+    validate_pairs(_solver.get(), left, right, result_pairs, _pool.get());
+
+    for(size_t i = offset; i < result_pairs.size(); ++i) {
+        new_left.insert(result_pairs[i].first);
+        new_right.insert(result_pairs[i].second);
     }
 }
 
@@ -53,6 +51,8 @@ void SimpleQueryMatcher::solve_both_same_qvar(const ConditionSet& values,
     for(ConditionSet::iterator it = values.begin();
             it != values.end(); ++it)
     {
+        check_cancellation();
+
         if(_solver->validate(it->get(), it->get())) {
             new_values.insert(*it);
             result_pairs.push_back(ConditionPair(*it, *it));
@@ -23,6 +23,7 @@
 #include <string>
 #include "simple/solver.h"
 #include "simple/matcher.h"
+#include "impl/thread_pool.h"
 
 namespace simple {
 namespace impl {
@@ -32,7 +33,7 @@ using namespace simple::impl;
 
 class SimpleQueryMatcher : public QueryMatcher {
   public:
-    SimpleQueryMatcher(QuerySolver *solver);
+    SimpleQueryMatcher(QuerySolver *solver, ThreadPoolPtr pool = ThreadPoolPtr());
 
     std::vector<ConditionPair> solve_both(QueryVariable *left, QueryVariable *right);
 
@@ -61,6 +62,7 @@ class SimpleQueryMatcher : public QueryMatcher {
 
   private:
     std::unique_ptr<QuerySolver> _solver;
+    ThreadPoolPtr _pool;
 };
 
 
@@ -0,0 +1,119 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impl/parallel_join.h"
+#include "impl/cancellation.h"
+
+namespace simple {
+namespace impl {
+
+typedef std::vector<ConditionPtr> ConditionList;
+
+class PairValidationTask : public ThreadPoolTask {
+  public:
+    PairValidationTask(QuerySolver *solver, 
+            ConditionList::const_iterator begin,
+            ConditionList::const_iterator end,
+            const ConditionSet *right) :
+        _solver(solver), _begin(begin), _end(end), _right(right), _result(),
+        _token(current_cancellation_token())
+    { }
+
+    void run() {
+        // pool threads do not inherit the token of the submitting thread
+        CancellationScope scope(_token);
+
+        for(ConditionList::const_iterator left_it = _begin;
+                left_it != _end; ++left_it)
+        {
+            for(ConditionSet::iterator right_it = _right->begin();
+                    right_it != _right->end(); ++right_it)
+            {
+                check_cancellation();
+
+                if(_solver->validate(left_it->get(), right_it->get())) {
+                    _result.push_back(ConditionPair(*left_it, *right_it));
+                }
+            }
+        }
+    }
+
+    std::vector<ConditionPair>& get_result() {
+        return _result;
+    }
+
+  private:
+    QuerySolver                     *_solver;
+    ConditionList::const_iterator   _begin;
+    ConditionList::const_iterator   _end;
+    const ConditionSet              *_right;
+    std::vector<ConditionPair>      _result;
+    CancellationToken               *_token;
+};
+
+void validate_pairs(QuerySolver *solver,
+        const ConditionSet& left, const ConditionSet& right,
+        std::vector<ConditionPair>& result,
+        WorkStealingPool *pool)
+{
+    ConditionList left_list(left.begin(), left.end());
+
+    if(pool == NULL || left_list.size() < 2 ||
+            left_list.size() * right.get_size() < PARALLEL_JOIN_THRESHOLD)
+    {
+        PairValidationTask task(solver, 
+                left_list.begin(), left_list.end(), &right);
+        task.run();
+        result.insert(result.end(), 
+                task.get_result().begin(), task.get_result().end());
+        return;
+    }
+
+    // Use several chunks per worker so that idle workers have something
+    // left to steal when the validation cost is skewed.
+    size_t num_chunks = pool->get_num_workers() * 4;
+    if(num_chunks > left_list.size()) {
+        num_chunks = left_list.size();
+    }
+    size_t chunk_size = (left_list.size() + num_chunks - 1) / num_chunks;
+
+    std::vector<std::unique_ptr<PairValidationTask> > chunks;
+    std::vector<ThreadPoolTask*> tasks;
+
+    for(size_t start = 0; start < left_list.size(); start += chunk_size) {
+        size_t end = start + chunk_size;
+        if(end > left_list.size()) {
+            end = left_list.size();
+        }
+
+        chunks.push_back(std::unique_ptr<PairValidationTask>(
+                new PairValidationTask(solver, 
+                    left_list.begin() + start, left_list.begin() + end, &right)));
+        tasks.push_back(chunks.back().get());
+    }
+
+    pool->run_all(tasks);
+
+    for(size_t i = 0; i < chunks.size(); ++i) {
+        std::vector<ConditionPair>& chunk_result = chunks[i]->get_result();
+        result.insert(result.end(), chunk_result.begin(), chunk_result.end());
+    }
+}
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,56 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include "simple/solver.h"
+#include "simple/condition_set.h"
+#include "impl/thread_pool.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * Below this many candidate pairs the join is validated on the calling
+ * thread, as dispatching to the pool costs more than it saves.
+ */
+const size_t PARALLEL_JOIN_THRESHOLD = 4096;
+
+/*
+ * Validate every pair in left x right against the solver and append the
+ * valid pairs to result, ordered by left condition and then by right
+ * condition.
+ *
+ * When a pool is given and the join is large enough, the left domain is
+ * cut into chunks that are validated concurrently. Each chunk writes to
+ * its own buffer and the buffers are concatenated in chunk order, so the
+ * output is identical to the sequential nested loop. The solver must be
+ * safe to call concurrently in that case, so the solvers that build
+ * graphs or fill caches while validating, e.g. Next* or Affects, guard
+ * them with a lock of their own.
+ */
+void validate_pairs(QuerySolver *solver,
+        const ConditionSet& left, const ConditionSet& right,
+        std::vector<ConditionPair>& result,
+        WorkStealingPool *pool = NULL);
+
+} // namespace impl
+} // namespace simple
@@ -94,11 +94,29 @@ class IteratorTokenizer : public SimpleTokenizer {
                 next_char();
                 return &_comma_token;
 
+            break;
+            case '<':
+                next_char();
+                return &_less_than_token;
+
+            break;
+            case '>':
+                next_char();
+                return &_more_than_token;
+
             break;
             case '.':
                 next_char();
                 return &_dot_token;
 
+            case '#':
+                next_char();
+                return &_hash_token;
+
+            case '?':
+                next_char();
+                return &_placeholder_token;
+
             case '=':
                 next_char();
                 return &_equal_token;
@@ -188,8 +206,12 @@ class IteratorTokenizer : public SimpleTokenizer {
     OpenBracketToken    _open_bracket_token;
     CloseBracketToken   _close_bracket_token;
     SemiColonToken      _semi_colon_token;
+    LessThanToken       _less_than_token;
+    MoreThanToken       _more_than_token;
     CommaToken          _comma_token;
     DotToken            _dot_token;
+    HashToken           _hash_token;
+    PlaceholderToken    _placeholder_token;
     EqualToken          _equal_token;
     EOFToken            _eof_token;
     NewLineToken        _new_line_token;
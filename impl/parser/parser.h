@@ -16,6 +16,8 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#pragma once
+
 #include <string>
 #include <map>
 #include <memory>
@@ -23,6 +25,7 @@
 #include "simple/ast.h"
 #include "simple/util/ast_utils.h"
 #include "impl/ast.h"
+#include "impl/expr_store.h"
 #include "impl/parser/token.h"
 #include "impl/parser/tokenizer.h"
 
@@ -36,10 +39,17 @@ class ParserError : public std::exception { };
 
 class SimpleParser {
   public:
-    SimpleParser(SimpleTokenizer *tokenizer) :
+    /*
+     * With an expression store, the right hand sides of all assignments
+     * are hash-consed through the store so that repeated subexpressions
+     * share their nodes.
+     */
+    SimpleParser(SimpleTokenizer *tokenizer, 
+            std::shared_ptr<ExprStore> store = std::shared_ptr<ExprStore>()) :
         _line(1),
         _line_table(),
-        _tokenizer(tokenizer)
+        _tokenizer(tokenizer),
+        _store(store)
     { 
         next_token();
     }
@@ -53,8 +63,15 @@ class SimpleParser {
         return SimpleRoot(_procs.begin(), _procs.end());
     }
 
+    /*
+     * Parse an expression into a new tree owned by the caller.
+     */
     ExprAst* parse_expr() {
-        ExprAst *primary = parse_primary();
+        return parse_expr_ptr()->clone();
+    }
+
+    ExprPtr parse_expr_ptr() {
+        ExprPtr primary = parse_primary();
         return parse_binary_op_rhs(0, primary);
     }
 
@@ -120,7 +137,7 @@ class SimpleParser {
 
         SimpleAssignmentAst *assign = new SimpleAssignmentAst();
         assign->set_variable(var);
-        assign->set_expr(parse_expr());
+        assign->set_expr(parse_expr_ptr());
 
         current_token_as<SemiColonToken>();
         next_token(); // eat ';'
@@ -289,7 +306,7 @@ class SimpleParser {
         return proc;
     }
 
-    ExprAst* parse_binary_op_rhs(int precedence, ExprAst* lhs) {
+    ExprPtr parse_binary_op_rhs(int precedence, ExprPtr lhs) {
         while(true) {
             int current_precedence = operator_precedence();
             if(current_precedence < precedence) {
@@ -299,16 +316,16 @@ class SimpleParser {
             char current_op = current_token_as<OperatorToken>()->get_op();
             next_token();
 
-            ExprAst *rhs = parse_primary();
+            ExprPtr rhs = parse_primary();
             int next_precedence = operator_precedence();
             if(current_precedence < next_precedence) {
                 rhs = parse_binary_op_rhs(current_precedence+1, rhs);
             }
-            lhs = new SimpleBinaryOpAst(current_op, lhs, rhs);
+            lhs = make_binary_op(current_op, lhs, rhs);
         }
     }
 
-    ExprAst* parse_primary() {
+    ExprPtr parse_primary() {
         SimpleToken *token = current_token();
         if(try_token<IdentifierToken>(token)) {
             return parse_variable();
@@ -321,23 +338,31 @@ class SimpleParser {
         }
     }
 
-    SimpleConstAst* parse_const() {
+    ExprPtr parse_const() {
         int value = current_token_as<IntegerToken>()->get_value();
         next_token();
-        return new SimpleConstAst(value);
+
+        if(_store) {
+            return _store->make_const(value);
+        }
+        return ExprPtr(new SimpleConstAst(value));
     }
 
-    SimpleVariableAst* parse_variable() {
+    ExprPtr parse_variable() {
         std::string name = current_token_as<IdentifierToken>()->get_content();
         next_token();
-        return new SimpleVariableAst(name);
+
+        if(_store) {
+            return _store->make_variable(SimpleVariable(name));
+        }
+        return ExprPtr(new SimpleVariableAst(name));
     }
 
-    ExprAst* parse_parent_expr() {
+    ExprPtr parse_parent_expr() {
         current_token_as<OpenBracketToken>();
         next_token(); // eat'('
 
-        ExprAst *expr = parse_expr();
+        ExprPtr expr = parse_expr_ptr();
 
         current_token_as<CloseBracketToken>();
         next_token(); // eat ')'
@@ -345,6 +370,13 @@ class SimpleParser {
         return expr;
     }
 
+    ExprPtr make_binary_op(char op, ExprPtr lhs, ExprPtr rhs) {
+        if(_store) {
+            return _store->make_binary_op(op, lhs, rhs);
+        }
+        return ExprPtr(new SimpleBinaryOpAst(op, lhs, rhs));
+    }
+
     int operator_precedence() {
         if(current_token_is<OperatorToken>()) {
             OperatorToken *token = current_token_as<OperatorToken>();
@@ -401,6 +433,7 @@ class SimpleParser {
     std::vector<ProcAst*> _procs;
 
     std::unique_ptr<SimpleTokenizer> _tokenizer;
+    std::shared_ptr<ExprStore>      _store;
 };
 
 } // namespace parser
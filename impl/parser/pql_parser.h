@@ -21,12 +21,21 @@
 #include <algorithm>
 #include <string>
 #include <exception>
+#include <vector>
 #include "simple/predicate.h"
 #include "simple/query.h"
 #include "simple/solver.h"
+#include "impl/attribute_index.h"
 #include "impl/condition.h"
+#include "impl/condition_pool.h"
+#include "impl/pattern_index.h"
+#include "impl/parser/parser.h"
+#include "impl/parser/iterator_tokenizer.h"
 #include "impl/parser/tokenizer.h"
 #include "impl/query.h"
+#include "impl/solvers/pattern.h"
+#include "impl/solvers/with.h"
+#include "simple/util/solver_generator.h"
 
 namespace simple {
 namespace parser {
@@ -43,10 +52,16 @@ class SimplePqlParser {
             const SimpleRoot& ast,
             const LineTable& line_table,
             const SolverTable& solver_table, 
-            const PredicateTable& pred_table) :
+            const PredicateTable& pred_table,
+            std::shared_ptr<PatternIndex> pattern_index = 
+                std::shared_ptr<PatternIndex>(),
+            std::shared_ptr<AttributeIndex> attribute_index = 
+                std::shared_ptr<AttributeIndex>(),
+            ConditionPoolPtr condition_pool = ConditionPoolPtr()) :
         _tokenizer(tokenizer), _ast(ast),
         _line_table(line_table), _solver_table(solver_table), 
-        _pred_table(pred_table)
+        _pred_table(pred_table), _pattern_index(pattern_index),
+        _attribute_index(attribute_index), _condition_pool(condition_pool)
     { 
         next_token();
     }
@@ -55,6 +70,14 @@ class SimplePqlParser {
         return _query_set;
     }
 
+    /*
+     * The kinds of the '?' placeholders of the query, in the order they
+     * appear. A query with placeholders can only be prepared.
+     */
+    const std::vector<ParameterKind>& get_parameter_kinds() {
+        return _parameter_kinds;
+    }
+
     PqlQuerySet parse_query() {
         while(!current_token_is<EOFToken>()) {
             std::string first_word = current_token_as_keyword();
@@ -92,6 +115,8 @@ class SimplePqlParser {
             pred = get_predicate("variable");
         } else if(keyword == "call") {
             pred = get_predicate("call");
+        } else if(keyword == "constant") {
+            pred = get_predicate("constant");
         } else {
             throw PqlParserError();
         }
@@ -101,6 +126,7 @@ class SimplePqlParser {
                         IdentifierToken>()->get_content();
 
             _query_set.predicates[qvar] = pred;
+            get_qvar_slot(qvar);
             next_token(); // eat var name
 
             if(current_token_is<SemiColonToken>()) {
@@ -116,22 +142,31 @@ class SimplePqlParser {
     void parse_main_query() {
         _query_set.selector = parse_selector();
 
+        // the kind of clause that a following "and" continues
+        std::string last_keyword = "such";
+
         while(!(current_token_is<EOFToken>() || 
                     current_token_is<SemiColonToken>())) 
         {
             std::string keyword = current_token_as_keyword();
             next_token(); // eat keyword
 
+            bool is_and = keyword == "and";
+            if(is_and) {
+                keyword = last_keyword;
+            } else {
+                last_keyword = keyword;
+            }
+
             if(keyword == "such") {
-                if(current_token_as_keyword() != "that") {
-                    throw PqlParserError();
-                } else {
+                if(!is_and) {
+                    if(current_token_as_keyword() != "that") {
+                        throw PqlParserError();
+                    }
                     next_token(); // eat "that"
-
-                    _query_set.clauses.insert(parse_clause());
                 }
-            } else if(keyword == "and") {
-                    _query_set.clauses.insert(parse_clause());
+
+                _query_set.clauses.insert(parse_clause());
             } else if(keyword == "with") {
                 parse_with();
             } else if(keyword == "pattern") {
@@ -211,19 +246,24 @@ class SimplePqlParser {
         } else if(current_token_is<IntegerToken>()) {
             int line = current_token_as<IntegerToken>()->get_value();
             next_token();
-            return new SimplePqlConditionTerm(
-                   new SimpleStatementCondition(get_statement(line)));
+            return new SimplePqlConditionTerm(get_condition_pool()->
+                   get_statement_condition(get_statement(line)));
             
         } else if(current_token_is<IdentifierToken>()) {
             std::string var_name = current_token_as<
                     IdentifierToken>()->get_content();
             next_token();
-            return new SimplePqlVariableTerm(var_name);
+            return new SimplePqlVariableTerm(var_name, 
+                    get_qvar_slot(var_name));
 
         } else if(current_token_is<WildCardToken>()) {
             next_token();
             return new SimplePqlWildcardTerm();
 
+        } else if(current_token_is<PlaceholderToken>()) {
+            next_token();
+            return new_parameter_term(PARAM_TERM);
+
         } else {
             throw PqlParserError();
         }
@@ -232,22 +272,259 @@ class SimplePqlParser {
     ConditionPtr parse_condition(const std::string& name) {
         ProcAst *proc = _ast.get_proc(name);
         if(proc) {
-            return new SimpleProcCondition(proc);
+            return get_condition_pool()->get_proc_condition(proc);
         } else {
-            return new SimpleVariableCondition(SimpleVariable(name));
+            return get_condition_pool()->get_variable_condition(
+                    SimpleVariable(name));
         }
     }
 
+    /*
+     * pattern a(v, "x * y")      exact match of the right hand side
+     * pattern a(v, _"x * y"_)    subexpression match
+     * pattern a(v, _)            any right hand side
+     *
+     * The first argument is a synonym, a variable name or a wildcard. 
+     * Only assignment synonyms are supported.
+     */
     void parse_pattern() {
-        throw PqlParserError(); // not implemented
+        std::string qvar = current_token_as<IdentifierToken>()->get_content();
+        next_token(); // eat synonym
+
+        if(_query_set.predicates.count(qvar) == 0 ||
+                _query_set.predicates[qvar] != get_predicate("assignment"))
+        {
+            throw PqlParserError();
+        }
+
+        current_token_as<OpenBracketToken>();
+        next_token();
+
+        PqlTerm *var_term;
+        if(current_token_is<LiteralToken>()) {
+            var_term = new SimplePqlConditionTerm(
+                    get_condition_pool()->get_variable_condition(SimpleVariable(
+                        current_token_as<LiteralToken>()->get_content())));
+            next_token();
+        } else if(current_token_is<PlaceholderToken>()) {
+            next_token();
+            var_term = new_parameter_term(PARAM_NAME);
+        } else {
+            var_term = parse_term();
+        }
+
+        current_token_as<CommaToken>();
+        next_token();
+
+        ExprPtr expr;
+        bool exact = true;
+
+        if(current_token_is<WildCardToken>()) {
+            next_token(); // eat '_'
+            exact = false;
+
+            if(current_token_is<LiteralToken>()) {
+                expr = parse_pattern_expr(
+                        current_token_as<LiteralToken>()->get_content());
+                next_token();
+
+                current_token_as<WildCardToken>();
+                next_token();
+            }
+        } else {
+            expr = parse_pattern_expr(
+                    current_token_as<LiteralToken>()->get_content());
+            next_token();
+        }
+
+        current_token_as<CloseBracketToken>();
+        next_token();
+
+        std::shared_ptr<QuerySolver> solver(
+                new SimpleSolverGenerator<PatternSolver>(
+                    new PatternSolver(get_pattern_index(), expr, exact,
+                        get_condition_pool())));
+
+        _query_set.clauses.insert(ClausePtr(new SimplePqlClause(solver, 
+                        new SimplePqlVariableTerm(qvar, get_qvar_slot(qvar)), 
+                        var_term)));
     }
 
+    ExprPtr parse_pattern_expr(const std::string& source) {
+        std::string expr_source = source;
+
+        SimpleParser parser(new IteratorTokenizer<std::string::iterator>(
+                    expr_source.begin(), expr_source.end()));
+
+        ExprPtr expr = parser.parse_expr_ptr();
+
+        try {
+            parser.current_token_as<EOFToken>();
+        } catch(InvalidTokenError& e) {
+            throw PqlParserError();
+        }
+        return expr;
+    }
+
+    /*
+     * with p.procName = v.varName
+     * with s.stmt# = c.value
+     * with c.value = 5
+     * with n = 10                for a prog_line or statement synonym n
+     *
+     * Each side is an attribute of a synonym, a bare statement synonym 
+     * standing for its stmt#, a name literal or an integer. Both sides 
+     * have to be names or both integers. One side may be a placeholder,
+     * which takes a literal of the kind of the other side.
+     */
     void parse_with() {
-        throw PqlParserError(); // not implemented
+        AttributeType left_type, right_type;
+
+        PqlTerm *left_term = parse_attribute_ref(left_type);
+
+        current_token_as<EqualToken>();
+        next_token();
+
+        PqlTerm *right_term = parse_attribute_ref(right_type);
+
+        if(left_term == NULL && right_term == NULL) {
+            throw PqlParserError();
+        } else if(left_term == NULL) {
+            left_term = new_attribute_parameter(right_type, left_type);
+        } else if(right_term == NULL) {
+            right_term = new_attribute_parameter(left_type, right_type);
+        }
+
+        if(is_name_attribute(left_type) != is_name_attribute(right_type)) {
+            delete left_term;
+            delete right_term;
+            throw PqlParserError();
+        }
+
+        std::shared_ptr<QuerySolver> solver(new WithSolver(
+                    get_attribute_index(), left_type, right_type));
+
+        _query_set.clauses.insert(ClausePtr(
+                    new SimplePqlClause(solver, left_term, right_term)));
+    }
+
+    /*
+     * Returns NULL for a placeholder, whose type is only known from the
+     * other side.
+     */
+    PqlTerm* parse_attribute_ref(AttributeType& type) {
+        if(current_token_is<PlaceholderToken>()) {
+            next_token();
+            type = ATTR_COUNT;
+            return NULL;
+        } else if(current_token_is<LiteralToken>()) {
+            type = ATTR_VAR_NAME;
+            std::string name = current_token_as<LiteralToken>()->get_content();
+            next_token();
+            return new SimplePqlConditionTerm(
+                    get_condition_pool()->get_variable_condition(
+                        SimpleVariable(name)));
+
+        } else if(current_token_is<IntegerToken>()) {
+            type = ATTR_VALUE;
+            int value = current_token_as<IntegerToken>()->get_value();
+            next_token();
+            return new SimplePqlConditionTerm(
+                    get_condition_pool()->get_constant_condition(
+                        SimpleConstant(value)));
+        }
+
+        std::string qvar = current_token_as<IdentifierToken>()->get_content();
+        next_token(); // eat synonym
+
+        if(_query_set.predicates.count(qvar) == 0) {
+            throw PqlParserError();
+        }
+        PredicatePtr pred = _query_set.predicates[qvar];
+
+        if(current_token_is<DotToken>()) {
+            next_token(); // eat '.'
+
+            std::string attribute = current_token_as_keyword();
+            next_token(); // eat attribute name
+
+            if(attribute == "stmt") {
+                current_token_as<HashToken>();
+                next_token(); // eat '#'
+                attribute = "stmt#";
+            }
+
+            type = get_attribute_type(pred, attribute);
+        } else if(is_statement_predicate(pred)) {
+            type = ATTR_STMT_NO;
+        } else {
+            throw PqlParserError();
+        }
+
+        return new SimplePqlVariableTerm(qvar, get_qvar_slot(qvar));
+    }
+
+    PqlTerm* new_attribute_parameter(AttributeType other_type, 
+            AttributeType& type) 
+    {
+        if(is_name_attribute(other_type)) {
+            type = ATTR_VAR_NAME;
+            return new_parameter_term(PARAM_NAME);
+        } else {
+            type = ATTR_VALUE;
+            return new_parameter_term(PARAM_VALUE);
+        }
+    }
+
+    AttributeType get_attribute_type(PredicatePtr pred, 
+            const std::string& attribute) 
+    {
+        if(attribute == "procname" && (is_predicate(pred, "procedure") ||
+                    is_predicate(pred, "call")))
+        {
+            return ATTR_PROC_NAME;
+        } else if(attribute == "varname" && is_predicate(pred, "variable")) {
+            return ATTR_VAR_NAME;
+        } else if(attribute == "value" && is_predicate(pred, "constant")) {
+            return ATTR_VALUE;
+        } else if(attribute == "stmt#" && is_statement_predicate(pred)) {
+            return ATTR_STMT_NO;
+        } else {
+            throw PqlParserError();
+        }
     }
     
+    /*
+     * Select <a, v, p>
+     *
+     * Every selected synonym has to be declared, which also catches
+     * misspelled synonyms before any clause is solved.
+     */
     std::shared_ptr<PqlSelector> parse_tuple_selector() {
-        throw PqlParserError(); // not implemented
+        current_token_as<LessThanToken>();
+        next_token(); // eat '<'
+
+        std::shared_ptr<SimplePqlTupleSelector> selector(
+                new SimplePqlTupleSelector());
+
+        while(true) {
+            std::string qvar = current_token_as<
+                    IdentifierToken>()->get_content();
+            next_token(); // eat var name
+
+            if(_query_set.predicates.count(qvar) == 0) {
+                throw PqlParserError();
+            }
+            selector->insert_qvar(qvar);
+
+            if(current_token_is<MoreThanToken>()) {
+                next_token(); // eat '>'
+                return selector;
+            }
+
+            current_token_as<CommaToken>();
+            next_token(); // eat comma
+        }
     }
 
     template <typename Token>
@@ -296,6 +573,61 @@ class SimplePqlParser {
         return _pred_table[name];
     }
 
+    std::shared_ptr<PatternIndex> get_pattern_index() {
+        if(!_pattern_index) {
+            _pattern_index.reset(new PatternIndex(_ast));
+        }
+        return _pattern_index;
+    }
+
+    std::shared_ptr<AttributeIndex> get_attribute_index() {
+        if(!_attribute_index) {
+            _attribute_index.reset(
+                    new AttributeIndex(_ast, get_condition_pool()));
+        }
+        return _attribute_index;
+    }
+
+    /*
+     * Get the slot of a synonym. Synonyms are numbered in the order 
+     * they are first seen, which is their declaration order.
+     */
+    QVarSlot get_qvar_slot(const std::string& qvar) {
+        std::map<std::string, QVarSlot>::iterator it = _qvar_slots.find(qvar);
+        if(it != _qvar_slots.end()) {
+            return it->second;
+        }
+
+        QVarSlot slot = _query_set.qvar_names.size();
+        _qvar_slots[qvar] = slot;
+        _query_set.qvar_names.push_back(qvar);
+        return slot;
+    }
+
+    PqlTerm* new_parameter_term(ParameterKind kind) {
+        _parameter_kinds.push_back(kind);
+        return new SimplePqlParameterTerm(_parameter_kinds.size() - 1, kind);
+    }
+
+    ConditionPoolPtr get_condition_pool() {
+        if(!_condition_pool) {
+            _condition_pool.reset(new ConditionPool(_ast));
+        }
+        return _condition_pool;
+    }
+
+    bool is_predicate(PredicatePtr pred, const std::string& name) {
+        return _pred_table.count(name) > 0 && _pred_table[name] == pred;
+    }
+
+    bool is_statement_predicate(PredicatePtr pred) {
+        return is_predicate(pred, "statement") || 
+            is_predicate(pred, "assignment") ||
+            is_predicate(pred, "while") ||
+            is_predicate(pred, "conditional") ||
+            is_predicate(pred, "call");
+    }
+
     StatementAst* get_statement(int line) {
         if(_line_table.count(line) == 0) {
             throw PqlParserError();
@@ -312,6 +644,13 @@ class SimplePqlParser {
     PredicateTable  _pred_table;
     PqlQuerySet     _query_set;
 
+    std::map<std::string, QVarSlot> _qvar_slots;
+    std::vector<ParameterKind>      _parameter_kinds;
+
+    std::shared_ptr<PatternIndex>   _pattern_index;
+    std::shared_ptr<AttributeIndex> _attribute_index;
+    ConditionPoolPtr                _condition_pool;
+
     SimpleToken     *_current_token;
 };
 
@@ -30,6 +30,8 @@ TokenType MoreThanToken::type("MoreThanToken");
 TokenType SemiColonToken::type("SemiColonToken");
 TokenType CommaToken::type("CommaToken");
 TokenType DotToken::type("DotToken");
+TokenType HashToken::type("HashToken");
+TokenType PlaceholderToken::type("PlaceholderToken");
 TokenType EqualToken::type("EqualToken");
 TokenType EOFToken::type("EOFToken");
 TokenType NewLineToken::type("NewLineToken");
@@ -172,6 +172,28 @@ class DotToken : public SimpleToken {
     static TokenType type;
 };
 
+class HashToken : public SimpleToken {
+  public:
+    virtual TokenType& get_type() {
+        return HashToken::type;
+    }
+
+    static TokenType type;
+};
+
+
+/*
+ * A '?' standing for a literal that is bound when a prepared PQL query
+ * is executed.
+ */
+class PlaceholderToken : public SimpleToken {
+  public:
+    virtual TokenType& get_type() {
+        return PlaceholderToken::type;
+    }
+
+    static TokenType type;
+};
 
 class SemiColonToken : public SimpleToken { 
   public:
@@ -0,0 +1,163 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <functional>
+#include "impl/pattern_index.h"
+#include "simple/util/ast_utils.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+using namespace simple::util;
+
+static size_t hash_combine(size_t seed, size_t value) {
+    return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+ExprHasher::ExprHasher() : _hash(0), _subexprs() { }
+
+size_t ExprHasher::hash(ExprAst *expr) {
+    expr->accept_expr_visitor(this);
+    return _hash;
+}
+
+const ExprHasher::SubExprList& ExprHasher::get_subexprs() {
+    return _subexprs;
+}
+
+void ExprHasher::visit_const(ConstAst *constant) {
+    record(constant, hash_combine('c', 
+                std::hash<int>()(constant->get_constant()->get_int())));
+}
+
+void ExprHasher::visit_variable(VariableAst *var) {
+    record(var, hash_combine('v', 
+                std::hash<std::string>()(var->get_variable()->get_name())));
+}
+
+void ExprHasher::visit_binary_op(BinaryOpAst *bin) {
+    size_t lhs = hash(bin->get_lhs());
+    size_t rhs = hash(bin->get_rhs());
+
+    record(bin, hash_combine(hash_combine(bin->get_op(), lhs), rhs));
+}
+
+void ExprHasher::record(ExprAst *expr, size_t hash) {
+    _hash = hash;
+    _subexprs.push_back(std::make_pair(hash, expr));
+}
+
+PatternIndex::PatternIndex(SimpleRoot ast) :
+    _exprs(), _subexprs(), _assignments(), _var_index(), _empty()
+{
+    for(SimpleRoot::iterator it = ast.begin(); it != ast.end(); ++it) {
+        index_statement_list((*it)->get_statement());
+    }
+}
+
+std::vector<AssignmentAst*> PatternIndex::find_exact(ExprAst *expr) {
+    std::vector<AssignmentAst*> result;
+    find_matches(_exprs, expr, result);
+    return result;
+}
+
+std::vector<AssignmentAst*> PatternIndex::find_subexpr(ExprAst *expr) {
+    std::vector<AssignmentAst*> result;
+    find_matches(_exprs, expr, result);
+    find_matches(_subexprs, expr, result);
+
+    // an assignment can contain the same subexpression more than once
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+const std::vector<AssignmentAst*>& PatternIndex::get_assignments() {
+    return _assignments;
+}
+
+const std::vector<AssignmentAst*>& PatternIndex::get_assignments(
+        SimpleVariable *var) 
+{
+    std::map<SimpleVariable, std::vector<AssignmentAst*> >::iterator it =
+        _var_index.find(*var);
+
+    if(it == _var_index.end()) {
+        return _empty;
+    }
+    return it->second;
+}
+
+void PatternIndex::find_matches(HashIndex& index, ExprAst *expr,
+        std::vector<AssignmentAst*>& result)
+{
+    ExprHasher hasher;
+    HashIndex::iterator it = index.find(hasher.hash(expr));
+
+    if(it == index.end()) {
+        return;
+    }
+
+    for(std::vector<IndexEntry>::iterator eit = it->second.begin();
+            eit != it->second.end(); ++eit)
+    {
+        if(is_same_expr<ExprAst, ExprAst>(eit->second, expr)) {
+            result.push_back(eit->first);
+        }
+    }
+}
+
+void PatternIndex::visit_assignment(AssignmentAst *assign) {
+    _assignments.push_back(assign);
+    _var_index[*assign->get_variable()].push_back(assign);
+
+    ExprHasher hasher;
+    ExprAst *expr = assign->get_expr();
+    hasher.hash(expr);
+
+    const ExprHasher::SubExprList& subexprs = hasher.get_subexprs();
+    for(ExprHasher::SubExprList::const_iterator it = subexprs.begin();
+            it != subexprs.end(); ++it)
+    {
+        HashIndex& index = it->second == expr ? _exprs : _subexprs;
+        index[it->first].push_back(IndexEntry(assign, it->second));
+    }
+}
+
+void PatternIndex::visit_conditional(ConditionalAst *condition) {
+    index_statement_list(condition->get_then_branch());
+    index_statement_list(condition->get_else_branch());
+}
+
+void PatternIndex::visit_while(WhileAst *loop) {
+    index_statement_list(loop->get_body());
+}
+
+void PatternIndex::visit_call(CallAst *call) { }
+
+void PatternIndex::index_statement_list(StatementAst *statement) {
+    while(statement != NULL) {
+        statement->accept_statement_visitor(this);
+        statement = statement->next();
+    }
+}
+
+} // namespace impl
+} // namespace simple
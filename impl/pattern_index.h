@@ -0,0 +1,116 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "simple/ast.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * Computes the structural hash of an expression tree bottom up, Merkle
+ * style: the hash of a binary node is derived from its operator and the
+ * hashes of its two operands, so two subtrees that are the same by 
+ * is_same_expr() always have the same hash.
+ *
+ * The hash of every subtree visited is recorded in get_subexprs(), in
+ * post order, so that a whole expression is indexed in a single pass.
+ */
+class ExprHasher : public ExprVisitor {
+  public:
+    typedef std::vector<std::pair<size_t, ExprAst*> > SubExprList;
+
+    ExprHasher();
+
+    size_t hash(ExprAst *expr);
+
+    const SubExprList& get_subexprs();
+
+    void visit_const(ConstAst *constant);
+    void visit_variable(VariableAst *var);
+    void visit_binary_op(BinaryOpAst *bin);
+
+  private:
+    void record(ExprAst *expr, size_t hash);
+
+    size_t      _hash;
+    SubExprList _subexprs;
+};
+
+/*
+ * Index of the assignments of a program for pattern clauses, built once
+ * when the program is loaded.
+ *
+ * Every subtree of every assignment expression is hashed with ExprHasher
+ * and indexed by its hash, the whole right hand sides separately from 
+ * the proper subtrees. A pattern lookup hashes the pattern once, probes
+ * the index and confirms the candidates with is_same_expr(), so only 
+ * hash collisions ever cost a tree comparison.
+ */
+class PatternIndex : public StatementVisitor {
+  public:
+    PatternIndex(SimpleRoot ast);
+
+    /*
+     * Assignments whose whole right hand side is the given expression.
+     */
+    std::vector<AssignmentAst*> find_exact(ExprAst *expr);
+
+    /*
+     * Assignments with the given expression anywhere in the right hand
+     * side, including the whole right hand side itself.
+     */
+    std::vector<AssignmentAst*> find_subexpr(ExprAst *expr);
+
+    const std::vector<AssignmentAst*>& get_assignments();
+
+    /*
+     * Assignments that modify the given variable.
+     */
+    const std::vector<AssignmentAst*>& get_assignments(SimpleVariable *var);
+
+    void visit_assignment(AssignmentAst *assign);
+    void visit_conditional(ConditionalAst *condition);
+    void visit_while(WhileAst *loop);
+    void visit_call(CallAst *call);
+
+  private:
+    typedef std::pair<AssignmentAst*, ExprAst*>    IndexEntry;
+    typedef std::unordered_map<size_t, std::vector<IndexEntry> > HashIndex;
+
+    void index_statement_list(StatementAst *statement);
+    void find_matches(HashIndex& index, ExprAst *expr, 
+            std::vector<AssignmentAst*>& result);
+
+    HashIndex   _exprs;
+    HashIndex   _subexprs;
+
+    std::vector<AssignmentAst*> _assignments;
+    std::map<SimpleVariable, std::vector<AssignmentAst*> > _var_index;
+    std::vector<AssignmentAst*> _empty;
+};
+
+} // namespace impl
+} // namespace simple
@@ -23,6 +23,7 @@
 #include "simple/condition_set.h"
 #include "simple/predicate.h"
 #include "impl/condition.h"
+#include "impl/condition_pool.h"
 
 namespace simple {
 namespace impl {
@@ -35,6 +36,12 @@ class PredicateGenerator :
   public:
     PredicateGenerator(SimpleRoot ast, Predicate *pred = new Predicate());
 
+    /*
+     * Build the global set out of the canonical conditions of the pool.
+     */
+    PredicateGenerator(SimpleRoot ast, ConditionPoolPtr pool, 
+            Predicate *pred = new Predicate());
+
     const ConditionSet& global_set();
 
     void filter(ConditionSet& conditions);
@@ -56,6 +63,7 @@ class PredicateGenerator :
     void filter_statement_list(StatementAst *statement);
 
     SimpleRoot _ast;
+    ConditionPoolPtr _pool;
     ConditionSet _global_set;
     std::unique_ptr<Predicate> _pred;
 };
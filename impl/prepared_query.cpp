@@ -0,0 +1,177 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include "impl/prepared_query.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+typedef std::chrono::steady_clock Clock;
+
+PreparedQuery::PreparedQuery(const PqlQuerySet& query,
+        const std::vector<ParameterKind>& kinds,
+        const SimpleRoot& ast, const LineTable& line_table,
+        ConditionPoolPtr pool, std::shared_ptr<QueryRewriter> rewriter,
+        double prepare_ms) :
+    _query(query), _kinds(kinds), _ast(ast), _line_table(line_table),
+    _pool(pool), _rewriter(rewriter), _lock(), _stats()
+{ 
+    _stats.prepare_ms = prepare_ms;
+}
+
+size_t PreparedQuery::get_num_parameters() const {
+    return _kinds.size();
+}
+
+ParameterKind PreparedQuery::get_parameter_kind(size_t index) const {
+    return _kinds.at(index);
+}
+
+PqlQuerySet PreparedQuery::bind(const std::vector<QueryParameter>& parameters) {
+    Clock::time_point start = Clock::now();
+
+    if(parameters.size() != _kinds.size()) {
+        throw QueryParameterError();
+    }
+
+    std::vector<ConditionPtr> conditions;
+    for(size_t i = 0; i < parameters.size(); ++i) {
+        conditions.push_back(resolve(_kinds[i], parameters[i]));
+    }
+
+    PqlQuerySet query;
+    query.predicates = _query.predicates;
+    query.selector = _query.selector;
+    query.qvar_names = _query.qvar_names;
+
+    // the clauses without placeholders are shared with the prepared query
+    for(ClauseSet::iterator it = _query.clauses.begin(); 
+            it != _query.clauses.end(); ++it)
+    {
+        SimplePqlClause *clause = dynamic_cast<SimplePqlClause*>(it->get());
+
+        bool is_bound = false;
+        std::shared_ptr<PqlTerm> left_term, right_term;
+        if(clause != NULL) {
+            left_term = bind_term(clause->get_left_term_ptr(), 
+                    conditions, is_bound);
+            right_term = bind_term(clause->get_right_term_ptr(), 
+                    conditions, is_bound);
+        }
+
+        if(is_bound) {
+            query.clauses.insert(ClausePtr(new SimplePqlClause(
+                            clause->get_solver_ptr(), left_term, right_term)));
+        } else {
+            query.clauses.insert(*it);
+        }
+    }
+
+    if(_rewriter) {
+        _rewriter->rewrite(query);
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(
+            Clock::now() - start).count();
+
+    std::lock_guard<std::mutex> guard(_lock);
+    _stats.bind_ms += elapsed;
+    return query;
+}
+
+QueryResult PreparedQuery::execute(QueryEvaluator& evaluator,
+        const std::vector<QueryParameter>& parameters, 
+        CancellationToken *token)
+{
+    PqlQuerySet query = bind(parameters);
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        ++_stats.executions;
+    }
+
+    return evaluator.evaluate(query, token);
+}
+
+PreparedStats PreparedQuery::get_stats() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _stats;
+}
+
+/*
+ * The condition of a value, as the PQL parser would have made it for a
+ * literal at the place of the placeholder.
+ */
+ConditionPtr PreparedQuery::resolve(ParameterKind kind, 
+        const QueryParameter& parameter)
+{
+    switch(kind) {
+        case PARAM_TERM:
+            if(parameter.is_name) {
+                ProcAst *proc = _ast.get_proc(parameter.name);
+                if(proc) {
+                    return _pool->get_proc_condition(proc);
+                } else {
+                    return _pool->get_variable_condition(
+                            SimpleVariable(parameter.name));
+                }
+            } else if(_line_table.count(parameter.value) > 0) {
+                return _pool->get_statement_condition(
+                        _line_table[parameter.value]);
+            }
+        break;
+
+        case PARAM_NAME:
+            if(parameter.is_name) {
+                return _pool->get_variable_condition(
+                        SimpleVariable(parameter.name));
+            }
+        break;
+
+        case PARAM_VALUE:
+            if(!parameter.is_name) {
+                return _pool->get_constant_condition(
+                        SimpleConstant(parameter.value));
+            }
+        break;
+    }
+
+    throw QueryParameterError();
+}
+
+std::shared_ptr<PqlTerm> PreparedQuery::bind_term(
+        std::shared_ptr<PqlTerm> term, 
+        const std::vector<ConditionPtr>& conditions, bool& is_bound)
+{
+    SimplePqlParameterTerm *parameter = 
+        dynamic_cast<SimplePqlParameterTerm*>(term.get());
+
+    if(parameter == NULL) {
+        return term;
+    }
+
+    is_bound = true;
+    return std::shared_ptr<PqlTerm>(new SimplePqlConditionTerm(
+                conditions[parameter->get_index()]));
+}
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,150 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "simple/ast.h"
+#include "simple/query.h"
+#include "impl/cancellation.h"
+#include "impl/condition_pool.h"
+#include "impl/evaluator.h"
+#include "impl/query.h"
+#include "impl/rewriter.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * Thrown when the values bound to a prepared query do not match its 
+ * placeholders, in number or in kind, or name a line that does not exist.
+ */
+class QueryParameterError : public std::exception { };
+
+/*
+ * A value bound to a placeholder: a name, or an integer that is a line
+ * number or a constant depending on the placeholder.
+ */
+struct QueryParameter {
+  public:
+    QueryParameter(const std::string& name) :
+        is_name(true), name(name), value(0)
+    { }
+
+    QueryParameter(const char *name) :
+        is_name(true), name(name), value(0)
+    { }
+
+    QueryParameter(int value) :
+        is_name(false), name(), value(value)
+    { }
+
+    bool        is_name;
+    std::string name;
+    int         value;
+};
+
+struct PreparedStats {
+  public:
+    PreparedStats() : executions(0), prepare_ms(0), bind_ms(0) { }
+
+    /*
+     * The time that executing the prepared query instead of parsing it
+     * every time has saved: the first execution still pays for the 
+     * prepare, and every one pays for its bind. Negative if binding cost
+     * more than parsing would have.
+     */
+    double skipped_ms() const {
+        if(executions == 0) {
+            return 0;
+        }
+        return (executions - 1) * prepare_ms - bind_ms;
+    }
+
+    size_t  executions;
+
+    // time taken to parse the query and look up its solvers, once
+    double  prepare_ms;
+
+    // time taken to bind the parameters, over all executions
+    double  bind_ms;
+};
+
+/*
+ * A PQL query parsed once, with '?' placeholders in place of some of its
+ * literals, e.g.
+ *
+ *   stmt s; Select s such that Modifies(s, ?) with s.stmt# = ?
+ *
+ * The solvers, predicates and pattern matches of the query are looked 
+ * up when it is prepared. Binding the placeholders only substitutes the
+ * conditions of the given values into the clauses that have them, and
+ * rewrites the resulting query, which may have become unsatisfiable.
+ *
+ * Every bind() returns an independent query set, so a prepared query can
+ * be bound and executed from several threads. Like a parsed query, it 
+ * refers to the knowledge base it was prepared on.
+ */
+class PreparedQuery {
+  public:
+    PreparedQuery(const PqlQuerySet& query, 
+            const std::vector<ParameterKind>& kinds,
+            const SimpleRoot& ast, const LineTable& line_table, 
+            ConditionPoolPtr pool, std::shared_ptr<QueryRewriter> rewriter,
+            double prepare_ms);
+
+    size_t get_num_parameters() const;
+
+    ParameterKind get_parameter_kind(size_t index) const;
+
+    /*
+     * The query with the parameters bound to its placeholders, in order.
+     */
+    PqlQuerySet bind(const std::vector<QueryParameter>& parameters);
+
+    QueryResult execute(QueryEvaluator& evaluator, 
+            const std::vector<QueryParameter>& parameters, 
+            CancellationToken *token = NULL);
+
+    PreparedStats get_stats() const;
+
+  private:
+    ConditionPtr resolve(ParameterKind kind, const QueryParameter& parameter);
+
+    std::shared_ptr<PqlTerm> bind_term(std::shared_ptr<PqlTerm> term,
+            const std::vector<ConditionPtr>& conditions, bool& is_bound);
+
+    PqlQuerySet                     _query;
+    std::vector<ParameterKind>      _kinds;
+    SimpleRoot                      _ast;
+    LineTable                       _line_table;
+    ConditionPoolPtr                _pool;
+    std::shared_ptr<QueryRewriter>  _rewriter;
+
+    mutable std::mutex              _lock;
+    PreparedStats                   _stats;
+};
+
+} // namespace impl
+} // namespace simple
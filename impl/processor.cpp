@@ -16,7 +16,11 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <unordered_map>
 #include "impl/processor.h"
+#include "impl/parallel_join.h"
+#include "impl/generic_join.h"
+#include "impl/cancellation.h"
 
 namespace simple {
 namespace impl {
@@ -39,9 +43,13 @@ class SolveClauseVisitorTraits {
 };
 
 void QueryProcessor::solve_clause(PqlClause *clause) {
+    solve_clause(clause, clause->get_solver());
+}
+
+void QueryProcessor::solve_clause(PqlClause *clause, QuerySolver *solver) {
     double_dispatch_pql_terms<QueryProcessor, SolveClauseVisitorTraits>(
             this, clause->get_left_term(), clause->get_right_term(),
-            clause->get_solver());
+            solver);
 }
 
 /*
@@ -67,43 +75,65 @@ void QueryProcessor::solve_clause<PqlVariableTerm, PqlVariableTerm>(
         QuerySolver *solver,
         PqlVariableTerm *term1, PqlVariableTerm *term2)
 {
-    std::string qvar1 = term1->get_query_variable();
-    std::string qvar2 = term2->get_query_variable();
+    QVarSlot qvar1 = get_slot(term1);
+    QVarSlot qvar2 = get_slot(term2);
 
     if(qvar1 == qvar2) {
-        ConditionSet conditions = get_qvar(qvar1);
+        const ConditionSet& conditions = get_qvar(qvar1);
         ConditionSet new_conditions;
 
         for(ConditionSet::iterator cit = conditions.begin();
                 cit != conditions.end(); ++cit)
         {
+            check_cancellation();
+
             if(solver->validate(*cit, *cit)) {
                 new_conditions.insert(*cit);
             }
         }
         _linker->update_results(qvar1, new_conditions);
     } else {
-        ConditionSet conditions1 = get_qvar(qvar1);
-        ConditionSet conditions2 = get_qvar(qvar2);
-
         std::vector<ConditionPair> links;
-
-        for(ConditionSet::iterator cit1 = conditions1.begin();
-                cit1 != conditions1.end(); ++cit1)
-        {
-            for(ConditionSet::iterator cit2 = conditions2.begin();
-                    cit2 != conditions2.end(); ++cit2)
-            {
-                if(solver->validate(*cit1, *cit2)) {
-                    links.push_back(ConditionPair(*cit1, *cit2));
-                }
-            }
-        }
+        collect_links(solver, term1, term2, links);
         _linker->update_links(qvar1, qvar2, links);
     }
 
 }
 
+void QueryProcessor::collect_links(QuerySolver *solver,
+        PqlVariableTerm *term1, PqlVariableTerm *term2,
+        std::vector<ConditionPair>& links)
+{
+    // registering a qvar may grow the linker tables, so both slots are
+    // resolved before taking references to their conditions
+    QVarSlot qvar1 = get_slot(term1);
+    QVarSlot qvar2 = get_slot(term2);
+
+    const ConditionSet& conditions1 = get_qvar(qvar1);
+    const ConditionSet& conditions2 = get_qvar(qvar2);
+
+    KeyedQuerySolver *keyed_solver = solver->as_keyed();
+
+    if(keyed_solver != NULL) {
+        hash_join(keyed_solver, conditions1, conditions2, links);
+    } else {
+        validate_pairs(solver, conditions1, conditions2, links, _pool.get());
+    }
+}
+
+void QueryProcessor::link_qvars(PqlVariableTerm *term1, 
+        PqlVariableTerm *term2, const std::vector<ConditionPair>& links)
+{
+    QVarSlot qvar1 = get_slot(term1);
+    QVarSlot qvar2 = get_slot(term2);
+
+    // initialize both qvars, links outside of their conditions are dropped
+    get_qvar(qvar1);
+    get_qvar(qvar2);
+
+    _linker->update_links(qvar1, qvar2, links);
+}
+
 /*
  * Solver(_, _)
  */
@@ -112,7 +142,9 @@ void QueryProcessor::solve_clause<PqlWildcardTerm, PqlWildcardTerm>(
         QuerySolver *solver,
         PqlWildcardTerm *term1, PqlWildcardTerm *term2)
 {
-
+    if(!solver->has_any()) {
+        _linker->invalidate_state();
+    }
 }
 
 /*
@@ -123,8 +155,13 @@ void QueryProcessor::solve_clause<PqlVariableTerm, PqlConditionTerm>(
         QuerySolver *solver,
         PqlVariableTerm *term1, PqlConditionTerm *term2)
 {
-    ConditionSet left = solver->solve_left(term2->get_condition().get());
-    set_qvar(term1->get_query_variable(), left);
+    QVarSlot qvar = get_slot(term1);
+
+    if(needs_all_results(qvar)) {
+        set_qvar(qvar, solver->solve_left(term2->get_condition().get()));
+    } else {
+        restrict_qvar(qvar, solver->cursor_left(term2->get_condition().get()));
+    }
 }
 
 /*
@@ -135,9 +172,13 @@ void QueryProcessor::solve_clause<PqlConditionTerm, PqlVariableTerm>(
         QuerySolver *solver,
         PqlConditionTerm *term1, PqlVariableTerm *term2)
 {
+    QVarSlot qvar = get_slot(term2);
 
-    ConditionSet right = solver->solve_right(term1->get_condition().get());
-    set_qvar(term2->get_query_variable(), right);
+    if(needs_all_results(qvar)) {
+        set_qvar(qvar, solver->solve_right(term1->get_condition().get()));
+    } else {
+        restrict_qvar(qvar, solver->cursor_right(term1->get_condition().get()));
+    }
 }
 
 /*
@@ -148,15 +189,21 @@ void QueryProcessor::solve_clause<PqlVariableTerm, PqlWildcardTerm>(
         QuerySolver *solver,
         PqlVariableTerm *term1, PqlWildcardTerm *term2)
 {
-    std::string qvar = term1->get_query_variable();
-    ConditionSet left_conditions = get_qvar(qvar);
+    QVarSlot qvar = get_slot(term1);
+    const ConditionSet& left_conditions = get_qvar(qvar);
 
     ConditionSet new_left;
     for(ConditionSet::iterator cit = left_conditions.begin();
             cit != left_conditions.end(); ++cit)
     {
-        if(!solver->solve_right(*cit).is_empty()) {
+        check_cancellation();
+
+        if(solver->has_right(*cit)) {
             new_left.insert(*cit);
+
+            if(is_existential(qvar)) {
+                break;
+            }
         }
     }
 
@@ -171,15 +218,21 @@ void QueryProcessor::solve_clause<PqlWildcardTerm, PqlVariableTerm>(
         QuerySolver *solver,
         PqlWildcardTerm *term1, PqlVariableTerm *term2)
 {
-    std::string qvar = term2->get_query_variable();
-    ConditionSet right_conditions = get_qvar(qvar);
+    QVarSlot qvar = get_slot(term2);
+    const ConditionSet& right_conditions = get_qvar(qvar);
 
     ConditionSet new_right;
     for(ConditionSet::iterator cit = right_conditions.begin();
             cit != right_conditions.end(); ++cit)
     {
-        if(!solver->solve_left(*cit).is_empty()) {
+        check_cancellation();
+
+        if(solver->has_left(*cit)) {
             new_right.insert(*cit);
+
+            if(is_existential(qvar)) {
+                break;
+            }
         }
     }
 
@@ -194,7 +247,7 @@ void QueryProcessor::solve_clause<PqlConditionTerm, PqlWildcardTerm>(
         QuerySolver *solver,
         PqlConditionTerm *term1, PqlWildcardTerm *term2)
 {
-    if(solver->solve_right(term1->get_condition()).is_empty()) {
+    if(!solver->has_right(term1->get_condition())) {
         _linker->invalidate_state();
     }
 }
@@ -207,26 +260,200 @@ void QueryProcessor::solve_clause<PqlWildcardTerm, PqlConditionTerm>(
         QuerySolver *solver,
         PqlWildcardTerm *term1, PqlConditionTerm *term2)
 {
-    if(solver->solve_left(term2->get_condition()).is_empty()) {
+    if(!solver->has_left(term2->get_condition())) {
         _linker->invalidate_state();
     }
 }
 
-ConditionSet QueryProcessor::get_qvar(const std::string& qvar) {
-    return _linker->get_conditions(qvar, get_predicate(qvar));
+void QueryProcessor::hash_join(KeyedQuerySolver *solver,
+        const ConditionSet& left, const ConditionSet& right,
+        std::vector<ConditionPair>& links)
+{
+    typedef std::unordered_map<std::string, std::vector<ConditionPtr> > KeyTable;
+    KeyTable right_keys;
+
+    for(ConditionSet::iterator cit = right.begin(); cit != right.end(); ++cit) {
+        check_cancellation();
+
+        std::string key;
+        if(solver->get_right_key(*cit, key)) {
+            right_keys[key].push_back(*cit);
+        }
+    }
+
+    for(ConditionSet::iterator cit = left.begin(); cit != left.end(); ++cit) {
+        check_cancellation();
+
+        std::string key;
+        if(!solver->get_left_key(*cit, key)) {
+            continue;
+        }
+
+        KeyTable::iterator match = right_keys.find(key);
+        if(match == right_keys.end()) {
+            continue;
+        }
+
+        for(std::vector<ConditionPtr>::iterator rit = match->second.begin();
+                rit != match->second.end(); ++rit)
+        {
+            links.push_back(ConditionPair(*cit, *rit));
+        }
+    }
+}
+
+void QueryProcessor::solve_join(const std::vector<PqlClause*>& clauses) {
+    std::vector<QVarSlot> slots;
+    std::map<QVarSlot, size_t> positions;
+    std::vector<JoinRelation> relations;
+
+    for(std::vector<PqlClause*>::const_iterator it = clauses.begin();
+            it != clauses.end(); ++it)
+    {
+        PqlVariableTerm *left = 
+            dynamic_cast<PqlVariableTerm*>((*it)->get_left_term());
+        PqlVariableTerm *right = 
+            dynamic_cast<PqlVariableTerm*>((*it)->get_right_term());
+        if(left == NULL || right == NULL) {
+            solve_clause(*it);
+            continue;
+        }
+
+        QVarSlot qvars[2] = { get_slot(left), get_slot(right) };
+        if(qvars[0] == qvars[1]) {
+            solve_clause(*it);
+            continue;
+        }
+
+        size_t sides[2];
+        for(size_t i = 0; i < 2; ++i) {
+            QVarSlot slot = qvars[i];
+            if(positions.count(slot) == 0) {
+                positions[slot] = slots.size();
+                slots.push_back(slot);
+            }
+            sides[i] = positions[slot];
+        }
+
+        relations.push_back(JoinRelation((*it)->get_solver(), sides[0], sides[1]));
+    }
+
+    std::vector<ConditionSet> domains;
+    for(size_t i = 0; i < slots.size(); ++i) {
+        domains.push_back(get_qvar(slots[i]));
+    }
+
+    GenericJoin join(domains, relations);
+    if(join.run() == 0) {
+        _linker->invalidate_state();
+        return;
+    }
+
+    for(size_t i = 0; i < relations.size(); ++i) {
+        std::vector<ConditionPair> links;
+        join.get_links(i, links);
+        _linker->update_links(slots[relations[i].left], 
+                slots[relations[i].right], links);
+    }
+}
+
+const ConditionSet& QueryProcessor::get_qvar(const std::string& qvar) {
+    return get_qvar(register_qvar(qvar));
+}
+
+const ConditionSet& QueryProcessor::get_qvar(QVarSlot qvar) {
+    return _linker->get_conditions(qvar, _slot_predicates[qvar]);
 }
 
 void QueryProcessor::set_qvar(const std::string& qvar, 
         const ConditionSet& conditions)
 {
+    set_qvar(register_qvar(qvar), conditions);
+}
+
+void QueryProcessor::set_qvar(QVarSlot qvar, const ConditionSet& conditions) {
     // Initialize the qvar first
     if(!_linker->is_initialized(qvar)) {
-        _linker->update_results(qvar, get_predicate(qvar)->global_set());
+        _linker->update_results(qvar, _slot_predicates[qvar]->global_set());
     }
 
     _linker->update_results(qvar, conditions);
 }
 
+void QueryProcessor::set_existential(const std::string& qvar) {
+    set_existential(register_qvar(qvar));
+}
+
+void QueryProcessor::set_existential(QVarSlot qvar) {
+    if(qvar >= _existential.size()) {
+        _existential.resize(qvar + 1, false);
+    }
+    _existential[qvar] = true;
+}
+
+bool QueryProcessor::is_existential(QVarSlot qvar) {
+    return qvar < _existential.size() && _existential[qvar];
+}
+
+/*
+ * A solve has to be built in full for a qvar that has no conditions yet,
+ * unless any one of them will do.
+ */
+bool QueryProcessor::needs_all_results(QVarSlot qvar) {
+    return !_linker->is_initialized(qvar) && !is_existential(qvar);
+}
+
+/*
+ * Keep the conditions of the qvar that the cursor yields. The cursor is
+ * only pulled until it has yielded every current condition of the qvar,
+ * or a single one of an existential qvar.
+ */
+void QueryProcessor::restrict_qvar(QVarSlot qvar, ConditionCursorPtr cursor) {
+    const ConditionSet& conditions = get_qvar(qvar);
+    size_t limit = is_existential(qvar) ? 1 : conditions.get_size();
+
+    ConditionSet new_conditions;
+    size_t found = 0;
+    ConditionPtr condition(NULL);
+
+    while(found < limit && cursor->next(condition)) {
+        check_cancellation();
+
+        if(conditions.has_element(condition)) {
+            new_conditions.insert(condition);
+            ++found;
+        }
+    }
+
+    _linker->update_results(qvar, new_conditions);
+}
+
+QVarSlot QueryProcessor::get_slot(PqlVariableTerm *term) {
+    QVarSlot slot = term->get_slot();
+    if(slot < _term_slots.size()) {
+        return _term_slots[slot];
+    }
+
+    // a term that was not created by the parser
+    return register_qvar(term->get_query_variable());
+}
+
+QVarSlot QueryProcessor::get_slot(const std::string& qvar) {
+    return register_qvar(qvar);
+}
+
+QVarSlot QueryProcessor::register_qvar(const std::string& qvar) {
+    QVarSlot slot = _linker->get_slot(qvar);
+
+    if(slot >= _slot_predicates.size()) {
+        _slot_predicates.resize(slot + 1, NULL);
+    }
+    if(_slot_predicates[slot] == NULL) {
+        _slot_predicates[slot] = get_predicate(qvar);
+    }
+    return slot;
+}
+
 SimplePredicate* QueryProcessor::get_predicate(const std::string& qvar) 
 {
     if(_predicates.count(qvar) > 0) {
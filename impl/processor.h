@@ -18,23 +18,39 @@
 
 #pragma once
 
+#include <vector>
 #include "simple/solver.h"
 #include "simple/predicate.h"
 #include "simple/query.h"
 #include "simple/linker.h"
 #include "simple/util/query_utils.h"
+#include "impl/thread_pool.h"
 
 namespace simple {
 namespace impl {
 
 class QueryProcessor {
   public:
+    /*
+     * qvar_names are the synonyms of the query by slot, as assigned by
+     * the parser. The variable terms carrying these slots are resolved 
+     * to linker slots by array lookups; terms without a slot fall back 
+     * to looking up their name.
+     */
     QueryProcessor(std::shared_ptr<QueryLinker> linker,
             const std::map<std::string, PredicatePtr>& predicates,
-            PredicatePtr wildcard_pred) :
+            PredicatePtr wildcard_pred,
+            ThreadPoolPtr pool = ThreadPoolPtr(),
+            const std::vector<std::string>& qvar_names = 
+                std::vector<std::string>()) :
         _linker(linker), _predicates(predicates), 
-        _wildcard_pred(wildcard_pred)
-    { }
+        _wildcard_pred(wildcard_pred), _pool(pool),
+        _term_slots(), _slot_predicates(), _existential()
+    { 
+        for(size_t i = 0; i < qvar_names.size(); ++i) {
+            _term_slots.push_back(register_qvar(qvar_names[i]));
+        }
+    }
 
     std::shared_ptr<QueryLinker> get_linker() {
         return _linker;
@@ -42,21 +58,102 @@ class QueryProcessor {
 
     void solve_clause(PqlClause *clause);
 
+    /*
+     * Solve the clause with another solver in place of the clause's own,
+     * e.g. a wrapper that instruments the solver calls.
+     */
+    void solve_clause(PqlClause *clause, QuerySolver *solver);
+
+    /*
+     * Solve two variable clauses whose query variables form a cycle 
+     * together, with a GenericJoin over the current conditions of the
+     * variables. Only the links that are part of a complete answer are
+     * handed to the linker, so no removals cascade through it. Clauses
+     * that do not have two distinct query variables are solved on their
+     * own.
+     */
+    void solve_join(const std::vector<PqlClause*>& clauses);
+
+    /*
+     * All pairs of the current conditions of two distinct query variables
+     * that the solver relates.
+     */
+    void collect_links(QuerySolver *solver, 
+            PqlVariableTerm *term1, PqlVariableTerm *term2,
+            std::vector<ConditionPair>& links);
+
+    /*
+     * Link two distinct query variables by pairs found beforehand, e.g. 
+     * by collect_links() on another processor. Pairs whose conditions
+     * are no longer in the query variables are ignored.
+     */
+    void link_qvars(PqlVariableTerm *term1, PqlVariableTerm *term2,
+            const std::vector<ConditionPair>& links);
+
     template <typename Term1, typename Term2>
     void solve_clause(QuerySolver *solver, Term1 *term1, Term2 *term2) {
 
     }
 
-    ConditionSet get_qvar(const std::string& qvar);
+    /*
+     * A view of the current conditions of a qvar, initializing it with
+     * the global set of its predicate first if needed.
+     */
+    const ConditionSet& get_qvar(const std::string& qvar);
+    const ConditionSet& get_qvar(QVarSlot qvar);
 
     void set_qvar(const std::string& qvar, const ConditionSet& conditions);
+    void set_qvar(QVarSlot qvar, const ConditionSet& conditions);
 
     SimplePredicate* get_predicate(const std::string& qvar);
 
+    /*
+     * The linker slot of the query variable of a term.
+     */
+    QVarSlot get_slot(PqlVariableTerm *term);
+    QVarSlot get_slot(const std::string& qvar);
+
+    /*
+     * Mark a qvar whose conditions only matter for whether there are any,
+     * e.g. one that is neither selected nor used by another clause. 
+     * Solving a clause then keeps a single condition of the qvar, and 
+     * stops generating results once it has found one.
+     */
+    void set_existential(const std::string& qvar);
+    void set_existential(QVarSlot qvar);
+    bool is_existential(QVarSlot qvar);
+
   private:
+    bool needs_all_results(QVarSlot qvar);
+
+    void restrict_qvar(QVarSlot qvar, ConditionCursorPtr cursor);
+
+    /*
+     * Link the conditions of two query variables that have the same key
+     * under a keyed solver, in time linear in the number of conditions
+     * and links.
+     */
+    void hash_join(KeyedQuerySolver *solver,
+            const ConditionSet& left, const ConditionSet& right,
+            std::vector<ConditionPair>& links);
+
+    /*
+     * Get the linker slot of a qvar and remember its predicate.
+     */
+    QVarSlot register_qvar(const std::string& qvar);
+
     std::shared_ptr<QueryLinker>        _linker;
     std::map<std::string, PredicatePtr> _predicates;
     PredicatePtr    _wildcard_pred;
+    ThreadPoolPtr   _pool;
+
+    // the linker slot of every parser slot, and the predicate of every
+    // linker slot
+    std::vector<QVarSlot>           _term_slots;
+    std::vector<SimplePredicate*>   _slot_predicates;
+
+    // by linker slot
+    std::vector<bool>               _existential;
 };
 
 /*
@@ -74,7 +171,11 @@ void QueryProcessor::solve_clause<PqlConditionTerm, PqlConditionTerm>(
  *
  * This is a solve both query variable query. It is the most complicated
  * among all. The only correct way to solve this is go through all
- * possible combinations and validate the combinations.
+ * possible combinations and validate the combinations. If the processor
+ * has a thread pool, large combinations are validated in parallel.
+ *
+ * The exception is a keyed solver, such as the solver of a with clause,
+ * for which the two query variables are hash joined on their keys.
  */
 template <>
 void QueryProcessor::solve_clause<PqlVariableTerm, PqlVariableTerm>(
@@ -84,8 +185,8 @@ void QueryProcessor::solve_clause<PqlVariableTerm, PqlVariableTerm>(
 /*
  * Solver(_, _)
  *
- * The way to solve this both wildcard term clause is not clear at 
- * the moment, so it is not implemented and an exception is thrown.
+ * This only checks whether the relation holds for any pair at all, by
+ * calling Solver->has_any().
  */
 template <>
 void QueryProcessor::solve_clause<PqlWildcardTerm, PqlWildcardTerm>(
@@ -95,7 +196,9 @@ void QueryProcessor::solve_clause<PqlWildcardTerm, PqlWildcardTerm>(
 /*
  * Solver(qvar, condition)
  *
- * This is a solve left query. Simply call Solver->solve_left().
+ * This is a solve left query. Call Solver->solve_left() if the qvar has
+ * no conditions yet; otherwise pull from Solver->cursor_left() only until
+ * every current condition of the qvar has been seen.
  */
 template <>
 void QueryProcessor::solve_clause<PqlVariableTerm, PqlConditionTerm>(
@@ -105,7 +208,9 @@ void QueryProcessor::solve_clause<PqlVariableTerm, PqlConditionTerm>(
 /*
  * Solver(condition, qvar)
  *
- * This is a solve right query. Simply call Solver->solve_right().
+ * This is a solve right query. Call Solver->solve_right() if the qvar has
+ * no conditions yet; otherwise pull from Solver->cursor_right() only 
+ * until every current condition of the qvar has been seen.
  */
 template <>
 void QueryProcessor::solve_clause<PqlConditionTerm, PqlVariableTerm>(
@@ -116,9 +221,8 @@ void QueryProcessor::solve_clause<PqlConditionTerm, PqlVariableTerm>(
  * Solver(qvar, _)
  *
  * This is to find all possible left conditions that have results at
- * the right. Call Solver->solve_right() on all possible conditions in
- * left qvar and if the result condition set is non-empty, keep that
- * condition.
+ * the right. Call Solver->has_right() on all possible conditions in
+ * left qvar and keep the conditions for which it is true.
  */
 template <>
 void QueryProcessor::solve_clause<PqlVariableTerm, PqlWildcardTerm>(
@@ -129,9 +233,8 @@ void QueryProcessor::solve_clause<PqlVariableTerm, PqlWildcardTerm>(
  * Solver(_, qvar)
  *
  * This is to find all possible right conditions that have results at
- * the left. Call Solver->solve_left() on all possible conditions in
- * right qvar and if the result condition set is non-empty, keep that
- * condition.
+ * the left. Call Solver->has_left() on all possible conditions in
+ * right qvar and keep the conditions for which it is true.
  */
 template <>
 void QueryProcessor::solve_clause<PqlWildcardTerm, PqlVariableTerm>(
@@ -141,8 +244,8 @@ void QueryProcessor::solve_clause<PqlWildcardTerm, PqlVariableTerm>(
 /*
  * Solver(condition, _)
  *
- * This is also a validate query. Call Solver->solve_right() and see
- * if the returned condition set is non-empty.
+ * This is also a validate query. Call Solver->has_right() on the
+ * condition.
  */
 template <>
 void QueryProcessor::solve_clause<PqlConditionTerm, PqlWildcardTerm>(
@@ -152,8 +255,8 @@ void QueryProcessor::solve_clause<PqlConditionTerm, PqlWildcardTerm>(
 /*
  * Solver(_, condition)
  *
- * This is also a validate query. Call Solver->solve_left() and see
- * if the returned condition set is non-empty.
+ * This is also a validate query. Call Solver->has_left() on the
+ * condition.
  */
 template <>
 void QueryProcessor::solve_clause<PqlWildcardTerm, PqlConditionTerm>(
@@ -0,0 +1,239 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include "impl/profiler.h"
+#include "simple/util/condition_utils.h"
+#include "simple/util/json_utils.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+using namespace simple::util;
+
+CountingSolver::CountingSolver(QuerySolver *solver) : 
+    _solver(solver), _validate_count(0), 
+    _solve_left_count(0), _solve_right_count(0), _probe_count(0)
+{ }
+
+ConditionSet CountingSolver::solve_left(SimpleCondition *right_condition) {
+    ++_solve_left_count;
+    return _solver->solve_left(right_condition);
+}
+
+ConditionSet CountingSolver::solve_right(SimpleCondition *left_condition) {
+    ++_solve_right_count;
+    return _solver->solve_right(left_condition);
+}
+
+bool CountingSolver::validate(SimpleCondition *left_condition, 
+        SimpleCondition *right_condition)
+{
+    ++_validate_count;
+    return _solver->validate(left_condition, right_condition);
+}
+
+ConditionCursorPtr CountingSolver::cursor_left(
+        SimpleCondition *right_condition) 
+{
+    ++_solve_left_count;
+    return _solver->cursor_left(right_condition);
+}
+
+ConditionCursorPtr CountingSolver::cursor_right(
+        SimpleCondition *left_condition) 
+{
+    ++_solve_right_count;
+    return _solver->cursor_right(left_condition);
+}
+
+bool CountingSolver::has_right(SimpleCondition *left_condition) {
+    ++_probe_count;
+    return _solver->has_right(left_condition);
+}
+
+bool CountingSolver::has_left(SimpleCondition *right_condition) {
+    ++_probe_count;
+    return _solver->has_left(right_condition);
+}
+
+bool CountingSolver::has_any() {
+    ++_probe_count;
+    return _solver->has_any();
+}
+
+KeyedQuerySolver* CountingSolver::as_keyed() {
+    return _solver->as_keyed();
+}
+
+size_t CountingSolver::get_validate_count() const {
+    return _validate_count;
+}
+
+size_t CountingSolver::get_solve_left_count() const {
+    return _solve_left_count;
+}
+
+size_t CountingSolver::get_solve_right_count() const {
+    return _solve_right_count;
+}
+
+size_t CountingSolver::get_probe_count() const {
+    return _probe_count;
+}
+
+class TermPrinter : public PqlTermVisitor {
+  public:
+    TermPrinter() : _kind(), _text(), _qvar() { }
+
+    void visit_condition_term(PqlConditionTerm *term) {
+        _kind = "condition";
+        _text = condition_to_string(term->get_condition().get());
+    }
+
+    void visit_variable_term(PqlVariableTerm *term) {
+        _kind = "qvar";
+        _text = term->get_query_variable();
+        _qvar = _text;
+    }
+
+    void visit_wildcard_term(PqlWildcardTerm *term) {
+        _kind = "_";
+        _text = "_";
+    }
+
+    std::string get_kind() {
+        return _kind;
+    }
+
+    std::string get_text() {
+        return _text;
+    }
+
+    std::string get_qvar() {
+        return _qvar;
+    }
+
+  private:
+    std::string _kind;
+    std::string _text;
+    std::string _qvar;
+};
+
+std::string clause_form(PqlClause *clause) {
+    TermPrinter left;
+    TermPrinter right;
+    clause->get_left_term()->accept_pql_term_visitor(&left);
+    clause->get_right_term()->accept_pql_term_visitor(&right);
+
+    return "Solver(" + left.get_kind() + ", " + right.get_kind() + ")";
+}
+
+std::string term_to_string(PqlTerm *term) {
+    TermPrinter printer;
+    term->accept_pql_term_visitor(&printer);
+    return printer.get_text();
+}
+
+std::vector<std::string> clause_qvars(PqlClause *clause) {
+    TermPrinter left;
+    TermPrinter right;
+    clause->get_left_term()->accept_pql_term_visitor(&left);
+    clause->get_right_term()->accept_pql_term_visitor(&right);
+
+    std::vector<std::string> result;
+    if(!left.get_qvar().empty()) {
+        result.push_back(left.get_qvar());
+    }
+    if(!right.get_qvar().empty() && right.get_qvar() != left.get_qvar()) {
+        result.push_back(right.get_qvar());
+    }
+    return result;
+}
+
+QueryProfile::QueryProfile() : 
+    _clauses(), _total_time_ms(0), _timed_out(false)
+{ }
+
+void QueryProfile::add_clause(const ClauseProfile& clause) {
+    _clauses.push_back(clause);
+}
+
+const std::vector<ClauseProfile>& QueryProfile::get_clauses() const {
+    return _clauses;
+}
+
+void QueryProfile::set_total_time(double total_time_ms) {
+    _total_time_ms = total_time_ms;
+}
+
+void QueryProfile::set_timed_out(bool timed_out) {
+    _timed_out = timed_out;
+}
+
+std::string QueryProfile::to_json() const {
+    std::stringstream out;
+
+    out << "{\"status\": " << json_string(_timed_out ? "timeout" : "ok")
+        << ", \"total_time_ms\": " << _total_time_ms
+        << ", \"clauses\": [";
+
+    for(std::vector<ClauseProfile>::const_iterator it = _clauses.begin();
+            it != _clauses.end(); ++it)
+    {
+        if(it != _clauses.begin()) {
+            out << ", ";
+        }
+
+        out << "{\"solver\": " << json_string(it->solver)
+            << ", \"form\": " << json_string(it->form)
+            << ", \"left\": " << json_string(it->left_term)
+            << ", \"right\": " << json_string(it->right_term)
+            << ", \"batched\": " << (it->batched ? "true" : "false")
+            << ", \"time_ms\": " << it->wall_time_ms
+            << ", \"calls\": {\"validate\": " << it->validate_calls
+            << ", \"solve_left\": " << it->solve_left_calls
+            << ", \"solve_right\": " << it->solve_right_calls 
+            << ", \"probe\": " << it->probe_calls << "}"
+            << ", \"domains\": [";
+
+        for(std::vector<DomainProfile>::const_iterator dit = it->domains.begin();
+                dit != it->domains.end(); ++dit)
+        {
+            if(dit != it->domains.begin()) {
+                out << ", ";
+            }
+
+            out << "{\"qvar\": " << json_string(dit->qvar)
+                << ", \"before\": " << dit->size_before
+                << ", \"after\": " << dit->size_after << "}";
+        }
+
+        out << "], \"links_created\": " << it->links_created
+            << ", \"conditions_removed\": " << it->conditions_removed
+            << ", \"conditions_cascaded\": " << it->conditions_cascaded 
+            << "}";
+    }
+
+    out << "]}";
+    return out.str();
+}
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,158 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "simple/solver.h"
+#include "simple/query.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * A solver wrapper that counts the calls made to the wrapped solver.
+ * The counters are atomic as the solver may be called from the pool
+ * during a parallel join.
+ */
+class CountingSolver : public QuerySolver {
+  public:
+    CountingSolver(QuerySolver *solver);
+
+    ConditionSet solve_left(SimpleCondition *right_condition);
+    ConditionSet solve_right(SimpleCondition *left_condition);
+    bool validate(SimpleCondition *left_condition, 
+            SimpleCondition *right_condition);
+
+    // counted as solve_left() and solve_right() calls
+    ConditionCursorPtr cursor_left(SimpleCondition *right_condition);
+    ConditionCursorPtr cursor_right(SimpleCondition *left_condition);
+
+    bool has_right(SimpleCondition *left_condition);
+    bool has_left(SimpleCondition *right_condition);
+    bool has_any();
+
+    // not counted, the keys are read from the wrapped solver
+    KeyedQuerySolver* as_keyed();
+
+    size_t get_validate_count() const;
+    size_t get_solve_left_count() const;
+    size_t get_solve_right_count() const;
+
+    // calls to has_right(), has_left() and has_any()
+    size_t get_probe_count() const;
+
+  private:
+    QuerySolver *_solver;
+    std::atomic<size_t> _validate_count;
+    std::atomic<size_t> _solve_left_count;
+    std::atomic<size_t> _solve_right_count;
+    std::atomic<size_t> _probe_count;
+};
+
+struct DomainProfile {
+  public:
+    DomainProfile(const std::string& qvar, size_t size_before) :
+        qvar(qvar), size_before(size_before), size_after(0)
+    { }
+
+    std::string qvar;
+    size_t      size_before;
+    size_t      size_after;
+};
+
+/*
+ * Execution profile of a single clause.
+ */
+struct ClauseProfile {
+  public:
+    ClauseProfile() :
+        solver(), form(), left_term(), right_term(), batched(false),
+        wall_time_ms(0),
+        validate_calls(0), solve_left_calls(0), solve_right_calls(0),
+        probe_calls(0),
+        domains(), links_created(0), conditions_removed(0),
+        conditions_cascaded(0)
+    { }
+
+    std::string solver;
+
+    // the solve_clause<Term1, Term2> specialization, e.g. Solver(qvar, _)
+    std::string form;
+
+    std::string left_term;
+    std::string right_term;
+
+    // solved once for the whole batch by the batch planner, whose solver
+    // calls are not counted here
+    bool        batched;
+
+    double      wall_time_ms;
+
+    size_t      validate_calls;
+    size_t      solve_left_calls;
+    size_t      solve_right_calls;
+    size_t      probe_calls;
+
+    // sizes of the query variables in the clause before and after solving
+    std::vector<DomainProfile> domains;
+
+    size_t      links_created;
+    size_t      conditions_removed;
+    size_t      conditions_cascaded;
+};
+
+class QueryProfile {
+  public:
+    QueryProfile();
+
+    void add_clause(const ClauseProfile& clause);
+
+    const std::vector<ClauseProfile>& get_clauses() const;
+
+    void set_total_time(double total_time_ms);
+
+    void set_timed_out(bool timed_out);
+
+    std::string to_json() const;
+
+  private:
+    std::vector<ClauseProfile>  _clauses;
+    double                      _total_time_ms;
+    bool                        _timed_out;
+};
+
+/*
+ * Name of the evaluation form used for the clause, following the names
+ * of the solve_clause() specializations in QueryProcessor.
+ */
+std::string clause_form(PqlClause *clause);
+
+std::string term_to_string(PqlTerm *term);
+
+/*
+ * Names of the query variables used in the clause, without duplicates.
+ */
+std::vector<std::string> clause_qvars(PqlClause *clause);
+
+} // namespace impl
+} // namespace simple
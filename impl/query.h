@@ -18,8 +18,10 @@
 
 #pragma once
 
+#include <sstream>
 #include "simple/query.h"
 #include "simple/solver.h"
+#include "impl/condition.h"
 
 namespace simple {
 namespace impl {
@@ -46,16 +48,79 @@ class SimplePqlConditionTerm : public PqlConditionTerm {
     ConditionPtr _condition;
 };
 
+/*
+ * The values a placeholder of a prepared query can be bound to, which
+ * depends on where it stands:
+ *
+ * PARAM_TERM   argument of a relation, a name or a line number
+ * PARAM_NAME   variable of a pattern or name attribute of a with clause
+ * PARAM_VALUE  integer attribute of a with clause
+ */
+enum ParameterKind {
+    PARAM_TERM,
+    PARAM_NAME,
+    PARAM_VALUE
+};
+
+/*
+ * A '?' placeholder of a prepared query. Until it is bound, and replaced
+ * by a condition term, it stands for a variable named after its index
+ * that no program can have, so that the clauses of distinct placeholders
+ * are never taken as the same clause.
+ */
+class SimplePqlParameterTerm : public PqlConditionTerm {
+  public:
+    SimplePqlParameterTerm(size_t index, ParameterKind kind) :
+        _index(index), _kind(kind), 
+        _condition(new SimpleVariableCondition(
+                    SimpleVariable(placeholder_name(index))))
+    { }
+
+    ConditionPtr get_condition() {
+        return _condition;
+    }
+
+    size_t get_index() const {
+        return _index;
+    }
+
+    ParameterKind get_kind() const {
+        return _kind;
+    }
+
+    void accept_pql_term_visitor(PqlTermVisitor *visitor) {
+        visitor->visit_condition_term(this);
+    }
+
+    ~SimplePqlParameterTerm() { }
+
+  private:
+    static std::string placeholder_name(size_t index) {
+        std::stringstream name;
+        name << "?" << index;
+        return name.str();
+    }
+
+    size_t          _index;
+    ParameterKind   _kind;
+    ConditionPtr    _condition;
+};
+
 class SimplePqlVariableTerm : public PqlVariableTerm {
   public:
-    SimplePqlVariableTerm(const std::string& qvar) :
-        _qvar(qvar)
+    SimplePqlVariableTerm(const std::string& qvar, 
+            QVarSlot slot = NO_QVAR_SLOT) :
+        _qvar(qvar), _slot(slot)
     { }
 
     std::string get_query_variable() {
         return _qvar;
     }
 
+    QVarSlot get_slot() {
+        return _slot;
+    }
+
     void accept_pql_term_visitor(PqlTermVisitor *visitor) {
         visitor->visit_variable_term(this);
     }
@@ -64,6 +129,7 @@ class SimplePqlVariableTerm : public PqlVariableTerm {
 
   private:
     std::string _qvar;
+    QVarSlot    _slot;
 };
 
 class SimplePqlWildcardTerm : public PqlWildcardTerm {
@@ -85,10 +151,33 @@ class SimplePqlClause : public PqlClause {
         _right_term(right_term)
     { }
 
+    SimplePqlClause(std::shared_ptr<QuerySolver> solver,
+            std::shared_ptr<PqlTerm> left_term, 
+            std::shared_ptr<PqlTerm> right_term) :
+        _solver(solver), _left_term(left_term), 
+        _right_term(right_term)
+    { }
+
     QuerySolver* get_solver() {
         return _solver.get();
     }
 
+    /*
+     * The shared parts of the clause, for building clauses that only 
+     * differ in one term.
+     */
+    std::shared_ptr<QuerySolver> get_solver_ptr() {
+        return _solver;
+    }
+
+    std::shared_ptr<PqlTerm> get_left_term_ptr() {
+        return _left_term;
+    }
+
+    std::shared_ptr<PqlTerm> get_right_term_ptr() {
+        return _right_term;
+    }
+
     PqlTerm* get_left_term() {
         return _left_term.get();
     }
@@ -146,6 +235,10 @@ class SimplePqlTupleSelector : public PqlTupleSelector {
         _tuples.push_back(qvar_name);
     }
 
+    void accept_pql_selector_visitor(PqlSelectorVisitor *visitor) {
+        visitor->visit_tuple(this);
+    }
+
   private:
     std::vector<std::string> _tuples;
 };
@@ -78,7 +78,7 @@ class SimpleQueryVariable : public QueryVariable {
         return _is_bounded;
     }
 
-    ConditionSet& get_conditions() {
+    const ConditionSet& get_conditions() {
         if(!_is_bounded) {
             _set = _pred->global_set();
             _is_bounded = true;
@@ -0,0 +1,369 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include "impl/result_cache.h"
+#include "impl/solvers/pattern.h"
+#include "impl/solvers/with.h"
+#include "simple/util/condition_utils.h"
+#include "simple/util/query_utils.h"
+#include "simple/util/solver_generator.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+using namespace simple::util;
+
+// rough per node overheads of the containers holding a result
+const size_t ENTRY_OVERHEAD = 128;
+const size_t CONDITION_SIZE = 48;
+const size_t TUPLE_NODE_SIZE = 64;
+
+QueryResultCache::QueryResultCache(size_t budget_bytes) :
+    _lock(), _entries(), _index(), _budget(budget_bytes), _memory(0),
+    _generation(0), _stats()
+{ }
+
+bool QueryResultCache::lookup(size_t generation, const std::string& key,
+        QueryResult& result)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    set_generation(generation);
+
+    std::unordered_map<std::string, EntryList::iterator>::iterator it =
+        _index.find(key);
+
+    if(it == _index.end()) {
+        ++_stats.misses;
+        return false;
+    }
+
+    // move the entry to the front of the LRU list
+    _entries.splice(_entries.begin(), _entries, it->second);
+
+    result = it->second->result;
+    ++_stats.hits;
+    return true;
+}
+
+void QueryResultCache::insert(size_t generation, const std::string& key,
+        const QueryResult& result)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    set_generation(generation);
+
+    size_t size = estimate_size(key, result);
+    if(size > _budget) {
+        return;
+    }
+
+    std::unordered_map<std::string, EntryList::iterator>::iterator it =
+        _index.find(key);
+
+    if(it != _index.end()) {
+        _memory -= it->second->size;
+        _entries.erase(it->second);
+        _index.erase(it);
+    }
+
+    _entries.push_front(Entry(key, result, size));
+    _index[key] = _entries.begin();
+    _memory += size;
+    ++_stats.insertions;
+
+    evict();
+}
+
+void QueryResultCache::invalidate() {
+    std::lock_guard<std::mutex> guard(_lock);
+    clear();
+}
+
+void QueryResultCache::set_budget(size_t budget_bytes) {
+    std::lock_guard<std::mutex> guard(_lock);
+    _budget = budget_bytes;
+    evict();
+}
+
+size_t QueryResultCache::get_budget() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _budget;
+}
+
+size_t QueryResultCache::get_num_entries() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _entries.size();
+}
+
+size_t QueryResultCache::get_memory() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _memory;
+}
+
+ResultCacheStats QueryResultCache::get_stats() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _stats;
+}
+
+size_t QueryResultCache::estimate_size(const std::string& key,
+        const QueryResult& result)
+{
+    size_t arity = 0;
+    if(!result.tuples.empty()) {
+        for(ConditionTuplePtr tuple = *result.tuples.begin(); tuple; 
+                tuple = tuple->next())
+        {
+            ++arity;
+        }
+    }
+
+    return ENTRY_OVERHEAD + 2 * key.size() + result.profile.size() +
+        result.conditions.get_size() * CONDITION_SIZE +
+        result.tuples.size() * arity * TUPLE_NODE_SIZE;
+}
+
+void QueryResultCache::set_generation(size_t generation) {
+    if(generation != _generation) {
+        clear();
+        _generation = generation;
+    }
+}
+
+void QueryResultCache::clear() {
+    if(!_entries.empty()) {
+        ++_stats.invalidations;
+    }
+
+    _entries.clear();
+    _index.clear();
+    _memory = 0;
+}
+
+void QueryResultCache::evict() {
+    while(_memory > _budget && !_entries.empty()) {
+        Entry& last = _entries.back();
+        _memory -= last.size;
+        _index.erase(last.key);
+        _entries.pop_back();
+        ++_stats.evictions;
+    }
+}
+
+/*
+ * Prints the terms of a clause, with the query variables replaced by 
+ * the names given in the renaming table. Variables that have not been
+ * renamed yet are printed as their predicate only, which gives the 
+ * shape of a clause.
+ */
+class CanonicalTermPrinter : public PqlTermVisitor {
+  public:
+    CanonicalTermPrinter(PqlQuerySet& query, 
+            std::map<std::string, std::string>& renames, bool rename) :
+        _query(query), _renames(renames), _rename(rename), _result()
+    { }
+
+    void visit_condition_term(PqlConditionTerm *term) {
+        _result = condition_to_string(term->get_condition().get());
+    }
+
+    void visit_variable_term(PqlVariableTerm *term) {
+        std::string qvar = term->get_query_variable();
+
+        if(_renames.count(qvar) > 0) {
+            _result = _renames[qvar];
+        } else if(_rename) {
+            _result = rename_qvar(_query, _renames, qvar);
+        } else {
+            _result = "?" + predicate_name(_query, qvar);
+        }
+    }
+
+    void visit_wildcard_term(PqlWildcardTerm *term) {
+        _result = "_";
+    }
+
+    std::string print(PqlTerm *term) {
+        term->accept_pql_term_visitor(this);
+        return _result;
+    }
+
+    static std::string predicate_name(PqlQuerySet& query, 
+            const std::string& qvar)
+    {
+        std::map<std::string, std::shared_ptr<SimplePredicate> >::iterator
+        it = query.predicates.find(qvar);
+
+        return it == query.predicates.end() ? 
+            std::string("?") : it->second->get_predicate_name();
+    }
+
+    static std::string rename_qvar(PqlQuerySet& query,
+            std::map<std::string, std::string>& renames,
+            const std::string& qvar)
+    {
+        if(renames.count(qvar) == 0) {
+            std::stringstream out;
+            out << "$" << renames.size() << ":" << predicate_name(query, qvar);
+            renames[qvar] = out.str();
+        }
+
+        return renames[qvar];
+    }
+
+  private:
+    PqlQuerySet&    _query;
+    std::map<std::string, std::string>& _renames;
+    bool            _rename;
+    std::string     _result;
+};
+
+static std::string canonical_solver(QuerySolver *solver,
+        const std::map<QuerySolver*, std::string>& solver_names)
+{
+    std::map<QuerySolver*, std::string>::const_iterator it = 
+        solver_names.find(solver);
+
+    if(it != solver_names.end()) {
+        return it->second;
+    }
+
+    SimpleSolverGenerator<PatternSolver> *pattern = 
+        dynamic_cast<SimpleSolverGenerator<PatternSolver>*>(solver);
+    if(pattern != NULL) {
+        return "pattern[" + pattern->get_solver()->get_key() + "]";
+    }
+
+    WithSolver *with = dynamic_cast<WithSolver*>(solver);
+    if(with != NULL) {
+        std::stringstream out;
+        out << "with[" << with->get_left_type() << "," 
+            << with->get_right_type() << "]";
+        return out.str();
+    }
+
+    return "";
+}
+
+struct CanonicalClause {
+    CanonicalClause(const std::string& shape, PqlClause *clause) :
+        shape(shape), clause(clause)
+    { }
+
+    bool operator <(const CanonicalClause& other) const {
+        return shape < other.shape;
+    }
+
+    std::string shape;
+    PqlClause   *clause;
+};
+
+std::string canonical_clause(PqlQuerySet& query, PqlClause *clause,
+        const std::map<QuerySolver*, std::string>& solver_names)
+{
+    std::string solver = canonical_solver(clause->get_solver(), solver_names);
+    if(solver.empty()) {
+        return "";
+    }
+
+    std::map<std::string, std::string> renames;
+    CanonicalTermPrinter printer(query, renames, false);
+
+    std::string shape = solver + "(" + 
+        printer.print(clause->get_left_term()) + ", ";
+    shape += printer.print(clause->get_right_term()) + ")";
+    return shape;
+}
+
+std::string canonical_query(PqlQuerySet& query,
+        const std::map<QuerySolver*, std::string>& solver_names)
+{
+    std::map<std::string, std::string> renames;
+    std::stringstream out;
+
+    // the selected variables keep their order, so they are named first
+    PqlSelector *selector = query.selector.get();
+    if(is_selector<PqlBooleanSelector>(selector)) {
+        out << "BOOLEAN";
+    } else if(is_selector<PqlSingleVarSelector>(selector)) {
+        out << "single " << CanonicalTermPrinter::rename_qvar(query, renames,
+                selector_cast<PqlSingleVarSelector>(selector)->get_qvar_name());
+    } else if(is_selector<PqlTupleSelector>(selector)) {
+        std::vector<std::string> qvars = 
+            selector_cast<PqlTupleSelector>(selector)->get_tuples();
+
+        out << "tuple <";
+        for(std::vector<std::string>::iterator it = qvars.begin();
+                it != qvars.end(); ++it)
+        {
+            out << (it == qvars.begin() ? "" : ", ") 
+                << CanonicalTermPrinter::rename_qvar(query, renames, *it);
+        }
+        out << ">";
+    } else {
+        return "";
+    }
+
+    if(query.is_unsatisfiable) {
+        out << " !";
+    }
+
+    std::vector<CanonicalClause> clauses;
+    for(ClauseSet::iterator it = query.clauses.begin();
+            it != query.clauses.end(); ++it)
+    {
+        std::string shape = canonical_clause(query, it->get(), solver_names);
+        if(shape.empty()) {
+            return "";
+        }
+
+        clauses.push_back(CanonicalClause(shape, it->get()));
+    }
+
+    std::stable_sort(clauses.begin(), clauses.end());
+
+    // name the remaining variables in the order of the sorted clauses;
+    // the renamed clauses are sorted again since the order of clauses 
+    // with the same shape depends on the original names
+    std::vector<std::string> renamed;
+    for(std::vector<CanonicalClause>::iterator it = clauses.begin();
+            it != clauses.end(); ++it)
+    {
+        CanonicalTermPrinter printer(query, renames, true);
+        PqlClause *clause = it->clause;
+        std::string text = canonical_solver(clause->get_solver(), 
+                solver_names) + "(" + printer.print(clause->get_left_term());
+        text += ", " + printer.print(clause->get_right_term()) + ")";
+
+        renamed.push_back(text);
+    }
+
+    std::sort(renamed.begin(), renamed.end());
+
+    for(std::vector<std::string>::iterator it = renamed.begin();
+            it != renamed.end(); ++it)
+    {
+        out << " " << *it;
+    }
+
+    return out.str();
+}
+
+} // namespace impl
+} // namespace simple
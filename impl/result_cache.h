@@ -0,0 +1,158 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "simple/query.h"
+#include "simple/solver.h"
+#include "impl/evaluator.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+const size_t DEFAULT_CACHE_BUDGET = 16 * 1024 * 1024;
+
+struct ResultCacheStats {
+  public:
+    ResultCacheStats() :
+        hits(0), misses(0), insertions(0), evictions(0), invalidations(0)
+    { }
+
+    size_t  hits;
+    size_t  misses;
+    size_t  insertions;
+
+    // entries dropped to stay within the memory budget
+    size_t  evictions;
+
+    // times the whole cache was dropped for a new program
+    size_t  invalidations;
+};
+
+/*
+ * An LRU cache of query results, keyed by the canonical form of the
+ * queries (see canonical_query()).
+ *
+ * Every entry belongs to a program generation, as handed out by
+ * SimpleKnowledgeBase::get_generation(). The first lookup or insertion
+ * for a different generation drops all the entries of the previous one,
+ * as their conditions refer to a program that is no longer loaded.
+ *
+ * The memory budget bounds the estimated size of the cached results and
+ * their keys; the least recently used entries are evicted to stay under
+ * it, and results larger than the whole budget are not cached at all.
+ * The cache may be shared by several evaluators and threads.
+ */
+class QueryResultCache {
+  public:
+    QueryResultCache(size_t budget_bytes = DEFAULT_CACHE_BUDGET);
+
+    /*
+     * Copy the cached result of the query into result and return true,
+     * or return false on a miss.
+     */
+    bool lookup(size_t generation, const std::string& key, 
+            QueryResult& result);
+
+    void insert(size_t generation, const std::string& key, 
+            const QueryResult& result);
+
+    /*
+     * Drop all entries, e.g. after the program has been changed in place.
+     */
+    void invalidate();
+
+    void set_budget(size_t budget_bytes);
+    size_t get_budget() const;
+
+    size_t get_num_entries() const;
+
+    // estimated bytes used by the entries
+    size_t get_memory() const;
+
+    ResultCacheStats get_stats() const;
+
+    /*
+     * Rough estimate of the memory held by a cache entry.
+     */
+    static size_t estimate_size(const std::string& key, 
+            const QueryResult& result);
+
+  private:
+    struct Entry {
+        Entry(const std::string& key, const QueryResult& result, size_t size) :
+            key(key), result(result), size(size)
+        { }
+
+        std::string key;
+        QueryResult result;
+        size_t      size;
+    };
+
+    typedef std::list<Entry> EntryList;
+
+    void set_generation(size_t generation);
+    void clear();
+    void evict();
+
+    mutable std::mutex  _lock;
+
+    // most recently used first
+    EntryList           _entries;
+    std::unordered_map<std::string, EntryList::iterator> _index;
+
+    size_t              _budget;
+    size_t              _memory;
+    size_t              _generation;
+    ResultCacheStats    _stats;
+};
+
+/*
+ * A canonical text form of a query, such that queries that only differ
+ * in the names of their synonyms or the order of their clauses have
+ * the same form.
+ *
+ * Synonyms are replaced by their predicate and their order of first 
+ * occurrence, in the selector and then in the clauses sorted by their
+ * shape. Solvers are identified by their names in solver_names, and the
+ * pattern and with solvers by what they match.
+ *
+ * Returns an empty string for a query with a solver that cannot be 
+ * identified, which must not be cached.
+ */
+std::string canonical_query(PqlQuerySet& query,
+        const std::map<QuerySolver*, std::string>& solver_names);
+
+/*
+ * The shape of a clause: its relation and its terms, with the query 
+ * variables replaced by their predicates. Clauses of the same shape 
+ * relate the same conditions, unless the same query variable is on both
+ * sides. Empty for a solver that cannot be identified.
+ */
+std::string canonical_clause(PqlQuerySet& query, PqlClause *clause,
+        const std::map<QuerySolver*, std::string>& solver_names);
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,369 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impl/rewriter.h"
+#include "impl/solvers/pattern.h"
+#include "impl/solvers/with.h"
+#include "simple/util/query_utils.h"
+#include "simple/util/solver_generator.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+using namespace simple::util;
+
+/*
+ * The synonym of a variable term, or an empty string for the other
+ * kinds of terms.
+ */
+class TermInfoVisitor : public PqlTermVisitor {
+  public:
+    TermInfoVisitor() : qvar(), is_wildcard(false) { }
+
+    void visit_condition_term(PqlConditionTerm *term) { }
+
+    void visit_variable_term(PqlVariableTerm *term) {
+        qvar = term->get_query_variable();
+    }
+
+    void visit_wildcard_term(PqlWildcardTerm *term) {
+        is_wildcard = true;
+    }
+
+    std::string qvar;
+    bool        is_wildcard;
+};
+
+static TermInfoVisitor get_term_info(PqlTerm *term) {
+    TermInfoVisitor visitor;
+    term->accept_pql_term_visitor(&visitor);
+    return visitor;
+}
+
+static bool is_wildcard(PqlTerm *term) {
+    return get_term_info(term).is_wildcard;
+}
+
+static bool is_statement_type(const std::string& type) {
+    return type == "statement" || type == "assign" || type == "while" ||
+        type == "if" || type == "call";
+}
+
+static bool types_overlap(const std::string& type1, const std::string& type2) {
+    if(type1 == type2 || type1 == "wildcard" || type2 == "wildcard") {
+        return true;
+    }
+
+    return (type1 == "statement" && is_statement_type(type2)) ||
+        (type2 == "statement" && is_statement_type(type1));
+}
+
+/*
+ * Whether a term of a qvar of the given predicate can be on a side of
+ * the relation with the given types.
+ */
+static bool is_valid_type(PqlQuerySet& query, PqlTerm *term,
+        const std::vector<std::string>& types)
+{
+    std::string qvar = get_term_info(term).qvar;
+    if(qvar.empty() || query.predicates.count(qvar) == 0) {
+        return true;
+    }
+
+    std::string type = query.predicates[qvar]->get_predicate_name();
+    for(std::vector<std::string>::const_iterator it = types.begin();
+            it != types.end(); ++it)
+    {
+        if(types_overlap(type, *it)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * A term implies another if it is the same term, or if the other term
+ * is a wildcard.
+ */
+static bool is_implied_term(PqlTerm *term, PqlTerm *by) {
+    return is_wildcard(term) || is_same_term(term, by);
+}
+
+/*
+ * with x = y and with y = x, on the same attributes.
+ */
+static bool is_same_with(PqlClause *clause1, PqlClause *clause2) {
+    WithSolver *with1 = dynamic_cast<WithSolver*>(clause1->get_solver());
+    WithSolver *with2 = dynamic_cast<WithSolver*>(clause2->get_solver());
+
+    if(with1 == NULL || with2 == NULL) {
+        return false;
+    }
+
+    if(with1->get_left_type() == with2->get_left_type() &&
+            with1->get_right_type() == with2->get_right_type() &&
+            is_same_term(clause1->get_left_term(), clause2->get_left_term()) &&
+            is_same_term(clause1->get_right_term(), clause2->get_right_term()))
+    {
+        return true;
+    }
+
+    return with1->get_left_type() == with2->get_right_type() &&
+        with1->get_right_type() == with2->get_left_type() &&
+        is_same_term(clause1->get_left_term(), clause2->get_right_term()) &&
+        is_same_term(clause1->get_right_term(), clause2->get_left_term());
+}
+
+/*
+ * with s.stmt# = s.stmt#, which holds for every s.
+ */
+static bool is_trivial_with(PqlClause *clause) {
+    WithSolver *with = dynamic_cast<WithSolver*>(clause->get_solver());
+
+    return with != NULL && with->get_left_type() == with->get_right_type() &&
+        !get_term_info(clause->get_left_term()).qvar.empty() &&
+        is_same_term(clause->get_left_term(), clause->get_right_term());
+}
+
+QueryRewriter::QueryRewriter(const SolverTable& solvers) :
+    _names(), _properties(), _implications()
+{
+    for(SolverTable::const_iterator it = solvers.begin(); 
+            it != solvers.end(); ++it)
+    {
+        _names[it->second.get()] = it->first;
+    }
+}
+
+void QueryRewriter::set_properties(const std::string& relation,
+        const RelationProperties& properties)
+{
+    _properties[relation] = properties;
+}
+
+void QueryRewriter::add_implication(const std::string& stronger,
+        const std::string& weaker)
+{
+    _implications.insert(std::make_pair(stronger, weaker));
+}
+
+QueryRewriter QueryRewriter::create_default(const SolverTable& solvers) {
+    QueryRewriter rewriter(solvers);
+
+    std::vector<std::string> statement(1, "statement");
+    std::vector<std::string> assign(1, "assign");
+    std::vector<std::string> procedure(1, "procedure");
+    std::vector<std::string> variable(1, "variable");
+
+    std::vector<std::string> container;
+    container.push_back("while");
+    container.push_back("if");
+
+    std::vector<std::string> statement_or_procedure;
+    statement_or_procedure.push_back("statement");
+    statement_or_procedure.push_back("procedure");
+
+    RelationProperties structure(true, true, statement, statement);
+    rewriter.set_properties("follows", structure);
+    rewriter.set_properties("ifollows", structure);
+
+    RelationProperties nesting(true, true, container, statement);
+    rewriter.set_properties("parent", nesting);
+    rewriter.set_properties("iparent", nesting);
+
+    RelationProperties access(false, false, statement_or_procedure, variable);
+    rewriter.set_properties("modifies", access);
+    rewriter.set_properties("uses", access);
+
+    // the call graph may be recursive
+    RelationProperties calls(false, false, procedure, procedure);
+    rewriter.set_properties("calls", calls);
+    rewriter.set_properties("icalls", calls);
+
+    rewriter.set_properties("next", 
+            RelationProperties(true, false, statement, statement));
+    rewriter.set_properties("inext", 
+            RelationProperties(false, false, statement, statement));
+    rewriter.set_properties("nextbip", 
+            RelationProperties(false, false, statement, statement));
+    rewriter.set_properties("inextbip", 
+            RelationProperties(false, false, statement, statement));
+
+    RelationProperties affects(false, false, assign, assign);
+    rewriter.set_properties("affects", affects);
+    rewriter.set_properties("iaffects", affects);
+    rewriter.set_properties("affectsbip", affects);
+    rewriter.set_properties("iaffectsbip", affects);
+
+    rewriter.add_implication("follows", "ifollows");
+    rewriter.add_implication("parent", "iparent");
+    rewriter.add_implication("calls", "icalls");
+    rewriter.add_implication("next", "inext");
+    rewriter.add_implication("affects", "iaffects");
+    rewriter.add_implication("nextbip", "inextbip");
+    rewriter.add_implication("affectsbip", "iaffectsbip");
+
+    // pattern a(v, expr) is Modifies(a, v) restricted by expr
+    rewriter.add_implication("pattern", "modifies");
+
+    return rewriter;
+}
+
+RewriteStats QueryRewriter::rewrite(PqlQuerySet& query) {
+    RewriteStats stats;
+    std::vector<ClausePtr> clauses(query.clauses.begin(), query.clauses.end());
+
+    for(size_t i = 0; i < clauses.size(); ++i) {
+        if(is_unsatisfiable(query, clauses[i].get())) {
+            stats.unsatisfiable = true;
+        }
+
+        for(size_t j = i + 1; j < clauses.size(); ++j) {
+            if(is_cyclic(clauses[i].get(), clauses[j].get())) {
+                stats.unsatisfiable = true;
+            }
+        }
+    }
+
+    if(stats.unsatisfiable) {
+        query.is_unsatisfiable = true;
+        return stats;
+    }
+
+    std::vector<bool> dropped(clauses.size(), false);
+
+    for(size_t i = 0; i < clauses.size(); ++i) {
+        if(is_trivial_with(clauses[i].get())) {
+            dropped[i] = true;
+            ++stats.clauses_dropped;
+            continue;
+        }
+
+        // an equivalent clause is only dropped if the other one is kept
+        for(size_t j = 0; j < clauses.size() && !dropped[i]; ++j) {
+            if(i == j || dropped[j]) {
+                continue;
+            }
+
+            if(is_same_with(clauses[i].get(), clauses[j].get())) {
+                dropped[i] = true;
+                ++stats.clauses_merged;
+            } else if(is_implied(clauses[i].get(), clauses[j].get())) {
+                dropped[i] = true;
+                ++stats.clauses_dropped;
+            }
+        }
+    }
+
+    for(size_t i = 0; i < clauses.size(); ++i) {
+        if(dropped[i]) {
+            query.clauses.erase(clauses[i]);
+        }
+    }
+
+    return stats;
+}
+
+std::string QueryRewriter::get_relation(QuerySolver *solver) const {
+    std::map<QuerySolver*, std::string>::const_iterator it = 
+        _names.find(solver);
+
+    if(it != _names.end()) {
+        return it->second;
+    } else if(dynamic_cast<SimpleSolverGenerator<PatternSolver>*>(solver)) {
+        return "pattern";
+    } else if(dynamic_cast<WithSolver*>(solver)) {
+        return "with";
+    } else {
+        return "";
+    }
+}
+
+const RelationProperties* 
+QueryRewriter::get_properties(QuerySolver *solver) const {
+    std::map<std::string, RelationProperties>::const_iterator it =
+        _properties.find(get_relation(solver));
+
+    return it != _properties.end() ? &it->second : NULL;
+}
+
+bool QueryRewriter::implies(QuerySolver *stronger, QuerySolver *weaker) const {
+    if(stronger == weaker) {
+        return true;
+    }
+
+    std::string stronger_name = get_relation(stronger);
+    std::string weaker_name = get_relation(weaker);
+
+    return !stronger_name.empty() && !weaker_name.empty() &&
+        _implications.count(std::make_pair(stronger_name, weaker_name)) > 0;
+}
+
+bool QueryRewriter::is_closure_of(QuerySolver *solver1, 
+        QuerySolver *solver2) const 
+{
+    return implies(solver1, solver2) || implies(solver2, solver1);
+}
+
+bool QueryRewriter::is_unsatisfiable(PqlQuerySet& query, 
+        PqlClause *clause) const 
+{
+    const RelationProperties *properties = get_properties(clause->get_solver());
+    if(properties == NULL) {
+        return false;
+    }
+
+    PqlTerm *left = clause->get_left_term();
+    PqlTerm *right = clause->get_right_term();
+
+    if(properties->irreflexive && !is_wildcard(left) && 
+            is_same_term(left, right)) 
+    {
+        return true;
+    }
+
+    return !is_valid_type(query, left, properties->left_types) ||
+        !is_valid_type(query, right, properties->right_types);
+}
+
+bool QueryRewriter::is_cyclic(PqlClause *clause1, PqlClause *clause2) const {
+    const RelationProperties *properties1 = get_properties(clause1->get_solver());
+    const RelationProperties *properties2 = get_properties(clause2->get_solver());
+
+    if(properties1 == NULL || properties2 == NULL || 
+            !properties1->acyclic || !properties2->acyclic ||
+            !is_closure_of(clause1->get_solver(), clause2->get_solver()))
+    {
+        return false;
+    }
+
+    return !is_wildcard(clause1->get_left_term()) && 
+        !is_wildcard(clause1->get_right_term()) &&
+        is_same_term(clause1->get_left_term(), clause2->get_right_term()) &&
+        is_same_term(clause1->get_right_term(), clause2->get_left_term());
+}
+
+bool QueryRewriter::is_implied(PqlClause *clause, PqlClause *by) const {
+    return implies(by->get_solver(), clause->get_solver()) &&
+        is_implied_term(clause->get_left_term(), by->get_left_term()) &&
+        is_implied_term(clause->get_right_term(), by->get_right_term());
+}
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,130 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "simple/query.h"
+#include "simple/solver.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * What the rewriter knows about a relation. The types are the names of
+ * the predicates the relation can hold on, e.g. "statement" or "assign";
+ * "statement" stands for all kinds of statements.
+ */
+struct RelationProperties {
+  public:
+    RelationProperties() :
+        irreflexive(false), acyclic(false), left_types(), right_types()
+    { }
+
+    RelationProperties(bool irreflexive, bool acyclic,
+            const std::vector<std::string>& left_types,
+            const std::vector<std::string>& right_types) :
+        irreflexive(irreflexive), acyclic(acyclic),
+        left_types(left_types), right_types(right_types)
+    { }
+
+    // R(x, x) never holds
+    bool irreflexive;
+
+    // R(x, y) and R(y, x) never hold together, also across the relation
+    // and its transitive closure
+    bool acyclic;
+
+    std::vector<std::string> left_types;
+    std::vector<std::string> right_types;
+};
+
+struct RewriteStats {
+  public:
+    RewriteStats() : 
+        clauses_dropped(0), clauses_merged(0), unsatisfiable(false) 
+    { }
+
+    // clauses implied by another clause of the query
+    size_t  clauses_dropped;
+
+    // clauses equal to another clause up to the order of their terms
+    size_t  clauses_merged;
+
+    bool    unsatisfiable;
+};
+
+/*
+ * A rule based rewrite pass over a parsed query, run before evaluation.
+ *
+ * - A clause that can never hold, such as Follows(s, s) or Parent(a, s)
+ *   for an assignment a, makes the whole query unsatisfiable, and it is
+ *   flagged so that the evaluator returns an empty or FALSE result 
+ *   without solving anything. So do R(x, y) and R(y, x) for an acyclic R.
+ * - A clause implied by another clause is dropped: Follows*(s1, s2) by
+ *   Follows(s1, s2), Follows(s, _) by Follows(s, 3), or Modifies(a, v) 
+ *   by pattern a(v, _).
+ * - With clauses that only differ in the order of their sides are 
+ *   merged, and with clauses comparing a synonym to itself are dropped.
+ *
+ * Relations are known by the names of the solver table, plus "pattern"
+ * and "with" for the solvers of pattern and with clauses.
+ */
+class QueryRewriter {
+  public:
+    QueryRewriter(const SolverTable& solvers);
+
+    void set_properties(const std::string& relation, 
+            const RelationProperties& properties);
+
+    /*
+     * Declare that stronger(x, y) implies weaker(x, y).
+     */
+    void add_implication(const std::string& stronger, 
+            const std::string& weaker);
+
+    /*
+     * The rewriter of the relations of the knowledge base solvers.
+     */
+    static QueryRewriter create_default(const SolverTable& solvers);
+
+    RewriteStats rewrite(PqlQuerySet& query);
+
+  private:
+    std::string get_relation(QuerySolver *solver) const;
+    const RelationProperties* get_properties(QuerySolver *solver) const;
+
+    bool implies(QuerySolver *stronger, QuerySolver *weaker) const;
+    bool is_closure_of(QuerySolver *solver1, QuerySolver *solver2) const;
+
+    bool is_unsatisfiable(PqlQuerySet& query, PqlClause *clause) const;
+    bool is_cyclic(PqlClause *clause1, PqlClause *clause2) const;
+    bool is_implied(PqlClause *clause, PqlClause *by) const;
+
+    std::map<QuerySolver*, std::string>         _names;
+    std::map<std::string, RelationProperties>   _properties;
+    std::set<std::pair<std::string, std::string> > _implications;
+};
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,318 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <string>
+#include "impl/solvers/affects.h"
+#include "impl/bit_vector.h"
+#include "impl/cancellation.h"
+#include "impl/condition.h"
+#include "impl/flow_collector.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+AffectsSolver::AffectsSolver(SimpleRoot ast, 
+        std::shared_ptr<NextQuerySolver> next_solver,
+        std::shared_ptr<ModifiesSolver> modifies_solver,
+        ConditionPoolPtr pool) :
+    _ast(ast), _pool(pool), _next_solver(next_solver), _modifies_solver(modifies_solver),
+    _statement_procs(), _graphs(), _graph_lock()
+{
+    for(SimpleRoot::iterator it = _ast.begin(); it != _ast.end(); ++it) {
+        index_statement_list((*it)->get_statement(), *it);
+    }
+}
+
+void AffectsSolver::index_statement_list(StatementAst *statement, 
+        ProcAst *proc)
+{
+    FlowStatementCollector collector;
+    collector.collect(statement);
+
+    for(size_t i = 0; i < collector.statements.size(); ++i) {
+        _statement_procs[collector.statements[i]] = proc;
+    }
+}
+
+AffectsGraph* AffectsSolver::get_graph(StatementAst *statement) {
+    std::map<StatementAst*, ProcAst*>::iterator proc_it = 
+        _statement_procs.find(statement);
+
+    if(proc_it == _statement_procs.end()) {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> guard(_graph_lock);
+
+    std::shared_ptr<AffectsGraph>& graph = _graphs[proc_it->second];
+    if(!graph) {
+        graph.reset(create_graph(proc_it->second));
+    }
+    return graph.get();
+}
+
+AffectsGraph* AffectsSolver::create_graph(ProcAst *proc) {
+    FlowStatementCollector collector;
+    collector.collect(proc->get_statement());
+
+    const std::vector<StatementAst*>& statements = collector.statements;
+    size_t num_statements = statements.size();
+
+    std::map<StatementAst*, size_t> positions;
+    for(size_t i = 0; i < num_statements; ++i) {
+        positions[statements[i]] = i;
+    }
+
+    std::unique_ptr<AffectsGraph> graph(new AffectsGraph());
+
+    // number the definitions, i.e. the assignments, in program order
+    std::vector<long> definitions(num_statements, -1);
+    for(size_t i = 0; i < num_statements; ++i) {
+        if(collector.assignments[i] != NULL) {
+            definitions[i] = graph->assignments.size();
+            graph->index[statements[i]] = graph->assignments.size();
+            graph->assignments.push_back(collector.assignments[i]);
+        }
+    }
+
+    size_t num_defs = graph->assignments.size();
+    graph->affects.resize(num_defs);
+    graph->affected_by.resize(num_defs);
+
+    std::map<std::string, BitVector> var_defs;
+    for(size_t i = 0; i < num_defs; ++i) {
+        std::string var = graph->assignments[i]->get_variable()->get_name();
+        if(var_defs.count(var) == 0) {
+            var_defs[var] = BitVector(num_defs);
+        }
+        var_defs[var].set(i);
+    }
+
+    // an assignment kills the other definitions of its variable and a
+    // call kills the definitions of every variable the callee modifies
+    std::vector<BitVector> kill(num_statements, BitVector(num_defs));
+    for(size_t i = 0; i < num_statements; ++i) {
+        if(collector.assignments[i] != NULL) {
+            kill[i] = var_defs[collector.assignments[i]->get_variable()->get_name()];
+        } else if(collector.calls[i] != NULL) {
+            ConditionSet modified = _modifies_solver->solve_right<StatementAst>(
+                    collector.calls[i]);
+
+            for(ConditionSet::iterator cit = modified.begin(); 
+                    cit != modified.end(); ++cit)
+            {
+                VariableCondition *var = dynamic_cast<VariableCondition*>(cit->get());
+                if(var == NULL) {
+                    continue;
+                }
+
+                std::map<std::string, BitVector>::iterator defs = 
+                    var_defs.find(var->get_variable()->get_name());
+                if(defs != var_defs.end()) {
+                    kill[i].union_with(defs->second);
+                }
+            }
+        }
+    }
+
+    std::vector<std::vector<size_t> > preds(num_statements);
+    std::vector<std::vector<size_t> > succs(num_statements);
+    for(size_t i = 0; i < num_statements; ++i) {
+        StatementSet next = _next_solver->solve_next_statement(statements[i]);
+
+        for(StatementSet::iterator it = next.begin(); it != next.end(); ++it) {
+            std::map<StatementAst*, size_t>::iterator pos = positions.find(*it);
+            if(pos != positions.end()) {
+                succs[i].push_back(pos->second);
+                preds[pos->second].push_back(i);
+            }
+        }
+    }
+
+    // reaching definitions: in[s] is the union of out[p] over the 
+    // predecessors p of s, and out[s] = gen[s] + (in[s] - kill[s])
+    std::vector<BitVector> in(num_statements, BitVector(num_defs));
+    std::vector<BitVector> out(num_statements, BitVector(num_defs));
+
+    std::deque<size_t> worklist;
+    std::vector<bool> queued(num_statements, true);
+    for(size_t i = 0; i < num_statements; ++i) {
+        worklist.push_back(i);
+    }
+
+    while(!worklist.empty()) {
+        check_cancellation();
+
+        size_t current = worklist.front();
+        worklist.pop_front();
+        queued[current] = false;
+
+        for(size_t i = 0; i < preds[current].size(); ++i) {
+            in[current].union_with(out[preds[current][i]]);
+        }
+
+        BitVector new_out = in[current];
+        new_out.subtract(kill[current]);
+        if(definitions[current] >= 0) {
+            new_out.set(definitions[current]);
+        }
+
+        if(new_out != out[current]) {
+            out[current] = new_out;
+
+            for(size_t i = 0; i < succs[current].size(); ++i) {
+                size_t succ = succs[current][i];
+                if(!queued[succ]) {
+                    queued[succ] = true;
+                    worklist.push_back(succ);
+                }
+            }
+        }
+    }
+
+    // a definition reaching an assignment affects it if the assignment
+    // uses its variable
+    for(size_t i = 0; i < num_statements; ++i) {
+        if(definitions[i] < 0) {
+            continue;
+        }
+
+        UsedVariableCollector used;
+        collector.assignments[i]->get_expr()->accept_expr_visitor(&used);
+
+        BitVector affecting(num_defs);
+        for(std::set<std::string>::iterator vit = used.variables.begin();
+                vit != used.variables.end(); ++vit)
+        {
+            std::map<std::string, BitVector>::iterator defs = var_defs.find(*vit);
+            if(defs != var_defs.end()) {
+                affecting.union_with(defs->second);
+            }
+        }
+        affecting.intersect_with(in[i]);
+
+        std::vector<size_t> sources = affecting.get_indexes();
+        for(size_t j = 0; j < sources.size(); ++j) {
+            graph->affects[sources[j]].push_back(definitions[i]);
+            graph->affected_by[definitions[i]].push_back(sources[j]);
+        }
+    }
+
+    return graph.release();
+}
+
+ConditionSet solve_affects_edges(AffectsGraph *graph, 
+        StatementAst *statement, bool forward, ConditionPool *pool)
+{
+    ConditionSet result;
+
+    if(graph == NULL || graph->index.count(statement) == 0) {
+        return result;
+    }
+
+    size_t index = graph->index[statement];
+    const std::vector<size_t>& edges = forward ? 
+        graph->affects[index] : graph->affected_by[index];
+
+    for(size_t i = 0; i < edges.size(); ++i) {
+        result.insert(pool->get_statement_condition(graph->assignments[edges[i]]));
+    }
+    return result;
+}
+
+bool validate_affects_edge(AffectsGraph *graph, 
+        StatementAst *statement1, StatementAst *statement2)
+{
+    if(graph == NULL || graph->index.count(statement1) == 0 ||
+            graph->index.count(statement2) == 0)
+    {
+        return false;
+    }
+
+    const std::vector<size_t>& targets = graph->affects[graph->index[statement1]];
+    return std::binary_search(targets.begin(), targets.end(), 
+            graph->index[statement2]);
+}
+
+bool has_affects_edge(AffectsGraph *graph, StatementAst *statement, 
+        bool forward)
+{
+    if(graph == NULL || graph->index.count(statement) == 0) {
+        return false;
+    }
+
+    size_t index = graph->index[statement];
+    return forward ? !graph->affects[index].empty() : 
+        !graph->affected_by[index].empty();
+}
+
+bool has_affects_pair(SimpleRoot ast, AffectsQuerySolver *solver) {
+    for(SimpleRoot::iterator it = ast.begin(); it != ast.end(); ++it) {
+        AffectsGraph *graph = solver->get_graph((*it)->get_statement());
+        if(graph == NULL) {
+            continue;
+        }
+
+        for(size_t i = 0; i < graph->affects.size(); ++i) {
+            if(!graph->affects[i].empty()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <>
+ConditionSet AffectsSolver::solve_right<StatementAst>(StatementAst *statement) {
+    return solve_affects_edges(get_graph(statement), statement, true, _pool.get());
+}
+
+template <>
+ConditionSet AffectsSolver::solve_left<StatementAst>(StatementAst *statement) {
+    return solve_affects_edges(get_graph(statement), statement, false, _pool.get());
+}
+
+template <>
+bool AffectsSolver::validate<StatementAst, StatementAst>(
+        StatementAst *statement1, StatementAst *statement2)
+{
+    // the edges are added in program order, so they are sorted
+    return validate_affects_edge(get_graph(statement1), statement1, statement2);
+}
+
+template <>
+bool AffectsSolver::has_right<StatementAst>(StatementAst *statement) {
+    return has_affects_edge(get_graph(statement), statement, true);
+}
+
+template <>
+bool AffectsSolver::has_left<StatementAst>(StatementAst *statement) {
+    return has_affects_edge(get_graph(statement), statement, false);
+}
+
+bool AffectsSolver::has_any() {
+    return has_affects_pair(_ast, this);
+}
+
+} // namespace impl
+} // namespace simple
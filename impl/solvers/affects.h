@@ -0,0 +1,182 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "simple/ast.h"
+#include "simple/condition_set.h"
+#include "simple/solver.h"
+#include "impl/condition_pool.h"
+#include "impl/solvers/modifies.h"
+#include "impl/solvers/next.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * The Affects relation between the assignments of one procedure. 
+ * Assignments are numbered in program order and the edges are kept in
+ * both directions.
+ */
+struct AffectsGraph {
+  public:
+    std::vector<AssignmentAst*>             assignments;
+    std::map<StatementAst*, size_t>         index;
+    std::vector<std::vector<size_t> >       affects;
+    std::vector<std::vector<size_t> >       affected_by;
+};
+
+/*
+ * The assignments affected by a statement, or affecting it if forward is
+ * false, as statement conditions. Empty if the statement is not an 
+ * assignment of the graph.
+ */
+ConditionSet solve_affects_edges(AffectsGraph *graph, 
+        StatementAst *statement, bool forward, ConditionPool *pool);
+
+/*
+ * Whether the graph has an edge from the first statement to the second.
+ * The edge lists have to be sorted.
+ */
+bool validate_affects_edge(AffectsGraph *graph, 
+        StatementAst *statement1, StatementAst *statement2);
+
+/*
+ * Whether the statement affects, or is affected by if forward is false,
+ * some assignment of the graph.
+ */
+bool has_affects_edge(AffectsGraph *graph, StatementAst *statement, 
+        bool forward);
+
+/*
+ * Solvers that build affects graphs, so that the Affects* closure can be
+ * computed the same way over any of them.
+ */
+class AffectsQuerySolver {
+  public:
+    /*
+     * The affects graph containing the statement, or NULL if the 
+     * statement is not part of the program.
+     */
+    virtual AffectsGraph* get_graph(StatementAst *statement) = 0;
+
+    virtual ~AffectsQuerySolver() { }
+};
+
+/*
+ * Whether some affects graph of the solver has an edge. The graphs are
+ * looked up through the first statement of every procedure.
+ */
+bool has_affects_pair(SimpleRoot ast, AffectsQuerySolver *solver);
+
+/*
+ * Affects(a1, a2) holds if a2 uses a variable v modified by a1, and
+ * there is a control flow path from a1 to a2 on which v is not modified
+ * again, neither by an assignment nor by a procedure call.
+ *
+ * This is the reaching definitions problem: a1 affects a2 if the 
+ * definition of a1 reaches a2 and a2 uses its variable. The definitions
+ * reaching every statement are computed with bit vector dataflow over
+ * the control flow graph of NextSolver, with the variables modified by
+ * a call taken from the Modifies index. The affects graph of a procedure
+ * is computed the first time one of its statements is queried, and kept
+ * for the lifetime of the solver.
+ */
+class AffectsSolver : public AffectsQuerySolver {
+  public:
+    AffectsSolver(SimpleRoot ast, 
+            std::shared_ptr<NextQuerySolver> next_solver,
+            std::shared_ptr<ModifiesSolver> modifies_solver,
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool()));
+
+    template <typename Condition>
+    ConditionSet solve_right(Condition *condition) {
+        return ConditionSet();
+    }
+
+    template <typename Condition>
+    ConditionSet solve_left(Condition *condition) {
+        return ConditionSet();
+    }
+
+    template <typename Condition1, typename Condition2>
+    bool validate(Condition1 *condition1, Condition2 *condition2) {
+        return false;
+    }
+
+    /*
+     * EXISTENCE PROBES
+     */
+    template <typename Condition>
+    bool has_right(Condition *condition) {
+        return false;
+    }
+
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any();
+
+    /*
+     * The affects graph of the procedure containing the statement, or 
+     * NULL if the statement is not part of the program.
+     */
+    AffectsGraph* get_graph(StatementAst *statement);
+
+  private:
+    void index_statement_list(StatementAst *statement, ProcAst *proc);
+    AffectsGraph* create_graph(ProcAst *proc);
+
+    SimpleRoot _ast;
+    ConditionPoolPtr _pool;
+    std::shared_ptr<NextQuerySolver>    _next_solver;
+    std::shared_ptr<ModifiesSolver>     _modifies_solver;
+
+    std::map<StatementAst*, ProcAst*>   _statement_procs;
+    std::map<ProcAst*, std::shared_ptr<AffectsGraph> > _graphs;
+
+    // guards the graphs
+    std::mutex _graph_lock;
+};
+
+template <>
+ConditionSet AffectsSolver::solve_right<StatementAst>(StatementAst *statement);
+
+template <>
+ConditionSet AffectsSolver::solve_left<StatementAst>(StatementAst *statement);
+
+template <>
+bool AffectsSolver::validate<StatementAst, StatementAst>(
+        StatementAst *statement1, StatementAst *statement2);
+
+template <>
+bool AffectsSolver::has_right<StatementAst>(StatementAst *statement);
+
+template <>
+bool AffectsSolver::has_left<StatementAst>(StatementAst *statement);
+
+} // namespace impl
+} // namespace simple
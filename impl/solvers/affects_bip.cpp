@@ -0,0 +1,249 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include "impl/solvers/affects_bip.h"
+#include "impl/cancellation.h"
+#include "impl/condition.h"
+#include "impl/flow_collector.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+AffectsBipSolver::AffectsBipSolver(SimpleRoot ast, 
+        std::shared_ptr<BipGraph> graph, ConditionPoolPtr pool) :
+    _ast(ast), _pool(pool), _graph(graph), _affects_graph(), _graph_lock()
+{ }
+
+AffectsGraph* AffectsBipSolver::get_graph(StatementAst *statement) {
+    size_t node;
+    if(!_graph->find_node(statement, node)) {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> guard(_graph_lock);
+
+    if(!_affects_graph) {
+        _affects_graph.reset(create_graph());
+    }
+    return _affects_graph.get();
+}
+
+void AffectsBipSolver::solve_flow(const BipProc& proc, 
+        const BitVector& entry_in,
+        const std::vector<BitVector>& gen, 
+        const std::vector<BitVector>& kill, 
+        bool with_gen, std::vector<BitVector>& in)
+{
+    size_t num_defs = entry_in.get_size();
+    std::map<size_t, BitVector> out;
+
+    std::deque<size_t> worklist(proc.nodes.begin(), proc.nodes.end());
+    std::set<size_t> queued(proc.nodes.begin(), proc.nodes.end());
+
+    for(size_t i = 0; i < proc.nodes.size(); ++i) {
+        in[proc.nodes[i]] = BitVector(num_defs);
+        out[proc.nodes[i]] = BitVector(num_defs);
+    }
+    in[proc.entry] = entry_in;
+
+    while(!worklist.empty()) {
+        check_cancellation();
+
+        size_t current = worklist.front();
+        worklist.pop_front();
+        queued.erase(current);
+
+        const BipNode& node = _graph->get_node(current);
+        for(size_t i = 0; i < node.flow_prev.size(); ++i) {
+            in[current].union_with(out[node.flow_prev[i]]);
+        }
+
+        BitVector new_out = in[current];
+        new_out.subtract(kill[current]);
+        if(with_gen) {
+            new_out.union_with(gen[current]);
+        }
+
+        if(new_out != out[current]) {
+            out[current] = new_out;
+
+            for(size_t i = 0; i < node.flow_next.size(); ++i) {
+                if(queued.insert(node.flow_next[i]).second) {
+                    worklist.push_back(node.flow_next[i]);
+                }
+            }
+        }
+    }
+}
+
+AffectsGraph* AffectsBipSolver::create_graph() {
+    size_t num_nodes = _graph->get_size();
+    const std::vector<BipProc>& procs = _graph->get_procs();
+
+    std::unique_ptr<AffectsGraph> graph(new AffectsGraph());
+
+    // number the definitions of the whole program in node order
+    std::vector<long> definitions(num_nodes, -1);
+    for(size_t i = 0; i < num_nodes; ++i) {
+        AssignmentAst *assign = _graph->get_node(i).assignment;
+        if(assign != NULL) {
+            definitions[i] = graph->assignments.size();
+            graph->index[assign] = graph->assignments.size();
+            graph->assignments.push_back(assign);
+        }
+    }
+
+    size_t num_defs = graph->assignments.size();
+    graph->affects.resize(num_defs);
+    graph->affected_by.resize(num_defs);
+
+    BitVector all_defs(num_defs);
+    std::map<std::string, BitVector> var_defs;
+    for(size_t i = 0; i < num_defs; ++i) {
+        std::string var = graph->assignments[i]->get_variable()->get_name();
+        if(var_defs.count(var) == 0) {
+            var_defs[var] = BitVector(num_defs);
+        }
+        var_defs[var].set(i);
+        all_defs.set(i);
+    }
+
+    std::vector<BitVector> gen(num_nodes, BitVector(num_defs));
+    std::vector<BitVector> kill(num_nodes, BitVector(num_defs));
+    for(size_t i = 0; i < num_nodes; ++i) {
+        if(definitions[i] >= 0) {
+            gen[i].set(definitions[i]);
+            kill[i] = var_defs[graph->assignments[definitions[i]]
+                ->get_variable()->get_name()];
+        }
+    }
+
+    // summarize the procedures with their callees first, so that the
+    // calls of a procedure have their transfer functions ready
+    std::map<ProcAst*, size_t> proc_indexes;
+    std::vector<BitVector> proc_gen(procs.size());
+    std::vector<BitVector> proc_kill(procs.size());
+    std::vector<BitVector> in(num_nodes);
+
+    for(size_t i = 0; i < procs.size(); ++i) {
+        const BipProc& proc = procs[i];
+
+        for(size_t j = 0; j < proc.nodes.size(); ++j) {
+            const BipNode& node = _graph->get_node(proc.nodes[j]);
+            if(!node.call_next.empty()) {
+                size_t callee = proc_indexes[
+                    _graph->get_node(node.call_next[0]).proc];
+                gen[proc.nodes[j]] = proc_gen[callee];
+                kill[proc.nodes[j]] = proc_kill[callee];
+            }
+        }
+
+        // the definitions surviving some path through the procedure are
+        // exactly those not killed on every path
+        solve_flow(proc, all_defs, gen, kill, false, in);
+        proc_kill[i] = all_defs;
+        proc_kill[i].subtract(in[proc.exit]);
+
+        solve_flow(proc, BitVector(num_defs), gen, kill, true, in);
+        proc_gen[i] = in[proc.exit];
+
+        proc_indexes[proc.proc] = i;
+    }
+
+    // propagate down the call graph, with the callers first
+    for(size_t i = procs.size(); i-- > 0; ) {
+        const BipProc& proc = procs[i];
+
+        BitVector entry_in(num_defs);
+        const std::vector<size_t>& calls = _graph->get_node(proc.entry).call_prev;
+        for(size_t j = 0; j < calls.size(); ++j) {
+            entry_in.union_with(in[calls[j]]);
+        }
+
+        solve_flow(proc, entry_in, gen, kill, true, in);
+    }
+
+    for(size_t i = 0; i < num_nodes; ++i) {
+        if(definitions[i] < 0) {
+            continue;
+        }
+
+        UsedVariableCollector used;
+        _graph->get_node(i).assignment->get_expr()->accept_expr_visitor(&used);
+
+        BitVector affecting(num_defs);
+        for(std::set<std::string>::iterator vit = used.variables.begin();
+                vit != used.variables.end(); ++vit)
+        {
+            std::map<std::string, BitVector>::iterator defs = var_defs.find(*vit);
+            if(defs != var_defs.end()) {
+                affecting.union_with(defs->second);
+            }
+        }
+        affecting.intersect_with(in[i]);
+
+        std::vector<size_t> sources = affecting.get_indexes();
+        for(size_t j = 0; j < sources.size(); ++j) {
+            graph->affects[sources[j]].push_back(definitions[i]);
+            graph->affected_by[definitions[i]].push_back(sources[j]);
+        }
+    }
+
+    return graph.release();
+}
+
+template <>
+ConditionSet AffectsBipSolver::solve_right<StatementAst>(StatementAst *statement) {
+    return solve_affects_edges(get_graph(statement), statement, true, _pool.get());
+}
+
+template <>
+ConditionSet AffectsBipSolver::solve_left<StatementAst>(StatementAst *statement) {
+    return solve_affects_edges(get_graph(statement), statement, false, _pool.get());
+}
+
+template <>
+bool AffectsBipSolver::validate<StatementAst, StatementAst>(
+        StatementAst *statement1, StatementAst *statement2)
+{
+    // the edges are added in node order, so they are sorted
+    return validate_affects_edge(get_graph(statement1), statement1, statement2);
+}
+
+template <>
+bool AffectsBipSolver::has_right<StatementAst>(StatementAst *statement) {
+    return has_affects_edge(get_graph(statement), statement, true);
+}
+
+template <>
+bool AffectsBipSolver::has_left<StatementAst>(StatementAst *statement) {
+    return has_affects_edge(get_graph(statement), statement, false);
+}
+
+bool AffectsBipSolver::has_any() {
+    return has_affects_pair(_ast, this);
+}
+
+} // namespace impl
+} // namespace simple
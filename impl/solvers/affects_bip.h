@@ -0,0 +1,132 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "simple/ast.h"
+#include "simple/condition_set.h"
+#include "simple/solver.h"
+#include "impl/bip_graph.h"
+#include "impl/bit_vector.h"
+#include "impl/solvers/affects.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * AffectsBip, the Affects relation over the valid paths of the 
+ * interprocedural control flow graph. The assignments inside a called 
+ * procedure may affect the assignments after the call and the other way
+ * round, and a call only kills what its callee modifies on every path.
+ *
+ * Reaching definitions are computed over all the assignments of the
+ * program in two passes, without inlining any call:
+ *
+ * - Going up the call graph, each procedure is summarized by the 
+ *   definitions it may generate and the definitions it always kills, 
+ *   which is exact for a gen/kill problem. A call is then a single
+ *   transfer function in its caller.
+ * - Going down the call graph, the definitions reaching the entry of a
+ *   procedure are the union of those reaching its calls, and are
+ *   propagated through its body with the same summaries.
+ *
+ * The result is one affects graph for the whole program, computed the
+ * first time it is needed.
+ */
+class AffectsBipSolver : public AffectsQuerySolver {
+  public:
+    AffectsBipSolver(SimpleRoot ast, std::shared_ptr<BipGraph> graph,
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool()));
+
+    template <typename Condition>
+    ConditionSet solve_right(Condition *condition) {
+        return ConditionSet();
+    }
+
+    template <typename Condition>
+    ConditionSet solve_left(Condition *condition) {
+        return ConditionSet();
+    }
+
+    template <typename Condition1, typename Condition2>
+    bool validate(Condition1 *condition1, Condition2 *condition2) {
+        return false;
+    }
+
+    /*
+     * EXISTENCE PROBES
+     */
+    template <typename Condition>
+    bool has_right(Condition *condition) {
+        return false;
+    }
+
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any();
+
+    AffectsGraph* get_graph(StatementAst *statement);
+
+  private:
+    AffectsGraph* create_graph();
+
+    /*
+     * Compute the definitions reaching every node of a procedure, given
+     * those reaching its entry. The generated definitions are left out
+     * if with_gen is false.
+     */
+    void solve_flow(const BipProc& proc, const BitVector& entry_in,
+            const std::vector<BitVector>& gen, 
+            const std::vector<BitVector>& kill, 
+            bool with_gen, std::vector<BitVector>& in);
+
+    SimpleRoot _ast;
+    ConditionPoolPtr _pool;
+    std::shared_ptr<BipGraph> _graph;
+    std::shared_ptr<AffectsGraph> _affects_graph;
+
+    // guards the affects graph
+    std::mutex _graph_lock;
+};
+
+template <>
+ConditionSet AffectsBipSolver::solve_right<StatementAst>(StatementAst *statement);
+
+template <>
+ConditionSet AffectsBipSolver::solve_left<StatementAst>(StatementAst *statement);
+
+template <>
+bool AffectsBipSolver::validate<StatementAst, StatementAst>(
+        StatementAst *statement1, StatementAst *statement2);
+
+template <>
+bool AffectsBipSolver::has_right<StatementAst>(StatementAst *statement);
+
+template <>
+bool AffectsBipSolver::has_left<StatementAst>(StatementAst *statement);
+
+} // namespace impl
+} // namespace simple
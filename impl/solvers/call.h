@@ -18,11 +18,11 @@
 
 #pragma once
 
-#include <map>
-#include <set>
+#include <memory>
 #include "simple/ast.h"
 #include "simple/condition.h"
 #include "simple/solver.h"
+#include "impl/call_graph.h"
 
 namespace simple {
 namespace impl {
@@ -33,6 +33,7 @@ using namespace simple::impl;
 class CallSolver {
   public:
     CallSolver(SimpleRoot ast);
+    CallSolver(SimpleRoot ast, std::shared_ptr<CallGraph> call_graph);
 
     /*
      * SOLVE RIGHT PART
@@ -52,17 +53,24 @@ class CallSolver {
         return false;
     }
 
+    /*
+     * EXISTENCE PROBES
+     */
     template <typename Condition>
-    void index_calls(Condition *condition) {
-        // no-op
+    bool has_right(Condition *condition) {
+        return false;
     }
 
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any();
 
   private:
-    typedef std::map<ProcAst*, std::set<ProcAst*> > ProcIndex;
     SimpleRoot _ast;
-    ProcIndex _calls_table;
-    ProcIndex _called_table;
+    std::shared_ptr<CallGraph> _call_graph;
 };
 
 template <>
@@ -75,23 +83,10 @@ template <>
 bool CallSolver::validate<ProcAst, ProcAst>(ProcAst *proc1, ProcAst *proc2);
 
 template <>
-void CallSolver::index_calls<StatementAst>(StatementAst *statement);
-
-template <>
-void CallSolver::index_calls<ProcAst>(ProcAst *proc);
+bool CallSolver::has_right<ProcAst>(ProcAst *proc);
 
 template <>
-void CallSolver::index_calls<CallAst>(CallAst *call);
-
-template <>
-void CallSolver::index_calls<WhileAst>(WhileAst *loop);
-
-template <>
-void CallSolver::index_calls<ConditionalAst>(ConditionalAst *condition);
-
-
-
-
+bool CallSolver::has_left<ProcAst>(ProcAst *proc);
 
 } // namespace impl
 } // namespace simple
@@ -17,6 +17,7 @@
  */
 
 #include "impl/solvers/follows.h"
+#include "simple/util/ast_utils.h"
 
 
 namespace simple {
@@ -25,13 +26,38 @@ namespace impl {
 using namespace simple;
 using namespace simple::util;
 
+static bool has_follows_pair(StatementAst *statement) {
+    if(statement->next() != NULL) {
+        return true;
+    }
+
+    std::vector<StatementAst*> lists = get_nested_lists(statement);
+    for(std::vector<StatementAst*>::iterator it = lists.begin();
+            it != lists.end(); ++it)
+    {
+        if(has_follows_pair(*it)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool has_follows_pair(SimpleRoot ast) {
+    for(SimpleRoot::iterator it = ast.begin(); it != ast.end(); ++it) {
+        StatementAst *statement = (*it)->get_statement();
+        if(statement != NULL && has_follows_pair(statement)) {
+            return true;
+        }
+    }
+    return false;
+}
 
 template <>
 ConditionSet FollowSolver::solve_right<StatementAst>(StatementAst *ast) {
     ConditionSet result;
 
     if(ast->next()) {
-        result.insert(new SimpleStatementCondition(ast->next()));
+        result.insert(_pool->get_statement_condition(ast->next()));
     }
     return result;
 }
@@ -41,7 +67,7 @@ ConditionSet FollowSolver::solve_left<StatementAst>(StatementAst *ast) {
     ConditionSet result;
 
     if(ast->prev()) {
-        result.insert(new SimpleStatementCondition(ast->prev()));
+        result.insert(_pool->get_statement_condition(ast->prev()));
     }
     return result;
 }
@@ -53,6 +79,16 @@ bool FollowSolver::validate<StatementAst, StatementAst>(
     return left->next() == right;
 }
 
+template <>
+bool FollowSolver::has_right<StatementAst>(StatementAst *ast) {
+    return ast->next() != NULL;
+}
+
+template <>
+bool FollowSolver::has_left<StatementAst>(StatementAst *ast) {
+    return ast->prev() != NULL;
+}
+
 
 
 }
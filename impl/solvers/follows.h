@@ -22,15 +22,25 @@
 #include "simple/condition.h"
 #include "simple/solver.h"
 #include "impl/condition.h"
+#include "impl/condition_pool.h"
 
 namespace simple {
 namespace impl {
 
 using namespace simple;
 
+/*
+ * Whether some statement of the program is followed by another one,
+ * i.e. whether some statement list has more than one statement.
+ */
+bool has_follows_pair(SimpleRoot ast);
+
 class FollowSolver {
   public:
-    FollowSolver(SimpleRoot ast) : _ast(ast) { }
+    FollowSolver(SimpleRoot ast, 
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool())) : 
+        _ast(ast), _pool(pool), _any(has_follows_pair(ast))
+    { }
 
     /*
      * SOLVE RIGHT PART
@@ -50,8 +60,27 @@ class FollowSolver {
         return false;
     }
 
+    /*
+     * EXISTENCE PROBES
+     */
+    template <typename Condition>
+    bool has_right(Condition *condition) {
+        return false;
+    }
+
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any() {
+        return _any;
+    }
+
   private:
     SimpleRoot _ast;
+    ConditionPoolPtr _pool;
+    bool _any;
 };
 
 template <>
@@ -64,6 +93,12 @@ template <>
 bool FollowSolver::validate<StatementAst, StatementAst>(
         StatementAst *left, StatementAst *right);
 
+template <>
+bool FollowSolver::has_right<StatementAst>(StatementAst *ast);
+
+template <>
+bool FollowSolver::has_left<StatementAst>(StatementAst *ast);
+
 
 } // namespace impl
 } // namespace simple
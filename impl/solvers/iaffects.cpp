@@ -0,0 +1,149 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "impl/solvers/iaffects.h"
+#include "impl/cancellation.h"
+#include "impl/condition.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+IAffectsSolver::IAffectsSolver(SimpleRoot ast, 
+        std::shared_ptr<AffectsQuerySolver> solver, ConditionPoolPtr pool) :
+    _ast(ast), _pool(pool), _affects_solver(solver), 
+    _forward_closures(), _backward_closures(), _closure_lock()
+{ }
+
+const BitVector* IAffectsSolver::get_closure(StatementAst *statement,
+        bool forward, AffectsGraph *&graph)
+{
+    graph = _affects_solver->get_graph(statement);
+    if(graph == NULL) {
+        return NULL;
+    }
+
+    std::map<StatementAst*, size_t>::iterator index = 
+        graph->index.find(statement);
+    if(index == graph->index.end()) {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> guard(_closure_lock);
+
+    ClosureTable& closures = forward ? _forward_closures : _backward_closures;
+    ClosureTable::iterator cached = closures.find(statement);
+    if(cached != closures.end()) {
+        return &cached->second;
+    }
+
+    const std::vector<std::vector<size_t> >& edges = 
+        forward ? graph->affects : graph->affected_by;
+
+    // the start itself is only in its row if it lies on a cycle
+    BitVector row(graph->assignments.size());
+    std::vector<size_t> stack(edges[index->second]);
+
+    while(!stack.empty()) {
+        check_cancellation();
+
+        size_t current = stack.back();
+        stack.pop_back();
+
+        if(row.test(current)) {
+            continue;
+        }
+        row.set(current);
+
+        const std::vector<size_t>& next = edges[current];
+        for(size_t i = 0; i < next.size(); ++i) {
+            if(!row.test(next[i])) {
+                stack.push_back(next[i]);
+            }
+        }
+    }
+
+    return &(closures[statement] = row);
+}
+
+ConditionSet IAffectsSolver::to_conditions(AffectsGraph *graph, 
+        const BitVector *row)
+{
+    ConditionSet result;
+    if(row == NULL) {
+        return result;
+    }
+
+    std::vector<size_t> indexes = row->get_indexes();
+    for(size_t i = 0; i < indexes.size(); ++i) {
+        result.insert(_pool->get_statement_condition(
+                    graph->assignments[indexes[i]]));
+    }
+    return result;
+}
+
+template <>
+ConditionSet IAffectsSolver::solve_right<StatementAst>(StatementAst *statement) {
+    AffectsGraph *graph;
+    const BitVector *row = get_closure(statement, true, graph);
+    return to_conditions(graph, row);
+}
+
+template <>
+ConditionSet IAffectsSolver::solve_left<StatementAst>(StatementAst *statement) {
+    AffectsGraph *graph;
+    const BitVector *row = get_closure(statement, false, graph);
+    return to_conditions(graph, row);
+}
+
+template <>
+bool IAffectsSolver::validate<StatementAst, StatementAst>(
+        StatementAst *statement1, StatementAst *statement2)
+{
+    AffectsGraph *graph;
+    const BitVector *row = get_closure(statement1, true, graph);
+
+    if(row == NULL) {
+        return false;
+    }
+
+    std::map<StatementAst*, size_t>::iterator index = 
+        graph->index.find(statement2);
+    return index != graph->index.end() && row->test(index->second);
+}
+
+template <>
+bool IAffectsSolver::has_right<StatementAst>(StatementAst *statement) {
+    return has_affects_edge(_affects_solver->get_graph(statement), 
+            statement, true);
+}
+
+template <>
+bool IAffectsSolver::has_left<StatementAst>(StatementAst *statement) {
+    return has_affects_edge(_affects_solver->get_graph(statement), 
+            statement, false);
+}
+
+bool IAffectsSolver::has_any() {
+    return has_affects_pair(_ast, _affects_solver.get());
+}
+
+} // namespace impl
+} // namespace simple
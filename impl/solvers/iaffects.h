@@ -0,0 +1,126 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include "simple/ast.h"
+#include "simple/condition_set.h"
+#include "simple/solver.h"
+#include "impl/bit_vector.h"
+#include "impl/condition_pool.h"
+#include "impl/solvers/affects.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * Affects*, the transitive closure of Affects. Built over AffectsBipSolver
+ * instead, it is AffectsBip*.
+ *
+ * The closure row of an assignment, i.e. all the assignments reachable
+ * from it in the affects graph containing it, is computed with a
+ * single traversal the first time it is needed and kept as a bit vector
+ * indexed by the assignment numbers of the graph. Validating a pair is
+ * then a single bit test, so Affects*(a1, a2) over all assignments costs
+ * one traversal per assignment rather than one per pair.
+ */
+class IAffectsSolver {
+  public:
+    IAffectsSolver(SimpleRoot ast, std::shared_ptr<AffectsQuerySolver> solver,
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool()));
+
+    template <typename Condition>
+    ConditionSet solve_right(Condition *condition) {
+        return ConditionSet();
+    }
+
+    template <typename Condition>
+    ConditionSet solve_left(Condition *condition) {
+        return ConditionSet();
+    }
+
+    template <typename Condition1, typename Condition2>
+    bool validate(Condition1 *condition1, Condition2 *condition2) {
+        return false;
+    }
+
+    /*
+     * EXISTENCE PROBES
+     *
+     * Affects*() relates an assignment to something exactly when 
+     * Affects() does, so the closure rows are not needed.
+     */
+    template <typename Condition>
+    bool has_right(Condition *condition) {
+        return false;
+    }
+
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any();
+
+  private:
+    typedef std::map<StatementAst*, BitVector> ClosureTable;
+
+    /*
+     * Get the closure row of an assignment, following the affects edges
+     * forward or backward. Return NULL if the statement is not an 
+     * assignment of the program.
+     */
+    const BitVector* get_closure(StatementAst *statement, bool forward,
+            AffectsGraph *&graph);
+
+    ConditionSet to_conditions(AffectsGraph *graph, const BitVector *row);
+
+    SimpleRoot _ast;
+    ConditionPoolPtr _pool;
+    std::shared_ptr<AffectsQuerySolver> _affects_solver;
+
+    ClosureTable _forward_closures;
+    ClosureTable _backward_closures;
+
+    // guards the closure tables
+    std::mutex _closure_lock;
+};
+
+template <>
+ConditionSet IAffectsSolver::solve_right<StatementAst>(StatementAst *statement);
+
+template <>
+ConditionSet IAffectsSolver::solve_left<StatementAst>(StatementAst *statement);
+
+template <>
+bool IAffectsSolver::validate<StatementAst, StatementAst>(
+        StatementAst *statement1, StatementAst *statement2);
+
+template <>
+bool IAffectsSolver::has_right<StatementAst>(StatementAst *statement);
+
+template <>
+bool IAffectsSolver::has_left<StatementAst>(StatementAst *statement);
+
+} // namespace impl
+} // namespace simple
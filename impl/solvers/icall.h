@@ -18,11 +18,11 @@
 
 #pragma once
 
-#include <map>
-#include <set>
+#include <memory>
 #include "simple/ast.h"
 #include "simple/condition.h"
 #include "simple/solver.h"
+#include "impl/call_graph.h"
 
 namespace simple {
 namespace impl {
@@ -32,6 +32,7 @@ using namespace simple;
 class ICallSolver {
   public:
     ICallSolver(SimpleRoot ast);
+    ICallSolver(SimpleRoot ast, std::shared_ptr<CallGraph> call_graph);
 
     /*
      * SOLVE RIGHT PART
@@ -51,16 +52,24 @@ class ICallSolver {
         return false;
     }
 
+    /*
+     * EXISTENCE PROBES
+     */
     template <typename Condition>
-    void index_calls(Condition *condition) {
-        // no-op
+    bool has_right(Condition *condition) {
+        return false;
     }
 
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any();
+
   private:
-    typedef std::map<ProcAst*, std::set<ProcAst*> > ProcIndex;
     SimpleRoot _ast;
-    ProcIndex _calls_table;
-    ProcIndex _called_table;
+    std::shared_ptr<CallGraph> _call_graph;
 };
 
 template <>
@@ -73,23 +82,10 @@ template <>
 bool ICallSolver::validate<ProcAst, ProcAst>(ProcAst *proc1, ProcAst *proc2);
 
 template <>
-void ICallSolver::index_calls<StatementAst>(StatementAst *statement);
-
-template <>
-void ICallSolver::index_calls<ProcAst>(ProcAst *proc);
-
-template <>
-void ICallSolver::index_calls<CallAst>(CallAst *call);
-
-template <>
-void ICallSolver::index_calls<WhileAst>(WhileAst *loop);
+bool ICallSolver::has_right<ProcAst>(ProcAst *proc);
 
 template <>
-void ICallSolver::index_calls<ConditionalAst>(ConditionalAst *condition);
-
-
-
-
+bool ICallSolver::has_left<ProcAst>(ProcAst *proc);
 
 } // namespace impl
 } // namespace simple
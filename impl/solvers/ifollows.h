@@ -22,6 +22,9 @@
 #include "simple/condition.h"
 #include "simple/solver.h"
 #include "impl/condition.h"
+#include "impl/condition_pool.h"
+#include "impl/cursor.h"
+#include "impl/solvers/follows.h"
 
 namespace simple {
 namespace impl {
@@ -30,7 +33,10 @@ using namespace simple;
 
 class IFollowSolver {
   public:
-    IFollowSolver(SimpleRoot ast) : _ast(ast) { }
+    IFollowSolver(SimpleRoot ast, 
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool())) : 
+        _ast(ast), _pool(pool), _any(has_follows_pair(ast))
+    { }
 
     /*
      * SOLVE RIGHT PART
@@ -50,48 +56,50 @@ class IFollowSolver {
         return false;
     }
 
+    /*
+     * EXISTENCE PROBES
+     */
+    template <typename Condition>
+    bool has_right(Condition *condition) {
+        return false;
+    }
+
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any() {
+        return _any;
+    }
+
+    /*
+     * solve_right and solve_left of a statement, one result at a time.
+     */
+    ConditionCursorPtr cursor_right(StatementAst *statement);
+    ConditionCursorPtr cursor_left(StatementAst *statement);
+
   private:
     SimpleRoot _ast;
+    ConditionPoolPtr _pool;
+    bool _any;
 };
 
 template <>
-ConditionSet IFollowSolver::solve_right<StatementAst>(StatementAst *statement) {
-    ConditionSet result;
-
-    if(statement->next()) {
-        while(statement->next() != NULL) {
-            result.insert(new SimpleStatementCondition(statement->next()));
-            statement = statement->next();
-        }
-    }
-    return result;
-}
-    
+ConditionSet IFollowSolver::solve_right<StatementAst>(StatementAst *statement);
+
 template <>
-ConditionSet IFollowSolver::solve_left<StatementAst>(StatementAst *statement) {
-    ConditionSet result;
-
-    if(statement->prev()) {
-        while(statement->prev() != NULL) {
-            result.insert(new SimpleStatementCondition(statement->prev()));
-            statement = statement->prev();
-        }
-    }
-    return result;
-}
+ConditionSet IFollowSolver::solve_left<StatementAst>(StatementAst *statement);
 
 template <>
 bool IFollowSolver::validate<StatementAst, StatementAst>(
-        StatementAst *left, StatementAst *right)
-{
-    while(left->next() != NULL) {
-        if(left->next() == right) {
-            return true;
-        }
-        left = left->next();
-    }
-    return false;
-}
+        StatementAst *left, StatementAst *right);
+
+template <>
+bool IFollowSolver::has_right<StatementAst>(StatementAst *statement);
+
+template <>
+bool IFollowSolver::has_left<StatementAst>(StatementAst *statement);
 
 } // namespace impl
 } // namespace simple
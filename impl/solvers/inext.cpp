@@ -18,6 +18,7 @@
 
 #include <list>
 #include "impl/solvers/inext.h"
+#include "impl/cancellation.h"
 #include "impl/condition.h"
 #include "simple/util/statement_visitor_generator.h"
 
@@ -31,7 +32,7 @@ ConditionSet INextSolver::solve_right<StatementAst>(StatementAst *statement) {
 
     if(result_stats.size() == 0) {
         // initialize empty set cache
-        _inext_cache[statement] = result_stats;
+        update_cache(_inext_cache, statement, result_stats);
         return ConditionSet();
     }
 
@@ -40,11 +41,11 @@ ConditionSet INextSolver::solve_right<StatementAst>(StatementAst *statement) {
     for(StatementSet::iterator it = result_stats.begin(); 
             it != result_stats.end(); ++it)
     {
-        result.insert(new SimpleStatementCondition(*it));
+        result.insert(_pool->get_statement_condition(*it));
     }
 
     // cache the result for future use
-    _inext_cache[statement] = std::move(result_stats);
+    update_cache(_inext_cache, statement, result_stats);
     return result;
 }
 
@@ -55,7 +56,7 @@ ConditionSet INextSolver::solve_left<StatementAst>(StatementAst *statement) {
 
     if(result_stats.size() == 0) {
         // initialize empty set cache
-        _iprev_cache[statement] = result_stats;
+        update_cache(_iprev_cache, statement, result_stats);
         return ConditionSet();
     }
 
@@ -64,18 +65,27 @@ ConditionSet INextSolver::solve_left<StatementAst>(StatementAst *statement) {
     for(StatementSet::iterator it = result_stats.begin(); 
             it != result_stats.end(); ++it)
     {
-        result.insert(new SimpleStatementCondition(*it));
+        result.insert(_pool->get_statement_condition(*it));
     }
 
     // cache the result for future use
-    _iprev_cache[statement] = std::move(result_stats);
+    update_cache(_iprev_cache, statement, result_stats);
     return result;
 }
 
 
+template <>
+bool INextSolver::has_right<StatementAst>(StatementAst *statement) {
+    return has_next_statement(statement);
+}
+
+template <>
+bool INextSolver::has_left<StatementAst>(StatementAst *statement) {
+    return has_prev_statement(statement);
+}
+
 void INextSolver::solve_inext(StatementAst *statement, StatementSet& results) {
-    if(_inext_cache.count(statement) > 0) {
-        union_set(results, _inext_cache[statement]);
+    if(lookup_cache(_inext_cache, statement, results)) {
         return;
     } else {
         StatementSet direct_next = _next_solver->solve_next_statement(statement);
@@ -85,6 +95,8 @@ void INextSolver::solve_inext(StatementAst *statement, StatementSet& results) {
         for(StatementSet::iterator it = direct_next.begin();
             it != direct_next.end(); ++it)
         {
+            check_cancellation();
+
             if(results.count(*it) == 0) {
                 results.insert(*it);
                 solve_inext(*it, results);
@@ -94,8 +106,7 @@ void INextSolver::solve_inext(StatementAst *statement, StatementSet& results) {
 }
 
 void INextSolver::solve_iprev(StatementAst *statement, StatementSet& results) {
-    if(_iprev_cache.count(statement) > 0) {
-        union_set(results, _iprev_cache[statement]);
+    if(lookup_cache(_iprev_cache, statement, results)) {
         return;
     } else {
         StatementSet direct_prev = _next_solver->solve_prev_statement(statement);
@@ -105,6 +116,8 @@ void INextSolver::solve_iprev(StatementAst *statement, StatementSet& results) {
         for(StatementSet::iterator it = direct_prev.begin();
             it != direct_prev.end(); ++it)
         {
+            check_cancellation();
+
             if(results.count(*it) == 0) {
                 results.insert(*it);
                 solve_iprev(*it, results);
@@ -113,11 +126,32 @@ void INextSolver::solve_iprev(StatementAst *statement, StatementSet& results) {
     }
 }
 
+bool INextSolver::lookup_cache(INextTable& cache, StatementAst *statement,
+        StatementSet& results)
+{
+    std::lock_guard<std::mutex> guard(_cache_lock);
+
+    INextTable::iterator it = cache.find(statement);
+    if(it == cache.end()) {
+        return false;
+    }
+
+    union_set(results, it->second);
+    return true;
+}
+
+void INextSolver::update_cache(INextTable& cache, StatementAst *statement,
+        const StatementSet& results)
+{
+    std::lock_guard<std::mutex> guard(_cache_lock);
+    cache[statement] = results;
+}
+
 template <>
 bool INextSolver::validate<StatementAst, StatementAst>(
         StatementAst *statement1, StatementAst *statement2)
 {
-    ConditionPtr condition = new SimpleStatementCondition(statement2);
+    ConditionPtr condition = _pool->get_statement_condition(statement2);
     return solve_right<StatementAst>(statement1).has_element(condition);
 }
 
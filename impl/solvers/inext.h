@@ -19,8 +19,10 @@
 #pragma once
 
 #include <map>
+#include <mutex>
 #include "simple/solver.h"
 #include "impl/solvers/next.h"
+#include "impl/condition_pool.h"
 #include "simple/condition_set.h"
 #include "simple/ast.h"
 
@@ -33,8 +35,9 @@ class INextSolver {
   public:
     typedef std::map<StatementAst*, StatementSet>  INextTable;
 
-    INextSolver(SimpleRoot ast, std::shared_ptr<NextQuerySolver> solver) :
-        _ast(ast), _next_solver(solver)
+    INextSolver(SimpleRoot ast, std::shared_ptr<NextQuerySolver> solver,
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool())) :
+        _ast(ast), _pool(pool), _next_solver(solver), _any(has_next_pair(ast))
     { }
 
     template <typename Condition>
@@ -52,16 +55,45 @@ class INextSolver {
         return false;
     }
 
+    /*
+     * EXISTENCE PROBES
+     *
+     * Next*() relates a statement to something exactly when Next() does.
+     */
+    template <typename Condition>
+    bool has_right(Condition *condition) {
+        return false;
+    }
+
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any() {
+        return _any;
+    }
+
     void solve_inext(StatementAst *statement, StatementSet& results);
     void solve_iprev(StatementAst *statement, StatementSet& results);
 
   private:
+    bool lookup_cache(INextTable& cache, StatementAst *statement, 
+            StatementSet& results);
+    void update_cache(INextTable& cache, StatementAst *statement,
+            const StatementSet& results);
+
     SimpleRoot _ast;
+    ConditionPoolPtr _pool;
     std::shared_ptr<NextQuerySolver> _next_solver;
     INextTable _inext_cache;
     INextTable _iprev_cache;
     INextTable _inext_partial_cache;
     INextTable _iprev_partial_cache;
+    bool _any;
+
+    // guards the caches
+    std::mutex _cache_lock;
 };
 
 template <>
@@ -74,5 +106,11 @@ ConditionSet INextSolver::solve_right<StatementAst>(StatementAst *statement);
 template <>
 ConditionSet INextSolver::solve_left<StatementAst>(StatementAst *statement);
 
+template <>
+bool INextSolver::has_right<StatementAst>(StatementAst *statement);
+
+template <>
+bool INextSolver::has_left<StatementAst>(StatementAst *statement);
+
 }
 }
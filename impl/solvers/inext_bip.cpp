@@ -0,0 +1,103 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "impl/solvers/inext_bip.h"
+#include "impl/condition.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+INextBipSolver::INextBipSolver(SimpleRoot ast, std::shared_ptr<BipGraph> graph,
+        ConditionPoolPtr pool) :
+    _ast(ast), _pool(pool), _graph(graph), _any(graph->has_any_bip_edge()),
+    _forward_rows(), _backward_rows(), _row_lock()
+{ }
+
+const BitVector& INextBipSolver::get_reachable(size_t node, bool forward) {
+    std::lock_guard<std::mutex> guard(_row_lock);
+
+    ReachableTable& rows = forward ? _forward_rows : _backward_rows;
+    ReachableTable::iterator cached = rows.find(node);
+    if(cached != rows.end()) {
+        return cached->second;
+    }
+
+    return rows[node] = _graph->get_reachable(node, forward);
+}
+
+ConditionSet INextBipSolver::solve_statement(StatementAst *statement, 
+        bool forward)
+{
+    ConditionSet result;
+    size_t node;
+
+    if(!_graph->find_node(statement, node)) {
+        return result;
+    }
+
+    std::vector<size_t> nodes = get_reachable(node, forward).get_indexes();
+    for(size_t i = 0; i < nodes.size(); ++i) {
+        result.insert(_pool->get_statement_condition(
+                    _graph->get_node(nodes[i]).statement));
+    }
+    return result;
+}
+
+template <>
+ConditionSet INextBipSolver::solve_right<StatementAst>(StatementAst *statement) {
+    return solve_statement(statement, true);
+}
+
+template <>
+ConditionSet INextBipSolver::solve_left<StatementAst>(StatementAst *statement) {
+    return solve_statement(statement, false);
+}
+
+template <>
+bool INextBipSolver::validate<StatementAst, StatementAst>(
+        StatementAst *statement1, StatementAst *statement2)
+{
+    size_t node1, node2;
+    if(!_graph->find_node(statement1, node1) || 
+            !_graph->find_node(statement2, node2)) 
+    {
+        return false;
+    }
+
+    return get_reachable(node1, true).test(node2);
+}
+
+template <>
+bool INextBipSolver::has_right<StatementAst>(StatementAst *statement) {
+    size_t node;
+    return _graph->find_node(statement, node) && 
+        _graph->has_bip_edge(node, true);
+}
+
+template <>
+bool INextBipSolver::has_left<StatementAst>(StatementAst *statement) {
+    size_t node;
+    return _graph->find_node(statement, node) && 
+        _graph->has_bip_edge(node, false);
+}
+
+} // namespace impl
+} // namespace simple
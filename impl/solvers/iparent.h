@@ -22,6 +22,9 @@
 #include "simple/condition.h"
 #include "simple/solver.h"
 #include "impl/condition.h"
+#include "impl/condition_pool.h"
+#include "impl/cursor.h"
+#include "impl/solvers/parent.h"
 #include "simple/util/statement_visitor_generator.h"
 
 namespace simple {
@@ -32,7 +35,10 @@ using namespace simple::impl;
 
 class IParentSolver {
   public:
-    IParentSolver(SimpleRoot ast) : _ast(ast) { }
+    IParentSolver(SimpleRoot ast, 
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool())) : 
+        _ast(ast), _pool(pool), _any(has_parent_pair(ast))
+    { }
 
     /*
      * SOLVE RIGHT PART
@@ -52,103 +58,68 @@ class IParentSolver {
         return false;
     }
 
+    /*
+     * EXISTENCE PROBES
+     */
+    template <typename Condition>
+    bool has_right(Condition *condition) {
+        return false;
+    }
+
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any() {
+        return _any;
+    }
+
+    /*
+     * solve_right and solve_left of a statement, one result at a time.
+     */
+    ConditionCursorPtr cursor_right(StatementAst *statement);
+    ConditionCursorPtr cursor_left(StatementAst *statement);
+
   private:
     SimpleRoot _ast;
+    ConditionPoolPtr _pool;
+    bool _any;
 };
 
-
 template <>
-ConditionSet IParentSolver::solve_right<StatementAst>(StatementAst *statement) {
-    StatementVisitorGenerator<IParentSolver, 
-        SolveRightVisitorTraits<IParentSolver> > visitor(this);
-    statement->accept_statement_visitor(&visitor);
-    return visitor.return_result();
-}
+ConditionSet IParentSolver::solve_right<StatementAst>(StatementAst *statement);
 
 template <>
-ConditionSet IParentSolver::solve_right<WhileAst>(WhileAst *loop) {
-    ConditionSet result;
-    StatementAst *body = loop->get_body();
-
-    while(body != NULL) {
-        result.insert(new SimpleStatementCondition(body));
-        result.union_with(solve_right<StatementAst>(body));
-        body = body->next();
-    }
-
-    return result;
-}
+ConditionSet IParentSolver::solve_right<WhileAst>(WhileAst *loop);
 
 template <>
-ConditionSet IParentSolver::solve_right<ConditionalAst>(ConditionalAst *condition) {
-    ConditionSet result;
-    StatementAst *then_branch = condition->get_then_branch();
-    StatementAst *else_branch = condition->get_else_branch();
-
-    while(then_branch != NULL) {
-        result.insert(new SimpleStatementCondition(then_branch));
-        result.union_with(solve_right<StatementAst>(then_branch));
-        then_branch = then_branch->next();
-    }
-
-    while(else_branch != NULL) {
-        result.insert(new SimpleStatementCondition(else_branch));
-        result.union_with(solve_right<StatementAst>(else_branch));
-        else_branch = else_branch->next();
-    }
+ConditionSet IParentSolver::solve_right<ConditionalAst>(ConditionalAst *condition);
 
-    return result;
-}
-    
 template <>
-ConditionSet IParentSolver::solve_left<StatementAst>(StatementAst *statement) {
-    ConditionSet result;
-
-    while(statement->get_parent() != NULL) {
-        result.insert(new SimpleStatementCondition(statement->get_parent()));
-        statement = statement->get_parent();
-    }
-    return result;
-}
+ConditionSet IParentSolver::solve_left<StatementAst>(StatementAst *statement);
 
 template <>
 bool IParentSolver::validate<StatementAst, StatementAst>(
-        StatementAst *left, StatementAst *right)
-{
-    StatementVisitorGenerator<IParentSolver, 
-        PartialValidateVisitorTraits<IParentSolver> > visitor(this, right);
-    left->accept_statement_visitor(&visitor);
-    return visitor.return_result();
-}
+        StatementAst *left, StatementAst *right);
 
 template <>
 bool IParentSolver::validate<ContainerAst, StatementAst>(
-        ContainerAst *container, StatementAst *statement)
-{
-    ContainerAst *parent = statement->get_parent();
-    while(parent != NULL) {
-        if(parent == container) {
-            return true;
-        }
-        parent = parent->get_parent();
-    }
-    return false;
-}
+        ContainerAst *container, StatementAst *statement);
 
 template <>
 bool IParentSolver::validate<ConditionalAst, StatementAst>(
-        ConditionalAst *condition, StatementAst *statement)
-{
-    return validate<ContainerAst, StatementAst>(condition, statement);
-}
+        ConditionalAst *condition, StatementAst *statement);
 
 template <>
 bool IParentSolver::validate<WhileAst, StatementAst>(
-        WhileAst *loop, StatementAst *statement)
-{
-    return validate<ContainerAst, StatementAst>(loop, statement);
-}
+        WhileAst *loop, StatementAst *statement);
 
+template <>
+bool IParentSolver::has_right<StatementAst>(StatementAst *statement);
+
+template <>
+bool IParentSolver::has_left<StatementAst>(StatementAst *statement);
 
 } // namespace impl
 } // namespace simple
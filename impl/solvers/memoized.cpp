@@ -0,0 +1,219 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impl/solvers/memoized.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+// rough sizes of an entry and of every condition in its answer
+const size_t MEMO_ENTRY_SIZE = 96;
+const size_t MEMO_CONDITION_SIZE = 48;
+
+MemoizedSolver::MemoizedSolver(std::shared_ptr<QuerySolver> solver,
+        ConditionPoolPtr pool, size_t budget_bytes) :
+    _solver(solver), _pool(pool), _lock(), _enabled(true), 
+    _budget(budget_bytes), _entries(), _index(), _stats()
+{ }
+
+ConditionSet MemoizedSolver::solve_left(SimpleCondition *right_condition) {
+    return solve(right_condition, false);
+}
+
+ConditionSet MemoizedSolver::solve_right(SimpleCondition *left_condition) {
+    return solve(left_condition, true);
+}
+
+ConditionCursorPtr MemoizedSolver::cursor_left(
+        SimpleCondition *right_condition) 
+{
+    return cursor(right_condition, false);
+}
+
+ConditionCursorPtr MemoizedSolver::cursor_right(
+        SimpleCondition *left_condition) 
+{
+    return cursor(left_condition, true);
+}
+
+bool MemoizedSolver::validate(SimpleCondition *left_condition,
+        SimpleCondition *right_condition)
+{
+    return _solver->validate(left_condition, right_condition);
+}
+
+bool MemoizedSolver::has_right(SimpleCondition *left_condition) {
+    return _solver->has_right(left_condition);
+}
+
+bool MemoizedSolver::has_left(SimpleCondition *right_condition) {
+    return _solver->has_left(right_condition);
+}
+
+bool MemoizedSolver::has_any() {
+    return _solver->has_any();
+}
+
+KeyedQuerySolver* MemoizedSolver::as_keyed() {
+    return _solver->as_keyed();
+}
+
+void MemoizedSolver::set_enabled(bool enabled) {
+    std::lock_guard<std::mutex> guard(_lock);
+    _enabled = enabled;
+    if(!enabled) {
+        _entries.clear();
+        _index.clear();
+        _stats.entries = 0;
+        _stats.memory = 0;
+    }
+}
+
+bool MemoizedSolver::is_enabled() const {
+    return _enabled;
+}
+
+void MemoizedSolver::set_budget(size_t budget_bytes) {
+    std::lock_guard<std::mutex> guard(_lock);
+    _budget = budget_bytes;
+    evict();
+}
+
+size_t MemoizedSolver::get_budget() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _budget;
+}
+
+MemoStats MemoizedSolver::get_stats() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _stats;
+}
+
+void MemoizedSolver::clear() {
+    std::lock_guard<std::mutex> guard(_lock);
+    _entries.clear();
+    _index.clear();
+    _stats.entries = 0;
+    _stats.memory = 0;
+}
+
+QuerySolver* MemoizedSolver::get_solver() {
+    return _solver.get();
+}
+
+ConditionSet MemoizedSolver::solve(SimpleCondition *condition, bool forward) {
+    size_t id;
+    if(!_enabled || !_pool->find_id(condition, id)) {
+        return compute(condition, forward);
+    }
+
+    size_t key = get_key(id, forward);
+    ConditionSet result;
+    if(lookup(key, result)) {
+        return result;
+    }
+
+    result = compute(condition, forward);
+    store(key, result);
+    return result;
+}
+
+ConditionCursorPtr MemoizedSolver::cursor(SimpleCondition *condition, 
+        bool forward) 
+{
+    size_t id;
+    ConditionSet result;
+    if(_enabled && _pool->find_id(condition, id) && 
+            lookup(get_key(id, forward), result)) 
+    {
+        return ConditionCursorPtr(new ConditionSetCursor(result));
+    }
+
+    if(forward) {
+        return _solver->cursor_right(condition);
+    } else {
+        return _solver->cursor_left(condition);
+    }
+}
+
+size_t MemoizedSolver::get_key(size_t id, bool forward) {
+    // the two directions share the memo, told apart by the lowest bit
+    return id * 2 + (forward ? 1 : 0);
+}
+
+bool MemoizedSolver::lookup(size_t key, ConditionSet& result) {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    std::unordered_map<size_t, EntryList::iterator>::iterator it =
+        _index.find(key);
+    if(it == _index.end()) {
+        return false;
+    }
+
+    _entries.splice(_entries.begin(), _entries, it->second);
+    ++_stats.hits;
+    result = it->second->result;
+    return true;
+}
+
+void MemoizedSolver::store(size_t key, const ConditionSet& result) {
+    size_t size = MEMO_ENTRY_SIZE + result.get_size() * MEMO_CONDITION_SIZE;
+
+    std::lock_guard<std::mutex> guard(_lock);
+    if(!_enabled) {
+        return;
+    }
+
+    ++_stats.misses;
+    if(size > _budget || _index.count(key) > 0) {
+        return;
+    }
+
+    _entries.push_front(MemoEntry(key, result, size));
+    _index[key] = _entries.begin();
+    ++_stats.entries;
+    _stats.memory += size;
+
+    evict();
+}
+
+ConditionSet MemoizedSolver::compute(SimpleCondition *condition, 
+        bool forward) 
+{
+    if(forward) {
+        return _solver->solve_right(condition);
+    } else {
+        return _solver->solve_left(condition);
+    }
+}
+
+void MemoizedSolver::evict() {
+    while(_stats.memory > _budget && !_entries.empty()) {
+        MemoEntry& last = _entries.back();
+        _stats.memory -= last.size;
+        _index.erase(last.key);
+        _entries.pop_back();
+        --_stats.entries;
+        ++_stats.evictions;
+    }
+}
+
+} // namespace impl
+} // namespace simple
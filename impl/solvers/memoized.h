@@ -0,0 +1,147 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "simple/condition.h"
+#include "simple/solver.h"
+#include "impl/condition_pool.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+const size_t DEFAULT_MEMO_BUDGET = 4 * 1024 * 1024;
+
+struct MemoStats {
+  public:
+    MemoStats() :
+        hits(0), misses(0), evictions(0), entries(0), memory(0)
+    { }
+
+    // fraction of the memoizable solves answered from the memo
+    double hit_rate() const {
+        size_t total = hits + misses;
+        return total == 0 ? 0.0 : (double) hits / total;
+    }
+
+    size_t  hits;
+    size_t  misses;
+    size_t  evictions;
+    size_t  entries;
+
+    // estimated bytes held by the entries
+    size_t  memory;
+};
+
+/*
+ * Wraps a solver to memoize its solve_left() and solve_right() answers,
+ * keyed by the pool id of the given condition, so that the queries of a
+ * batch asking the same per-entity question, e.g. the children of one 
+ * statement for Parent*, only solve it once. Conditions outside of the
+ * pool are solved by the wrapped solver every time.
+ *
+ * The answers are kept in LRU order within a byte budget. Memoization 
+ * can be turned off per solver, after which every call is forwarded 
+ * unchanged; validate(), the existence probes and as_keyed() are always
+ * forwarded.
+ * The wrapped solver is called outside of the lock, as it may take a 
+ * while; concurrent misses on the same condition compute the same answer
+ * and only the first one is kept.
+ * Cursors are served from memoized answers, but are otherwise forwarded
+ * without memoizing what they yield, as they may not be pulled to the 
+ * end.
+ */
+class MemoizedSolver : public QuerySolver {
+  public:
+    MemoizedSolver(std::shared_ptr<QuerySolver> solver, 
+            ConditionPoolPtr pool, size_t budget_bytes = DEFAULT_MEMO_BUDGET);
+
+    ConditionSet solve_left(SimpleCondition *right_condition);
+    ConditionSet solve_right(SimpleCondition *left_condition);
+
+    bool validate(SimpleCondition *left_condition,
+            SimpleCondition *right_condition);
+
+    ConditionCursorPtr cursor_left(SimpleCondition *right_condition);
+    ConditionCursorPtr cursor_right(SimpleCondition *left_condition);
+
+    bool has_right(SimpleCondition *left_condition);
+    bool has_left(SimpleCondition *right_condition);
+    bool has_any();
+    KeyedQuerySolver* as_keyed();
+
+    /*
+     * Disabling memoization also drops the memoized answers.
+     */
+    void set_enabled(bool enabled);
+    bool is_enabled() const;
+
+    void set_budget(size_t budget_bytes);
+    size_t get_budget() const;
+
+    MemoStats get_stats() const;
+
+    void clear();
+
+    QuerySolver* get_solver();
+
+  private:
+    struct MemoEntry {
+        MemoEntry(size_t key, const ConditionSet& result, size_t size) :
+            key(key), result(result), size(size)
+        { }
+
+        size_t          key;
+        ConditionSet    result;
+        size_t          size;
+    };
+
+    typedef std::list<MemoEntry> EntryList;
+
+    ConditionSet solve(SimpleCondition *condition, bool forward);
+    ConditionCursorPtr cursor(SimpleCondition *condition, bool forward);
+    ConditionSet compute(SimpleCondition *condition, bool forward);
+    static size_t get_key(size_t id, bool forward);
+    bool lookup(size_t key, ConditionSet& result);
+    void store(size_t key, const ConditionSet& result);
+    void evict();
+
+    std::shared_ptr<QuerySolver> _solver;
+    ConditionPoolPtr    _pool;
+
+    mutable std::mutex  _lock;
+    // read without the lock, so that a disabled memo forwards every
+    // call straight to the wrapped solver
+    std::atomic<bool>   _enabled;
+    size_t              _budget;
+
+    // most recently used first
+    EntryList           _entries;
+    std::unordered_map<size_t, EntryList::iterator> _index;
+    MemoStats           _stats;
+};
+
+} // namespace impl
+} // namespace simple
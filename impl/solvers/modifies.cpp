@@ -77,12 +77,18 @@ class ModifiesVariableVisitorAdapter {
 };
 
 
-ModifiesSolver::ModifiesSolver(const SimpleRoot& ast) : 
-    _ast(ast) 
+ModifiesSolver::ModifiesSolver(const SimpleRoot& ast, ConditionPoolPtr pool) : 
+    _ast(ast), _pool(pool) 
 {
    for(SimpleRoot::iterator it = _ast.begin(); it != _ast.end(); ++it) {
        index_variables<ProcAst>(*it);
    } 
+
+   for(std::map<SimpleVariable, ConditionSet>::iterator it = _var_index.begin();
+           it != _var_index.end(); ++it)
+   {
+       _domain.union_with(it->second);
+   }
 }
 
 /*
@@ -227,7 +233,7 @@ ConditionSet ModifiesSolver::solve_right<ProcAst>(ProcAst *ast) {
 template <>
 ConditionSet ModifiesSolver::solve_right<AssignmentAst>(AssignmentAst *ast) {
     ConditionSet result;
-    result.insert(new SimpleVariableCondition(
+    result.insert(_pool->get_variable_condition(
             *(ast->get_variable())));
     return result;
 }
@@ -243,7 +249,7 @@ ConditionSet ModifiesSolver::solve_variable<AssignmentAst>(
 {
     if(validate<AssignmentAst, SimpleVariable>(ast, variable)) {
         ConditionSet result;
-        result.insert(new SimpleStatementCondition(ast));
+        result.insert(_pool->get_statement_condition(ast));
         return result;
     } else {
         return ConditionSet(); // empty set
@@ -269,7 +275,7 @@ template <>
 ConditionSet ModifiesSolver::solve_variable<CallAst>(CallAst *ast, SimpleVariable *variable) {
     if(validate<CallAst, SimpleVariable>(ast, variable)) {
         ConditionSet result;
-        result.insert(new SimpleStatementCondition(ast));
+        result.insert(_pool->get_statement_condition(ast));
         return result;
     } else {
         return ConditionSet(); // empty set
@@ -287,7 +293,7 @@ ConditionSet ModifiesSolver::solve_variable<ProcAst>(ProcAst *ast, SimpleVariabl
     }
 
     if(!result.is_empty()) {
-        result.insert(new SimpleProcCondition(ast));
+        result.insert(_pool->get_proc_condition(ast));
     }
 
     return result;
@@ -309,6 +315,32 @@ ConditionSet ModifiesSolver::solve_variable<StatementAst>(
     return visitor.return_result();
 }
 
+/*
+ * has_right() and has_left() definitions
+ */
+template <>
+bool ModifiesSolver::has_right<StatementAst>(StatementAst *ast) {
+    return _domain.has_element(_pool->get_statement_condition(ast));
+}
+
+template <>
+bool ModifiesSolver::has_right<ProcAst>(ProcAst *ast) {
+    return _domain.has_element(_pool->get_proc_condition(ast));
+}
+
+template <>
+bool ModifiesSolver::has_left<SimpleVariable>(SimpleVariable *variable) {
+    return _var_index.count(*variable) > 0;
+}
+
+bool ModifiesSolver::has_any() {
+    return !_var_index.empty();
+}
+
+const std::map<SimpleVariable, ConditionSet>& ModifiesSolver::get_var_index() const {
+    return _var_index;
+}
+
 /*
  * index_variable()
  */
@@ -334,14 +366,14 @@ template <>
 std::set<SimpleVariable> ModifiesSolver::index_variables<ProcAst>(ProcAst *proc) {
     std::set<SimpleVariable> result;
 
-    index_statement_list(proc->get_statement(), new SimpleProcCondition(proc), result);
+    index_statement_list(proc->get_statement(), _pool->get_proc_condition(proc), result);
 
     return result;
 }
 
 template <>
 std::set<SimpleVariable> ModifiesSolver::index_variables<AssignmentAst>(AssignmentAst *assign) {
-    _var_index[*assign->get_variable()].insert(new SimpleStatementCondition(assign));
+    _var_index[*assign->get_variable()].insert(_pool->get_statement_condition(assign));
     std::set<SimpleVariable> result;
     result.insert(*assign->get_variable());
     return result;
@@ -351,7 +383,7 @@ template <>
 std::set<SimpleVariable> ModifiesSolver::index_variables<WhileAst>(WhileAst *ast) {
     std::set<SimpleVariable> result;
 
-    index_statement_list(ast->get_body(), new SimpleStatementCondition(ast), result);
+    index_statement_list(ast->get_body(), _pool->get_statement_condition(ast), result);
 
     return result;
 }
@@ -359,7 +391,7 @@ std::set<SimpleVariable> ModifiesSolver::index_variables<WhileAst>(WhileAst *ast
 template <>
 std::set<SimpleVariable> ModifiesSolver::index_variables<ConditionalAst>(ConditionalAst *ast) {
     std::set<SimpleVariable> result;
-    ConditionPtr condition = new SimpleStatementCondition(ast);
+    ConditionPtr condition = _pool->get_statement_condition(ast);
 
     index_statement_list(ast->get_then_branch(), condition, result);
     index_statement_list(ast->get_else_branch(), condition, result);
@@ -370,7 +402,7 @@ std::set<SimpleVariable> ModifiesSolver::index_variables<ConditionalAst>(Conditi
 template <>
 std::set<SimpleVariable> ModifiesSolver::index_variables<CallAst>(CallAst *ast) {
     std::set<SimpleVariable> result = index_variables<ProcAst>(ast->get_proc_called());
-    ConditionPtr this_condition = new SimpleStatementCondition(ast);
+    ConditionPtr this_condition = _pool->get_statement_condition(ast);
 
     for(std::set<SimpleVariable>::iterator it = result.begin();
             it != result.end(); ++it)
@@ -24,6 +24,7 @@
 #include "simple/condition.h"
 #include "simple/condition_set.h"
 #include "simple/solver.h"
+#include "impl/condition_pool.h"
 #include "simple/util/statement_visitor_generator.h"
 
 namespace simple {
@@ -41,7 +42,8 @@ class ModifiesQuerySolver {
 
 class ModifiesSolver {
   public:
-    ModifiesSolver(const SimpleRoot& ast);
+    ModifiesSolver(const SimpleRoot& ast, 
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool()));
 
     template <typename Condition1, typename Condition2>
     bool validate(Condition1 *condition1, Condition2 *condition2);
@@ -58,11 +60,28 @@ class ModifiesSolver {
     template <typename Condition>
     std::set<SimpleVariable> index_variables(Condition *condition);
 
+    template <typename Condition>
+    bool has_right(Condition *condition);
+
+    template <typename Condition>
+    bool has_left(Condition *condition);
+
+    bool has_any();
+
+    /*
+     * The statements and procedures modifying each variable.
+     */
+    const std::map<SimpleVariable, ConditionSet>& get_var_index() const;
+
     ~ModifiesSolver() { }
   private:
     SimpleRoot _ast;
+    ConditionPoolPtr _pool;
     std::map<SimpleVariable, ConditionSet> _var_index;
 
+    // the statements and procedures modifying some variable
+    ConditionSet _domain;
+
     void index_statement_list(StatementAst *statement, ConditionPtr condition, std::set<SimpleVariable>& result);
 };
 
@@ -92,7 +111,17 @@ ConditionSet ModifiesSolver::solve_left(Condition *condition) {
 
 template <typename Condition>
 std::set<SimpleVariable> ModifiesSolver::index_variables(Condition *condition) {
-    return ConditionSet();
+    return std::set<SimpleVariable>();
+}
+
+template <typename Condition>
+bool ModifiesSolver::has_right(Condition *condition) {
+    return false;
+}
+
+template <typename Condition>
+bool ModifiesSolver::has_left(Condition *condition) {
+    return false;
 }
 
 
@@ -173,6 +202,15 @@ std::set<SimpleVariable> ModifiesSolver::index_variables<CallAst>(CallAst *ast);
 template <>
 std::set<SimpleVariable> ModifiesSolver::index_variables<StatementAst>(StatementAst *statement);
 
+template <>
+bool ModifiesSolver::has_right<StatementAst>(StatementAst *ast);
+
+template <>
+bool ModifiesSolver::has_right<ProcAst>(ProcAst *ast);
+
+template <>
+bool ModifiesSolver::has_left<SimpleVariable>(SimpleVariable *variable);
+
 
 } // namespace impl
 } // namespace simple
@@ -27,6 +27,8 @@ namespace impl {
 
 using namespace simple;
 using simple::util::is_statement_type;
+using simple::util::get_nested_lists;
+using simple::util::is_while_statement;
 
 class SolveNextVisitorTraits {
   public:
@@ -105,7 +107,7 @@ ConditionSet NextSolver::solve_right<StatementAst>(StatementAst *ast) {
     for(StatementSet::iterator it = statements.begin(); 
             it!= statements.end(); ++it)
     {
-        result.insert(new SimpleStatementCondition(*it));
+        result.insert(_pool->get_statement_condition(*it));
     }
     return result;
 }
@@ -118,7 +120,7 @@ ConditionSet NextSolver::solve_left<StatementAst>(StatementAst *ast) {
     for(StatementSet::iterator it = statements.begin(); 
             it!= statements.end(); ++it)
     {
-        result.insert(new SimpleStatementCondition(*it));
+        result.insert(_pool->get_statement_condition(*it));
     }
     return result;
 }
@@ -528,6 +530,56 @@ bool NextSolver::validate_container_next<WhileAst>(WhileAst *container, Statemen
 
 
 
+/*
+ * The last statement of a while body goes back to the loop, and the last
+ * statement of an if branch goes on after the if statement, so the 
+ * containers are walked up until one of them settles it.
+ */
+bool has_next_statement(StatementAst *statement) {
+    if(!get_nested_lists(statement).empty()) {
+        return true;
+    }
+
+    while(statement->next() == NULL) {
+        ContainerAst *parent = statement->get_parent();
+        if(parent == NULL) {
+            return false;
+        } else if(is_while_statement(parent)) {
+            return true;
+        }
+        statement = parent;
+    }
+    return true;
+}
+
+bool has_prev_statement(StatementAst *statement) {
+    if(statement->prev() != NULL || statement->get_parent() != NULL) {
+        return true;
+    }
+    return is_while_statement(statement) && 
+        !get_nested_lists(statement).empty();
+}
+
+bool has_next_pair(SimpleRoot ast) {
+    for(SimpleRoot::iterator it = ast.begin(); it != ast.end(); ++it) {
+        StatementAst *statement = (*it)->get_statement();
+        if(statement != NULL && has_next_statement(statement)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <>
+bool NextSolver::has_right<StatementAst>(StatementAst *statement) {
+    return has_next_statement(statement);
+}
+
+template <>
+bool NextSolver::has_left<StatementAst>(StatementAst *statement) {
+    return has_prev_statement(statement);
+}
+
 void ValidateNextStatementVisitor::visit_conditional(ConditionalAst *ast) {
     _result = _solver->validate_next<ConditionalAst>(ast, _statement);
 }
@@ -24,12 +24,26 @@
 #include "simple/condition.h"
 #include "simple/condition_set.h"
 #include "simple/solver.h"
+#include "impl/condition_pool.h"
 
 namespace simple {
 namespace impl {
 
 using namespace simple;
 
+/*
+ * Whether a statement has a statement executed right after or right 
+ * before it, without solving for those statements.
+ */
+bool has_next_statement(StatementAst *statement);
+bool has_prev_statement(StatementAst *statement);
+
+/*
+ * Whether some procedure of the program has a Next() pair, i.e. whether
+ * its first statement has a next statement.
+ */
+bool has_next_pair(SimpleRoot ast);
+
 class NextQuerySolver {
   public:
     virtual StatementSet solve_next_statement(StatementAst *statement) = 0;
@@ -40,7 +54,10 @@ class NextQuerySolver {
 
 class NextSolver : public NextQuerySolver {
   public:
-    NextSolver(SimpleRoot ast) : _ast(ast) { }
+    NextSolver(SimpleRoot ast, 
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool())) : 
+        _ast(ast), _pool(pool), _any(has_next_pair(ast))
+    { }
 
     template <typename Condition>
     ConditionSet solve_right(Condition *condition);
@@ -75,9 +92,27 @@ class NextSolver : public NextQuerySolver {
     template <typename Container>
     bool validate_container_next(Container *container, StatementAst *statement);
 
+    /*
+     * EXISTENCE PROBES
+     */
+    template <typename Condition>
+    bool has_right(Condition *condition) {
+        return false;
+    }
+
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any() {
+        return _any;
+    }
 
   private:
     SimpleRoot _ast;
+    ConditionPoolPtr _pool;
+    bool _any;
 };
 
 template <typename Condition>
@@ -224,5 +259,11 @@ StatementSet NextSolver::solve_last_previous<AssignmentAst>(AssignmentAst *assig
 template <>
 StatementSet NextSolver::solve_last_previous<CallAst>(CallAst *call);
 
+template <>
+bool NextSolver::has_right<StatementAst>(StatementAst *statement);
+
+template <>
+bool NextSolver::has_left<StatementAst>(StatementAst *statement);
+
 } // namespace impl
 } // namespace simple
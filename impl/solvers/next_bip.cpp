@@ -0,0 +1,92 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <vector>
+#include "impl/solvers/next_bip.h"
+#include "impl/condition.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+NextBipSolver::NextBipSolver(SimpleRoot ast, std::shared_ptr<BipGraph> graph,
+        ConditionPoolPtr pool) :
+    _ast(ast), _pool(pool), _graph(graph), _any(graph->has_any_bip_edge())
+{ }
+
+ConditionSet NextBipSolver::solve_statement(StatementAst *statement, 
+        bool forward)
+{
+    ConditionSet result;
+    size_t node;
+
+    if(!_graph->find_node(statement, node)) {
+        return result;
+    }
+
+    std::vector<size_t> edges = _graph->get_bip_edges(node, forward);
+    for(size_t i = 0; i < edges.size(); ++i) {
+        result.insert(_pool->get_statement_condition(
+                    _graph->get_node(edges[i]).statement));
+    }
+    return result;
+}
+
+template <>
+ConditionSet NextBipSolver::solve_right<StatementAst>(StatementAst *statement) {
+    return solve_statement(statement, true);
+}
+
+template <>
+ConditionSet NextBipSolver::solve_left<StatementAst>(StatementAst *statement) {
+    return solve_statement(statement, false);
+}
+
+template <>
+bool NextBipSolver::validate<StatementAst, StatementAst>(
+        StatementAst *statement1, StatementAst *statement2)
+{
+    size_t node1, node2;
+    if(!_graph->find_node(statement1, node1) || 
+            !_graph->find_node(statement2, node2)) 
+    {
+        return false;
+    }
+
+    std::vector<size_t> edges = _graph->get_bip_edges(node1, true);
+    return std::binary_search(edges.begin(), edges.end(), node2);
+}
+
+template <>
+bool NextBipSolver::has_right<StatementAst>(StatementAst *statement) {
+    size_t node;
+    return _graph->find_node(statement, node) && 
+        _graph->has_bip_edge(node, true);
+}
+
+template <>
+bool NextBipSolver::has_left<StatementAst>(StatementAst *statement) {
+    size_t node;
+    return _graph->find_node(statement, node) && 
+        _graph->has_bip_edge(node, false);
+}
+
+} // namespace impl
+} // namespace simple
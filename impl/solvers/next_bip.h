@@ -0,0 +1,101 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include "simple/ast.h"
+#include "simple/condition_set.h"
+#include "simple/solver.h"
+#include "impl/bip_graph.h"
+#include "impl/condition_pool.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * NextBip, the Next relation branching into procedures. A call is 
+ * followed by the first statement of its callee, and the last statements
+ * of a procedure are followed by the statements after every call to it.
+ */
+class NextBipSolver {
+  public:
+    NextBipSolver(SimpleRoot ast, std::shared_ptr<BipGraph> graph,
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool()));
+
+    template <typename Condition>
+    ConditionSet solve_right(Condition *condition) {
+        return ConditionSet();
+    }
+
+    template <typename Condition>
+    ConditionSet solve_left(Condition *condition) {
+        return ConditionSet();
+    }
+
+    template <typename Condition1, typename Condition2>
+    bool validate(Condition1 *condition1, Condition2 *condition2) {
+        return false;
+    }
+
+    /*
+     * EXISTENCE PROBES
+     */
+    template <typename Condition>
+    bool has_right(Condition *condition) {
+        return false;
+    }
+
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any() {
+        return _any;
+    }
+
+  private:
+    ConditionSet solve_statement(StatementAst *statement, bool forward);
+
+    SimpleRoot _ast;
+    ConditionPoolPtr _pool;
+    std::shared_ptr<BipGraph> _graph;
+    bool _any;
+};
+
+template <>
+ConditionSet NextBipSolver::solve_right<StatementAst>(StatementAst *statement);
+
+template <>
+ConditionSet NextBipSolver::solve_left<StatementAst>(StatementAst *statement);
+
+template <>
+bool NextBipSolver::validate<StatementAst, StatementAst>(
+        StatementAst *statement1, StatementAst *statement2);
+
+template <>
+bool NextBipSolver::has_right<StatementAst>(StatementAst *statement);
+
+template <>
+bool NextBipSolver::has_left<StatementAst>(StatementAst *statement);
+
+} // namespace impl
+} // namespace simple
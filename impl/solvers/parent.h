@@ -22,6 +22,7 @@
 #include "simple/condition.h"
 #include "simple/solver.h"
 #include "impl/condition.h"
+#include "impl/condition_pool.h"
 #include "simple/util/statement_visitor_generator.h"
 
 namespace simple {
@@ -29,9 +30,22 @@ namespace impl {
 
 using namespace simple;
 
+/*
+ * Whether a statement has statements nested in it.
+ */
+bool has_child_statements(StatementAst *statement);
+
+/*
+ * Whether some statement of the program has statements nested in it.
+ */
+bool has_parent_pair(SimpleRoot ast);
+
 class ParentSolver {
   public:
-    ParentSolver(SimpleRoot ast) : _ast(ast) { }
+    ParentSolver(SimpleRoot ast, 
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool())) : 
+        _ast(ast), _pool(pool), _any(has_parent_pair(ast))
+    { }
 
     /*
      * SOLVE RIGHT PART
@@ -51,85 +65,58 @@ class ParentSolver {
         return false;
     }
 
+    /*
+     * EXISTENCE PROBES
+     */
+    template <typename Condition>
+    bool has_right(Condition *condition) {
+        return false;
+    }
+
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any() {
+        return _any;
+    }
+
   private:
     SimpleRoot _ast;
+    ConditionPoolPtr _pool;
+    bool _any;
 };
 
-
 template <>
-ConditionSet ParentSolver::solve_right<StatementAst>(StatementAst *statement) {
-    StatementVisitorGenerator<ParentSolver, 
-        SolveRightVisitorTraits<ParentSolver> > visitor(this);
-    statement->accept_statement_visitor(&visitor);
-    return visitor.return_result();
-}
+ConditionSet ParentSolver::solve_right<StatementAst>(StatementAst *statement);
 
 template <>
-ConditionSet ParentSolver::solve_right<WhileAst>(WhileAst *loop) {
-    ConditionSet result;
-    StatementAst *body = loop->get_body();
-
-    while(body != NULL) {
-        result.insert(new SimpleStatementCondition(body));
-        body = body->next();
-    }
-
-    return result;
-}
+ConditionSet ParentSolver::solve_right<WhileAst>(WhileAst *loop);
 
 template <>
-ConditionSet ParentSolver::solve_right<ConditionalAst>(ConditionalAst *condition) {
-    ConditionSet result;
-    StatementAst *then_branch = condition->get_then_branch();
-    StatementAst *else_branch = condition->get_else_branch();
-
-    while(then_branch != NULL) {
-        result.insert(new SimpleStatementCondition(then_branch));
-        then_branch = then_branch->next();
-    }
+ConditionSet ParentSolver::solve_right<ConditionalAst>(ConditionalAst *condition);
 
-    while(else_branch != NULL) {
-        result.insert(new SimpleStatementCondition(else_branch));
-        else_branch = else_branch->next();
-    }
-
-    return result;
-}
-    
 template <>
-ConditionSet ParentSolver::solve_left<StatementAst>(StatementAst *ast) {
-    ConditionSet result;
-
-    if(ast->get_parent()) {
-        result.insert(new SimpleStatementCondition(ast->get_parent()));
-    }
-    return result;
-}
+ConditionSet ParentSolver::solve_left<StatementAst>(StatementAst *ast);
 
 template <>
 bool ParentSolver::validate<StatementAst, StatementAst>(
-        StatementAst *left, StatementAst *right)
-{
-    StatementVisitorGenerator<ParentSolver, 
-        PartialValidateVisitorTraits<ParentSolver> > visitor(this, right);
-    left->accept_statement_visitor(&visitor);
-    return visitor.return_result();
-}
+        StatementAst *left, StatementAst *right);
 
 template <>
 bool ParentSolver::validate<ConditionalAst, StatementAst>(
-        ConditionalAst *condition, StatementAst *statement)
-{
-    return statement->get_parent() == static_cast<ContainerAst*>(condition);
-}
+        ConditionalAst *condition, StatementAst *statement);
 
 template <>
 bool ParentSolver::validate<WhileAst, StatementAst>(
-        WhileAst *loop, StatementAst *statement)
-{
-    return statement->get_parent() == static_cast<ContainerAst*>(loop);
-}
+        WhileAst *loop, StatementAst *statement);
 
+template <>
+bool ParentSolver::has_right<StatementAst>(StatementAst *statement);
+
+template <>
+bool ParentSolver::has_left<StatementAst>(StatementAst *statement);
 
 } // namespace impl
 } // namespace simple
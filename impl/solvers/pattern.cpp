@@ -0,0 +1,147 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include "impl/solvers/pattern.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * Prints an expression in prefix form, e.g. (+ x (* y 2)).
+ */
+class ExprPrinter : public ExprVisitor {
+  public:
+    ExprPrinter(std::ostream& out) : _out(out) { }
+
+    void visit_const(ConstAst *val) {
+        _out << val->get_constant()->get_int();
+    }
+
+    void visit_variable(VariableAst *var) {
+        _out << var->get_variable()->get_name();
+    }
+
+    void visit_binary_op(BinaryOpAst *bin) {
+        _out << "(" << bin->get_op() << " ";
+        bin->get_lhs()->accept_expr_visitor(this);
+        _out << " ";
+        bin->get_rhs()->accept_expr_visitor(this);
+        _out << ")";
+    }
+
+  private:
+    std::ostream& _out;
+};
+
+PatternSolver::PatternSolver(std::shared_ptr<PatternIndex> index, 
+        ExprPtr expr, bool exact, ConditionPoolPtr pool) :
+    _index(index), _pool(pool), _expr(expr), _key(), _matches()
+{
+    std::stringstream key;
+    if(!expr) {
+        key << "_";
+    } else {
+        key << (exact ? "exact " : "subexpr ");
+        ExprPrinter printer(key);
+        expr->accept_expr_visitor(&printer);
+    }
+    _key = key.str();
+
+    std::vector<AssignmentAst*> matches;
+
+    if(!expr) {
+        matches = index->get_assignments();
+    } else if(exact) {
+        matches = index->find_exact(expr.get());
+    } else {
+        matches = index->find_subexpr(expr.get());
+    }
+
+    for(std::vector<AssignmentAst*>::iterator it = matches.begin();
+            it != matches.end(); ++it)
+    {
+        _matches[*it] = *it;
+    }
+}
+
+const std::string& PatternSolver::get_key() const {
+    return _key;
+}
+
+template <>
+ConditionSet PatternSolver::solve_right<StatementAst>(StatementAst *ast) {
+    ConditionSet result;
+
+    std::map<StatementAst*, AssignmentAst*>::iterator it = _matches.find(ast);
+    if(it != _matches.end()) {
+        result.insert(_pool->get_variable_condition(
+                    *it->second->get_variable()));
+    }
+    return result;
+}
+
+template <>
+ConditionSet PatternSolver::solve_left<SimpleVariable>(SimpleVariable *var) {
+    ConditionSet result;
+
+    const std::vector<AssignmentAst*>& assignments = 
+        _index->get_assignments(var);
+
+    for(std::vector<AssignmentAst*>::const_iterator it = assignments.begin();
+            it != assignments.end(); ++it)
+    {
+        if(_matches.count(*it) > 0) {
+            result.insert(_pool->get_statement_condition(*it));
+        }
+    }
+    return result;
+}
+
+template <>
+bool PatternSolver::validate<StatementAst, SimpleVariable>(
+        StatementAst *ast, SimpleVariable *var)
+{
+    std::map<StatementAst*, AssignmentAst*>::iterator it = _matches.find(ast);
+    return it != _matches.end() && *it->second->get_variable() == *var;
+}
+
+template <>
+bool PatternSolver::has_right<StatementAst>(StatementAst *ast) {
+    return _matches.count(ast) > 0;
+}
+
+template <>
+bool PatternSolver::has_left<SimpleVariable>(SimpleVariable *var) {
+    const std::vector<AssignmentAst*>& assignments = 
+        _index->get_assignments(var);
+
+    for(std::vector<AssignmentAst*>::const_iterator it = assignments.begin();
+            it != assignments.end(); ++it)
+    {
+        if(_matches.count(*it) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace impl
+} // namespace simple
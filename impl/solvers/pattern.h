@@ -0,0 +1,119 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include "simple/ast.h"
+#include "simple/condition.h"
+#include "simple/solver.h"
+#include "impl/condition.h"
+#include "impl/condition_pool.h"
+#include "impl/pattern_index.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * Solver for a single pattern clause, pattern a(v, expr), as the 
+ * relation between the assignments a and the variables v they modify,
+ * restricted to the assignments whose right hand side matches expr.
+ *
+ * The matching assignments are looked up in the pattern index once when
+ * the solver is created, so solving the clause never walks expressions.
+ */
+class PatternSolver {
+  public:
+    /*
+     * A null expression matches every assignment, as in pattern a(v, _).
+     */
+    PatternSolver(std::shared_ptr<PatternIndex> index, 
+            ExprPtr expr, bool exact, 
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool()));
+
+    /*
+     * Identifies what the solver matches: two pattern solvers with the
+     * same key match the same assignments of the same program.
+     */
+    const std::string& get_key() const;
+
+    template <typename Condition>
+    ConditionSet solve_right(Condition *condition) {
+        return ConditionSet();
+    }
+
+    template <typename Condition>
+    ConditionSet solve_left(Condition *condition) {
+        return ConditionSet();
+    }
+
+    template <typename Condition1, typename Condition2>
+    bool validate(Condition1 *condition1, Condition2 *condition2) {
+        return false;
+    }
+
+    /*
+     * EXISTENCE PROBES
+     */
+    template <typename Condition>
+    bool has_right(Condition *condition) {
+        return false;
+    }
+
+    template <typename Condition>
+    bool has_left(Condition *condition) {
+        return false;
+    }
+
+    bool has_any() {
+        return !_matches.empty();
+    }
+
+  private:
+    std::shared_ptr<PatternIndex>   _index;
+    ConditionPoolPtr                _pool;
+    ExprPtr                         _expr;
+    std::string                     _key;
+
+    // matching assignments, keyed by the statement node that the
+    // statement conditions refer to
+    std::map<StatementAst*, AssignmentAst*> _matches;
+};
+
+template <>
+ConditionSet PatternSolver::solve_right<StatementAst>(StatementAst *ast);
+
+template <>
+ConditionSet PatternSolver::solve_left<SimpleVariable>(SimpleVariable *var);
+
+template <>
+bool PatternSolver::validate<StatementAst, SimpleVariable>(
+        StatementAst *ast, SimpleVariable *var);
+
+template <>
+bool PatternSolver::has_right<StatementAst>(StatementAst *ast);
+
+template <>
+bool PatternSolver::has_left<SimpleVariable>(SimpleVariable *var);
+
+} // namespace impl
+} // namespace simple
@@ -102,14 +102,29 @@ class SolveNameVisitorTraits {
 };
 
 
+/*
+ * Look up without inserting so that concurrent queries only ever read
+ * the name table.
+ */
+ConditionSet SameNameSolver::lookup_name(const std::string& name) {
+    std::map<std::string, ConditionSet>::const_iterator it = 
+        _name_table.find(name);
+
+    if(it != _name_table.end()) {
+        return it->second;
+    } else {
+        return ConditionSet();
+    }
+}
+
 template <>
 ConditionSet SameNameSolver::solve_name<ProcAst>(ProcAst *proc) {
-    return _name_table[proc->get_name()];
+    return lookup_name(proc->get_name());
 }
 
 template <>
 ConditionSet SameNameSolver::solve_name<SimpleVariable>(SimpleVariable *var) {
-    return _name_table[var->get_name()];
+    return lookup_name(var->get_name());
 }
 
 template <>
@@ -73,6 +73,8 @@ class SameNameSolver {
     }
 
   private:
+    ConditionSet lookup_name(const std::string& name);
+
     std::map<std::string, ConditionSet> _name_table;
     SimpleRoot _ast;
 };
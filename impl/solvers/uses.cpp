@@ -90,12 +90,18 @@ class UsesValidateExprVisitor : public ExprVisitor {
     bool _result;
 };
 
-UsesSolver::UsesSolver(const SimpleRoot& ast) : 
-    _ast(ast) 
+UsesSolver::UsesSolver(const SimpleRoot& ast, ConditionPoolPtr pool) : 
+    _ast(ast), _pool(pool)
 {
    for(SimpleRoot::iterator it = _ast.begin(); it != _ast.end(); ++it) {
        index_variables<ProcAst>(*it);
    } 
+
+   for(std::map<SimpleVariable, ConditionSet>::iterator it = _var_index.begin();
+           it != _var_index.end(); ++it)
+   {
+       _domain.union_with(it->second);
+   }
 }
 
 /*
@@ -241,7 +247,7 @@ ConditionSet UsesSolver::solve_right<StatementAst>(StatementAst *ast) {
 template <>
 ConditionSet UsesSolver::solve_right<ConditionalAst>(ConditionalAst *ast) {
     ConditionSet result;
-    result.insert(new SimpleVariableCondition(*ast->get_variable()));
+    result.insert(_pool->get_variable_condition(*ast->get_variable()));
     
     StatementAst *then = ast->get_then_branch();
     while(then != NULL) {
@@ -261,7 +267,7 @@ ConditionSet UsesSolver::solve_right<ConditionalAst>(ConditionalAst *ast) {
 template <>
 ConditionSet UsesSolver::solve_right<WhileAst>(WhileAst *ast) {
     ConditionSet result;
-    result.insert(new SimpleVariableCondition(*ast->get_variable()));
+    result.insert(_pool->get_variable_condition(*ast->get_variable()));
 
     StatementAst *body = ast->get_body();
     while(body != NULL) {
@@ -303,7 +309,7 @@ ConditionSet UsesSolver::solve_right<ExprAst>(ExprAst *ast) {
 template <>
 ConditionSet UsesSolver::solve_right<VariableAst>(VariableAst *ast) {
     ConditionSet result;
-    result.insert(new SimpleVariableCondition(
+    result.insert(_pool->get_variable_condition(
             *(ast->get_variable())));
 
     return result;
@@ -331,5 +337,168 @@ ConditionSet UsesSolver::solve_right<CallAst>(CallAst *ast) {
     return solve_right<ProcAst>(ast->get_proc_called());
 }
 
+/*
+ * solve_left() definitions
+ */
+template <>
+ConditionSet UsesSolver::solve_left<SimpleVariable>(SimpleVariable *variable) {
+    if(_var_index.count(*variable)) {
+        return _var_index[*variable];
+    } else {
+        return ConditionSet();
+    }
+}
+
+/*
+ * has_right() and has_left() definitions
+ */
+template <>
+bool UsesSolver::has_right<StatementAst>(StatementAst *ast) {
+    return _domain.has_element(_pool->get_statement_condition(ast));
+}
+
+template <>
+bool UsesSolver::has_right<ProcAst>(ProcAst *ast) {
+    return _domain.has_element(_pool->get_proc_condition(ast));
+}
+
+template <>
+bool UsesSolver::has_right<ExprAst>(ExprAst *ast) {
+    return !index_variables<ExprAst>(ast).empty();
+}
+
+template <>
+bool UsesSolver::has_left<SimpleVariable>(SimpleVariable *variable) {
+    return _var_index.count(*variable) > 0;
+}
+
+bool UsesSolver::has_any() {
+    return !_var_index.empty();
+}
+
+const std::map<SimpleVariable, ConditionSet>& UsesSolver::get_var_index() const {
+    return _var_index;
+}
+
+/*
+ * index_variable()
+ */
+void UsesSolver::index_statement_list(
+        StatementAst *statement, ConditionPtr condition, 
+        std::set<SimpleVariable>& result) 
+{
+    while(statement != NULL) {
+        std::set<SimpleVariable> current_result = index_variables<StatementAst>(statement);
+        for(std::set<SimpleVariable>::iterator it = current_result.begin(); 
+                it != current_result.end(); ++it) 
+        {
+            if(result.count(*it) == 0) {
+                _var_index[*it].insert(condition);
+                result.insert(*it);
+            }
+        }
+        statement = statement->next();
+    }
+}
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<ProcAst>(ProcAst *proc) {
+    std::set<SimpleVariable> result;
+
+    index_statement_list(proc->get_statement(), _pool->get_proc_condition(proc), result);
+
+    return result;
+}
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<AssignmentAst>(AssignmentAst *assign) {
+    std::set<SimpleVariable> result = index_variables<ExprAst>(assign->get_expr());
+    ConditionPtr this_condition = _pool->get_statement_condition(assign);
+
+    for(std::set<SimpleVariable>::iterator it = result.begin();
+            it != result.end(); ++it)
+    {
+        _var_index[*it].insert(this_condition);
+    }
+
+    return result;
+}
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<WhileAst>(WhileAst *ast) {
+    std::set<SimpleVariable> result;
+    ConditionPtr condition = _pool->get_statement_condition(ast);
+
+    _var_index[*ast->get_variable()].insert(condition);
+    result.insert(*ast->get_variable());
+
+    index_statement_list(ast->get_body(), condition, result);
+
+    return result;
+}
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<ConditionalAst>(ConditionalAst *ast) {
+    std::set<SimpleVariable> result;
+    ConditionPtr condition = _pool->get_statement_condition(ast);
+
+    _var_index[*ast->get_variable()].insert(condition);
+    result.insert(*ast->get_variable());
+
+    index_statement_list(ast->get_then_branch(), condition, result);
+    index_statement_list(ast->get_else_branch(), condition, result);
+
+    return result;
+}
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<CallAst>(CallAst *ast) {
+    std::set<SimpleVariable> result = index_variables<ProcAst>(ast->get_proc_called());
+    ConditionPtr this_condition = _pool->get_statement_condition(ast);
+
+    for(std::set<SimpleVariable>::iterator it = result.begin();
+            it != result.end(); ++it)
+    {
+        _var_index[*it].insert(this_condition);
+    }
+
+    return result;
+}
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<StatementAst>(StatementAst *statement) {
+    StatementVisitorGenerator<UsesSolver,
+        IndexVariableVisitorTraits<UsesSolver> > 
+    visitor(this);
+
+    statement->accept_statement_visitor(&visitor);
+    return visitor.return_result();
+}
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<ExprAst>(ExprAst *expr) {
+    ExprVisitorGenerator<UsesSolver,
+        IndexVariableVisitorTraits<UsesSolver> > 
+    visitor(this);
+
+    expr->accept_expr_visitor(&visitor);
+    return visitor.return_result();
+}
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<VariableAst>(VariableAst *ast) {
+    std::set<SimpleVariable> result;
+    result.insert(*ast->get_variable());
+    return result;
+}
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<BinaryOpAst>(BinaryOpAst *ast) {
+    std::set<SimpleVariable> result = index_variables<ExprAst>(ast->get_lhs());
+    std::set<SimpleVariable> rhs = index_variables<ExprAst>(ast->get_rhs());
+    result.insert(rhs.begin(), rhs.end());
+    return result;
+}
+
 } // namespace impl
 } // namespace simple
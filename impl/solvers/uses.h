@@ -26,6 +26,7 @@
 #include "simple/condition.h"
 #include "simple/condition_set.h"
 #include "simple/solver.h"
+#include "impl/condition_pool.h"
 #include "simple/util/set_utils.h"
 #include "simple/util/statement_visitor_generator.h"
 
@@ -44,7 +45,8 @@ class UsesQuerySolver {
 
 class UsesSolver {
   public:
-    UsesSolver(const SimpleRoot& ast);
+    UsesSolver(const SimpleRoot& ast, 
+            ConditionPoolPtr pool = ConditionPoolPtr(new ConditionPool()));
 
     template <typename Condition1, typename Condition2>
     bool validate(Condition1 *condition1, Condition2 *condition2);
@@ -61,11 +63,28 @@ class UsesSolver {
     template <typename Condition>
     std::set<SimpleVariable> index_variables(Condition *condition);
 
+    template <typename Condition>
+    bool has_right(Condition *condition);
+
+    template <typename Condition>
+    bool has_left(Condition *condition);
+
+    bool has_any();
+
+    /*
+     * The statements and procedures using each variable.
+     */
+    const std::map<SimpleVariable, ConditionSet>& get_var_index() const;
+
     ~UsesSolver() { }
   private:
     SimpleRoot _ast;
+    ConditionPoolPtr _pool;
     std::map<SimpleVariable, ConditionSet> _var_index;
 
+    // the statements and procedures using some variable
+    ConditionSet _domain;
+
     void index_statement_list(StatementAst *statement, ConditionPtr condition, std::set<SimpleVariable>& result);
 };
 
@@ -98,6 +117,16 @@ std::set<SimpleVariable> UsesSolver::index_variables(Condition *condition) {
     return VariableSet();
 }
 
+template <typename Condition>
+bool UsesSolver::has_right(Condition *condition) {
+    return false;
+}
+
+template <typename Condition>
+bool UsesSolver::has_left(Condition *condition) {
+    return false;
+}
+
 template <>
 bool UsesSolver::validate<StatementAst, SimpleVariable>(
         StatementAst *ast, SimpleVariable *var);
@@ -168,5 +197,47 @@ ConditionSet UsesSolver::solve_right<BinaryOpAst>(BinaryOpAst *ast);
 template <>
 ConditionSet UsesSolver::solve_right<CallAst>(CallAst *ast);
 
+template <>
+bool UsesSolver::has_right<StatementAst>(StatementAst *ast);
+
+template <>
+bool UsesSolver::has_right<ProcAst>(ProcAst *ast);
+
+template <>
+bool UsesSolver::has_right<ExprAst>(ExprAst *ast);
+
+template <>
+bool UsesSolver::has_left<SimpleVariable>(SimpleVariable *variable);
+
+template <>
+ConditionSet UsesSolver::solve_left<SimpleVariable>(SimpleVariable *variable);
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<ProcAst>(ProcAst *proc);
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<AssignmentAst>(AssignmentAst *assign);
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<WhileAst>(WhileAst *ast);
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<ConditionalAst>(ConditionalAst *ast);
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<CallAst>(CallAst *ast);
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<StatementAst>(StatementAst *statement);
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<ExprAst>(ExprAst *expr);
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<VariableAst>(VariableAst *ast);
+
+template <>
+std::set<SimpleVariable> UsesSolver::index_variables<BinaryOpAst>(BinaryOpAst *ast);
+
 } // namespace impl
 } // namespace simple
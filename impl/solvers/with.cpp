@@ -0,0 +1,73 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impl/solvers/with.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+WithSolver::WithSolver(std::shared_ptr<AttributeIndex> index,
+        AttributeType left, AttributeType right) :
+    _index(index), _left(left), _right(right)
+{ }
+
+AttributeType WithSolver::get_left_type() const {
+    return _left;
+}
+
+AttributeType WithSolver::get_right_type() const {
+    return _right;
+}
+
+ConditionSet WithSolver::solve_left(SimpleCondition *right_condition) {
+    std::string key;
+    if(!get_right_key(right_condition, key)) {
+        return ConditionSet();
+    }
+    return _index->lookup(_left, key);
+}
+
+ConditionSet WithSolver::solve_right(SimpleCondition *left_condition) {
+    std::string key;
+    if(!get_left_key(left_condition, key)) {
+        return ConditionSet();
+    }
+    return _index->lookup(_right, key);
+}
+
+bool WithSolver::validate(SimpleCondition *left_condition,
+        SimpleCondition *right_condition)
+{
+    std::string left_key, right_key;
+    return get_left_key(left_condition, left_key) &&
+        get_right_key(right_condition, right_key) &&
+        left_key == right_key;
+}
+
+bool WithSolver::get_left_key(SimpleCondition *condition, std::string& key) {
+    return _index->get_attribute(_left, condition, key);
+}
+
+bool WithSolver::get_right_key(SimpleCondition *condition, std::string& key) {
+    return _index->get_attribute(_right, condition, key);
+}
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,65 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "simple/condition.h"
+#include "simple/solver.h"
+#include "impl/attribute_index.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * Solver for a single with clause, e.g. with p.procName = v.varName,
+ * relating the conditions whose left attribute equals the right 
+ * attribute of the other side. Literals in the clause are conditions 
+ * too: a name is a variable condition compared by ATTR_VAR_NAME and an 
+ * integer is a constant condition compared by ATTR_VALUE.
+ *
+ * Every solve is a single lookup in the attribute index.
+ */
+class WithSolver : public KeyedQuerySolver {
+  public:
+    WithSolver(std::shared_ptr<AttributeIndex> index,
+            AttributeType left, AttributeType right);
+
+    ConditionSet solve_left(SimpleCondition *right_condition);
+    ConditionSet solve_right(SimpleCondition *left_condition);
+
+    bool validate(SimpleCondition *left_condition,
+            SimpleCondition *right_condition);
+
+    bool get_left_key(SimpleCondition *condition, std::string& key);
+    bool get_right_key(SimpleCondition *condition, std::string& key);
+
+    AttributeType get_left_type() const;
+    AttributeType get_right_type() const;
+
+  private:
+    std::shared_ptr<AttributeIndex> _index;
+    AttributeType   _left;
+    AttributeType   _right;
+};
+
+} // namespace impl
+} // namespace simple
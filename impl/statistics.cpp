@@ -0,0 +1,379 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <set>
+#include <sstream>
+#include "impl/statistics.h"
+#include "simple/util/json_utils.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+using namespace simple::util;
+
+static void histogram_to_json(std::ostream& out, 
+        const std::map<size_t, size_t>& histogram)
+{
+    out << "{";
+    for(std::map<size_t, size_t>::const_iterator it = histogram.begin();
+            it != histogram.end(); ++it)
+    {
+        if(it != histogram.begin()) {
+            out << ", ";
+        }
+        out << "\"" << it->first << "\": " << it->second;
+    }
+    out << "}";
+}
+
+double RelationStatistics::average_left_degree() const {
+    if(distinct_left == 0) {
+        return 0;
+    }
+    return double(pair_count) / distinct_left;
+}
+
+double RelationStatistics::average_right_degree() const {
+    if(distinct_right == 0) {
+        return 0;
+    }
+    return double(pair_count) / distinct_right;
+}
+
+size_t RelationStatistics::max_left_degree() const {
+    return left_degrees.empty() ? 0 : left_degrees.rbegin()->first;
+}
+
+size_t RelationStatistics::max_right_degree() const {
+    return right_degrees.empty() ? 0 : right_degrees.rbegin()->first;
+}
+
+std::string RelationStatistics::to_json() const {
+    std::stringstream out;
+
+    out << "{\"pairs\": " << pair_count
+        << ", \"distinct_left\": " << distinct_left
+        << ", \"distinct_right\": " << distinct_right
+        << ", \"average_left_degree\": " << average_left_degree()
+        << ", \"average_right_degree\": " << average_right_degree()
+        << ", \"left_degrees\": ";
+    histogram_to_json(out, left_degrees);
+    out << ", \"right_degrees\": ";
+    histogram_to_json(out, right_degrees);
+    out << "}";
+
+    return out.str();
+}
+
+RelationStatisticsBuilder::RelationStatisticsBuilder(ConditionPoolPtr pool) :
+    _pool(pool), _pair_count(0), 
+    _left_counts(pool->get_size(), 0), _right_counts(pool->get_size(), 0)
+{ }
+
+void RelationStatisticsBuilder::add_pair(SimpleCondition *left, 
+        SimpleCondition *right)
+{
+    size_t left_id, right_id;
+    if(!_pool->find_id(left, left_id) || !_pool->find_id(right, right_id)) {
+        return;
+    }
+
+    _pair_count += 1;
+    _left_counts[left_id] += 1;
+    _right_counts[right_id] += 1;
+}
+
+RelationStatistics RelationStatisticsBuilder::get_statistics() const {
+    RelationStatistics statistics;
+    statistics.pair_count = _pair_count;
+
+    for(size_t id = 0; id < _left_counts.size(); ++id) {
+        if(_left_counts[id] > 0) {
+            statistics.distinct_left += 1;
+            statistics.left_degrees[_left_counts[id]] += 1;
+        }
+
+        if(_right_counts[id] > 0) {
+            statistics.distinct_right += 1;
+            statistics.right_degrees[_right_counts[id]] += 1;
+        }
+    }
+
+    return statistics;
+}
+
+StatisticsCatalog::StatisticsCatalog(ConditionPoolPtr pool) :
+    _pool(pool), _relations(), _pending(), _domain_sizes(), _call_depth(0),
+    _lock()
+{ }
+
+void StatisticsCatalog::set_relation(const std::string& name,
+        const RelationStatistics& statistics)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _relations[name] = statistics;
+    _pending.erase(name);
+}
+
+void StatisticsCatalog::set_relation_solver(const std::string& name,
+        std::shared_ptr<QuerySolver> solver)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _relations.erase(name);
+    _pending[name] = solver;
+}
+
+void StatisticsCatalog::set_domain_size(const std::string& predicate, 
+        size_t size) 
+{
+    _domain_sizes[predicate] = size;
+}
+
+void StatisticsCatalog::set_call_depth(size_t depth) {
+    _call_depth = depth;
+}
+
+bool StatisticsCatalog::has_relation(const std::string& name) const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _relations.find(name) != _relations.end() ||
+        _pending.find(name) != _pending.end();
+}
+
+const RelationStatistics& 
+StatisticsCatalog::get_relation(const std::string& name) const {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    SolverMap::iterator pending = _pending.find(name);
+    if(pending != _pending.end()) {
+        _relations[name] = collect_relation_statistics(
+                pending->second.get(), _pool);
+        _pending.erase(pending);
+    }
+
+    std::map<std::string, RelationStatistics>::const_iterator it =
+        _relations.find(name);
+
+    if(it == _relations.end()) {
+        throw StatisticsError();
+    }
+    return it->second;
+}
+
+size_t StatisticsCatalog::get_domain_size(const std::string& predicate) const {
+    std::map<std::string, size_t>::const_iterator it = 
+        _domain_sizes.find(predicate);
+
+    if(it == _domain_sizes.end()) {
+        throw StatisticsError();
+    }
+    return it->second;
+}
+
+size_t StatisticsCatalog::get_call_depth() const {
+    return _call_depth;
+}
+
+std::vector<std::string> StatisticsCatalog::get_relation_names() const {
+    std::lock_guard<std::mutex> guard(_lock);
+
+    std::set<std::string> names;
+    for(std::map<std::string, RelationStatistics>::const_iterator it = 
+            _relations.begin(); it != _relations.end(); ++it)
+    {
+        names.insert(it->first);
+    }
+
+    for(SolverMap::const_iterator it = _pending.begin(); 
+            it != _pending.end(); ++it)
+    {
+        names.insert(it->first);
+    }
+    return std::vector<std::string>(names.begin(), names.end());
+}
+
+void StatisticsCatalog::collect_pending() const {
+    for(SolverMap::iterator it = _pending.begin(); it != _pending.end(); ++it) {
+        _relations[it->first] = collect_relation_statistics(
+                it->second.get(), _pool);
+    }
+    _pending.clear();
+}
+
+std::string StatisticsCatalog::to_json() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    collect_pending();
+
+    std::stringstream out;
+
+    out << "{\"call_depth\": " << _call_depth << ", \"relations\": {";
+    for(std::map<std::string, RelationStatistics>::const_iterator it = 
+            _relations.begin(); it != _relations.end(); ++it)
+    {
+        if(it != _relations.begin()) {
+            out << ", ";
+        }
+        out << json_string(it->first) << ": " << it->second.to_json();
+    }
+
+    out << "}, \"domains\": {";
+    for(std::map<std::string, size_t>::const_iterator it = 
+            _domain_sizes.begin(); it != _domain_sizes.end(); ++it)
+    {
+        if(it != _domain_sizes.begin()) {
+            out << ", ";
+        }
+        out << json_string(it->first) << ": " << it->second;
+    }
+    out << "}}";
+
+    return out.str();
+}
+
+RelationStatistics collect_relation_statistics(QuerySolver *solver, 
+        ConditionPoolPtr pool)
+{
+    RelationStatisticsBuilder builder(pool);
+
+    for(size_t id = 0; id < pool->get_size(); ++id) {
+        ConditionPtr left = pool->get_condition(id);
+        ConditionSet result = solver->solve_right(left.get());
+
+        for(ConditionSet::iterator it = result.begin(); it != result.end(); ++it) {
+            builder.add_pair(left.get(), it->get());
+        }
+    }
+
+    return builder.get_statistics();
+}
+
+RelationStatistics collect_follows_statistics(const LineTable& lines,
+        ConditionPoolPtr pool)
+{
+    RelationStatisticsBuilder builder(pool);
+
+    for(LineTable::const_iterator it = lines.begin(); it != lines.end(); ++it) {
+        StatementAst *next = it->second->next();
+        if(next != NULL) {
+            builder.add_pair(pool->get_statement_condition(it->second).get(),
+                    pool->get_statement_condition(next).get());
+        }
+    }
+
+    return builder.get_statistics();
+}
+
+RelationStatistics collect_parent_statistics(const LineTable& lines,
+        ConditionPoolPtr pool)
+{
+    RelationStatisticsBuilder builder(pool);
+
+    for(LineTable::const_iterator it = lines.begin(); it != lines.end(); ++it) {
+        StatementAst *parent = it->second->get_parent();
+        if(parent != NULL) {
+            builder.add_pair(pool->get_statement_condition(parent).get(),
+                    pool->get_statement_condition(it->second).get());
+        }
+    }
+
+    return builder.get_statistics();
+}
+
+RelationStatistics collect_variable_statistics(
+        const std::map<SimpleVariable, ConditionSet>& var_index,
+        ConditionPoolPtr pool)
+{
+    RelationStatisticsBuilder builder(pool);
+
+    for(std::map<SimpleVariable, ConditionSet>::const_iterator it = 
+            var_index.begin(); it != var_index.end(); ++it)
+    {
+        ConditionPtr variable = pool->get_variable_condition(it->first);
+
+        for(ConditionSet::iterator cit = it->second.begin(); 
+                cit != it->second.end(); ++cit)
+        {
+            builder.add_pair(cit->get(), variable.get());
+        }
+    }
+
+    return builder.get_statistics();
+}
+
+RelationStatistics collect_call_statistics(const CallGraph& call_graph,
+        ConditionPoolPtr pool, bool transitive)
+{
+    RelationStatisticsBuilder builder(pool);
+
+    for(size_t id = 0; id < call_graph.get_size(); ++id) {
+        ConditionPtr caller = pool->get_proc_condition(call_graph.get_proc(id));
+        std::vector<size_t> callees = (transitive ? 
+                call_graph.get_closure(id, true) : 
+                call_graph.get_calls(id, true)).get_indexes();
+
+        for(std::vector<size_t>::iterator it = callees.begin();
+                it != callees.end(); ++it)
+        {
+            builder.add_pair(caller.get(), 
+                    pool->get_proc_condition(call_graph.get_proc(*it)).get());
+        }
+    }
+
+    return builder.get_statistics();
+}
+
+/*
+ * The procedures are visited callees first, so the depth of every 
+ * callee outside of the caller's recursive component is already known.
+ * A callee that has not been visited yet can only be in the same 
+ * component, and is left out.
+ */
+size_t compute_call_depth(const CallGraph& call_graph) {
+    const std::vector<size_t>& order = call_graph.get_topological_order();
+    std::vector<size_t> positions(call_graph.get_size(), 0);
+    std::vector<size_t> depths(call_graph.get_size(), 0);
+    size_t max_depth = 0;
+
+    for(size_t i = 0; i < order.size(); ++i) {
+        positions[order[i]] = i;
+    }
+
+    for(size_t i = 0; i < order.size(); ++i) {
+        size_t id = order[i];
+        size_t depth = 1;
+
+        std::vector<size_t> callees = call_graph.get_calls(id, true).get_indexes();
+        for(std::vector<size_t>::iterator it = callees.begin(); 
+                it != callees.end(); ++it)
+        {
+            if(positions[*it] < i && depths[*it] + 1 > depth) {
+                depth = depths[*it] + 1;
+            }
+        }
+
+        depths[id] = depth;
+        if(depth > max_depth) {
+            max_depth = depth;
+        }
+    }
+
+    return max_depth;
+}
+
+} // namespace impl
+} // namespace simple
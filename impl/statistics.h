@@ -0,0 +1,191 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "simple/ast.h"
+#include "simple/solver.h"
+#include "simple/predicate.h"
+#include "impl/bit_vector.h"
+#include "impl/call_graph.h"
+#include "impl/condition_pool.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+class StatisticsError : public std::exception { };
+
+/*
+ * The size of one relation over the pooled conditions of a program.
+ * The degree of a condition on the left side is the number of right 
+ * sides it is related to, and the other way round. The histograms map
+ * a degree to the number of conditions having it, leaving out the
+ * conditions outside of the relation.
+ */
+struct RelationStatistics {
+  public:
+    RelationStatistics() :
+        pair_count(0), distinct_left(0), distinct_right(0),
+        left_degrees(), right_degrees()
+    { }
+
+    size_t  pair_count;
+    size_t  distinct_left;
+    size_t  distinct_right;
+
+    std::map<size_t, size_t> left_degrees;
+    std::map<size_t, size_t> right_degrees;
+
+    // average number of right sides of a left side, 0 if empty
+    double average_left_degree() const;
+
+    // average number of left sides of a right side, 0 if empty
+    double average_right_degree() const;
+
+    size_t max_left_degree() const;
+    size_t max_right_degree() const;
+
+    std::string to_json() const;
+};
+
+/*
+ * Counts the pairs of a relation given one at a time, for the relations
+ * whose pairs can be listed from an index instead of being solved. 
+ * Pairs with a side outside of the pool are left out.
+ */
+class RelationStatisticsBuilder {
+  public:
+    RelationStatisticsBuilder(ConditionPoolPtr pool);
+
+    void add_pair(SimpleCondition *left, SimpleCondition *right);
+
+    RelationStatistics get_statistics() const;
+
+  private:
+    ConditionPoolPtr    _pool;
+    size_t              _pair_count;
+    std::vector<size_t> _left_counts;
+    std::vector<size_t> _right_counts;
+};
+
+/*
+ * The statistics of the relations and predicates of one knowledge
+ * base. The relations with an index, and the predicates, are counted
+ * when the program is loaded. The other relations, i.e. the transitive
+ * closures and the control and data flow relations, are only solved 
+ * the first time their statistics are asked for, so loading does not 
+ * pay for them. The catalog may be shared between threads.
+ */
+class StatisticsCatalog {
+  public:
+    StatisticsCatalog(ConditionPoolPtr pool = ConditionPoolPtr());
+
+    void set_relation(const std::string& name, 
+            const RelationStatistics& statistics);
+
+    /*
+     * Collect the statistics of a relation with collect_relation_statistics()
+     * over the pool of the catalog the first time they are asked for. 
+     * The solver should not be memoized, so that the scan does not fill
+     * the memo.
+     */
+    void set_relation_solver(const std::string& name,
+            std::shared_ptr<QuerySolver> solver);
+    void set_domain_size(const std::string& predicate, size_t size);
+    void set_call_depth(size_t depth);
+
+    bool has_relation(const std::string& name) const;
+
+    /*
+     * Throws StatisticsError if there are no statistics of the relation.
+     */
+    const RelationStatistics& get_relation(const std::string& name) const;
+
+    /*
+     * The number of conditions a predicate accepts. Throws 
+     * StatisticsError for an unknown predicate.
+     */
+    size_t get_domain_size(const std::string& predicate) const;
+
+    /*
+     * The number of procedures on the longest call chain, not counting
+     * the calls within a recursive component.
+     */
+    size_t get_call_depth() const;
+
+    std::vector<std::string> get_relation_names() const;
+
+    /*
+     * The whole catalog as a JSON object, keyed by relation and
+     * predicate name in alphabetical order. All the relations left to
+     * their solvers are collected first.
+     */
+    std::string to_json() const;
+
+  private:
+    typedef std::map<std::string, std::shared_ptr<QuerySolver> > SolverMap;
+
+    // collect the relations left to their solvers, with the lock held
+    void collect_pending() const;
+
+    ConditionPoolPtr    _pool;
+    mutable std::map<std::string, RelationStatistics>   _relations;
+    mutable SolverMap   _pending;
+    std::map<std::string, size_t>               _domain_sizes;
+    size_t  _call_depth;
+
+    mutable std::mutex  _lock;
+};
+
+/*
+ * Compute the statistics of a relation by solving the right sides of 
+ * every pooled condition.
+ */
+RelationStatistics collect_relation_statistics(QuerySolver *solver, 
+        ConditionPoolPtr pool);
+
+/*
+ * Count Follows, Parent, Modifies or Uses, and Calls or Calls*, from 
+ * the statements of the line table, the variable index of their solver
+ * or the call graph.
+ */
+RelationStatistics collect_follows_statistics(const LineTable& lines,
+        ConditionPoolPtr pool);
+
+RelationStatistics collect_parent_statistics(const LineTable& lines,
+        ConditionPoolPtr pool);
+
+RelationStatistics collect_variable_statistics(
+        const std::map<SimpleVariable, ConditionSet>& var_index,
+        ConditionPoolPtr pool);
+
+RelationStatistics collect_call_statistics(const CallGraph& call_graph,
+        ConditionPoolPtr pool, bool transitive);
+
+size_t compute_call_depth(const CallGraph& call_graph);
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,204 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impl/thread_pool.h"
+
+namespace simple {
+namespace impl {
+
+/*
+ * Book keeping for one call to run_all(). The batch lives on the stack of
+ * the submitting thread, so the remaining counter is only ever touched
+ * under the batch lock; that way the submitter cannot return and destroy
+ * the batch while a worker is still signalling completion.
+ */
+class WorkStealingPool::TaskBatch {
+  public:
+    TaskBatch(size_t size) : remaining(size), error() { }
+
+    void finish_one() {
+        std::lock_guard<std::mutex> guard(lock);
+        if(--remaining == 0) {
+            done.notify_all();
+        }
+    }
+
+    void fail(std::exception_ptr e) {
+        std::lock_guard<std::mutex> guard(lock);
+        if(!error) {
+            error = e;
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> guard(lock);
+        while(remaining > 0) {
+            done.wait(guard);
+        }
+    }
+
+    size_t                  remaining;
+    std::exception_ptr      error;
+    std::mutex              lock;
+    std::condition_variable done;
+};
+
+WorkStealingPool::WorkStealingPool(size_t num_workers) :
+    _queues(), _threads(), _wake_lock(), _wake(),
+    _queued(0), _next_queue(0), _shutdown(false)
+{
+    if(num_workers == 0) {
+        num_workers = 1;
+    }
+
+    for(size_t i = 0; i < num_workers; ++i) {
+        _queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+
+    for(size_t i = 0; i < num_workers; ++i) {
+        _threads.push_back(std::thread(&WorkStealingPool::worker_loop, this, i));
+    }
+}
+
+size_t WorkStealingPool::get_num_workers() const {
+    return _queues.size();
+}
+
+size_t WorkStealingPool::default_num_workers() {
+    size_t cores = std::thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+}
+
+void WorkStealingPool::run_all(const std::vector<ThreadPoolTask*>& tasks) {
+    if(tasks.empty()) {
+        return;
+    }
+
+    TaskBatch batch(tasks.size());
+
+    // Count the tasks before they become visible so that a sleeping worker
+    // woken up by the notification always sees a non-zero queue count.
+    _queued += tasks.size();
+
+    size_t start = _next_queue++;
+    for(size_t i = 0; i < tasks.size(); ++i) {
+        WorkerQueue *queue = _queues[(start + i) % _queues.size()].get();
+        std::lock_guard<std::mutex> guard(queue->lock);
+        queue->tasks.push_back(PendingTask(tasks[i], &batch));
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(_wake_lock);
+    }
+    _wake.notify_all();
+
+    // Help out instead of idling until there is nothing left to steal.
+    PendingTask pending;
+    while(steal_task(_queues.size(), pending)) {
+        run_task(pending);
+    }
+
+    batch.wait();
+
+    if(batch.error) {
+        std::rethrow_exception(batch.error);
+    }
+}
+
+void WorkStealingPool::worker_loop(size_t id) {
+    while(true) {
+        PendingTask pending;
+        if(pop_task(id, pending) || steal_task(id, pending)) {
+            run_task(pending);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(_wake_lock);
+        while(!_shutdown && _queued == 0) {
+            _wake.wait(guard);
+        }
+
+        if(_shutdown && _queued == 0) {
+            return;
+        }
+    }
+}
+
+bool WorkStealingPool::pop_task(size_t id, PendingTask& result) {
+    WorkerQueue *queue = _queues[id].get();
+    std::lock_guard<std::mutex> guard(queue->lock);
+
+    if(queue->tasks.empty()) {
+        return false;
+    }
+
+    result = queue->tasks.back();
+    queue->tasks.pop_back();
+    --_queued;
+    return true;
+}
+
+bool WorkStealingPool::steal_task(size_t thief, PendingTask& result) {
+    size_t num_queues = _queues.size();
+
+    for(size_t i = 1; i <= num_queues; ++i) {
+        size_t victim = (thief + i) % num_queues;
+        if(victim == thief) {
+            continue;
+        }
+
+        WorkerQueue *queue = _queues[victim].get();
+        std::lock_guard<std::mutex> guard(queue->lock);
+
+        if(!queue->tasks.empty()) {
+            result = queue->tasks.front();
+            queue->tasks.pop_front();
+            --_queued;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingPool::run_task(PendingTask& pending) {
+    try {
+        pending.task->run();
+    } catch(...) {
+        pending.batch->fail(std::current_exception());
+    }
+
+    pending.batch->finish_one();
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> guard(_wake_lock);
+        _shutdown = true;
+    }
+    _wake.notify_all();
+
+    for(std::vector<std::thread>::iterator it = _threads.begin();
+            it != _threads.end(); ++it)
+    {
+        it->join();
+    }
+}
+
+} // namespace impl
+} // namespace simple
@@ -0,0 +1,109 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace simple {
+namespace impl {
+
+/*
+ * A unit of work submitted to the thread pool. The pool does not take
+ * ownership of the task; the submitter has to keep it alive until
+ * run_all() returns.
+ */
+class ThreadPoolTask {
+  public:
+    virtual void run() = 0;
+
+    virtual ~ThreadPoolTask() { }
+};
+
+/*
+ * A fixed size work stealing thread pool.
+ *
+ * Every worker owns a deque of tasks. A batch submitted by run_all() is
+ * spread round robin over the worker deques; a worker pops from the back
+ * of its own deque and, once it runs dry, steals from the front of the
+ * other deques. The submitting thread also steals tasks while waiting so
+ * that nested or concurrent batches can never deadlock the pool.
+ */
+class WorkStealingPool {
+  public:
+    WorkStealingPool(size_t num_workers = default_num_workers());
+
+    size_t get_num_workers() const;
+
+    /*
+     * Run all tasks in the batch and block until they have all finished.
+     * If any of the tasks throws, the first exception is rethrown here
+     * after the whole batch has completed.
+     */
+    void run_all(const std::vector<ThreadPoolTask*>& tasks);
+
+    static size_t default_num_workers();
+
+    ~WorkStealingPool();
+
+  private:
+    class TaskBatch;
+
+    struct PendingTask {
+        PendingTask() : task(NULL), batch(NULL) { }
+        PendingTask(ThreadPoolTask *task, TaskBatch *batch) :
+            task(task), batch(batch)
+        { }
+
+        ThreadPoolTask  *task;
+        TaskBatch       *batch;
+    };
+
+    struct WorkerQueue {
+        std::mutex              lock;
+        std::deque<PendingTask> tasks;
+    };
+
+    void worker_loop(size_t id);
+    bool pop_task(size_t id, PendingTask& result);
+    bool steal_task(size_t thief, PendingTask& result);
+    void run_task(PendingTask& pending);
+
+    std::vector<std::unique_ptr<WorkerQueue> >  _queues;
+    std::vector<std::thread>    _threads;
+    std::mutex                  _wake_lock;
+    std::condition_variable     _wake;
+    std::atomic<size_t>         _queued;
+    std::atomic<size_t>         _next_queue;
+    bool                        _shutdown;
+
+    WorkStealingPool(const WorkStealingPool&);
+    WorkStealingPool& operator =(const WorkStealingPool&);
+};
+
+typedef std::shared_ptr<WorkStealingPool> ThreadPoolPtr;
+
+} // namespace impl
+} // namespace simple
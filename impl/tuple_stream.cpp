@@ -0,0 +1,190 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "impl/tuple_stream.h"
+#include "impl/cancellation.h"
+#include "simple/util/condition_utils.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+using namespace simple::util;
+
+StreamTupleWriter::StreamTupleWriter(std::ostream& out) : _out(out) { }
+
+void StreamTupleWriter::write_row(const std::vector<ConditionPtr>& row) {
+    for(size_t i = 0; i < row.size(); ++i) {
+        if(i > 0) {
+            _out << ' ';
+        }
+        _out << condition_to_value(row[i].get());
+    }
+    _out << '\n';
+}
+
+TupleListWriter::TupleListWriter(TupleList& tuples) : _tuples(tuples) { }
+
+void TupleListWriter::write_row(const std::vector<ConditionPtr>& row) {
+    ConditionTuplePtr tuple;
+    for(size_t i = row.size(); i > 0; --i) {
+        tuple = ConditionTuplePtr(new SimpleConditionTuple(row[i - 1], tuple));
+    }
+    _tuples.insert(tuple);
+}
+
+TupleProducer::TupleProducer(SimpleQueryLinker *linker,
+        const std::vector<std::string>& qvars) :
+    _linker(linker), _qvars(), _columns(), _domains(),
+    _direct_links(), _indirect_links(), _bound(), _last_row(),
+    _has_last_row(false), _row(qvars.size(), ConditionPtr((SimpleCondition*) NULL)), _count(0)
+{
+    for(std::vector<std::string>::const_iterator qit = qvars.begin();
+            qit != qvars.end(); ++qit)
+    {
+        QVarSlot slot = _linker->get_slot(*qit);
+        std::vector<QVarSlot>::iterator found = 
+            std::find(_qvars.begin(), _qvars.end(), slot);
+
+        _columns.push_back(found - _qvars.begin());
+        if(found == _qvars.end()) {
+            _qvars.push_back(slot);
+        }
+    }
+
+    for(size_t level = 0; level < _qvars.size(); ++level) {
+        if(!_linker->is_initialized(_qvars[level])) {
+            throw QueryLinkerError();
+        }
+
+        const ConditionSet& domain = _linker->get_conditions(_qvars[level]);
+        _domains.push_back(std::vector<ConditionPtr>(
+                    domain.begin(), domain.end()));
+
+        std::vector<size_t> direct_links;
+        for(size_t prev = 0; prev < level; ++prev) {
+            if(_linker->has_link(_qvars[prev], _qvars[level])) {
+                direct_links.push_back(prev);
+            }
+        }
+        _direct_links.push_back(direct_links);
+
+        _indirect_links.push_back(direct_links.empty() && level > 0 &&
+                _linker->has_indirect_links(_qvars[level - 1], _qvars[level]));
+    }
+
+    _bound.resize(_qvars.size(), 0);
+}
+
+size_t TupleProducer::produce(TupleWriter *writer) {
+    _count = 0;
+    _has_last_row = false;
+
+    if(!_qvars.empty()) {
+        produce_level(0, writer);
+    }
+    return _count;
+}
+
+void TupleProducer::produce_level(size_t level, TupleWriter *writer) {
+    check_cancellation();
+
+    const std::vector<size_t>& direct_links = _direct_links[level];
+
+    if(direct_links.empty() && !_indirect_links[level]) {
+        for(ConditionId id = 0; id < _domains[level].size(); ++id) {
+            bind(level, id, writer);
+        }
+        return;
+    }
+
+    ConditionSet candidates;
+
+    if(direct_links.empty()) {
+        candidates = _linker->get_indirect_links(
+                _qvars[level - 1], _qvars[level], 
+                _domains[level - 1][_bound[level - 1]]);
+    } else {
+        for(size_t i = 0; i < direct_links.size(); ++i) {
+            size_t prev = direct_links[i];
+            const ConditionSet& linked = _linker->get_linked_conditions(
+                    _qvars[prev], _qvars[level], 
+                    _domains[prev][_bound[prev]]);
+
+            if(i == 0) {
+                candidates = linked;
+            } else {
+                candidates.intersect_with(linked);
+            }
+        }
+    }
+
+    for(ConditionSet::iterator cit = candidates.begin();
+            cit != candidates.end(); ++cit)
+    {
+        ConditionId id;
+        if(find_id(level, *cit, id)) {
+            bind(level, id, writer);
+        }
+    }
+}
+
+void TupleProducer::bind(size_t level, ConditionId id, TupleWriter *writer) {
+    _bound[level] = id;
+
+    if(level + 1 < _qvars.size()) {
+        produce_level(level + 1, writer);
+    } else {
+        write_row(writer);
+    }
+}
+
+void TupleProducer::write_row(TupleWriter *writer) {
+    if(_has_last_row && _last_row == _bound) {
+        return;
+    }
+    _last_row = _bound;
+    _has_last_row = true;
+
+    for(size_t i = 0; i < _columns.size(); ++i) {
+        size_t level = _columns[i];
+        _row[i] = _domains[level][_bound[level]];
+    }
+
+    writer->write_row(_row);
+    ++_count;
+}
+
+bool TupleProducer::find_id(size_t level, const ConditionPtr& condition,
+        ConditionId& id)
+{
+    const std::vector<ConditionPtr>& domain = _domains[level];
+    std::vector<ConditionPtr>::const_iterator it = 
+        std::lower_bound(domain.begin(), domain.end(), condition);
+
+    if(it == domain.end() || *it != condition) {
+        return false;
+    }
+
+    id = it - domain.begin();
+    return true;
+}
+
+} // namespace impl
+} // namespace simple
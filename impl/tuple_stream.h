@@ -0,0 +1,129 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "simple/condition_set.h"
+#include "simple/tuple.h"
+#include "impl/linker.h"
+
+namespace simple {
+namespace impl {
+
+using namespace simple;
+
+/*
+ * Receives the rows of a tuple selection one at a time, in the order 
+ * of the selected query variables.
+ */
+class TupleWriter {
+  public:
+    virtual void write_row(const std::vector<ConditionPtr>& row) = 0;
+
+    virtual ~TupleWriter() { }
+};
+
+/*
+ * Writes every row as a line of space separated answer values, e.g.
+ * "3 x main", as soon as it is produced.
+ */
+class StreamTupleWriter : public TupleWriter {
+  public:
+    StreamTupleWriter(std::ostream& out);
+
+    void write_row(const std::vector<ConditionPtr>& row);
+
+  private:
+    std::ostream& _out;
+};
+
+/*
+ * Collects the rows into a TupleList, for callers that want the whole
+ * result in memory.
+ */
+class TupleListWriter : public TupleWriter {
+  public:
+    TupleListWriter(TupleList& tuples);
+
+    void write_row(const std::vector<ConditionPtr>& row);
+
+  private:
+    TupleList& _tuples;
+};
+
+/*
+ * Enumerates the tuples of a set of query variables from the links in
+ * a solved linker, depth first, handing every row to a TupleWriter as
+ * soon as it is complete. Apart from the rows the writer keeps, memory
+ * is bounded by the domains of the selected query variables and one
+ * candidate set per selected variable.
+ *
+ * Every condition is identified by its position in the sorted domain of
+ * its query variable, and the candidates of each variable are visited
+ * in that order, so rows are produced sorted by their fixed width ID 
+ * rows. A duplicate row can therefore only follow its twin directly 
+ * and is dropped by comparing against the previous ID row.
+ *
+ * The candidates of a variable are the conditions linked to every 
+ * earlier variable it has direct links with. Without direct links, they
+ * are the conditions indirectly linked to the previous variable, and 
+ * failing that its whole domain. A variable selected more than once 
+ * takes the same condition in every position.
+ */
+class TupleProducer {
+  public:
+    TupleProducer(SimpleQueryLinker *linker, 
+            const std::vector<std::string>& qvars);
+
+    /*
+     * Write all the tuples and return the number of rows written.
+     */
+    size_t produce(TupleWriter *writer);
+
+  private:
+    typedef unsigned int ConditionId;
+
+    void produce_level(size_t level, TupleWriter *writer);
+    void bind(size_t level, ConditionId id, TupleWriter *writer);
+    void write_row(TupleWriter *writer);
+    bool find_id(size_t level, const ConditionPtr& condition, 
+            ConditionId& id);
+
+    SimpleQueryLinker           *_linker;
+
+    // the slots of the distinct selected qvars, and the qvar of every 
+    // column
+    std::vector<QVarSlot>       _qvars;
+    std::vector<size_t>         _columns;
+
+    std::vector<std::vector<ConditionPtr> > _domains;
+    std::vector<std::vector<size_t> >       _direct_links;
+    std::vector<bool>                       _indirect_links;
+
+    std::vector<ConditionId>    _bound;
+    std::vector<ConditionId>    _last_row;
+    bool                        _has_last_row;
+    std::vector<ConditionPtr>   _row;
+    size_t                      _count;
+};
+
+} // namespace impl
+} // namespace simple
@@ -40,6 +40,7 @@ class StatementVisitor;
 class ExprVisitor;
 
 typedef std::map<int, StatementAst*> LineTable;
+typedef std::shared_ptr<ExprAst> ExprPtr;
 
 class InconsistentAstError : public std::exception { };
 
@@ -293,6 +294,12 @@ class AssignmentAst : public StatementAst {
      */
     virtual ExprAst* get_expr() = 0;
 
+    /**
+     * Get a shared reference to the right hand side expression, for holders
+     * that need to keep the expression alive without copying it.
+     */
+    virtual ExprPtr get_expr_ptr() = 0;
+
     virtual ~AssignmentAst() { }
 };
 
@@ -326,6 +333,22 @@ class ExprAst {
     virtual void accept_expr_visitor(ExprVisitor*) = 0;
     virtual ExprAst* clone() = 0;
 
+    /**
+     * Get the id of a hash-consed expression node, or 0 if the node was 
+     * not created by an expression store. Two nodes of the same store 
+     * have the same id if and only if they are structurally the same.
+     */
+    virtual unsigned long long get_id() = 0;
+
+    /**
+     * Whether two non-zero ids were handed out by the same store. The 
+     * upper half of an id identifies the store and the lower half the 
+     * node.
+     */
+    static bool is_same_store(unsigned long long id1, unsigned long long id2) {
+        return (id1 >> 32) == (id2 >> 32);
+    }
+
     virtual ~ExprAst() { }
 };
 
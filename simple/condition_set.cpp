@@ -58,62 +58,140 @@ ConditionSet::ConditionSet(ConditionPtr condition) :
 }
 
 ConditionSet::ConditionSet(std::set<ConditionPtr>&& set) :
-    _set(std::forward< std::set<ConditionPtr> >(set))
-{ }
+    _set()
+{
+    if(!set.empty()) {
+        _set.reset(new std::set<ConditionPtr>(
+                    std::forward< std::set<ConditionPtr> >(set)));
+    }
+}
+
+ConditionSet& ConditionSet::operator =(const ConditionSet& other) {
+    _set = other._set;
+    return *this;
+}
+
+ConditionSet& ConditionSet::operator =(ConditionSet&& other) {
+    _set = std::move(other._set);
+    return *this;
+}
+
+const std::set<ConditionPtr>& ConditionSet::get_set() const {
+    static const std::set<ConditionPtr> empty_set;
+
+    if(_set) {
+        return *_set;
+    } else {
+        return empty_set;
+    }
+}
+
+std::set<ConditionPtr>& ConditionSet::detach() {
+    if(!_set) {
+        _set.reset(new std::set<ConditionPtr>());
+    } else if(!_set.unique()) {
+        _set.reset(new std::set<ConditionPtr>(*_set));
+    }
+    return *_set;
+}
 
 void ConditionSet::insert(ConditionPtr condition) {
-    _set.insert(condition);
+    if(!has_element(condition)) {
+        detach().insert(condition);
+    }
 }
 
 void ConditionSet::insert(SimpleCondition *condition) {
-    _set.insert(ConditionPtr(condition));
+    insert(ConditionPtr(condition));
 }
 
 void ConditionSet::remove(ConditionPtr condition) {
-    _set.erase(condition);
+    if(!has_element(condition)) {
+        return;
+    }
+
+    if(get_size() == 1) {
+        _set.reset();
+    } else {
+        detach().erase(condition);
+    }
 }
 
 void ConditionSet::union_with(const ConditionSet& other) {
-    union_set(_set, other._set);
+    if(other.is_empty() || _set == other._set) {
+        return;
+    }
+
+    if(is_empty()) {
+        _set = other._set;
+        return;
+    }
+
+    union_set(detach(), other.get_set());
 }
 
 void ConditionSet::intersect_with(const ConditionSet& other) {
     if(other.is_empty()) {
         // we are intersecting with empty set, and so
         // the result is also an empty set.
-        _set.clear();
+        _set.reset();
         return; 
     }
 
-    std::set<ConditionPtr>::iterator it = _set.begin();
-    while(it != _set.end()) {
-        if(!other.has_element(*it)) {
-            std::set<ConditionPtr>::iterator old_it = it++;
-            _set.erase(old_it);
-        } else {
-            ++it;
+    if(is_empty() || _set == other._set) {
+        return;
+    }
+
+    const std::set<ConditionPtr>& set = get_set();
+
+    // Only build a new set if the intersection removes anything.
+    std::set<ConditionPtr>::const_iterator it = set.begin();
+    while(it != set.end() && other.has_element(*it)) {
+        ++it;
+    }
+
+    if(it == set.end()) {
+        return;
+    }
+
+    SetPtr result(new std::set<ConditionPtr>(set.begin(), it));
+    for(++it; it != set.end(); ++it) {
+        if(other.has_element(*it)) {
+            result->insert(result->end(), *it);
         }
     }
+
+    if(result->empty()) {
+        _set.reset();
+    } else {
+        _set = std::move(result);
+    }
 }
 
 ConditionSet ConditionSet::difference_with(const ConditionSet& other) {
-    return ConditionSet(difference_set(_set, other._set));
+    if(other.is_empty()) {
+        return *this;
+    } else if(_set == other._set) {
+        return ConditionSet();
+    }
+
+    return ConditionSet(difference_set(get_set(), other.get_set()));
 }
 
 void ConditionSet::clear() {
-    _set.clear();
+    _set.reset();
 }
 
 bool ConditionSet::is_empty() const {
-    return _set.empty();
+    return !_set || _set->empty();
 }
 
 bool ConditionSet::equals(const ConditionSet& other) const {
-    return _set == other._set;
+    return _set == other._set || get_set() == other.get_set();
 }
 
 bool ConditionSet::equals(const std::set<ConditionPtr>& other) const {
-    return _set == other;
+    return get_set() == other;
 }
 
 bool ConditionSet::operator ==(const ConditionSet& other) const {
@@ -125,19 +203,19 @@ bool ConditionSet::operator !=(const ConditionSet& other) const {
 }
 
 bool ConditionSet::has_element(const ConditionPtr& other) const {
-    return _set.count(other) != 0;
+    return _set && _set->count(other) != 0;
 }
 
 size_t ConditionSet::get_size() const {
-    return _set.size();
+    return _set ? _set->size() : 0;
 }
 
 std::set<ConditionPtr>::const_iterator ConditionSet::begin() const {
-    return _set.begin();
+    return get_set().begin();
 }
 
 std::set<ConditionPtr>::const_iterator ConditionSet::end() const {
-    return _set.end();
+    return get_set().end();
 }
 
 ConditionSet::~ConditionSet() { }
@@ -162,6 +240,16 @@ ConditionPtr::ConditionPtr(ConditionPtr&& other) :
     _ptr(std::move(other._ptr))
 { }
 
+ConditionPtr& ConditionPtr::operator =(const ConditionPtr& other) {
+    _ptr = other._ptr;
+    return *this;
+}
+
+ConditionPtr& ConditionPtr::operator =(ConditionPtr&& other) {
+    _ptr = std::move(other._ptr);
+    return *this;
+}
+
 SimpleCondition* ConditionPtr::get() const {
     return _ptr.get();
 }
@@ -36,6 +36,9 @@ class ConditionPtr {
     ConditionPtr(const ConditionPtr& other);
     ConditionPtr(ConditionPtr&& other);
 
+    ConditionPtr& operator =(const ConditionPtr& other);
+    ConditionPtr& operator =(ConditionPtr&& other);
+
     SimpleCondition* get() const;
 
     bool equals(const ConditionPtr& other) const ;
@@ -56,6 +59,14 @@ class ConditionPtr {
     std::shared_ptr<SimpleCondition> _ptr;
 };
 
+/*
+ * An ordered set of conditions with copy-on-write storage. Copying a 
+ * ConditionSet only shares the underlying set, which is copied by the
+ * first modification of one of the sharing sets. Modifications that 
+ * do not change the set, such as intersecting a set with a superset of
+ * itself, never copy it, so query variable domains can be passed around
+ * by value and are only copied when a clause actually narrows them.
+ */
 class ConditionSet {
   public:
     typedef std::set<ConditionPtr>::const_iterator  iterator;
@@ -67,6 +78,9 @@ class ConditionSet {
     ConditionSet(ConditionPtr condition);
     ConditionSet(std::set<ConditionPtr>&& set);
 
+    ConditionSet& operator =(const ConditionSet& other);
+    ConditionSet& operator =(ConditionSet&& other);
+
     void insert(ConditionPtr condition);
     void insert(SimpleCondition *condition);
     void union_with(const ConditionSet& other);
@@ -90,7 +104,18 @@ class ConditionSet {
     ~ConditionSet();
 
   private:
-    std::set<ConditionPtr> _set;
+    typedef std::shared_ptr< std::set<ConditionPtr> > SetPtr;
+
+    const std::set<ConditionPtr>& get_set() const;
+
+    /*
+     * Get the set for modification, copying it first if it is shared 
+     * with another ConditionSet.
+     */
+    std::set<ConditionPtr>& detach();
+
+    // NULL for the empty set
+    SetPtr _set;
 };
 
 struct ConditionPair {
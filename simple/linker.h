@@ -22,6 +22,7 @@
 #include "simple/tuple.h"
 #include "simple/predicate.h"
 #include "simple/condition_set.h"
+#include "simple/query.h"
 
 namespace simple {
 
@@ -141,9 +142,29 @@ class QueryLinker {
     /*
      * Get the ConditionSet that the qvar is holding. If the qvar is
      * not yet initialized, use pred to initialize the qvar and return
-     * the result.
+     * the result. The returned set is a view that is only valid until 
+     * the linker is next modified; copy it to keep it around, which is
+     * cheap as the copy shares the storage until either side changes.
      */
-    virtual ConditionSet get_conditions(const std::string& qvar,
+    virtual const ConditionSet& get_conditions(const std::string& qvar,
+            SimplePredicate *pred) = 0;
+
+    /*
+     * Get the slot of a query variable, assigning a new slot the first
+     * time a name is seen. Each of the methods above has an overload
+     * taking slots in place of names, for use on the evaluation path.
+     */
+    virtual QVarSlot get_slot(const std::string& qvar) = 0;
+
+    virtual void update_links(QVarSlot qvar1, QVarSlot qvar2, 
+            const std::vector<ConditionPair>& links) = 0;
+
+    virtual void update_results(QVarSlot qvar, 
+            const ConditionSet& conditions) = 0;
+
+    virtual bool is_initialized(QVarSlot qvar) = 0;
+
+    virtual const ConditionSet& get_conditions(QVarSlot qvar,
             SimplePredicate *pred) = 0;
 };
 
@@ -30,6 +30,15 @@ namespace simple {
 
 class PqlTermVisitor;
 
+/*
+ * The dense index of a query variable. The PQL parser numbers the 
+ * synonyms of a query in the order they are first seen, so that query
+ * evaluation can keep per-variable state in flat arrays.
+ */
+typedef size_t QVarSlot;
+
+const QVarSlot NO_QVAR_SLOT = (QVarSlot) -1;
+
 class PqlTerm {
   public:
     virtual void accept_pql_term_visitor(PqlTermVisitor *visitor) = 0;
@@ -48,6 +57,12 @@ class PqlVariableTerm : public PqlTerm {
   public:
     virtual std::string get_query_variable() = 0;
 
+    /*
+     * The slot of the query variable in its query set, or NO_QVAR_SLOT
+     * if the term was not created by the parser.
+     */
+    virtual QVarSlot get_slot() = 0;
+
     virtual ~PqlVariableTerm() { }
 };
 
@@ -127,11 +142,22 @@ typedef std::set<ClausePtr> ClauseSet;
 
 struct PqlQuerySet {
   public:
+    PqlQuerySet() :
+        predicates(), selector(), clauses(), qvar_names(), 
+        is_unsatisfiable(false)
+    { }
+
     std::map< std::string, 
         std::shared_ptr<SimplePredicate> >      predicates;
 
     std::shared_ptr<PqlSelector>                selector;
     std::set<ClausePtr>                         clauses;
+
+    // the synonym of every slot
+    std::vector<std::string>                    qvar_names;
+
+    // set when the query is known to have no result without solving it
+    bool                                        is_unsatisfiable;
 };
 
 } // namespace simple
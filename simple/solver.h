@@ -19,6 +19,8 @@
 #pragma once
 
 #include <map>
+#include <memory>
+#include <string>
 #include "simple/ast.h"
 #include "simple/condition.h"
 #include "simple/condition_set.h"
@@ -33,14 +35,125 @@ class QueryValidator {
     virtual ~QueryValidator() { }
 };
 
+/*
+ * A pull based view of the result of a solve, for consumers that may not
+ * need all of it. next() hands out one condition at a time, each of them
+ * once, and returns false when there are no more.
+ */
+class ConditionCursor {
+  public:
+    virtual bool next(ConditionPtr& condition) = 0;
+
+    virtual ~ConditionCursor() { }
+};
+
+typedef std::shared_ptr<ConditionCursor> ConditionCursorPtr;
+
+/*
+ * A cursor over a result that has already been built.
+ */
+class ConditionSetCursor : public ConditionCursor {
+  public:
+    ConditionSetCursor(const ConditionSet& conditions) :
+        _conditions(conditions), _it(_conditions.begin())
+    { }
+
+    bool next(ConditionPtr& condition) {
+        if(_it == _conditions.end()) {
+            return false;
+        }
+        condition = *_it++;
+        return true;
+    }
+
+  private:
+    ConditionSet            _conditions;
+    ConditionSet::iterator  _it;
+};
+
+class KeyedQuerySolver;
+
 class QuerySolver : public QueryValidator {
   public:
     virtual ConditionSet solve_left(SimpleCondition *right_condition) = 0;
     virtual ConditionSet solve_right(SimpleCondition *left_condition) = 0;
 
+    /*
+     * The results of solve_right() and solve_left() as cursors. Solvers
+     * that can generate their results one at a time, e.g. by walking 
+     * the AST, should override these so that consumers can stop early;
+     * the defaults build the whole result first.
+     */
+    virtual ConditionCursorPtr cursor_right(SimpleCondition *left_condition) {
+        return ConditionCursorPtr(
+                new ConditionSetCursor(solve_right(left_condition)));
+    }
+
+    virtual ConditionCursorPtr cursor_left(SimpleCondition *right_condition) {
+        return ConditionCursorPtr(
+                new ConditionSetCursor(solve_left(right_condition)));
+    }
+
+    /*
+     * Existence probes, for clauses with a wildcard on one side: whether
+     * solve_right() or solve_left() would return anything at all, and 
+     * whether the relation holds for any pair. Solvers that can answer
+     * without generating the results should override these; the 
+     * defaults pull the first result from a cursor, and has_any() 
+     * conservatively returns true.
+     */
+    virtual bool has_right(SimpleCondition *left_condition) {
+        ConditionPtr condition(NULL);
+        return cursor_right(left_condition)->next(condition);
+    }
+
+    virtual bool has_left(SimpleCondition *right_condition) {
+        ConditionPtr condition(NULL);
+        return cursor_left(right_condition)->next(condition);
+    }
+
+    virtual bool has_any() {
+        return true;
+    }
+
+    /*
+     * The solver as a KeyedQuerySolver, or NULL if its relation is not
+     * keyed. Solvers wrapping another solver forward this, so that the 
+     * wrapped solver can still be joined by its keys.
+     */
+    virtual KeyedQuerySolver* as_keyed() {
+        return NULL;
+    }
+
    virtual ~QuerySolver() { }
 };
 
+/*
+ * A solver whose relation is equality of a key derived from each side,
+ * e.g. the attribute comparisons of with clauses. Two conditions are
+ * related exactly when they have the same key, so the query processor
+ * can join two query variables by hashing the keys instead of validating
+ * every pair.
+ */
+class KeyedQuerySolver : public QuerySolver {
+  public:
+    /*
+     * Get the key of a condition at the left or right side. Return
+     * false if the condition has no key, in which case it is not 
+     * related to anything.
+     */
+    virtual bool get_left_key(SimpleCondition *condition, 
+            std::string& key) = 0;
+    virtual bool get_right_key(SimpleCondition *condition, 
+            std::string& key) = 0;
+
+    KeyedQuerySolver* as_keyed() {
+        return this;
+    }
+
+    virtual ~KeyedQuerySolver() { }
+};
+
 typedef std::map<std::string, std::shared_ptr<QuerySolver> > SolverTable;
 
 } // namespace matcher
@@ -143,6 +143,65 @@ bool is_same_statement_list(StatementAst *statement1, StatementAst *statement2)
     }
 }
 
+class NestedListVisitor : public StatementVisitor {
+  public:
+    NestedListVisitor(std::vector<StatementAst*>& lists) : _lists(lists) { }
+
+    void visit_assignment(AssignmentAst*) { }
+    void visit_call(CallAst*) { }
+
+    void visit_conditional(ConditionalAst *condition) {
+        add_list(condition->get_then_branch());
+        add_list(condition->get_else_branch());
+    }
+
+    void visit_while(WhileAst *loop) {
+        add_list(loop->get_body());
+    }
+
+  private:
+    void add_list(StatementAst *statement) {
+        if(statement != NULL) {
+            _lists.push_back(statement);
+        }
+    }
+
+    std::vector<StatementAst*>& _lists;
+};
+
+std::vector<StatementAst*> get_nested_lists(StatementAst *statement) {
+    std::vector<StatementAst*> lists;
+    NestedListVisitor visitor(lists);
+    statement->accept_statement_visitor(&visitor);
+    return lists;
+}
+
+class WhileStatementVisitor : public StatementVisitor {
+  public:
+    WhileStatementVisitor() : _result(false) { }
+
+    void visit_assignment(AssignmentAst*) { }
+    void visit_call(CallAst*) { }
+    void visit_conditional(ConditionalAst*) { }
+
+    void visit_while(WhileAst*) {
+        _result = true;
+    }
+
+    bool return_result() {
+        return _result;
+    }
+
+  private:
+    bool _result;
+};
+
+bool is_while_statement(StatementAst *statement) {
+    WhileStatementVisitor visitor;
+    statement->accept_statement_visitor(&visitor);
+    return visitor.return_result();
+}
+
 class FirstSameExprVisitor : public ExprVisitor {
   public:
     FirstSameExprVisitor(ExprAst *ast2);
@@ -178,6 +237,17 @@ class SecondSameExprVisitor : public ExprVisitor {
 
 template <>
 bool is_same_expr<ExprAst, ExprAst>(ExprAst *ast1, ExprAst *ast2) {
+    if(ast1 == ast2) {
+        return true;
+    }
+
+    // hash-consed nodes of the same store are equal only if identical
+    unsigned long long id1 = ast1->get_id();
+    unsigned long long id2 = ast2->get_id();
+    if(id1 != 0 && id2 != 0 && ExprAst::is_same_store(id1, id2)) {
+        return false;
+    }
+
     FirstSameExprVisitor visitor(ast2);
     ast1->accept_expr_visitor(&visitor);
     return visitor.return_result();
@@ -220,6 +290,71 @@ bool is_same_expr<BinaryOpAst, BinaryOpAst>(BinaryOpAst *ast1, BinaryOpAst *ast2
             is_same_expr<ExprAst, ExprAst>(ast1->get_rhs(), ast2->get_rhs());
 }
 
+class ExprKindVisitor : public ExprVisitor {
+  public:
+    ExprKindVisitor() : kind(0), constant(NULL), var(NULL), bin(NULL) { }
+
+    void visit_const(ConstAst *ast) {
+        kind = 0;
+        constant = ast;
+    }
+
+    void visit_variable(VariableAst *ast) {
+        kind = 1;
+        var = ast;
+    }
+
+    void visit_binary_op(BinaryOpAst *ast) {
+        kind = 2;
+        bin = ast;
+    }
+
+    int         kind;
+    ConstAst    *constant;
+    VariableAst *var;
+    BinaryOpAst *bin;
+};
+
+static int compare_expr(ExprAst *ast1, ExprAst *ast2) {
+    if(ast1 == ast2) {
+        return 0;
+    }
+
+    ExprKindVisitor kind1, kind2;
+    ast1->accept_expr_visitor(&kind1);
+    ast2->accept_expr_visitor(&kind2);
+
+    if(kind1.kind != kind2.kind) {
+        return kind1.kind < kind2.kind ? -1 : 1;
+    }
+
+    if(kind1.constant) {
+        int value1 = kind1.constant->get_constant()->get_int();
+        int value2 = kind2.constant->get_constant()->get_int();
+        return value1 == value2 ? 0 : (value1 < value2 ? -1 : 1);
+    }
+
+    if(kind1.var) {
+        SimpleVariable *var1 = kind1.var->get_variable();
+        SimpleVariable *var2 = kind2.var->get_variable();
+        return *var1 == *var2 ? 0 : (*var1 < *var2 ? -1 : 1);
+    }
+
+    if(kind1.bin->get_op() != kind2.bin->get_op()) {
+        return kind1.bin->get_op() < kind2.bin->get_op() ? -1 : 1;
+    }
+
+    int lhs = compare_expr(kind1.bin->get_lhs(), kind2.bin->get_lhs());
+    if(lhs != 0) {
+        return lhs;
+    }
+    return compare_expr(kind1.bin->get_rhs(), kind2.bin->get_rhs());
+}
+
+template <>
+bool is_less_than_expr<ExprAst, ExprAst>(ExprAst *ast1, ExprAst *ast2) {
+    return compare_expr(ast1, ast2) < 0;
+}
 
 FirstSameExprVisitor::FirstSameExprVisitor(ExprAst *ast2) : 
     _ast2(ast2), _result(false)
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <vector>
 #include "simple/ast.h"
 #include "impl/ast.h"
 
@@ -96,6 +97,18 @@ bool is_same_statement<ConditionalAst, ConditionalAst>(ConditionalAst *condition
 
 bool is_same_statement_list(StatementAst *statement1, StatementAst *statement2);
 
+/*
+ * The first statements of the statement lists directly nested in a 
+ * statement: the body of a while loop, or the then and else branches of
+ * an if statement. Empty lists are left out.
+ */
+std::vector<StatementAst*> get_nested_lists(StatementAst *statement);
+
+/*
+ * Whether a statement is a while loop.
+ */
+bool is_while_statement(StatementAst *statement);
+
 
 
 template <>
@@ -119,6 +132,13 @@ bool is_same_expr<ConstAst, ConstAst>(ConstAst *ast1, ConstAst *ast2);
 template <>
 bool is_same_expr<BinaryOpAst, BinaryOpAst>(BinaryOpAst *ast1, BinaryOpAst *ast2);
 
+/*
+ * Structural order of expressions: constants before variables before
+ * binary operations, then by value, name, or operator and operands.
+ */
+template <>
+bool is_less_than_expr<ExprAst, ExprAst>(ExprAst *ast1, ExprAst *ast2);
+
 
 
 } // namespace util 
@@ -77,15 +77,15 @@ class ConditionPrinter : public ConditionVisitor {
     }
 
     void visit_constant_condition(ConstantCondition *condition) {
-        _result = "(ConstantCondition ";
-        _result += condition->get_constant()->get_int();
-        _result += ")";
+        std::stringstream out;
+        out << "(ConstantCondition " << condition->get_constant()->get_int() << ")";
+        _result = out.str();
     }
 
     void visit_pattern_condition(PatternCondition *condition) {
-        _result = "(PatternCondition ";
-        _result += (long) condition->get_expr_ast();
-        _result += ")";
+        std::stringstream out;
+        out << "(PatternCondition " << condition->get_expr_ast() << ")";
+        _result = out.str();
     }
 
     std::string return_result() {
@@ -96,11 +96,55 @@ class ConditionPrinter : public ConditionVisitor {
 };
 
 
+class ConditionValuePrinter : public ConditionVisitor {
+  public:
+    ConditionValuePrinter(SimpleCondition *condition) :
+        _result()
+    {
+        condition->accept_condition_visitor(this);
+    }
+
+    void visit_proc_condition(ProcCondition *condition) {
+        _result = condition->get_proc_ast()->get_name();
+    }
+
+    void visit_statement_condition(StatementCondition *condition) {
+        std::stringstream out;
+        out << condition->get_statement_ast()->get_line();
+        _result = out.str();
+    }
+
+    void visit_variable_condition(VariableCondition *condition) {
+        _result = condition->get_variable()->get_name();
+    }
+
+    void visit_constant_condition(ConstantCondition *condition) {
+        std::stringstream out;
+        out << condition->get_constant()->get_int();
+        _result = out.str();
+    }
+
+    void visit_pattern_condition(PatternCondition *condition) {
+        _result = condition_to_string(condition);
+    }
+
+    std::string return_result() {
+        return std::move(_result);
+    }
+  private:
+    std::string _result;
+};
+
 std::string condition_to_string(SimpleCondition *condition) {
     ConditionPrinter printer(condition);
     return printer.return_result();
 }
 
+std::string condition_to_value(SimpleCondition *condition) {
+    ConditionValuePrinter printer(condition);
+    return printer.return_result();
+}
+
 
 template <>
 bool is_same_condition<SimpleCondition, SimpleCondition>(
@@ -135,6 +179,14 @@ bool is_same_condition<ProcCondition, ProcCondition>(
     return condition1->get_proc_ast() == condition2->get_proc_ast();
 }
 
+template <>
+bool is_same_condition<ConstantCondition, ConstantCondition>(
+        ConstantCondition *condition1, ConstantCondition *condition2)
+{
+    return condition1->get_constant()->get_int() ==
+        condition2->get_constant()->get_int();
+}
+
 template <>
 bool is_same_condition<PatternCondition, PatternCondition>(
         PatternCondition *condition1, PatternCondition *condition2)
@@ -198,6 +250,34 @@ bool is_less_than_condition<PatternCondition, ProcCondition>(
 }
 
 
+template <>
+bool is_less_than_condition<ConstantCondition, PatternCondition>(
+        ConstantCondition *condition1, PatternCondition *condition2)
+{
+    return true;
+}
+
+template <>
+bool is_less_than_condition<ConstantCondition, VariableCondition>(
+        ConstantCondition *condition1, VariableCondition *condition2)
+{
+    return true;
+}
+
+template <>
+bool is_less_than_condition<ConstantCondition, StatementCondition>(
+        ConstantCondition *condition1, StatementCondition *condition2)
+{
+    return true;
+}
+
+template <>
+bool is_less_than_condition<ConstantCondition, ProcCondition>(
+        ConstantCondition *condition1, ProcCondition *condition2)
+{
+    return true;
+}
+
 template <>
 bool is_less_than_condition<StatementCondition, StatementCondition>(
         StatementCondition *condition1, StatementCondition *condition2)
@@ -220,6 +300,14 @@ bool is_less_than_condition<ProcCondition, ProcCondition>(
     return condition1->get_proc_ast() < condition2->get_proc_ast();
 }
 
+template <>
+bool is_less_than_condition<ConstantCondition, ConstantCondition>(
+        ConstantCondition *condition1, ConstantCondition *condition2)
+{
+    return condition1->get_constant()->get_int() <
+        condition2->get_constant()->get_int();
+}
+
 template <>
 bool is_less_than_condition<PatternCondition, PatternCondition>(
         PatternCondition *condition1, PatternCondition *condition2)
@@ -27,6 +27,12 @@ namespace util {
 
 std::string condition_to_string(SimpleCondition *condition);
 
+/*
+ * The condition as it is written in a PQL answer: the line number of a
+ * statement, the name of a procedure or variable, or a constant value.
+ */
+std::string condition_to_value(SimpleCondition *condition);
+
 template <typename Condition1, typename Condition2>
 bool is_same_condition(Condition1 *condition1, Condition2 *condition2) {
     return false;
@@ -48,13 +54,17 @@ template <>
 bool is_same_condition<ProcCondition, ProcCondition>(
         ProcCondition *condition1, ProcCondition *condition2);
 
+template <>
+bool is_same_condition<ConstantCondition, ConstantCondition>(
+        ConstantCondition *condition1, ConstantCondition *condition2);
+
 template <>
 bool is_same_condition<PatternCondition, PatternCondition>(
         PatternCondition *condition1, PatternCondition *condition2);
 
 /*
  * Condition Ordering:
- * Proc > Statement > Variable > Pattern
+ * Proc > Statement > Variable > Pattern > Constant
  */
 template <typename Condition1, typename Condition2>
 bool is_less_than_condition(
@@ -91,6 +101,22 @@ template <>
 bool is_less_than_condition<PatternCondition, ProcCondition>(
         PatternCondition *condition1, ProcCondition *condition2);
 
+template <>
+bool is_less_than_condition<ConstantCondition, PatternCondition>(
+        ConstantCondition *condition1, PatternCondition *condition2);
+
+template <>
+bool is_less_than_condition<ConstantCondition, VariableCondition>(
+        ConstantCondition *condition1, VariableCondition *condition2);
+
+template <>
+bool is_less_than_condition<ConstantCondition, StatementCondition>(
+        ConstantCondition *condition1, StatementCondition *condition2);
+
+template <>
+bool is_less_than_condition<ConstantCondition, ProcCondition>(
+        ConstantCondition *condition1, ProcCondition *condition2);
+
 template <>
 bool is_less_than_condition<StatementCondition, StatementCondition>(
         StatementCondition *condition1, StatementCondition *condition2);
@@ -103,6 +129,10 @@ template <>
 bool is_less_than_condition<ProcCondition, ProcCondition>(
         ProcCondition *condition1, ProcCondition *condition2);
 
+template <>
+bool is_less_than_condition<ConstantCondition, ConstantCondition>(
+        ConstantCondition *condition1, ConstantCondition *condition2);
+
 template <>
 bool is_less_than_condition<PatternCondition, PatternCondition>(
         PatternCondition *condition1, PatternCondition *condition2);
@@ -0,0 +1,53 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include "simple/util/json_utils.h"
+
+namespace simple {
+namespace util {
+
+std::string json_string(const std::string& value) {
+    std::string result = "\"";
+
+    for(std::string::const_iterator it = value.begin(); 
+            it != value.end(); ++it)
+    {
+        switch(*it) {
+            case '"':   result += "\\\""; break;
+            case '\\':  result += "\\\\"; break;
+            case '\n':  result += "\\n"; break;
+            case '\r':  result += "\\r"; break;
+            case '\t':  result += "\\t"; break;
+            default:
+                if((unsigned char) *it < 0x20) {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", *it);
+                    result += buffer;
+                } else {
+                    result += *it;
+                }
+        }
+    }
+
+    result += "\"";
+    return result;
+}
+
+} // namespace util
+} // namespace simple
@@ -26,6 +26,12 @@ namespace impl {
 
 using namespace simple;
 
+/*
+ * Adapts a concrete solver, whose methods are templates specialized on
+ * the AST types of the conditions, to a QuerySolver. Besides solve_right,
+ * solve_left and validate, a concrete solver answers the existence 
+ * probes has_right, has_left and has_any() from its own indexes.
+ */
 template <typename ConcreteSolver>
 class SimpleSolverGenerator : public QuerySolver  {
   private:
@@ -188,9 +194,62 @@ class SimpleSolverGenerator : public QuerySolver  {
         SimpleCondition *_right_condition;
     };
 
+    class ProbeVisitor : public ConditionVisitor {
+      public:
+        ProbeVisitor(ConcreteSolver *solver, bool forward) : 
+            _solver(solver), _forward(forward), _result(false)
+        { }
+
+        void visit_statement_condition(StatementCondition *condition) {
+            probe<StatementAst>(condition->get_statement_ast());
+        }
+
+        void visit_proc_condition(ProcCondition *condition) {
+            probe<ProcAst>(condition->get_proc_ast());
+        }
+
+        void visit_variable_condition(VariableCondition *condition) {
+            probe<SimpleVariable>(condition->get_variable());
+        }
+
+        void visit_constant_condition(ConstantCondition *condition) {
+            probe<SimpleConstant>(condition->get_constant());
+        }
+
+        void visit_pattern_condition(PatternCondition *condition) {
+            probe<ExprAst>(condition->get_expr_ast());
+        }
+
+        bool return_result() {
+            return _result;
+        }
+
+      private:
+        template <typename Condition>
+        void probe(Condition *condition) {
+            if(_forward) {
+                _result = _solver->template has_right<Condition>(condition);
+            } else {
+                _result = _solver->template has_left<Condition>(condition);
+            }
+        }
+
+        ConcreteSolver *_solver;
+        bool _forward;
+        bool _result;
+    };
+
   public:
     SimpleSolverGenerator(ConcreteSolver *solver) : _solver(solver) { }
 
+    /*
+     * Share the concrete solver with other users, e.g. another solver
+     * that is built on top of it and should reuse its caches.
+     */
+    SimpleSolverGenerator(std::shared_ptr<ConcreteSolver> solver) : 
+        _solver(solver) 
+    { }
+
     virtual ConditionSet solve_left(SimpleCondition *right_condition) {
         SolverLeftVisitor visitor(_solver.get());
         right_condition->accept_condition_visitor(&visitor);
@@ -209,13 +268,94 @@ class SimpleSolverGenerator : public QuerySolver  {
         return visitor.return_result();
     }
 
+    virtual bool has_right(SimpleCondition *left_condition) {
+        ProbeVisitor visitor(_solver.get(), true);
+        left_condition->accept_condition_visitor(&visitor);
+        return visitor.return_result();
+    }
+
+    virtual bool has_left(SimpleCondition *right_condition) {
+        ProbeVisitor visitor(_solver.get(), false);
+        right_condition->accept_condition_visitor(&visitor);
+        return visitor.return_result();
+    }
+
+    virtual bool has_any() {
+        return _solver->has_any();
+    }
+
     ConcreteSolver* get_solver() {
         return _solver.get();
     }
 
   private:
-    std::unique_ptr<ConcreteSolver> _solver;
+    std::shared_ptr<ConcreteSolver> _solver;
+
+};
+
+/*
+ * A solver generator for concrete solvers that can also generate their
+ * results for a statement lazily, through
+ *
+ *   ConditionCursorPtr cursor_right(StatementAst *statement);
+ *   ConditionCursorPtr cursor_left(StatementAst *statement);
+ *
+ * Cursors on other conditions build the whole result as usual.
+ */
+template <typename ConcreteSolver>
+class LazySolverGenerator : public SimpleSolverGenerator<ConcreteSolver> {
+  private:
+    class StatementFinder : public ConditionVisitor {
+      public:
+        StatementFinder() : _statement(NULL) { }
+
+        void visit_statement_condition(StatementCondition *condition) {
+            _statement = condition->get_statement_ast();
+        }
 
+        void visit_proc_condition(ProcCondition*) { }
+        void visit_variable_condition(VariableCondition*) { }
+        void visit_constant_condition(ConstantCondition*) { }
+        void visit_pattern_condition(PatternCondition*) { }
+
+        StatementAst* get_statement() {
+            return _statement;
+        }
+
+      private:
+        StatementAst *_statement;
+    };
+
+    typedef SimpleSolverGenerator<ConcreteSolver> Parent;
+
+  public:
+    LazySolverGenerator(ConcreteSolver *solver) : Parent(solver) { }
+
+    LazySolverGenerator(std::shared_ptr<ConcreteSolver> solver) : 
+        Parent(solver) 
+    { }
+
+    virtual ConditionCursorPtr cursor_right(SimpleCondition *left_condition) {
+        StatementFinder finder;
+        left_condition->accept_condition_visitor(&finder);
+
+        if(finder.get_statement() != NULL) {
+            return Parent::get_solver()->cursor_right(finder.get_statement());
+        } else {
+            return Parent::cursor_right(left_condition);
+        }
+    }
+
+    virtual ConditionCursorPtr cursor_left(SimpleCondition *right_condition) {
+        StatementFinder finder;
+        right_condition->accept_condition_visitor(&finder);
+
+        if(finder.get_statement() != NULL) {
+            return Parent::get_solver()->cursor_left(finder.get_statement());
+        } else {
+            return Parent::cursor_left(right_condition);
+        }
+    }
 };
     
 } // namespace impl
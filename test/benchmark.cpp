@@ -0,0 +1,125 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <sys/resource.h>
+#include "test/benchmark.h"
+#include "simple/util/json_utils.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple::util;
+
+Stopwatch::Stopwatch() : _start(std::chrono::steady_clock::now()) { }
+
+void Stopwatch::restart() {
+    _start = std::chrono::steady_clock::now();
+}
+
+double Stopwatch::elapsed_ms() const {
+    std::chrono::duration<double, std::milli> elapsed = 
+        std::chrono::steady_clock::now() - _start;
+    return elapsed.count();
+}
+
+LatencyStats::LatencyStats() : _samples(), _total(0) { }
+
+void LatencyStats::add_sample(double ms) {
+    _samples.push_back(ms);
+    _total += ms;
+}
+
+size_t LatencyStats::get_num_samples() const {
+    return _samples.size();
+}
+
+double LatencyStats::get_total() const {
+    return _total;
+}
+
+double LatencyStats::get_mean() const {
+    if(_samples.empty()) {
+        return 0;
+    }
+
+    return _total / _samples.size();
+}
+
+double LatencyStats::get_percentile(double p) const {
+    if(_samples.empty()) {
+        return 0;
+    }
+
+    std::vector<double> sorted(_samples);
+    std::sort(sorted.begin(), sorted.end());
+
+    size_t rank = (size_t) std::ceil(p / 100 * sorted.size());
+    if(rank > 0) {
+        --rank;
+    }
+
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+BenchmarkResult::BenchmarkResult(const std::string& phase, 
+        const std::string& name) :
+    phase(phase), name(name), items(0), failures(0), latency()
+{ }
+
+double BenchmarkResult::get_throughput() const {
+    double total = latency.get_total();
+    if(total <= 0) {
+        return 0;
+    }
+
+    return items * 1000 / total;
+}
+
+std::string BenchmarkResult::to_json() const {
+    std::stringstream out;
+
+    out << "{\"phase\": " << json_string(phase)
+        << ", \"name\": " << json_string(name)
+        << ", \"samples\": " << latency.get_num_samples()
+        << ", \"items\": " << items
+        << ", \"failures\": " << failures
+        << ", \"total_ms\": " << latency.get_total()
+        << ", \"throughput_per_sec\": " << get_throughput()
+        << ", \"mean_ms\": " << latency.get_mean()
+        << ", \"p50_ms\": " << latency.get_percentile(50)
+        << ", \"p90_ms\": " << latency.get_percentile(90)
+        << ", \"p99_ms\": " << latency.get_percentile(99) << "}";
+
+    return out.str();
+}
+
+long peak_rss_kb() {
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+
+    // ru_maxrss is in kilobytes on Linux
+    return usage.ru_maxrss;
+}
+
+} // namespace test
+} // namespace simple
@@ -0,0 +1,100 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace simple {
+namespace test {
+
+/*
+ * Wall clock stopwatch reporting milliseconds.
+ */
+class Stopwatch {
+  public:
+    Stopwatch();
+
+    void restart();
+
+    double elapsed_ms() const;
+
+  private:
+    std::chrono::steady_clock::time_point _start;
+};
+
+/*
+ * Latency samples of one benchmark, in milliseconds.
+ */
+class LatencyStats {
+  public:
+    LatencyStats();
+
+    void add_sample(double ms);
+
+    size_t get_num_samples() const;
+
+    double get_total() const;
+
+    double get_mean() const;
+
+    /*
+     * Nearest rank percentile, for p between 0 and 100. Returns zero if
+     * there are no samples.
+     */
+    double get_percentile(double p) const;
+
+  private:
+    std::vector<double> _samples;
+    double              _total;
+};
+
+/*
+ * Timings of one benchmarked operation, e.g. constructing the Follows*
+ * solver or evaluating the Parent queries in syn-lit form.
+ */
+struct BenchmarkResult {
+  public:
+    BenchmarkResult(const std::string& phase, const std::string& name);
+
+    // items processed per second over all samples
+    double get_throughput() const;
+
+    std::string to_json() const;
+
+    std::string phase;
+    std::string name;
+
+    // units of work over all samples: tokens, statements or queries
+    long items;
+
+    // samples that failed to complete, e.g. queries that timed out
+    long failures;
+
+    LatencyStats latency;
+};
+
+/*
+ * Peak resident set size of the process so far, in kilobytes.
+ */
+long peak_rss_kb();
+
+} // namespace test
+} // namespace simple
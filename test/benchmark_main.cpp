@@ -0,0 +1,462 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include "test/benchmark.h"
+#include "test/workload.h"
+#include "impl/knowledge_base.h"
+#include "impl/evaluator.h"
+#include "impl/predicate.h"
+#include "impl/parser/parser.h"
+#include "impl/parser/iterator_tokenizer.h"
+#include "impl/solvers/follows.h"
+#include "impl/solvers/ifollows.h"
+#include "impl/solvers/parent.h"
+#include "impl/solvers/iparent.h"
+#include "impl/solvers/modifies.h"
+#include "impl/solvers/uses.h"
+#include "impl/solvers/call.h"
+#include "impl/solvers/icall.h"
+#include "impl/solvers/next.h"
+#include "impl/solvers/inext.h"
+#include "simple/util/json_utils.h"
+
+using namespace simple;
+using namespace simple::impl;
+using namespace simple::parser;
+using namespace simple::test;
+using namespace simple::util;
+
+struct BenchmarkScale {
+    BenchmarkScale(int procs, int statements) : 
+        procs(procs), statements(statements) 
+    { }
+
+    std::string name() const {
+        std::stringstream out;
+        out << procs << "x" << statements;
+        return out.str();
+    }
+
+    int procs;
+    int statements;
+};
+
+struct BenchmarkOptions {
+    BenchmarkOptions() : 
+        seed(WorkloadParams().seed), iterations(5), num_queries(100),
+        timeout_ms(5000), num_threads(0), stats_file(), scales()
+    { }
+
+    unsigned int seed;
+    int iterations;
+    int num_queries;
+    long timeout_ms;
+    int num_threads;
+    std::string stats_file;
+    std::vector<BenchmarkScale> scales;
+};
+
+static void print_usage(const char *program) {
+    BenchmarkOptions defaults;
+
+    std::cerr << "usage: " << program << " [options]\n"
+        << "\n"
+        << "Time tokenizing, parsing, solver and predicate construction and\n"
+        << "PQL evaluation over synthetic workloads, and write the results\n"
+        << "as JSON to standard output.\n"
+        << "\n"
+        << "  --scale PxS      P procedures of S statements each, may be given\n"
+        << "                   more than once (5x50, 20x100 and 50x200)\n"
+        << "  --iterations N   samples per parsing and construction phase (" 
+            << defaults.iterations << ")\n"
+        << "  --queries N      queries per scale (" 
+            << defaults.num_queries << ")\n"
+        << "  --seed N         workload seed (" << defaults.seed << ")\n"
+        << "  --timeout MS     per query timeout (" 
+            << defaults.timeout_ms << ")\n"
+        << "  --threads N      worker threads for clause joins, 0 for none ("
+            << defaults.num_threads << ")\n"
+        << "  --stats FILE     dump the relation statistics catalog of every\n"
+        << "                   scale to FILE as JSON\n";
+}
+
+static bool parse_scale(const char *value, std::vector<BenchmarkScale>& scales) {
+    int procs = 0, statements = 0;
+    char separator = 0;
+
+    std::stringstream in(value);
+    in >> procs >> separator >> statements;
+
+    if(!in || separator != 'x' || procs <= 0 || statements <= 0) {
+        return false;
+    }
+
+    scales.push_back(BenchmarkScale(procs, statements));
+    return true;
+}
+
+static void bench_tokenize(const std::string& source, int iterations,
+        std::vector<BenchmarkResult>& results) 
+{
+    BenchmarkResult result("tokenize", "IteratorTokenizer");
+
+    for(int i = 0; i < iterations; ++i) {
+        std::string program = source;
+
+        Stopwatch watch;
+        IteratorTokenizer<std::string::iterator> tokenizer(
+                program.begin(), program.end());
+
+        long tokens = 0;
+        while(try_token<EOFToken>(tokenizer.next_token()) == NULL) {
+            ++tokens;
+        }
+
+        result.latency.add_sample(watch.elapsed_ms());
+        result.items += tokens;
+    }
+
+    results.push_back(result);
+}
+
+/*
+ * Parses through an expression store, the same way the knowledge base
+ * loads a program.
+ */
+static SimpleRoot bench_parse(const std::string& source, int iterations,
+        std::vector<BenchmarkResult>& results, LineTable& line_table,
+        std::shared_ptr<ExprStore>& expr_store)
+{
+    BenchmarkResult result("parse", "parse_program");
+    std::unique_ptr<SimpleRoot> ast;
+
+    for(int i = 0; i < iterations; ++i) {
+        std::string program = source;
+
+        Stopwatch watch;
+        expr_store.reset(new ExprStore());
+        SimpleParser parser(new IteratorTokenizer<std::string::iterator>(
+                    program.begin(), program.end()), expr_store);
+        ast.reset(new SimpleRoot(parser.parse_program()));
+        result.latency.add_sample(watch.elapsed_ms());
+
+        line_table = parser.get_line_table();
+        result.items += line_table.size();
+    }
+
+    results.push_back(result);
+    return *ast;
+}
+
+/*
+ * Items of the construction phases are the statements indexed, so that
+ * the throughput of different scales can be compared directly.
+ */
+template <typename Solver>
+void bench_solver(const std::string& name, SimpleRoot ast, long statements,
+        int iterations, std::vector<BenchmarkResult>& results) 
+{
+    BenchmarkResult result("solver", name);
+
+    for(int i = 0; i < iterations; ++i) {
+        Stopwatch watch;
+        std::unique_ptr<Solver> solver(new Solver(ast));
+        result.latency.add_sample(watch.elapsed_ms());
+        result.items += statements;
+    }
+
+    results.push_back(result);
+}
+
+static void bench_inext_solver(SimpleRoot ast, long statements,
+        int iterations, std::vector<BenchmarkResult>& results) 
+{
+    BenchmarkResult result("solver", "Next*");
+
+    for(int i = 0; i < iterations; ++i) {
+        Stopwatch watch;
+        std::shared_ptr<NextSolver> next_solver(new NextSolver(ast));
+        std::unique_ptr<INextSolver> solver(new INextSolver(ast, next_solver));
+        result.latency.add_sample(watch.elapsed_ms());
+        result.items += statements;
+    }
+
+    results.push_back(result);
+}
+
+template <typename Predicate>
+void bench_predicate(const std::string& name, SimpleRoot ast, 
+        long statements, int iterations, 
+        std::vector<BenchmarkResult>& results) 
+{
+    BenchmarkResult result("predicate", name);
+
+    for(int i = 0; i < iterations; ++i) {
+        Stopwatch watch;
+        std::unique_ptr<Predicate> pred(new Predicate(ast));
+        result.latency.add_sample(watch.elapsed_ms());
+        result.items += statements;
+    }
+
+    results.push_back(result);
+}
+
+static void bench_construction(SimpleRoot ast, long statements, 
+        int iterations, std::vector<BenchmarkResult>& results) 
+{
+    bench_solver<FollowSolver>("Follows", ast, statements, iterations, results);
+    bench_solver<IFollowSolver>("Follows*", ast, statements, iterations, results);
+    bench_solver<ParentSolver>("Parent", ast, statements, iterations, results);
+    bench_solver<IParentSolver>("Parent*", ast, statements, iterations, results);
+    bench_solver<ModifiesSolver>("Modifies", ast, statements, iterations, results);
+    bench_solver<UsesSolver>("Uses", ast, statements, iterations, results);
+    bench_solver<CallSolver>("Calls", ast, statements, iterations, results);
+    bench_solver<ICallSolver>("Calls*", ast, statements, iterations, results);
+    bench_solver<NextSolver>("Next", ast, statements, iterations, results);
+    bench_inext_solver(ast, statements, iterations, results);
+
+    bench_predicate<SimpleProcPredicate>("procedure", 
+            ast, statements, iterations, results);
+    bench_predicate<SimpleStatementPredicate>("stmt", 
+            ast, statements, iterations, results);
+    bench_predicate<SimpleAssignmentPredicate>("assign", 
+            ast, statements, iterations, results);
+    bench_predicate<SimpleWhilePredicate>("while", 
+            ast, statements, iterations, results);
+    bench_predicate<SimpleConditionalPredicate>("if", 
+            ast, statements, iterations, results);
+    bench_predicate<SimpleCallPredicate>("call", 
+            ast, statements, iterations, results);
+    bench_predicate<SimpleVariablePredicate>("variable", 
+            ast, statements, iterations, results);
+}
+
+/*
+ * Every query is parsed and evaluated once. Parsing is reported as a
+ * whole, evaluation is grouped by relation and clause form.
+ */
+static void bench_queries(SimpleKnowledgeBase& kb, 
+        const std::vector<WorkloadQuery>& queries, 
+        const BenchmarkOptions& options, ThreadPoolPtr pool,
+        std::vector<BenchmarkResult>& results) 
+{
+    QueryEvaluator evaluator(kb.get_wildcard_predicate(), pool);
+
+    BenchmarkResult parse_result("pql", "parse_query");
+    std::vector<BenchmarkResult> query_results;
+    std::map<std::string, size_t> groups;
+
+    for(std::vector<WorkloadQuery>::const_iterator it = queries.begin();
+            it != queries.end(); ++it)
+    {
+        std::string name = it->relation + "/" + it->form;
+        if(groups.find(name) == groups.end()) {
+            groups[name] = query_results.size();
+            query_results.push_back(BenchmarkResult("query", name));
+        }
+        BenchmarkResult& result = query_results[groups[name]];
+
+        Stopwatch watch;
+        PqlQuerySet query = kb.parse_query(it->text);
+        parse_result.latency.add_sample(watch.elapsed_ms());
+        parse_result.items += 1;
+
+        watch.restart();
+        QueryResult query_result = evaluator.evaluate(query, options.timeout_ms);
+        result.latency.add_sample(watch.elapsed_ms());
+        result.items += 1;
+
+        if(query_result.status != QUERY_OK) {
+            result.failures += 1;
+        }
+    }
+
+    results.push_back(parse_result);
+    results.insert(results.end(), query_results.begin(), query_results.end());
+}
+
+/*
+ * The statistics catalog of the scale is written to stats_out, if given.
+ */
+static std::string run_scale(const BenchmarkScale& scale, 
+        const BenchmarkOptions& options, ThreadPoolPtr pool,
+        std::ostream *stats_out) 
+{
+    WorkloadParams params;
+    params.seed = options.seed;
+    params.num_procs = scale.procs;
+    params.statements_per_proc = scale.statements;
+    params.num_queries = options.num_queries;
+
+    WorkloadGenerator generator(params);
+    std::string source = generator.generate_program();
+    std::vector<WorkloadQuery> queries = generator.generate_query_mix();
+
+    std::vector<BenchmarkResult> results;
+    LineTable line_table;
+
+    std::cerr << "scale " << scale.name() << ": " 
+        << generator.get_num_statements() << " statements\n";
+
+    bench_tokenize(source, options.iterations, results);
+    std::shared_ptr<ExprStore> expr_store;
+    SimpleRoot ast = bench_parse(source, options.iterations, 
+            results, line_table, expr_store);
+    bench_construction(ast, line_table.size(), options.iterations, results);
+
+    BenchmarkResult load_result("load", "knowledge_base");
+    Stopwatch watch;
+    SimpleKnowledgeBase kb(ast, line_table, expr_store);
+    load_result.latency.add_sample(watch.elapsed_ms());
+    load_result.items += line_table.size();
+    results.push_back(load_result);
+
+    if(stats_out != NULL) {
+        *stats_out << "\n  {\"scale\": " << json_string(scale.name())
+            << ", \"statistics\": " << kb.get_statistics().to_json() << "}";
+    }
+
+    bench_queries(kb, queries, options, pool, results);
+
+    // solve calls answered from the memos of all relations
+    MemoStats memo;
+    const SolverTable& solvers = kb.get_solver_table();
+    for(SolverTable::const_iterator it = solvers.begin(); 
+            it != solvers.end(); ++it)
+    {
+        MemoStats stats = kb.get_memoized_solver(it->first)->get_stats();
+        memo.hits += stats.hits;
+        memo.misses += stats.misses;
+    }
+
+    // the peak is that of the whole process so far, so it includes the
+    // scales run before this one
+    std::stringstream out;
+    out << "{\"scale\": " << json_string(scale.name())
+        << ", \"procs\": " << scale.procs
+        << ", \"statements\": " << generator.get_num_statements()
+        << ", \"queries\": " << queries.size()
+        << ", \"expr_nodes\": " << expr_store->get_size()
+        << ", \"process_peak_rss_kb\": " << peak_rss_kb()
+        << ", \"memo_hit_rate\": " << memo.hit_rate()
+        << ", \"results\": [";
+
+    for(std::vector<BenchmarkResult>::iterator it = results.begin();
+            it != results.end(); ++it)
+    {
+        if(it != results.begin()) {
+            out << ", ";
+        }
+        out << "\n    " << it->to_json();
+    }
+
+    out << "]}";
+    return out.str();
+}
+
+int main(int argc, char **argv) {
+    BenchmarkOptions options;
+
+    for(int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+
+        if(i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+
+        if(strcmp(arg, "--scale") == 0) {
+            if(!parse_scale(value, options.scales)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if(strcmp(arg, "--iterations") == 0) {
+            options.iterations = atoi(value);
+        } else if(strcmp(arg, "--queries") == 0) {
+            options.num_queries = atoi(value);
+        } else if(strcmp(arg, "--seed") == 0) {
+            options.seed = strtoul(value, NULL, 10);
+        } else if(strcmp(arg, "--timeout") == 0) {
+            options.timeout_ms = atol(value);
+        } else if(strcmp(arg, "--threads") == 0) {
+            options.num_threads = atoi(value);
+        } else if(strcmp(arg, "--stats") == 0) {
+            options.stats_file = value;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(options.scales.empty()) {
+        options.scales.push_back(BenchmarkScale(5, 50));
+        options.scales.push_back(BenchmarkScale(20, 100));
+        options.scales.push_back(BenchmarkScale(50, 200));
+    }
+
+    if(options.iterations <= 0) {
+        options.iterations = 1;
+    }
+
+    ThreadPoolPtr pool;
+    if(options.num_threads > 0) {
+        pool.reset(new WorkStealingPool(options.num_threads));
+    }
+
+    std::unique_ptr<std::ofstream> stats_out;
+    if(!options.stats_file.empty()) {
+        stats_out.reset(new std::ofstream(options.stats_file.c_str()));
+        *stats_out << "[";
+    }
+
+    std::cout << "{\"seed\": " << options.seed
+        << ", \"iterations\": " << options.iterations
+        << ", \"threads\": " << options.num_threads
+        << ", \"scales\": [";
+
+    for(std::vector<BenchmarkScale>::iterator it = options.scales.begin();
+            it != options.scales.end(); ++it)
+    {
+        if(it != options.scales.begin()) {
+            std::cout << ",";
+            if(stats_out) {
+                *stats_out << ",";
+            }
+        }
+        std::cout << "\n  " << run_scale(*it, options, pool, stats_out.get());
+    }
+
+    if(stats_out) {
+        *stats_out << "\n]\n";
+        if(!*stats_out) {
+            std::cerr << "failed to write " << options.stats_file << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << "],\n \"peak_rss_kb\": " << peak_rss_kb() << "}\n";
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/condition.h"
+#include "impl/evaluator.h"
+#include "impl/knowledge_base.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+/*
+ * Fixture for the tests that query a knowledge base built from a small
+ * SIMPLE program. Fixtures that need more of the evaluator, e.g. a
+ * result cache, set it up in configure().
+ */
+class KnowledgeBaseTest : public testing::Test {
+  protected:
+    explicit KnowledgeBaseTest(const char *program) :
+        _program(program)
+    { }
+
+    virtual void SetUp() {
+        kb = create_knowledge_base(_program);
+        line_table = kb->get_line_table();
+    }
+
+    virtual void configure(QueryEvaluator& evaluator) { }
+
+    ConditionSet statements(const std::vector<int>& lines) {
+        ConditionSet result;
+        for(size_t i = 0; i < lines.size(); ++i) {
+            result.insert(new SimpleStatementCondition(line_table[lines[i]]));
+        }
+        return result;
+    }
+
+    QuerySolver* get_solver(const std::string& name) {
+        return kb->get_solver_table().at(name).get();
+    }
+
+    QueryResult evaluate(PqlQuerySet& query) {
+        QueryEvaluator evaluator(kb->get_wildcard_predicate());
+        configure(evaluator);
+        return evaluator.evaluate(query);
+    }
+
+    QueryResult evaluate(const std::string& query) {
+        PqlQuerySet query_set = kb->parse_query(query);
+        return evaluate(query_set);
+    }
+
+    std::shared_ptr<SimpleKnowledgeBase> kb;
+    LineTable line_table;
+
+  private:
+    const char *_program;
+};
+
+} // namespace test
+} // namespace simple
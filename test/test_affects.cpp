@@ -0,0 +1,197 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/bit_vector.h"
+#include "impl/condition.h"
+#include "impl/evaluator.h"
+#include "impl/knowledge_base.h"
+#include "impl/solvers/affects.h"
+#include "impl/solvers/iaffects.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+static const char *AFFECTS_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    y = x + 2;\n"
+    "    while y {\n"
+    "        z = x + y;\n"
+    "        x = z;\n"
+    "        call sub; }\n"
+    "    if x {\n"
+    "        y = z; } else {\n"
+    "        w = x; }\n"
+    "    v = y + w; }\n"
+    "proc sub {\n"
+    "    z = 3;\n"
+    "    v = z; }\n";
+
+static ConditionSet statements(SimpleKnowledgeBase& kb, 
+        const std::vector<int>& lines) 
+{
+    LineTable line_table = kb.get_line_table();
+
+    ConditionSet result;
+    for(size_t i = 0; i < lines.size(); ++i) {
+        result.insert(new SimpleStatementCondition(line_table[lines[i]]));
+    }
+    return result;
+}
+
+static ConditionSet solve_query(SimpleKnowledgeBase& kb, 
+        const std::string& query)
+{
+    QueryEvaluator evaluator(kb.get_wildcard_predicate());
+    PqlQuerySet query_set = kb.parse_query(query);
+    return evaluator.evaluate(query_set).conditions;
+}
+
+static bool solve_boolean(SimpleKnowledgeBase& kb, const std::string& query) {
+    QueryEvaluator evaluator(kb.get_wildcard_predicate());
+    PqlQuerySet query_set = kb.parse_query(query);
+    return evaluator.evaluate(query_set).is_true;
+}
+
+TEST(BitVectorTest, BasicTest) {
+    BitVector bits1(70);
+    BitVector bits2(70);
+
+    EXPECT_TRUE(bits1.is_empty());
+
+    bits1.set(3);
+    bits1.set(64);
+    bits2.set(64);
+    bits2.set(69);
+
+    EXPECT_TRUE(bits1.test(64));
+    EXPECT_FALSE(bits1.test(69));
+    EXPECT_EQ(bits1.count(), (size_t) 2);
+
+    BitVector both = bits1;
+    both.intersect_with(bits2);
+    EXPECT_EQ(both.get_indexes(), std::vector<size_t>({ 64 }));
+
+    EXPECT_TRUE(bits1.union_with(bits2));
+    EXPECT_FALSE(bits1.union_with(bits2));
+    EXPECT_EQ(bits1.get_indexes(), std::vector<size_t>({ 3, 64, 69 }));
+
+    bits1.subtract(bits2);
+    bits1.reset(3);
+    EXPECT_TRUE(bits1.is_empty());
+    EXPECT_NE(bits1, bits2);
+}
+
+TEST(AffectsTest, SolverTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(AFFECTS_PROGRAM);
+    SimpleRoot ast = kb->get_ast();
+    LineTable line_table = kb->get_line_table();
+
+    AffectsSolver solver(ast, 
+            std::shared_ptr<NextQuerySolver>(new NextSolver(ast)),
+            std::shared_ptr<ModifiesSolver>(new ModifiesSolver(ast)));
+
+    EXPECT_EQ(solver.solve_right<StatementAst>(line_table[1]),
+            statements(*kb, std::vector<int>({ 2, 4, 9 })));
+    EXPECT_EQ(solver.solve_right<StatementAst>(line_table[5]),
+            statements(*kb, std::vector<int>({ 4, 9 })));
+
+    // the call to sub modifies z, so z = x + y does not reach y = z
+    EXPECT_EQ(solver.solve_right<StatementAst>(line_table[4]),
+            statements(*kb, std::vector<int>({ 5 })));
+    EXPECT_TRUE(solver.solve_left<StatementAst>(line_table[8]).is_empty());
+
+    EXPECT_EQ(solver.solve_left<StatementAst>(line_table[10]),
+            statements(*kb, std::vector<int>({ 2, 8, 9 })));
+    EXPECT_EQ(solver.solve_left<StatementAst>(line_table[12]),
+            statements(*kb, std::vector<int>({ 11 })));
+
+    EXPECT_TRUE(solver.validate<StatementAst>(line_table[2], line_table[4]));
+    EXPECT_FALSE(solver.validate<StatementAst>(line_table[4], line_table[4]));
+    EXPECT_FALSE(solver.validate<StatementAst>(line_table[3], line_table[4]));
+    EXPECT_FALSE(solver.validate<StatementAst>(line_table[9], line_table[12]));
+
+    // statements that are not assignments are not affected by anything
+    EXPECT_TRUE(solver.solve_right<StatementAst>(line_table[6]).is_empty());
+    EXPECT_TRUE(solver.solve_left<StatementAst>(line_table[7]).is_empty());
+}
+
+TEST(AffectsTest, ClosureTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(AFFECTS_PROGRAM);
+    SimpleRoot ast = kb->get_ast();
+    LineTable line_table = kb->get_line_table();
+
+    std::shared_ptr<AffectsSolver> affects_solver(new AffectsSolver(ast, 
+            std::shared_ptr<NextQuerySolver>(new NextSolver(ast)),
+            std::shared_ptr<ModifiesSolver>(new ModifiesSolver(ast))));
+    IAffectsSolver solver(ast, affects_solver);
+
+    EXPECT_EQ(solver.solve_right<StatementAst>(line_table[1]),
+            statements(*kb, std::vector<int>({ 2, 4, 5, 9, 10 })));
+    EXPECT_EQ(solver.solve_right<StatementAst>(line_table[4]),
+            statements(*kb, std::vector<int>({ 4, 5, 9, 10 })));
+    EXPECT_EQ(solver.solve_left<StatementAst>(line_table[10]),
+            statements(*kb, std::vector<int>({ 1, 2, 4, 5, 8, 9 })));
+
+    EXPECT_TRUE(solver.validate<StatementAst>(line_table[4], line_table[4]));
+    EXPECT_TRUE(solver.validate<StatementAst>(line_table[1], line_table[10]));
+    EXPECT_FALSE(solver.validate<StatementAst>(line_table[1], line_table[1]));
+    EXPECT_FALSE(solver.validate<StatementAst>(line_table[10], line_table[2]));
+    EXPECT_FALSE(solver.validate<StatementAst>(line_table[11], line_table[10]));
+}
+
+TEST(AffectsTest, QueryTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(AFFECTS_PROGRAM);
+
+    EXPECT_EQ(solve_query(*kb, "assign a; Select a such that Affects(1, a)"),
+            statements(*kb, std::vector<int>({ 2, 4, 9 })));
+    EXPECT_EQ(solve_query(*kb, "assign a; Select a such that Affects(a, 10)"),
+            statements(*kb, std::vector<int>({ 2, 8, 9 })));
+    EXPECT_EQ(solve_query(*kb, "assign a; Select a such that Affects*(1, a)"),
+            statements(*kb, std::vector<int>({ 2, 4, 5, 9, 10 })));
+    EXPECT_EQ(solve_query(*kb, "assign a; Select a such that Affects*(a, a)"),
+            statements(*kb, std::vector<int>({ 4, 5 })));
+    EXPECT_EQ(solve_query(*kb, 
+                "assign a1, a2; Select a1 such that Affects(a1, a2) "
+                "and Affects(a2, 9)"),
+            statements(*kb, std::vector<int>({ 4 })));
+
+    EXPECT_FALSE(solve_boolean(*kb, "Select BOOLEAN such that Affects(4, 8)"));
+    EXPECT_TRUE(solve_boolean(*kb, "Select BOOLEAN such that Affects*(2, 10)"));
+
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+    PqlQuerySet pairs = kb->parse_query(
+            "assign a1, a2; Select <a1, a2> such that Affects(a1, a2)");
+    EXPECT_EQ(evaluator.evaluate(pairs).tuple_count, (size_t) 11);
+
+    PqlQuerySet closure_pairs = kb->parse_query(
+            "assign a1, a2; Select <a1, a2> such that Affects*(a1, a2)");
+    EXPECT_EQ(evaluator.evaluate(closure_pairs).tuple_count, (size_t) 20);
+}
+
+}
+}
@@ -0,0 +1,234 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/batch_planner.h"
+#include "kb_fixture.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+static const char *BATCH_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    while x {\n"
+    "        y = x + 2;\n"
+    "        while y {\n"
+    "            x = y;\n"
+    "            z = x; } }\n"
+    "    x = z; }\n";
+
+class BatchPlannerTest : public KnowledgeBaseTest {
+  protected:
+    BatchPlannerTest() : KnowledgeBaseTest(BATCH_PROGRAM) { }
+
+    void SetUp() {
+        KnowledgeBaseTest::SetUp();
+        planner.reset(new BatchPlanner(kb->get_wildcard_predicate(),
+                    kb->get_solver_table(), kb->get_predicate_table(),
+                    kb->get_statistics()));
+    }
+
+    void configure(QueryEvaluator& evaluator) {
+        evaluator.set_batch_planner(batch_planner);
+    }
+
+    std::vector<QueryResult> evaluate(std::vector<PqlQuerySet>& queries,
+            std::shared_ptr<BatchPlanner> planner)
+    {
+        batch_planner = planner;
+
+        std::vector<QueryResult> results;
+        for(size_t i = 0; i < queries.size(); ++i) {
+            results.push_back(KnowledgeBaseTest::evaluate(queries[i]));
+        }
+        return results;
+    }
+
+    std::shared_ptr<BatchPlanner> planner;
+
+    // the planner given to the evaluator, if any
+    std::shared_ptr<BatchPlanner> batch_planner;
+};
+
+TEST_F(BatchPlannerTest, PlanTest) {
+    std::vector<PqlQuerySet> queries;
+    queries.push_back(kb->parse_query(
+            "while w; assign a; Select a such that Parent*(w, a) "
+            "and Modifies(a, \"x\")"));
+    queries.push_back(kb->parse_query(
+            "while w2; assign a2; Select w2 such that Parent*(w2, a2) "
+            "and Modifies(a2, \"x\")"));
+    queries.push_back(kb->parse_query(
+            "while w; assign a; variable v; Select v such that "
+            "Parent*(w, a) and Uses(a, v)"));
+    queries.push_back(kb->parse_query(
+            "stmt s; assign a; Select s such that Parent*(s, a) "
+            "and Modifies(a, \"z\")"));
+
+    std::vector<PqlQuerySet*> batch;
+    for(size_t i = 0; i < queries.size(); ++i) {
+        batch.push_back(&queries[i]);
+    }
+    planner->plan(batch);
+
+    BatchStats stats = planner->get_stats();
+    EXPECT_EQ(4u, stats.queries);
+    EXPECT_EQ(2u, stats.shared_clauses);
+
+    PqlQuerySet& last = queries[3];
+    for(ClauseSet::iterator it = last.clauses.begin(); 
+            it != last.clauses.end(); ++it)
+    {
+        // Parent*(stmt, assign) and Modifies(assign, "z") are only here
+        EXPECT_FALSE(planner->is_shared(last, it->get()));
+    }
+
+    std::vector<QueryResult> expected = evaluate(queries, 
+            std::shared_ptr<BatchPlanner>());
+    std::vector<QueryResult> results = evaluate(queries, planner);
+
+    ASSERT_EQ(expected.size(), results.size());
+    for(size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(expected[i].conditions, results[i].conditions);
+    }
+    EXPECT_FALSE(results[0].conditions.is_empty());
+
+    stats = planner->get_stats();
+    EXPECT_EQ(2u, stats.computed);
+    EXPECT_EQ(5u, stats.reuses);
+}
+
+TEST_F(BatchPlannerTest, ProfileTest) {
+    std::vector<PqlQuerySet> queries;
+    queries.push_back(kb->parse_query(
+            "while w; assign a; Select a such that Parent*(w, a) "
+            "and Modifies(a, \"x\")"));
+    queries.push_back(kb->parse_query(
+            "while w2; assign a2; Select w2 such that Parent*(w2, a2) "
+            "and Modifies(a2, \"x\")"));
+
+    std::vector<PqlQuerySet*> batch;
+    for(size_t i = 0; i < queries.size(); ++i) {
+        batch.push_back(&queries[i]);
+    }
+    planner->plan(batch);
+    ASSERT_EQ((size_t) 2, planner->get_stats().shared_clauses);
+
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+    evaluator.set_batch_planner(planner);
+    evaluator.set_profiling(true);
+
+    // the shared clauses are profiled like any other
+    std::string profile = evaluator.evaluate(queries[0]).profile;
+    size_t first = profile.find("\"batched\": true");
+    ASSERT_NE(std::string::npos, first);
+    EXPECT_NE(std::string::npos, profile.find("\"batched\": true", first + 1));
+    EXPECT_NE(std::string::npos, profile.find("\"qvar\": \"a\""));
+}
+
+TEST_F(BatchPlannerTest, ReplanTest) {
+    std::vector<PqlQuerySet> queries;
+    queries.push_back(kb->parse_query(
+            "while w; assign a; Select a such that Parent*(w, a)"));
+    queries.push_back(kb->parse_query(
+            "while w2; assign a2; Select w2 such that Parent*(w2, a2)"));
+    queries.push_back(kb->parse_query(
+            "assign a; Select a such that Modifies(a, \"x\")"));
+    queries.push_back(kb->parse_query(
+            "assign a2; Select a2 such that Modifies(a2, \"x\")"));
+
+    std::vector<PqlQuerySet*> batch;
+    batch.push_back(&queries[0]);
+    batch.push_back(&queries[1]);
+    planner->plan(batch);
+    EXPECT_EQ(1u, planner->get_stats().shared_clauses);
+
+    // the second batch shares its own clause only
+    batch.clear();
+    batch.push_back(&queries[2]);
+    batch.push_back(&queries[3]);
+    planner->plan(batch);
+
+    BatchStats stats = planner->get_stats();
+    EXPECT_EQ(2u, stats.queries);
+    EXPECT_EQ(1u, stats.shared_clauses);
+    EXPECT_FALSE(planner->is_shared(queries[0], 
+                queries[0].clauses.begin()->get()));
+    EXPECT_TRUE(planner->is_shared(queries[2], 
+                queries[2].clauses.begin()->get()));
+}
+
+TEST_F(BatchPlannerTest, SameSynonymTest) {
+    std::vector<PqlQuerySet> queries;
+    queries.push_back(kb->parse_query(
+            "stmt s; Select s such that Next*(s, s)"));
+    queries.push_back(kb->parse_query(
+            "stmt s1, s2; Select s1 such that Next*(s1, s2)"));
+    queries.push_back(kb->parse_query(
+            "stmt s; Select s such that Next*(s, s)"));
+
+    std::vector<PqlQuerySet*> batch;
+    for(size_t i = 0; i < queries.size(); ++i) {
+        batch.push_back(&queries[i]);
+    }
+    planner->plan(batch);
+    EXPECT_EQ(0u, planner->get_stats().shared_clauses);
+}
+
+TEST_F(BatchPlannerTest, CostTest) {
+    std::vector<PqlQuerySet> queries;
+    queries.push_back(kb->parse_query(
+            "stmt s1, s2; Select s1 such that Next*(s1, s2)"));
+    queries.push_back(kb->parse_query(
+            "stmt s1, s2; Select s2 such that Next*(s1, s2)"));
+
+    std::vector<PqlQuerySet*> batch;
+    for(size_t i = 0; i < queries.size(); ++i) {
+        batch.push_back(&queries[i]);
+    }
+
+    // 7 * 7 pairs cost more than 7 + 7 solves in each of two queries
+    planner->plan(batch);
+    EXPECT_EQ(0u, planner->get_stats().shared_clauses);
+    EXPECT_FALSE(planner->is_shared(queries[0], 
+                queries[0].clauses.begin()->get()));
+
+    // but not in each of four
+    batch.push_back(&queries[0]);
+    batch.push_back(&queries[1]);
+    planner->plan(batch);
+    EXPECT_EQ(4u, planner->get_stats().queries);
+    EXPECT_EQ(1u, planner->get_stats().shared_clauses);
+
+    std::vector<QueryResult> expected = evaluate(queries, 
+            std::shared_ptr<BatchPlanner>());
+    std::vector<QueryResult> results = evaluate(queries, planner);
+    for(size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(expected[i].conditions, results[i].conditions);
+    }
+    EXPECT_EQ(1u, planner->get_stats().computed);
+}
+
+} // namespace test
+} // namespace simple
@@ -0,0 +1,76 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include "gtest/gtest.h"
+#include "test/benchmark.h"
+
+namespace simple {
+namespace test {
+
+TEST(BenchmarkTest, LatencyTest) {
+    LatencyStats stats;
+
+    EXPECT_EQ(stats.get_num_samples(), (size_t) 0);
+    EXPECT_EQ(stats.get_mean(), 0);
+    EXPECT_EQ(stats.get_percentile(50), 0);
+
+    // added out of order on purpose
+    for(int i = 100; i >= 1; --i) {
+        stats.add_sample(i);
+    }
+
+    EXPECT_EQ(stats.get_num_samples(), (size_t) 100);
+    EXPECT_EQ(stats.get_total(), 5050);
+    EXPECT_EQ(stats.get_mean(), 50.5);
+
+    EXPECT_EQ(stats.get_percentile(0), 1);
+    EXPECT_EQ(stats.get_percentile(50), 50);
+    EXPECT_EQ(stats.get_percentile(90), 90);
+    EXPECT_EQ(stats.get_percentile(99), 99);
+    EXPECT_EQ(stats.get_percentile(100), 100);
+
+    LatencyStats single;
+    single.add_sample(7);
+    EXPECT_EQ(single.get_percentile(1), 7);
+    EXPECT_EQ(single.get_percentile(99), 7);
+}
+
+TEST(BenchmarkTest, ResultTest) {
+    BenchmarkResult result("parse", "parse_program");
+    EXPECT_EQ(result.get_throughput(), 0);
+
+    result.latency.add_sample(200);
+    result.latency.add_sample(300);
+    result.items = 1000;
+
+    // 1000 items in half a second
+    EXPECT_EQ(result.get_throughput(), 2000);
+
+    std::string json = result.to_json();
+    EXPECT_EQ(json.find("{\"phase\": \"parse\", \"name\": \"parse_program\""), 
+            (size_t) 0);
+    EXPECT_NE(json.find("\"samples\": 2"), std::string::npos);
+    EXPECT_NE(json.find("\"p50_ms\": 200"), std::string::npos);
+    EXPECT_NE(json.find("\"p99_ms\": 300"), std::string::npos);
+
+    EXPECT_GT(peak_rss_kb(), 0);
+}
+
+}
+}
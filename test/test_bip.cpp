@@ -0,0 +1,180 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/bip_graph.h"
+#include "impl/solvers/next_bip.h"
+#include "impl/solvers/inext_bip.h"
+#include "impl/solvers/affects_bip.h"
+#include "impl/solvers/iaffects.h"
+#include "kb_fixture.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+static const char *BIP_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    call p;\n"
+    "    y = x;\n"
+    "    call q; }\n"
+    "proc p {\n"
+    "    x = x + 1;\n"
+    "    while x {\n"
+    "        call q; } }\n"
+    "proc q {\n"
+    "    z = x;\n"
+    "    x = 2; }\n";
+
+class BipTest : public KnowledgeBaseTest {
+  protected:
+    BipTest() : KnowledgeBaseTest(BIP_PROGRAM) { }
+
+    void SetUp() {
+        KnowledgeBaseTest::SetUp();
+        graph.reset(new BipGraph(kb->get_ast(), 
+                    std::shared_ptr<NextQuerySolver>(
+                        new NextSolver(kb->get_ast()))));
+    }
+
+    std::shared_ptr<BipGraph> graph;
+};
+
+TEST_F(BipTest, GraphTest) {
+    const std::vector<BipProc>& procs = graph->get_procs();
+    ASSERT_EQ(procs.size(), (size_t) 3);
+
+    // callees come before their callers
+    EXPECT_EQ(procs[0].proc->get_name(), "q");
+    EXPECT_EQ(procs[1].proc->get_name(), "p");
+    EXPECT_EQ(procs[2].proc->get_name(), "main");
+
+    size_t node;
+    ASSERT_TRUE(graph->find_node(line_table[6], node));
+
+    // the while is the last statement of p, so it may leave p
+    const BipNode& loop = graph->get_node(node);
+    EXPECT_EQ(loop.flow_next.size(), (size_t) 2);
+    EXPECT_EQ(graph->get_node(procs[1].exit).return_next.size(), (size_t) 1);
+    EXPECT_EQ(graph->get_node(procs[0].entry).call_prev.size(), (size_t) 2);
+}
+
+TEST_F(BipTest, NextBipTest) {
+    NextBipSolver solver(kb->get_ast(), graph);
+
+    EXPECT_EQ(solver.solve_right<StatementAst>(line_table[2]),
+            statements(std::vector<int>({ 5 })));
+    EXPECT_EQ(solver.solve_right<StatementAst>(line_table[6]),
+            statements(std::vector<int>({ 3, 7 })));
+    EXPECT_EQ(solver.solve_right<StatementAst>(line_table[9]),
+            statements(std::vector<int>({ 6 })));
+    EXPECT_EQ(solver.solve_right<StatementAst>(line_table[4]),
+            statements(std::vector<int>({ 8 })));
+
+    EXPECT_EQ(solver.solve_left<StatementAst>(line_table[6]),
+            statements(std::vector<int>({ 5, 9 })));
+    EXPECT_EQ(solver.solve_left<StatementAst>(line_table[8]),
+            statements(std::vector<int>({ 4, 7 })));
+    EXPECT_EQ(solver.solve_left<StatementAst>(line_table[3]),
+            statements(std::vector<int>({ 6 })));
+    EXPECT_TRUE(solver.solve_left<StatementAst>(line_table[1]).is_empty());
+
+    EXPECT_TRUE(solver.validate<StatementAst>(line_table[7], line_table[8]));
+    EXPECT_FALSE(solver.validate<StatementAst>(line_table[7], line_table[6]));
+    EXPECT_FALSE(solver.validate<StatementAst>(line_table[2], line_table[3]));
+}
+
+TEST_F(BipTest, INextBipTest) {
+    INextBipSolver solver(kb->get_ast(), graph);
+
+    EXPECT_EQ(solver.solve_right<StatementAst>(line_table[1]),
+            statements(std::vector<int>({ 2, 3, 4, 5, 6, 7, 8, 9 })));
+    EXPECT_EQ(solver.solve_right<StatementAst>(line_table[9]),
+            statements(std::vector<int>({ 3, 4, 6, 7, 8, 9 })));
+
+    // q called from main returns to main only
+    EXPECT_EQ(solver.solve_right<StatementAst>(line_table[3]),
+            statements(std::vector<int>({ 4, 8, 9 })));
+
+    EXPECT_EQ(solver.solve_left<StatementAst>(line_table[5]),
+            statements(std::vector<int>({ 1, 2 })));
+
+    EXPECT_TRUE(solver.validate<StatementAst>(line_table[7], line_table[7]));
+    EXPECT_FALSE(solver.validate<StatementAst>(line_table[1], line_table[1]));
+    EXPECT_FALSE(solver.validate<StatementAst>(line_table[3], line_table[6]));
+}
+
+TEST_F(BipTest, AffectsBipTest) {
+    std::shared_ptr<AffectsBipSolver> solver(
+            new AffectsBipSolver(kb->get_ast(), graph));
+
+    EXPECT_EQ(solver->solve_right<StatementAst>(line_table[1]),
+            statements(std::vector<int>({ 5 })));
+    EXPECT_EQ(solver->solve_left<StatementAst>(line_table[3]),
+            statements(std::vector<int>({ 5, 9 })));
+    EXPECT_EQ(solver->solve_left<StatementAst>(line_table[8]),
+            statements(std::vector<int>({ 5, 9 })));
+    EXPECT_TRUE(solver->solve_right<StatementAst>(line_table[8]).is_empty());
+
+    // p modifies x on every path
+    EXPECT_FALSE(solver->validate<StatementAst>(line_table[1], line_table[3]));
+    EXPECT_TRUE(solver->validate<StatementAst>(line_table[9], line_table[8]));
+
+    IAffectsSolver closure(kb->get_ast(), solver);
+    EXPECT_EQ(closure.solve_right<StatementAst>(line_table[1]),
+            statements(std::vector<int>({ 3, 5, 8 })));
+    EXPECT_EQ(closure.solve_left<StatementAst>(line_table[3]),
+            statements(std::vector<int>({ 1, 5, 9 })));
+    EXPECT_FALSE(closure.validate<StatementAst>(line_table[9], line_table[5]));
+}
+
+TEST_F(BipTest, QueryTest) {
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+
+    PqlQuerySet query1 = kb->parse_query(
+            "assign a; Select a such that AffectsBip(a, 3)");
+    EXPECT_EQ(evaluator.evaluate(query1).conditions,
+            statements(std::vector<int>({ 5, 9 })));
+
+    PqlQuerySet query2 = kb->parse_query(
+            "stmt s; Select s such that NextBip*(3, s)");
+    EXPECT_EQ(evaluator.evaluate(query2).conditions,
+            statements(std::vector<int>({ 4, 8, 9 })));
+
+    PqlQuerySet query3 = kb->parse_query(
+            "assign a; Select a such that AffectsBip*(1, a)");
+    EXPECT_EQ(evaluator.evaluate(query3).conditions,
+            statements(std::vector<int>({ 3, 5, 8 })));
+
+    PqlQuerySet query4 = kb->parse_query(
+            "Select BOOLEAN such that NextBip(9, 6)");
+    EXPECT_TRUE(evaluator.evaluate(query4).is_true);
+
+    // the intraprocedural relations do not enter procedures
+    PqlQuerySet query5 = kb->parse_query(
+            "Select BOOLEAN such that Affects(5, 3)");
+    EXPECT_FALSE(evaluator.evaluate(query5).is_true);
+}
+
+}
+}
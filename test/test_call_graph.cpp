@@ -0,0 +1,118 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/call_graph.h"
+#include "impl/condition.h"
+#include "impl/expr_store.h"
+#include "impl/parser/parser.h"
+#include "impl/parser/iterator_tokenizer.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+using namespace simple::parser;
+
+// a recursive program, which the knowledge base cannot index
+static SimpleRoot parse_call_program() {
+    std::string program = 
+        "proc a { call b; call c; }\n"
+        "proc b { call d; }\n"
+        "proc c { call d; call e; }\n"
+        "proc d { x = 1; }\n"
+        "proc e { call f; }\n"
+        "proc f { call e; }\n";
+
+    SimpleParser parser(new IteratorTokenizer<std::string::iterator>(
+                program.begin(), program.end()), 
+            std::shared_ptr<ExprStore>(new ExprStore()));
+    return parser.parse_program();
+}
+
+class CallGraphTest : public testing::Test {
+  protected:
+    CallGraphTest() : 
+        ast(parse_call_program()), graph(new CallGraph(ast)) 
+    { }
+
+    size_t id(const std::string& name) {
+        size_t result = 0;
+        EXPECT_TRUE(graph->find_proc(ast.get_proc(name), result));
+        return result;
+    }
+
+    std::vector<size_t> ids(const std::string& names) {
+        std::vector<size_t> result;
+        for(size_t i = 0; i < names.size(); ++i) {
+            result.push_back(id(names.substr(i, 1)));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    size_t position(const std::string& name) {
+        const std::vector<size_t>& order = graph->get_topological_order();
+        return std::find(order.begin(), order.end(), id(name)) - order.begin();
+    }
+
+    SimpleRoot ast;
+    std::shared_ptr<CallGraph> graph;
+};
+
+TEST_F(CallGraphTest, ClosureTest) {
+    EXPECT_EQ(graph->get_size(), (size_t) 6);
+
+    EXPECT_EQ(graph->get_calls(id("c"), true).get_indexes(), ids("de"));
+    EXPECT_EQ(graph->get_calls(id("d"), false).get_indexes(), ids("bc"));
+
+    EXPECT_EQ(graph->get_closure(id("a"), true).get_indexes(), ids("bcdef"));
+    EXPECT_EQ(graph->get_closure(id("e"), true).get_indexes(), ids("ef"));
+    EXPECT_TRUE(graph->get_closure(id("d"), true).is_empty());
+
+    EXPECT_EQ(graph->get_closure(id("d"), false).get_indexes(), ids("abc"));
+    EXPECT_EQ(graph->get_closure(id("f"), false).get_indexes(), ids("acef"));
+    EXPECT_TRUE(graph->get_closure(id("a"), false).is_empty());
+
+    ConditionSet expected;
+    expected.insert(new SimpleProcCondition(ast.get_proc("e")));
+    expected.insert(new SimpleProcCondition(ast.get_proc("f")));
+    EXPECT_EQ(graph->to_conditions(graph->get_closure(id("f"), true)), expected);
+}
+
+TEST_F(CallGraphTest, OrderTest) {
+    EXPECT_EQ(graph->get_topological_order().size(), (size_t) 6);
+
+    EXPECT_LT(position("d"), position("b"));
+    EXPECT_LT(position("d"), position("c"));
+    EXPECT_LT(position("e"), position("c"));
+    EXPECT_LT(position("f"), position("c"));
+    EXPECT_LT(position("b"), position("a"));
+    EXPECT_LT(position("c"), position("a"));
+
+    // the recursive component is kept together
+    EXPECT_EQ(std::max(position("e"), position("f")) - 
+            std::min(position("e"), position("f")), (size_t) 1);
+}
+
+}
+}
@@ -161,5 +161,51 @@ TEST(ConditionTest, ConditionSetTest) {
     EXPECT_EQ(set3.get_size(), (size_t) 1);
 }
 
+TEST(ConditionTest, CopyOnWriteTest) {
+    SimpleAssignmentAst statement1, statement2, statement3;
+    ConditionPtr condition1 = new SimpleStatementCondition(&statement1);
+    ConditionPtr condition2 = new SimpleStatementCondition(&statement2);
+    ConditionPtr condition3 = new SimpleStatementCondition(&statement3);
+
+    ConditionSet set1;
+    set1.insert(condition1);
+    set1.insert(condition2);
+
+    // copies share the storage of the original set
+    ConditionSet set2 = set1;
+    EXPECT_EQ(&*set1.begin(), &*set2.begin());
+
+    // intersecting with a superset does not narrow, and so does not copy
+    ConditionSet superset = set1;
+    superset.insert(condition3);
+    set2.intersect_with(superset);
+    EXPECT_EQ(&*set1.begin(), &*set2.begin());
+
+    set2.remove(condition3);
+    EXPECT_EQ(&*set1.begin(), &*set2.begin());
+
+    // narrowing one set leaves the other intact
+    set2.remove(condition1);
+    EXPECT_NE(&*set1.begin(), &*set2.begin());
+    EXPECT_EQ(set1.get_size(), (size_t) 2);
+    EXPECT_EQ(set2.get_size(), (size_t) 1);
+
+    ConditionSet set3 = set1;
+    set3.intersect_with(ConditionSet(condition2));
+    EXPECT_EQ(set3, set2);
+    EXPECT_EQ(set1.get_size(), (size_t) 2);
+
+    ConditionSet set4 = set1;
+    set4.clear();
+    EXPECT_TRUE(set4.is_empty());
+    EXPECT_TRUE(set4.begin() == set4.end());
+    EXPECT_FALSE(set1.is_empty());
+
+    // union into an empty set shares the other set
+    set4.union_with(set1);
+    EXPECT_EQ(&*set1.begin(), &*set4.begin());
+    EXPECT_TRUE(set1.difference_with(set4).is_empty());
+}
+
 }
 }
@@ -0,0 +1,118 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include "gtest/gtest.h"
+#include "impl/condition_pool.h"
+#include "kb_fixture.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+static const char *POOL_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    while x {\n"
+    "        y = x + 2;\n"
+    "        call p; }\n"
+    "    z = y; }\n"
+    "proc p {\n"
+    "    x = z; }\n";
+
+class ConditionPoolTest : public KnowledgeBaseTest {
+  protected:
+    ConditionPoolTest() : KnowledgeBaseTest(POOL_PROGRAM) { }
+
+    void SetUp() {
+        KnowledgeBaseTest::SetUp();
+        pool = kb->get_condition_pool();
+    }
+
+    SimpleCondition* solve_one(const std::string& relation, 
+            SimpleCondition *left) 
+    {
+        ConditionSet result = get_solver(relation)->solve_right(left);
+        EXPECT_EQ(result.get_size(), (size_t) 1);
+        return result.begin()->get();
+    }
+
+    ConditionPoolPtr pool;
+};
+
+TEST_F(ConditionPoolTest, LookupTest) {
+    // 6 statements, 2 procedures, 3 variables and 2 constants
+    EXPECT_EQ(pool->get_size(), (size_t) 13);
+
+    EXPECT_EQ(pool->get_statement_condition(line_table[1]).get(),
+            pool->get_statement_condition(line_table[1]).get());
+    EXPECT_NE(pool->get_statement_condition(line_table[1]).get(),
+            pool->get_statement_condition(line_table[2]).get());
+
+    EXPECT_EQ(pool->get_variable_condition(SimpleVariable("x")).get(),
+            pool->get_variable_condition(SimpleVariable("x")).get());
+    EXPECT_EQ(pool->get_constant_condition(SimpleConstant(2)).get(),
+            pool->get_constant_condition(SimpleConstant(2)).get());
+
+    ProcAst *proc = kb->get_ast().get_proc("p");
+    EXPECT_EQ(pool->get_proc_condition(proc).get(),
+            pool->get_proc_condition(proc).get());
+
+    // Entities outside of the program still get a valid condition
+    ConditionPtr unknown = pool->get_variable_condition(SimpleVariable("w"));
+    EXPECT_TRUE(unknown == ConditionPtr(
+                new SimpleVariableCondition(SimpleVariable("w"))));
+    EXPECT_EQ(pool->get_size(), (size_t) 13);
+}
+
+TEST_F(ConditionPoolTest, EmptyPoolTest) {
+    ConditionPool empty;
+    EXPECT_EQ(empty.get_size(), (size_t) 0);
+
+    ConditionPtr first = empty.get_statement_condition(line_table[1]);
+    ConditionPtr second = empty.get_statement_condition(line_table[1]);
+    EXPECT_NE(first.get(), second.get());
+    EXPECT_TRUE(first == second);
+}
+
+TEST_F(ConditionPoolTest, SolverTest) {
+    SimpleStatementCondition line1(line_table[1]);
+    SimpleStatementCondition line3(line_table[3]);
+    SimpleStatementCondition line4(line_table[4]);
+
+    // Different solvers return the same object for the same statement
+    SimpleCondition *next = solve_one("next", &line3);
+    SimpleCondition *follows = solve_one("follows", &line3);
+    EXPECT_EQ(next, follows);
+    EXPECT_EQ(next, pool->get_statement_condition(line_table[4]).get());
+
+    SimpleCondition *modified = solve_one("modifies", &line1);
+    SimpleCondition *used = solve_one("uses", &line4);
+    EXPECT_EQ(modified, pool->get_variable_condition(SimpleVariable("x")).get());
+    EXPECT_NE(used, modified);
+
+    ProcAst *main = kb->get_ast().get_proc("main");
+    SimpleProcCondition main_condition(main);
+    EXPECT_EQ(solve_one("calls", &main_condition), 
+            pool->get_proc_condition(kb->get_ast().get_proc("p")).get());
+}
+
+} // namespace test
+} // namespace simple
@@ -0,0 +1,125 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include "gtest/gtest.h"
+#include "impl/cursor.h"
+#include "kb_fixture.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+static const char *CURSOR_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    while x {\n"
+    "        if x {\n"
+    "            y = 2;\n"
+    "            while y {\n"
+    "                z = 3; } }\n"
+    "        else { z = y; } }\n"
+    "    x = z; }\n";
+
+class CursorTest : public KnowledgeBaseTest {
+  protected:
+    CursorTest() : KnowledgeBaseTest(CURSOR_PROGRAM) { }
+
+    void SetUp() {
+        KnowledgeBaseTest::SetUp();
+        pool = kb->get_condition_pool();
+    }
+
+    ConditionSet drain(ConditionCursorPtr cursor) {
+        ConditionSet result;
+        ConditionPtr condition(NULL);
+        while(cursor->next(condition)) {
+            result.insert(condition);
+        }
+        return result;
+    }
+
+    ConditionPoolPtr pool;
+};
+
+TEST_F(CursorTest, ChainTest) {
+    ConditionSet following = statements({2});
+    following.insert(new SimpleStatementCondition(line_table[8]));
+    EXPECT_EQ(following, drain(ConditionCursorPtr(
+            new StatementChainCursor(pool, line_table[1], CHAIN_NEXT))));
+    EXPECT_EQ(statements({1}), drain(ConditionCursorPtr(
+            new StatementChainCursor(pool, line_table[2], CHAIN_PREV))));
+    EXPECT_TRUE(drain(ConditionCursorPtr(
+            new StatementChainCursor(pool, line_table[1], CHAIN_PREV)))
+            .is_empty());
+
+    ConditionSet ancestors = statements({2, 3});
+    ancestors.insert(new SimpleStatementCondition(line_table[5]));
+    EXPECT_EQ(ancestors, drain(ConditionCursorPtr(
+            new StatementChainCursor(pool, line_table[6], CHAIN_PARENT))));
+}
+
+TEST_F(CursorTest, DescendantTest) {
+    EXPECT_EQ(statements({3, 4, 5, 6, 7}), drain(ConditionCursorPtr(
+            new DescendantCursor(pool, line_table[2]))));
+    EXPECT_EQ(statements({4, 5, 6, 7}), drain(ConditionCursorPtr(
+            new DescendantCursor(pool, line_table[3]))));
+    EXPECT_TRUE(drain(ConditionCursorPtr(
+            new DescendantCursor(pool, line_table[4]))).is_empty());
+}
+
+TEST_F(CursorTest, SolverTest) {
+    const SolverTable& solvers = kb->get_solver_table();
+    const char *names[] = { "ifollows", "iparent", "follows", "parent" };
+
+    // the cursors of the solver stack yield what the solvers return
+    for(size_t i = 0; i < 4; ++i) {
+        QuerySolver *solver = solvers.find(names[i])->second.get();
+
+        for(size_t line = 1; line <= 8; ++line) {
+            SimpleStatementCondition condition(line_table[line]);
+
+            EXPECT_EQ(solver->solve_right(&condition),
+                    drain(solver->cursor_right(&condition)));
+            EXPECT_EQ(solver->solve_left(&condition),
+                    drain(solver->cursor_left(&condition)));
+            EXPECT_EQ(!solver->solve_right(&condition).is_empty(),
+                    solver->has_right(&condition));
+            EXPECT_EQ(!solver->solve_left(&condition).is_empty(),
+                    solver->has_left(&condition));
+        }
+    }
+}
+
+TEST_F(CursorTest, QueryTest) {
+    EXPECT_TRUE(evaluate(
+            "stmt s; Select BOOLEAN such that Parent*(2, s)").is_true);
+    EXPECT_FALSE(evaluate(
+            "stmt s; Select BOOLEAN such that Parent*(4, s)").is_true);
+    EXPECT_EQ(statements({8}), evaluate(
+            "stmt s; assign a; Select a such that Follows*(s, a) "
+            "and Parent*(s, 6)").conditions);
+    EXPECT_EQ(statements({4}), evaluate(
+            "stmt s; while w; Select s such that Follows*(s, w) "
+            "and Parent*(3, s)").conditions);
+}
+
+} // namespace test
+} // namespace simple
@@ -0,0 +1,259 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include "gtest/gtest.h"
+#include "simple/solver.h"
+#include "simple/util/solver_generator.h"
+#include "impl/condition.h"
+#include "impl/query.h"
+#include "impl/predicate.h"
+#include "impl/evaluator.h"
+#include "impl/cancellation.h"
+#include "impl/profiler.h"
+#include "impl/solvers/follows.h"
+#include "impl/parser/parser.h"
+#include "impl/parser/iterator_tokenizer.h"
+#include "impl/ast.h"
+#include "test/mock.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+using namespace simple::parser;
+
+/*
+ * A solver that accepts every pair, but cancels the token after a given
+ * number of validations.
+ */
+class CancellingSolver : public QuerySolver {
+  public:
+    CancellingSolver(CancellationToken *token, int limit) :
+        _token(token), _limit(limit), _count(0)
+    { }
+
+    ConditionSet solve_left(SimpleCondition *right) {
+        return ConditionSet();
+    }
+
+    ConditionSet solve_right(SimpleCondition *left) {
+        return ConditionSet();
+    }
+
+    bool validate(SimpleCondition *left, SimpleCondition *right) {
+        if(++_count == _limit) {
+            _token->cancel();
+        }
+        return true;
+    }
+
+    int get_count() {
+        return _count;
+    }
+
+  private:
+    CancellationToken *_token;
+    int _limit;
+    int _count;
+};
+
+static SimpleRoot parse_straight_line_program(int num_statements) {
+    std::string source = "proc test { \n";
+    for(int i = 0; i < num_statements; ++i) {
+        source += "   x" + std::to_string(i) + " = 1; ";
+        source += (i == num_statements - 1) ? "} \n" : "\n";
+    }
+
+    SimpleParser parser(new IteratorTokenizer<
+            std::string::iterator>(source.begin(), source.end()));
+    return parser.parse_program();
+}
+
+TEST(CancellationTest, TokenTest) {
+    CancellationToken no_deadline;
+    EXPECT_FALSE(no_deadline.is_cancelled());
+    no_deadline.cancel();
+    EXPECT_TRUE(no_deadline.is_cancelled());
+    EXPECT_THROW(no_deadline.check(), QueryTimeoutError);
+
+    CancellationToken expired(0);
+    EXPECT_TRUE(expired.is_cancelled());
+
+    CancellationToken far_deadline(3600 * 1000);
+    EXPECT_FALSE(far_deadline.is_cancelled());
+    EXPECT_NO_THROW(far_deadline.check());
+
+    // no token installed
+    EXPECT_NO_THROW(check_cancellation());
+
+    {
+        CancellationScope scope(&no_deadline);
+        EXPECT_EQ(current_cancellation_token(), &no_deadline);
+        EXPECT_THROW(check_cancellation(), QueryTimeoutError);
+    }
+
+    EXPECT_TRUE(current_cancellation_token() == NULL);
+}
+
+TEST(QueryEvaluatorTest, BasicTest) {
+    SimpleRoot ast = parse_straight_line_program(3);
+
+    std::shared_ptr<QuerySolver> follows_solver(
+            new SimpleSolverGenerator<FollowSolver>(new FollowSolver(ast)));
+    PredicatePtr wildcard_pred(new SimpleWildCardPredicate(ast));
+    PredicatePtr statement_pred(new SimpleStatementPredicate(ast));
+
+    /*
+     * stmt s1, s2;
+     * Select s1 such that Follows(s1, s2)
+     */
+    PqlQuerySet query;
+    query.predicates["s1"] = statement_pred;
+    query.predicates["s2"] = statement_pred;
+    query.selector.reset(new SimplePqlSingleVarSelector("s1"));
+    query.clauses.insert(ClausePtr(new SimplePqlClause(follows_solver,
+                new SimplePqlVariableTerm("s1"),
+                new SimplePqlVariableTerm("s2"))));
+
+    QueryEvaluator evaluator(wildcard_pred);
+    QueryResult result = evaluator.evaluate(query);
+
+    EXPECT_EQ(result.status, QUERY_OK);
+    EXPECT_TRUE(result.is_true);
+    EXPECT_EQ(result.conditions.get_size(), (size_t) 2);
+
+    /*
+     * Select BOOLEAN such that Follows(s1, s1)
+     */
+    PqlQuerySet boolean_query;
+    boolean_query.predicates["s1"] = statement_pred;
+    boolean_query.selector.reset(new SimplePqlBooleanSelector());
+    boolean_query.clauses.insert(ClausePtr(new SimplePqlClause(follows_solver,
+                new SimplePqlVariableTerm("s1"),
+                new SimplePqlVariableTerm("s1"))));
+
+    result = evaluator.evaluate(boolean_query, 60 * 1000);
+    EXPECT_EQ(result.status, QUERY_OK);
+    EXPECT_FALSE(result.is_true);
+}
+
+TEST(QueryEvaluatorTest, TimeoutTest) {
+    SimpleRoot ast = parse_straight_line_program(100);
+
+    PredicatePtr wildcard_pred(new SimpleWildCardPredicate(ast));
+    PredicatePtr statement_pred(new SimpleStatementPredicate(ast));
+
+    CancellationToken token;
+    CancellingSolver *solver = new CancellingSolver(&token, 10);
+
+    PqlQuerySet query;
+    query.predicates["s1"] = statement_pred;
+    query.predicates["s2"] = statement_pred;
+    query.selector.reset(new SimplePqlSingleVarSelector("s1"));
+    query.clauses.insert(ClausePtr(new SimplePqlClause(
+                std::shared_ptr<QuerySolver>(solver),
+                new SimplePqlVariableTerm("s1"),
+                new SimplePqlVariableTerm("s2"))));
+
+    QueryEvaluator evaluator(wildcard_pred);
+    QueryResult result = evaluator.evaluate(query, &token);
+
+    // the join of 100 x 100 pairs is abandoned shortly after cancellation
+    EXPECT_EQ(result.status, QUERY_TIMEOUT);
+    EXPECT_FALSE(result.is_true);
+    EXPECT_TRUE(result.conditions.is_empty());
+    EXPECT_LT(solver->get_count(), 200);
+
+    // an already expired deadline never starts solving
+    CancellationToken expired(0);
+    result = evaluator.evaluate(query, &expired);
+    EXPECT_EQ(result.status, QUERY_TIMEOUT);
+    EXPECT_LT(solver->get_count(), 200);
+}
+
+TEST(QueryEvaluatorTest, ProfileTest) {
+    SimpleRoot ast = parse_straight_line_program(3);
+
+    std::shared_ptr<QuerySolver> follows_solver(
+            new SimpleSolverGenerator<FollowSolver>(new FollowSolver(ast)));
+    PredicatePtr wildcard_pred(new SimpleWildCardPredicate(ast));
+    PredicatePtr statement_pred(new SimpleStatementPredicate(ast));
+
+    SolverTable solvers;
+    solvers["follows"] = follows_solver;
+
+    /*
+     * stmt s1, s2;
+     * Select s2 such that Follows(s1, s2)
+     */
+    PqlQuerySet query;
+    query.predicates["s1"] = statement_pred;
+    query.predicates["s2"] = statement_pred;
+    query.selector.reset(new SimplePqlSingleVarSelector("s2"));
+    query.clauses.insert(ClausePtr(new SimplePqlClause(follows_solver,
+                new SimplePqlVariableTerm("s1"),
+                new SimplePqlVariableTerm("s2"))));
+
+    QueryEvaluator evaluator(wildcard_pred);
+
+    QueryResult result = evaluator.evaluate(query);
+    EXPECT_TRUE(result.profile.empty());
+
+    evaluator.set_profiling(true);
+    evaluator.set_solver_names(solvers);
+    result = evaluator.evaluate(query);
+
+    EXPECT_EQ(result.conditions.get_size(), (size_t) 2);
+
+    const std::string& profile = result.profile;
+    EXPECT_EQ(profile.find("{\"status\": \"ok\""), (size_t) 0);
+    EXPECT_NE(profile.find("\"solver\": \"follows\""), std::string::npos);
+    EXPECT_NE(profile.find("\"form\": \"Solver(qvar, qvar)\""), std::string::npos);
+    EXPECT_NE(profile.find("\"validate\": 9, \"solve_left\": 0, \"solve_right\": 0"), 
+            std::string::npos);
+    EXPECT_NE(profile.find("{\"qvar\": \"s1\", \"before\": 3, \"after\": 2}"),
+            std::string::npos);
+    EXPECT_NE(profile.find("\"links_created\": 2, \"conditions_removed\": 2, "
+                "\"conditions_cascaded\": 0"), std::string::npos);
+}
+
+TEST(ProfilerTest, CountingSolverTest) {
+    MockSolver *mock = new MockSolver();
+    std::unique_ptr<QuerySolver> owner(mock);
+    CountingSolver solver(mock);
+
+    SimpleProcAst proc("test");
+    SimpleProcCondition condition(&proc);
+
+    solver.validate(&condition, &condition);
+    solver.validate(&condition, &condition);
+    solver.solve_left(&condition);
+    solver.solve_right(&condition);
+    EXPECT_FALSE(solver.has_right(&condition));
+    EXPECT_FALSE(solver.has_left(&condition));
+
+    EXPECT_EQ(solver.get_validate_count(), (size_t) 2);
+    EXPECT_EQ(solver.get_solve_left_count(), (size_t) 1);
+    EXPECT_EQ(solver.get_solve_right_count(), (size_t) 1);
+    EXPECT_EQ(solver.get_probe_count(), (size_t) 2);
+}
+
+}
+}
@@ -0,0 +1,200 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include "gtest/gtest.h"
+#include "impl/solvers/pattern.h"
+#include "simple/util/solver_generator.h"
+#include "kb_fixture.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+using namespace simple::util;
+
+static const char *EXISTENCE_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    while x {\n"
+    "        y = x + 2; }\n"
+    "    z = y; }\n";
+
+static const char *PROBE_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    call second;\n"
+    "    while x {\n"
+    "        if y {\n"
+    "            y = x + 2; }\n"
+    "        else {\n"
+    "            call third; } }\n"
+    "    z = y * x; }\n"
+    "proc second {\n"
+    "    if z {\n"
+    "        x = 3; }\n"
+    "    else {\n"
+    "        y = z; } }\n"
+    "proc third {\n"
+    "    z = 4; }\n";
+
+// loops that start a procedure, and loop bodies that end one
+static const char *LOOP_PROGRAM =
+    "proc main {\n"
+    "    while x {\n"
+    "        y = 1; } }\n"
+    "proc second {\n"
+    "    x = 2;\n"
+    "    while x {\n"
+    "        if y {\n"
+    "            y = x; }\n"
+    "        else {\n"
+    "            x = y; } } }\n";
+
+/*
+ * Every probe of the solver agrees with solving for every condition of
+ * the pool.
+ */
+static void expect_probes_match(QuerySolver *solver, ConditionPoolPtr pool,
+        const std::string& name)
+{
+    bool any = false;
+    for(size_t id = 0; id < pool->get_size(); ++id) {
+        ConditionPtr condition = pool->get_condition(id);
+        bool has_right = !solver->solve_right(condition.get()).is_empty();
+        bool has_left = !solver->solve_left(condition.get()).is_empty();
+
+        EXPECT_EQ(has_right, solver->has_right(condition.get())) 
+            << name << " " << id;
+        EXPECT_EQ(has_left, solver->has_left(condition.get())) 
+            << name << " " << id;
+        any = any || has_right;
+    }
+    EXPECT_EQ(any, solver->has_any()) << name;
+}
+
+class ExistenceTest : public KnowledgeBaseTest {
+  protected:
+    ExistenceTest() : KnowledgeBaseTest(EXISTENCE_PROGRAM) { }
+};
+
+TEST_F(ExistenceTest, ProbeTest) {
+    QuerySolver *parent = get_solver("iparent");
+
+    SimpleStatementCondition line1(line_table[1]);
+    SimpleStatementCondition line2(line_table[2]);
+    SimpleStatementCondition line3(line_table[3]);
+
+    EXPECT_FALSE(parent->has_right(&line1));
+    EXPECT_TRUE(parent->has_right(&line2));
+    EXPECT_FALSE(parent->has_right(&line3));
+    EXPECT_FALSE(parent->has_left(&line2));
+    EXPECT_TRUE(parent->has_left(&line3));
+
+    EXPECT_TRUE(parent->has_any());
+
+    QuerySolver *follows = get_solver("follows");
+    SimpleStatementCondition line4(line_table[4]);
+    EXPECT_TRUE(follows->has_right(&line2));
+    EXPECT_FALSE(follows->has_right(&line4));
+    EXPECT_TRUE(follows->has_left(&line4));
+
+    // a variable outside of the program
+    SimpleVariableCondition unknown(SimpleVariable("w"));
+    EXPECT_FALSE(get_solver("modifies")->has_left(&unknown));
+}
+
+TEST_F(ExistenceTest, AnyTest) {
+    EXPECT_TRUE(get_solver("follows")->has_any());
+    EXPECT_TRUE(get_solver("affects")->has_any());
+    EXPECT_FALSE(get_solver("calls")->has_any());
+    EXPECT_FALSE(get_solver("icalls")->has_any());
+}
+
+TEST(ExistenceProbeTest, SolveTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(PROBE_PROGRAM);
+    ConditionPoolPtr pool = kb->get_condition_pool();
+    const SolverTable& solvers = kb->get_solver_table();
+
+    for(SolverTable::const_iterator it = solvers.begin(); 
+            it != solvers.end(); ++it)
+    {
+        expect_probes_match(it->second.get(), pool, it->first);
+    }
+
+    SimpleSolverGenerator<PatternSolver> pattern(new PatternSolver(
+                kb->get_pattern_index(), ExprPtr(), false, pool));
+    expect_probes_match(&pattern, pool, "pattern");
+}
+
+TEST(ExistenceProbeTest, LoopTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(LOOP_PROGRAM);
+    ConditionPoolPtr pool = kb->get_condition_pool();
+    LineTable line_table = kb->get_line_table();
+
+    SimpleStatementCondition line1(line_table[1]);
+    SimpleStatementCondition line2(line_table[2]);
+    SimpleStatementCondition line6(line_table[6]);
+
+    const char *names[] = { "next", "inext" };
+    for(size_t i = 0; i < 2; ++i) {
+        QuerySolver *solver = kb->get_solver_table().at(names[i]).get();
+        expect_probes_match(solver, pool, names[i]);
+
+        // the loop body goes back to the while
+        EXPECT_TRUE(solver->has_left(&line1)) << names[i];
+        EXPECT_TRUE(solver->has_right(&line2)) << names[i];
+        EXPECT_TRUE(solver->has_right(&line6)) << names[i];
+    }
+
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+
+    PqlQuerySet query1 = kb->parse_query(
+            "while w; Select w such that Next(_, w)");
+    ConditionSet expected1;
+    expected1.insert(new SimpleStatementCondition(line_table[1]));
+    expected1.insert(new SimpleStatementCondition(line_table[4]));
+    EXPECT_EQ(expected1, evaluator.evaluate(query1).conditions);
+
+    PqlQuerySet query2 = kb->parse_query(
+            "stmt s; Select s such that Next(s, _)");
+    EXPECT_EQ((size_t) 7, evaluator.evaluate(query2).conditions.get_size());
+}
+
+TEST_F(ExistenceTest, QueryTest) {
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+
+    PqlQuerySet query1 = kb->parse_query("Select BOOLEAN such that Calls(_, _)");
+    EXPECT_FALSE(evaluator.evaluate(query1).is_true);
+
+    PqlQuerySet query2 = kb->parse_query("Select BOOLEAN such that Parent(_, _)");
+    EXPECT_TRUE(evaluator.evaluate(query2).is_true);
+
+    PqlQuerySet query3 = kb->parse_query(
+            "stmt s; Select s such that Parent*(s, _)");
+    QueryResult result3 = evaluator.evaluate(query3);
+    ConditionSet expected3;
+    expected3.insert(new SimpleStatementCondition(line_table[2]));
+    EXPECT_EQ(result3.conditions, expected3);
+}
+
+} // namespace test
+} // namespace simple
@@ -0,0 +1,167 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <string>
+#include "gtest/gtest.h"
+#include "simple/util/ast_utils.h"
+#include "simple/util/condition_utils.h"
+#include "impl/condition.h"
+#include "impl/expr_store.h"
+#include "impl/knowledge_base.h"
+#include "impl/predicate.h"
+#include "impl/parser/parser.h"
+#include "impl/parser/iterator_tokenizer.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+using namespace simple::parser;
+using namespace simple::util;
+
+static ExprPtr parse_expr(const std::string& source, 
+        std::shared_ptr<ExprStore> store) 
+{
+    std::string expr = source;
+
+    SimpleParser parser(new IteratorTokenizer<std::string::iterator>(
+                expr.begin(), expr.end()), store);
+    return parser.parse_expr_ptr();
+}
+
+TEST(ExprStoreTest, HashConsTest) {
+    std::shared_ptr<ExprStore> store(new ExprStore());
+
+    ExprPtr x1 = store->make_variable(SimpleVariable("x"));
+    ExprPtr x2 = store->make_variable(SimpleVariable("x"));
+    ExprPtr y = store->make_variable(SimpleVariable("y"));
+    ExprPtr one = store->make_const(1);
+
+    EXPECT_EQ(x1, x2);
+    EXPECT_NE(x1, y);
+    EXPECT_NE(x1->get_id(), (size_t) 0);
+    EXPECT_NE(x1->get_id(), y->get_id());
+
+    ExprPtr sum1 = store->make_binary_op('+', x1, one);
+    ExprPtr sum2 = store->make_binary_op('+', x2, store->make_const(1));
+    ExprPtr diff = store->make_binary_op('-', x1, one);
+
+    EXPECT_EQ(sum1, sum2);
+    EXPECT_NE(sum1, diff);
+
+    // x, y, 1, x + 1, x - 1
+    EXPECT_EQ(store->get_size(), (size_t) 5);
+
+    // trees built outside the store are rebuilt from the shared nodes
+    std::unique_ptr<ExprAst> tree(new SimpleBinaryOpAst('+', 
+                new SimpleVariableAst("x"), new SimpleConstAst(1)));
+    EXPECT_EQ(tree->get_id(), (size_t) 0);
+    EXPECT_EQ(store->intern(tree.get()), sum1);
+    EXPECT_EQ(store->get_size(), (size_t) 5);
+
+    // parsing through the store shares every repeated subexpression
+    ExprPtr expr1 = parse_expr("(x + 1) * (x + 1)", store);
+    ExprPtr expr2 = parse_expr("((x+1)) * (x + 1)", store);
+    EXPECT_EQ(expr1, expr2);
+    EXPECT_EQ(store->get_size(), (size_t) 6);
+
+    BinaryOpAst *bin = dynamic_cast<BinaryOpAst*>(expr1.get());
+    ASSERT_TRUE(bin != NULL);
+    EXPECT_EQ(bin->get_lhs(), sum1.get());
+    EXPECT_EQ(bin->get_rhs(), sum1.get());
+
+    // ids of different stores never collide
+    ExprStore other;
+    EXPECT_NE(other.make_variable(SimpleVariable("x"))->get_id(), 
+            x1->get_id());
+}
+
+TEST(ExprStoreTest, CompareTest) {
+    std::shared_ptr<ExprStore> store(new ExprStore());
+
+    ExprPtr expr1 = parse_expr("a * b + c", store);
+    ExprPtr expr2 = parse_expr("a * b + c", store);
+    ExprPtr expr3 = parse_expr("a * (b + c)", store);
+    ExprPtr fresh = parse_expr("a * b + c", std::shared_ptr<ExprStore>());
+
+    EXPECT_TRUE((is_same_expr<ExprAst, ExprAst>(expr1.get(), expr2.get())));
+    EXPECT_FALSE((is_same_expr<ExprAst, ExprAst>(expr1.get(), expr3.get())));
+
+    // nodes outside the store fall back to a structural compare
+    EXPECT_EQ(fresh->get_id(), (size_t) 0);
+    EXPECT_TRUE((is_same_expr<ExprAst, ExprAst>(expr1.get(), fresh.get())));
+    EXPECT_TRUE((is_same_expr<ExprAst, ExprAst>(fresh.get(), expr1.get())));
+    EXPECT_FALSE((is_same_expr<ExprAst, ExprAst>(fresh.get(), expr3.get())));
+
+    bool less13 = is_less_than_expr<ExprAst, ExprAst>(expr1.get(), expr3.get());
+    bool less31 = is_less_than_expr<ExprAst, ExprAst>(expr3.get(), expr1.get());
+    EXPECT_NE(less13, less31);
+    EXPECT_FALSE((is_less_than_expr<ExprAst, ExprAst>(expr1.get(), fresh.get())));
+    EXPECT_FALSE((is_less_than_expr<ExprAst, ExprAst>(fresh.get(), expr1.get())));
+
+    ConditionPtr pattern1(new SimplePatternCondition(expr1));
+    ConditionPtr pattern2(new SimplePatternCondition(expr2));
+    ConditionPtr pattern3(new SimplePatternCondition(expr3));
+
+    EXPECT_EQ(pattern1, pattern2);
+    EXPECT_NE(pattern1, pattern3);
+
+    ConditionSet patterns;
+    patterns.insert(pattern1);
+    patterns.insert(pattern2);
+    patterns.insert(pattern3);
+    EXPECT_EQ(patterns.get_size(), (size_t) 2);
+}
+
+TEST(ExprStoreTest, ProgramTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = create_knowledge_base(
+        "proc test {\n"
+        "    x = a * b + c;\n"
+        "    y = a * b + c;\n"
+        "    z = c * (a * b + c); }\n");
+
+    LineTable line_table = kb->get_line_table();
+    AssignmentAst *assign1 = dynamic_cast<AssignmentAst*>(line_table[1]);
+    AssignmentAst *assign2 = dynamic_cast<AssignmentAst*>(line_table[2]);
+    AssignmentAst *assign3 = dynamic_cast<AssignmentAst*>(line_table[3]);
+
+    // identical right hand sides are the same node
+    EXPECT_EQ(assign1->get_expr(), assign2->get_expr());
+
+    BinaryOpAst *product = dynamic_cast<BinaryOpAst*>(assign3->get_expr());
+    ASSERT_TRUE(product != NULL);
+    EXPECT_EQ(product->get_rhs(), assign1->get_expr());
+
+    // a, b, c, a * b, a * b + c, c * (a * b + c)
+    EXPECT_EQ(kb->get_expr_store()->get_size(), (size_t) 6);
+
+    // the predicates share the expressions instead of copying them
+    SimpleWildCardPredicate wildcard(kb->get_ast());
+
+    ConditionSet patterns;
+    patterns.insert(new SimplePatternCondition(assign1->get_expr_ptr()));
+    patterns.insert(new SimplePatternCondition(assign3->get_expr_ptr()));
+    ConditionSet all = wildcard.global_set();
+    all.intersect_with(patterns);
+    EXPECT_EQ(all.get_size(), (size_t) 2);
+}
+
+}
+}
@@ -0,0 +1,172 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/generic_join.h"
+#include "impl/tuple_stream.h"
+#include "kb_fixture.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+static const char *JOIN_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    while x {\n"
+    "        y = 2;\n"
+    "        if y {\n"
+    "            z = 3; } else {\n"
+    "            w = 4; }\n"
+    "        x = y; }\n"
+    "    z = x; }\n";
+
+static const char *TRIANGLE_QUERY = 
+    "stmt a, b; while w; Select <w, a, b> such that Follows*(a, b) "
+    "and Parent*(w, a) and Parent*(w, b)";
+
+class GenericJoinTest : public KnowledgeBaseTest {
+  protected:
+    GenericJoinTest() : KnowledgeBaseTest(JOIN_PROGRAM) { }
+
+    const ConditionSet& global_set(const std::string& pred) {
+        return kb->get_predicate_table().at(pred)->global_set();
+    }
+};
+
+TEST(LeapfrogTest, IntersectTest) {
+    std::vector<unsigned int> list1 = {1, 3, 4, 7, 9, 12};
+    std::vector<unsigned int> list2 = {0, 3, 7, 8, 12};
+    std::vector<unsigned int> list3 = {3, 5, 7, 12, 15};
+    std::vector<unsigned int> empty;
+
+    std::vector<const std::vector<unsigned int>*> lists;
+    std::vector<unsigned int> result;
+
+    lists.push_back(&list1);
+    leapfrog_intersect(lists, result);
+    EXPECT_EQ(result, list1);
+
+    lists.push_back(&list2);
+    lists.push_back(&list3);
+    leapfrog_intersect(lists, result);
+    EXPECT_EQ(result, std::vector<unsigned int>({3, 7, 12}));
+
+    lists.push_back(&empty);
+    leapfrog_intersect(lists, result);
+    EXPECT_TRUE(result.empty());
+}
+
+TEST_F(GenericJoinTest, JoinTest) {
+    std::vector<ConditionSet> domains;
+    domains.push_back(global_set("statement"));
+    domains.push_back(global_set("statement"));
+    domains.push_back(global_set("while"));
+
+    std::vector<JoinRelation> relations;
+    relations.push_back(JoinRelation(get_solver("ifollows"), 0, 1));
+    relations.push_back(JoinRelation(get_solver("iparent"), 2, 0));
+    relations.push_back(JoinRelation(get_solver("iparent"), 2, 1));
+
+    GenericJoin join(domains, relations);
+    EXPECT_EQ(join.run(), (size_t) 3);
+
+    // the single while is bound first
+    EXPECT_EQ(join.get_order()[0], (size_t) 2);
+
+    EXPECT_EQ(join.get_domain(0), statements({3, 4}));
+    EXPECT_EQ(join.get_domain(1), statements({4, 7}));
+    EXPECT_EQ(join.get_domain(2), statements({2}));
+
+    std::vector<ConditionPair> links;
+    join.get_links(0, links);
+    EXPECT_EQ(links.size(), (size_t) 3);
+
+    links.clear();
+    join.get_links(1, links);
+    EXPECT_EQ(links.size(), (size_t) 2);
+}
+
+TEST_F(GenericJoinTest, SplitTest) {
+    PqlQuerySet query = kb->parse_query(std::string(TRIANGLE_QUERY) + 
+            " and Modifies(a, \"y\") and Follows(w, 8) and Uses(b, v)");
+
+    std::vector<PqlClause*> join_clauses;
+    std::vector<PqlClause*> other_clauses;
+    split_cyclic_clauses(query.clauses, join_clauses, other_clauses);
+
+    // Uses(b, v) hangs off the cycle and is joined along with it
+    EXPECT_EQ(join_clauses.size(), (size_t) 4);
+    EXPECT_EQ(other_clauses.size(), (size_t) 2);
+
+    PqlQuerySet path = kb->parse_query(
+            "stmt a, b; while w; Select a such that Follows*(a, b) "
+            "and Parent*(w, a) and Next(b, 2)");
+
+    join_clauses.clear();
+    other_clauses.clear();
+    split_cyclic_clauses(path.clauses, join_clauses, other_clauses);
+
+    EXPECT_TRUE(join_clauses.empty());
+    EXPECT_EQ(other_clauses.size(), (size_t) 3);
+}
+
+TEST_F(GenericJoinTest, QueryTest) {
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+
+    PqlQuerySet query1 = kb->parse_query(TRIANGLE_QUERY);
+    std::stringstream out;
+    StreamTupleWriter writer(out);
+    QueryResult result1 = evaluator.evaluate(query1, &writer);
+    EXPECT_EQ(result1.tuple_count, (size_t) 3);
+
+    std::vector<std::string> rows;
+    std::string row;
+    while(std::getline(out, row)) {
+        rows.push_back(row);
+    }
+    std::sort(rows.begin(), rows.end());
+    EXPECT_EQ(rows, std::vector<std::string>({"2 3 4", "2 3 7", "2 4 7"}));
+
+    PqlQuerySet query2 = kb->parse_query(
+            "stmt a, b; while w; Select a such that Follows*(a, b) "
+            "and Parent*(w, a) and Parent*(w, b) and Modifies(b, \"x\")");
+    EXPECT_EQ(evaluator.evaluate(query2).conditions, statements({3, 4}));
+
+    PqlQuerySet query3 = kb->parse_query(
+            "stmt a, b; while w; Select BOOLEAN such that Follows*(a, b) "
+            "and Parent*(w, a) and Parent*(w, b) and Follows(b, 8)");
+    EXPECT_FALSE(evaluator.evaluate(query3).is_true);
+
+    evaluator.set_profiling(true);
+    PqlQuerySet query4 = kb->parse_query(TRIANGLE_QUERY);
+    QueryResult result4 = evaluator.evaluate(query4);
+    EXPECT_EQ(result4.tuple_count, (size_t) 3);
+    EXPECT_NE(result4.profile.find("\"solver\": \"generic_join\""), 
+            std::string::npos);
+}
+
+} // namespace test
+} // namespace simple
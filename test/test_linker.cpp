@@ -16,6 +16,7 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <sstream>
 #include "gtest/gtest.h"
 #include "impl/ast.h"
 #include "impl/condition.h"
@@ -474,6 +475,102 @@ TEST(LinkerTest, ThreeWayTest) {
 
 }
 
+/*
+ * A ring of qvars where every qvar holds one "a" and one "b" condition
+ * linked to its counterpart in the next qvar. Removing a single "a" has
+ * to cascade around the whole ring, and back to where it started.
+ */
+TEST(LinkerTest, CascadeTest) {
+    const int size = 10000;
+
+    SimpleQueryLinker linker;
+    std::vector<std::string> qvars;
+    for(int i = 0; i < size; ++i) {
+        std::stringstream name;
+        name << "q" << i;
+        qvars.push_back(name.str());
+
+        ConditionSet conditions;
+        conditions.insert(new SimpleConstantCondition(SimpleConstant(i)));
+        conditions.insert(new SimpleConstantCondition(SimpleConstant(size + i)));
+        linker.update_results(qvars[i], conditions);
+    }
+
+    for(int i = 0; i < size; ++i) {
+        int next = (i + 1) % size;
+
+        std::vector<ConditionPair> links;
+        links.push_back(ConditionPair(
+                    new SimpleConstantCondition(SimpleConstant(i)),
+                    new SimpleConstantCondition(SimpleConstant(next))));
+        links.push_back(ConditionPair(
+                    new SimpleConstantCondition(SimpleConstant(size + i)),
+                    new SimpleConstantCondition(SimpleConstant(size + next))));
+        linker.update_links(qvars[i], qvars[next], links);
+    }
+
+    EXPECT_EQ(linker.get_stats().links_created, (size_t) 2 * size);
+    EXPECT_EQ(linker.get_stats().conditions_removed, (size_t) 0);
+    EXPECT_EQ(linker.get_stats().conditions_cascaded, (size_t) 0);
+
+    linker.remove_condition(qvars[0], 
+            new SimpleConstantCondition(SimpleConstant(0)));
+
+    EXPECT_TRUE(linker.is_valid_state());
+    EXPECT_EQ(linker.get_stats().conditions_removed, (size_t) 1);
+    EXPECT_EQ(linker.get_stats().conditions_cascaded, (size_t) size - 1);
+
+    // both directions of every "a" link, each removed exactly once
+    EXPECT_EQ(linker.get_stats().links_removed, (size_t) 2 * size);
+
+    for(int i = 0; i < size; ++i) {
+        EXPECT_EQ(linker.get_conditions(qvars[i]), ConditionSet(
+                    new SimpleConstantCondition(SimpleConstant(size + i))));
+    }
+
+    EXPECT_TRUE(linker.get_linked_conditions(qvars[1], qvars[2],
+                new SimpleConstantCondition(SimpleConstant(1))).is_empty());
+    EXPECT_EQ(linker.get_links(qvars[1], qvars[2]).size(), (size_t) 1);
+}
+
+TEST(LinkerTest, SlotTest) {
+    SimpleQueryLinker linker(2);
+    EXPECT_EQ(linker.get_num_slots(), (size_t) 2);
+
+    QVarSlot x = linker.get_slot("x");
+    QVarSlot y = linker.get_slot("y");
+    EXPECT_EQ(x, (QVarSlot) 0);
+    EXPECT_EQ(y, (QVarSlot) 1);
+    EXPECT_EQ(linker.get_slot("x"), x);
+    EXPECT_FALSE(linker.is_initialized(x));
+
+    ConditionPtr condition1 = new SimpleConstantCondition(SimpleConstant(1));
+    ConditionPtr condition2 = new SimpleConstantCondition(SimpleConstant(2));
+
+    ConditionSet x_set(condition1);
+    x_set.insert(condition2);
+    linker.update_results(x, x_set);
+    linker.update_results(y, ConditionSet(condition2));
+
+    const ConditionSet& x_view = linker.get_conditions(x);
+
+    std::vector<ConditionPair> links;
+    links.push_back(ConditionPair(condition2, condition2));
+    linker.update_links(x, y, links);
+
+    EXPECT_TRUE(linker.has_link("x", "y"));
+    EXPECT_TRUE(linker.has_link(y, x));
+    EXPECT_EQ(linker.get_conditions("x"), ConditionSet(condition2));
+
+    // more slots than allocated up front leave the existing views intact
+    QVarSlot z = linker.get_slot("z");
+    EXPECT_EQ(z, (QVarSlot) 2);
+    EXPECT_EQ(linker.get_num_slots(), (size_t) 3);
+    EXPECT_FALSE(linker.is_initialized("z"));
+    EXPECT_EQ(x_view, ConditionSet(condition2));
+    EXPECT_FALSE(linker.has_link(x, z));
+}
+
 TEST(LinkerTest, UnlinkedPermutations) {
 
 }
@@ -0,0 +1,163 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include "gtest/gtest.h"
+#include "impl/profiler.h"
+#include "impl/solvers/memoized.h"
+#include "kb_fixture.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+static const char *MEMO_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    while x {\n"
+    "        y = x + 2;\n"
+    "        z = y; }\n"
+    "    z = y; }\n";
+
+class MemoizedTest : public KnowledgeBaseTest {
+  protected:
+    MemoizedTest() : KnowledgeBaseTest(MEMO_PROGRAM) { }
+
+    void SetUp() {
+        KnowledgeBaseTest::SetUp();
+
+        QuerySolver *solver = kb->get_memoized_solver("iparent")->get_solver();
+        counter = new CountingSolver(solver);
+        memoized.reset(new MemoizedSolver(
+                    std::shared_ptr<QuerySolver>(counter), 
+                    kb->get_condition_pool()));
+    }
+
+    CountingSolver *counter;
+    std::shared_ptr<MemoizedSolver> memoized;
+};
+
+TEST_F(MemoizedTest, SolveTest) {
+    SimpleStatementCondition line2(line_table[2]);
+    SimpleStatementCondition line3(line_table[3]);
+
+    ConditionSet children;
+    children.insert(new SimpleStatementCondition(line_table[3]));
+    children.insert(new SimpleStatementCondition(line_table[4]));
+
+    EXPECT_EQ(children, memoized->solve_right(&line2));
+    EXPECT_EQ(children, memoized->solve_right(&line2));
+    EXPECT_EQ(1u, counter->get_solve_right_count());
+
+    // the directions are memoized apart
+    EXPECT_EQ(ConditionSet(new SimpleStatementCondition(line_table[2])),
+            memoized->solve_left(&line3));
+    EXPECT_TRUE(memoized->solve_right(&line3).is_empty());
+    EXPECT_EQ(1u, counter->get_solve_left_count());
+    EXPECT_EQ(2u, counter->get_solve_right_count());
+
+    MemoStats stats = memoized->get_stats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(3u, stats.misses);
+    EXPECT_EQ(3u, stats.entries);
+    EXPECT_DOUBLE_EQ(0.25, stats.hit_rate());
+
+    // validate is never memoized
+    memoized->validate(&line2, &line3);
+    memoized->validate(&line2, &line3);
+    EXPECT_EQ(2u, counter->get_validate_count());
+
+    // a variable outside of the program is solved every time
+    SimpleVariableCondition unknown(SimpleVariable("w"));
+    EXPECT_TRUE(memoized->solve_right(&unknown).is_empty());
+    EXPECT_TRUE(memoized->solve_right(&unknown).is_empty());
+    EXPECT_EQ(4u, counter->get_solve_right_count());
+}
+
+TEST_F(MemoizedTest, BudgetTest) {
+    SimpleStatementCondition line1(line_table[1]);
+    SimpleStatementCondition line4(line_table[4]);
+    SimpleStatementCondition line3(line_table[3]);
+
+    memoized->solve_right(&line1);
+    memoized->solve_right(&line3);
+    size_t size = memoized->get_stats().memory;
+
+    // room for two empty answers only
+    memoized->set_budget(size);
+    memoized->solve_right(&line1);
+    memoized->solve_right(&line4);
+
+    MemoStats stats = memoized->get_stats();
+    EXPECT_EQ(2u, stats.entries);
+    EXPECT_EQ(1u, stats.evictions);
+    EXPECT_LE(stats.memory, size);
+
+    // line1 was used more recently than line3
+    memoized->solve_right(&line1);
+    EXPECT_EQ(3u, counter->get_solve_right_count());
+    memoized->solve_right(&line3);
+    EXPECT_EQ(4u, counter->get_solve_right_count());
+}
+
+TEST_F(MemoizedTest, EnableTest) {
+    SimpleStatementCondition line2(line_table[2]);
+
+    memoized->solve_right(&line2);
+    memoized->set_enabled(false);
+    EXPECT_FALSE(memoized->is_enabled());
+    EXPECT_EQ(0u, memoized->get_stats().entries);
+
+    memoized->solve_right(&line2);
+    memoized->solve_right(&line2);
+    EXPECT_EQ(3u, counter->get_solve_right_count());
+    EXPECT_EQ(1u, memoized->get_stats().misses);
+
+    memoized->set_enabled(true);
+    memoized->solve_right(&line2);
+    memoized->solve_right(&line2);
+    EXPECT_EQ(4u, counter->get_solve_right_count());
+    EXPECT_EQ(1u, memoized->get_stats().hits);
+}
+
+TEST_F(MemoizedTest, QueryTest) {
+    std::shared_ptr<MemoizedSolver> parent = kb->get_memoized_solver("parent");
+    ASSERT_TRUE(parent.get() != NULL);
+    EXPECT_TRUE(kb->get_memoized_solver("unknown").get() == NULL);
+
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+    ConditionSet expected;
+    expected.insert(new SimpleStatementCondition(line_table[3]));
+    expected.insert(new SimpleStatementCondition(line_table[4]));
+
+    // the answers of the first query are reused by the second
+    PqlQuerySet query1 = kb->parse_query(
+            "assign a; Select a such that Parent(2, a)");
+    EXPECT_EQ(expected, evaluator.evaluate(query1).conditions);
+    size_t hits = parent->get_stats().hits;
+
+    PqlQuerySet query2 = kb->parse_query(
+            "stmt s; Select s such that Parent(2, s)");
+    EXPECT_EQ(expected, evaluator.evaluate(query2).conditions);
+    EXPECT_GT(parent->get_stats().hits, hits);
+}
+
+} // namespace test
+} // namespace simple
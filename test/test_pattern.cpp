@@ -0,0 +1,171 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/condition.h"
+#include "impl/evaluator.h"
+#include "impl/knowledge_base.h"
+#include "impl/pattern_index.h"
+#include "impl/parser/parser.h"
+#include "impl/parser/iterator_tokenizer.h"
+#include "impl/parser/pql_parser.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+using namespace simple::parser;
+
+static const char *PATTERN_PROGRAM =
+    "proc test {\n"
+    "    x = a * b + c;\n"
+    "    y = a * b;\n"
+    "    while x {\n"
+    "        z = c + a * b; }\n"
+    "    x = a + b * c; }\n";
+
+static ExprAst* parse_expr(const std::string& source) {
+    std::string expr = source;
+
+    SimpleParser parser(new IteratorTokenizer<std::string::iterator>(
+                expr.begin(), expr.end()));
+    return parser.parse_expr();
+}
+
+static std::vector<int> get_lines(const std::vector<AssignmentAst*>& assigns) {
+    std::vector<int> result;
+    for(size_t i = 0; i < assigns.size(); ++i) {
+        result.push_back(assigns[i]->get_line());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+static ConditionSet statements(SimpleKnowledgeBase& kb, 
+        const std::vector<int>& lines) 
+{
+    LineTable line_table = kb.get_line_table();
+
+    ConditionSet result;
+    for(size_t i = 0; i < lines.size(); ++i) {
+        result.insert(new SimpleStatementCondition(line_table[lines[i]]));
+    }
+    return result;
+}
+
+TEST(PatternTest, HashTest) {
+    std::unique_ptr<ExprAst> expr1(parse_expr("a * b + c"));
+    std::unique_ptr<ExprAst> expr2(parse_expr("(a * b) + c"));
+    std::unique_ptr<ExprAst> expr3(parse_expr("a * (b + c)"));
+    std::unique_ptr<ExprAst> expr4(parse_expr("c + a * b"));
+
+    ExprHasher hasher;
+    size_t hash1 = hasher.hash(expr1.get());
+
+    EXPECT_EQ(ExprHasher().hash(expr2.get()), hash1);
+    EXPECT_NE(ExprHasher().hash(expr3.get()), hash1);
+    EXPECT_NE(ExprHasher().hash(expr4.get()), hash1);
+
+    // a, b, a * b, c, a * b + c
+    EXPECT_EQ(hasher.get_subexprs().size(), (size_t) 5);
+    EXPECT_EQ(hasher.get_subexprs().back().second, expr1.get());
+}
+
+TEST(PatternTest, IndexTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(PATTERN_PROGRAM);
+    PatternIndex index(kb->get_ast());
+
+    std::unique_ptr<ExprAst> ab(parse_expr("a * b"));
+    std::unique_ptr<ExprAst> bc(parse_expr("b * c"));
+    std::unique_ptr<ExprAst> a_plus_b(parse_expr("a + b"));
+    std::unique_ptr<ExprAst> c(parse_expr("c"));
+
+    EXPECT_EQ(get_lines(index.find_subexpr(ab.get())), 
+            std::vector<int>({ 1, 2, 4 }));
+    EXPECT_EQ(get_lines(index.find_exact(ab.get())), 
+            std::vector<int>({ 2 }));
+    EXPECT_EQ(get_lines(index.find_subexpr(bc.get())), 
+            std::vector<int>({ 5 }));
+    EXPECT_TRUE(index.find_subexpr(a_plus_b.get()).empty());
+    EXPECT_EQ(get_lines(index.find_subexpr(c.get())), 
+            std::vector<int>({ 1, 4, 5 }));
+    EXPECT_TRUE(index.find_exact(c.get()).empty());
+
+    EXPECT_EQ(index.get_assignments().size(), (size_t) 4);
+
+    SimpleVariable x("x");
+    SimpleVariable w("w");
+    EXPECT_EQ(get_lines(index.get_assignments(&x)), std::vector<int>({ 1, 5 }));
+    EXPECT_TRUE(index.get_assignments(&w).empty());
+}
+
+TEST(PatternTest, QueryTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(PATTERN_PROGRAM);
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+
+    PqlQuerySet query1 = kb->parse_query(
+            "assign a; Select a pattern a(_, _\"a * b\"_)");
+    EXPECT_EQ(evaluator.evaluate(query1).conditions, 
+            statements(*kb, std::vector<int>({ 1, 2, 4 })));
+
+    PqlQuerySet query2 = kb->parse_query(
+            "assign a; Select a pattern a(\"x\", _)");
+    EXPECT_EQ(evaluator.evaluate(query2).conditions, 
+            statements(*kb, std::vector<int>({ 1, 5 })));
+
+    PqlQuerySet query3 = kb->parse_query(
+            "assign a; variable v; Select v pattern a(v, \"a*b\")");
+    ConditionSet expected3;
+    expected3.insert(new SimpleVariableCondition(SimpleVariable("y")));
+    EXPECT_EQ(evaluator.evaluate(query3).conditions, expected3);
+
+    PqlQuerySet query4 = kb->parse_query(
+            "assign a; Select a such that Parent(3, a) "
+            "pattern a(_, _\"a*b\"_)");
+    EXPECT_EQ(evaluator.evaluate(query4).conditions, 
+            statements(*kb, std::vector<int>({ 4 })));
+
+    PqlQuerySet query5 = kb->parse_query(
+            "assign a, a2; Select a pattern a(\"x\", _) and a2(_, \"a*b\")");
+    EXPECT_EQ(evaluator.evaluate(query5).conditions, 
+            statements(*kb, std::vector<int>({ 1, 5 })));
+
+    PqlQuerySet query6 = kb->parse_query(
+            "assign a; Select BOOLEAN pattern a(\"z\", \"a * b\")");
+    EXPECT_FALSE(evaluator.evaluate(query6).is_true);
+
+    PqlQuerySet query7 = kb->parse_query(
+            "assign a; Select BOOLEAN pattern a(\"z\", _\"c\"_)");
+    EXPECT_TRUE(evaluator.evaluate(query7).is_true);
+
+    EXPECT_THROW(kb->parse_query("while w; Select w pattern w(_, _)"),
+            PqlParserError);
+    EXPECT_THROW(kb->parse_query("assign a; Select a pattern a(_, \"a +\")"),
+            std::exception);
+    EXPECT_THROW(kb->parse_query("assign a; Select a pattern a(_, \"a b\")"),
+            PqlParserError);
+}
+
+}
+}
@@ -366,6 +366,22 @@ TEST(PqlParserTest, FullQueryTest) {
                 new SimplePqlVariableTerm("v")));
 
     EXPECT_EQ(result2.clauses, expected_clauses2);
+
+    // synonyms get slots in declaration order
+    std::vector<std::string> expected_names2;
+    expected_names2.push_back("s");
+    expected_names2.push_back("p");
+    expected_names2.push_back("v");
+    EXPECT_EQ(result2.qvar_names, expected_names2);
+
+    for(ClauseSet::iterator it = result2.clauses.begin();
+            it != result2.clauses.end(); ++it)
+    {
+        PqlVariableTerm *term = 
+            dynamic_cast<PqlVariableTerm*>((*it)->get_left_term());
+        ASSERT_TRUE(term != NULL);
+        EXPECT_EQ(term->get_slot(), (QVarSlot) 0);
+    }
 }
 
 
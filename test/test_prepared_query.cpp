@@ -0,0 +1,158 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/prepared_query.h"
+#include "impl/parser/pql_parser.h"
+#include "kb_fixture.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+using namespace simple::parser;
+
+static const char *PREPARED_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    y = x + 2;\n"
+    "    while y {\n"
+    "        x = y * 3;\n"
+    "        call p; } }\n"
+    "proc p {\n"
+    "    y = 3; }\n";
+
+class PreparedQueryTest : public KnowledgeBaseTest {
+  protected:
+    PreparedQueryTest() : KnowledgeBaseTest(PREPARED_PROGRAM) { }
+};
+
+TEST_F(PreparedQueryTest, ExecuteTest) {
+    std::shared_ptr<PreparedQuery> query = kb->prepare_query(
+            "stmt s; Select s such that Modifies(s, ?)");
+    ASSERT_EQ(1u, query->get_num_parameters());
+    EXPECT_EQ(PARAM_TERM, query->get_parameter_kind(0));
+
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+    std::vector<QueryParameter> x(1, QueryParameter("x"));
+    std::vector<QueryParameter> y(1, QueryParameter("y"));
+
+    EXPECT_EQ(statements({1, 3, 4}), 
+            query->execute(evaluator, x).conditions);
+    EXPECT_EQ(statements({2, 3, 5, 6}), 
+            query->execute(evaluator, y).conditions);
+    EXPECT_EQ(evaluate("stmt s; Select s such that Modifies(s, \"x\")")
+            .conditions, query->execute(evaluator, x).conditions);
+
+    PreparedStats stats = query->get_stats();
+    EXPECT_EQ(3u, stats.executions);
+    EXPECT_DOUBLE_EQ(2 * stats.prepare_ms - stats.bind_ms, 
+            stats.skipped_ms());
+    EXPECT_DOUBLE_EQ(0, PreparedStats().skipped_ms());
+
+    // a procedure name binds to the procedure
+    std::shared_ptr<PreparedQuery> calls = kb->prepare_query(
+            "procedure q; Select BOOLEAN such that Calls(q, ?)");
+    EXPECT_TRUE(calls->execute(evaluator, 
+                std::vector<QueryParameter>(1, QueryParameter("p"))).is_true);
+    EXPECT_FALSE(calls->execute(evaluator, 
+                std::vector<QueryParameter>(1, QueryParameter("main"))).is_true);
+}
+
+TEST_F(PreparedQueryTest, KindTest) {
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+
+    std::shared_ptr<PreparedQuery> follows = kb->prepare_query(
+            "stmt s; Select s such that Follows(?, s)");
+    EXPECT_EQ(statements({2}), follows->execute(evaluator, 
+                std::vector<QueryParameter>(1, QueryParameter(1))).conditions);
+    EXPECT_EQ(statements({3}), follows->execute(evaluator, 
+                std::vector<QueryParameter>(1, QueryParameter(2))).conditions);
+
+    std::shared_ptr<PreparedQuery> with = kb->prepare_query(
+            "assign a; constant c; variable v; Select a "
+            "such that Modifies(a, v) with v.varName = ? and c.value = ?");
+    ASSERT_EQ(2u, with->get_num_parameters());
+    EXPECT_EQ(PARAM_NAME, with->get_parameter_kind(0));
+    EXPECT_EQ(PARAM_VALUE, with->get_parameter_kind(1));
+
+    std::vector<QueryParameter> parameters;
+    parameters.push_back("y");
+    parameters.push_back(3);
+    EXPECT_EQ(statements({2, 6}), 
+            with->execute(evaluator, parameters).conditions);
+
+    std::shared_ptr<PreparedQuery> pattern = kb->prepare_query(
+            "assign a; Select a pattern a(?, _\"y\"_)");
+    EXPECT_EQ(PARAM_NAME, pattern->get_parameter_kind(0));
+    EXPECT_EQ(statements({4}), pattern->execute(evaluator, 
+                std::vector<QueryParameter>(1, QueryParameter("x"))).conditions);
+}
+
+TEST_F(PreparedQueryTest, BindTest) {
+    std::shared_ptr<PreparedQuery> query = kb->prepare_query(
+            "Select BOOLEAN such that Follows(?, ?)");
+
+    std::vector<QueryParameter> parameters;
+    parameters.push_back(1);
+    parameters.push_back(1);
+
+    // the bound query is rewritten
+    PqlQuerySet same = query->bind(parameters);
+    EXPECT_TRUE(same.is_unsatisfiable);
+
+    parameters[1] = 2;
+    PqlQuerySet next = query->bind(parameters);
+    EXPECT_FALSE(next.is_unsatisfiable);
+    EXPECT_TRUE(same.is_unsatisfiable);
+
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+    EXPECT_TRUE(evaluator.evaluate(next).is_true);
+    EXPECT_FALSE(evaluator.evaluate(same).is_true);
+}
+
+TEST_F(PreparedQueryTest, ErrorTest) {
+    std::shared_ptr<PreparedQuery> query = kb->prepare_query(
+            "stmt s; constant c; Select s such that Follows(?, s) "
+            "with c.value = ?");
+
+    std::vector<QueryParameter> parameters;
+    parameters.push_back(1);
+    EXPECT_THROW(query->bind(parameters), QueryParameterError);
+
+    parameters.push_back("x");
+    EXPECT_THROW(query->bind(parameters), QueryParameterError);
+
+    parameters[0] = 42;
+    parameters[1] = 3;
+    EXPECT_THROW(query->bind(parameters), QueryParameterError);
+
+    parameters[0] = 1;
+    EXPECT_NO_THROW(query->bind(parameters));
+
+    EXPECT_THROW(kb->parse_query("stmt s; Select s such that Follows(?, s)"),
+            PqlParserError);
+    EXPECT_THROW(kb->prepare_query("Select BOOLEAN with ? = ?"), 
+            PqlParserError);
+}
+
+} // namespace test
+} // namespace simple
@@ -24,10 +24,15 @@
 #include "impl/ast.h"
 #include "impl/linker.h"
 #include "impl/parser/pql_parser.h"
+#include "impl/parser/parser.h"
+#include "impl/parser/iterator_tokenizer.h"
 #include "impl/solvers/follows.h"
 #include "impl/solvers/modifies.h"
+#include "impl/solvers/next.h"
+#include "impl/solvers/inext.h"
 #include "impl/predicate.h"
 #include "impl/processor.h"
+#include "impl/thread_pool.h"
 
 namespace simple {
 namespace test {
@@ -35,6 +40,7 @@ namespace test {
 using namespace simple;
 using namespace simple::impl;
 using namespace simple::util;
+using namespace simple::parser;
 
 TEST(QueryProcessorTest, IntegratedTest) {
     /*
@@ -123,5 +129,177 @@ TEST(QueryProcessorTest, IntegratedTest) {
 
 
 
+TEST(QueryProcessorTest, ParallelJoinTest) {
+    /*
+     * proc test {
+     *   while i {
+     *     x0 = y; ... x99 = y;
+     *   }
+     *   z = 1;
+     * }
+     *
+     * Next*(s1, s2) has enough candidate pairs to be validated in
+     * parallel, and the result must match the sequential join.
+     */
+    std::string source = "proc test { \n   while i { \n";
+    for(int i = 0; i < 100; ++i) {
+        source += "       x" + std::to_string(i) + " = y; ";
+        source += (i == 99) ? "} \n" : "\n";
+    }
+    source += "   z = 1; } \n";
+
+    SimpleParser parser(new IteratorTokenizer<
+            std::string::iterator>(source.begin(), source.end()));
+    SimpleRoot ast = parser.parse_program();
+
+    std::shared_ptr<NextSolver> next_solver(new NextSolver(ast));
+    std::shared_ptr<QuerySolver> inext_solver(
+            new SimpleSolverGenerator<INextSolver>(
+                new INextSolver(ast, next_solver)));
+
+    std::shared_ptr<SimplePredicate> wildcard_pred(new SimpleWildCardPredicate(ast));
+    std::shared_ptr<SimplePredicate> statement_pred(new SimpleStatementPredicate(ast));
+
+    PredicateTable pred_table;
+    pred_table["s1"] = statement_pred;
+    pred_table["s2"] = statement_pred;
+
+    ClausePtr inext_clause(new SimplePqlClause(inext_solver,
+                new SimplePqlVariableTerm("s1"),
+                new SimplePqlVariableTerm("s2")));
+
+    std::shared_ptr<SimpleQueryLinker> sequential_linker(new SimpleQueryLinker());
+    QueryProcessor sequential(sequential_linker, pred_table, wildcard_pred);
+    sequential.solve_clause(inext_clause.get());
+
+    std::shared_ptr<SimpleQueryLinker> parallel_linker(new SimpleQueryLinker());
+    QueryProcessor parallel(parallel_linker, pred_table, wildcard_pred,
+            ThreadPoolPtr(new WorkStealingPool(4)));
+    parallel.solve_clause(inext_clause.get());
+
+    ConditionSet s1 = sequential_linker->get_conditions("s1");
+    EXPECT_EQ(s1.get_size(), (size_t) 101);
+    EXPECT_EQ(parallel_linker->get_conditions("s1"), s1);
+    EXPECT_EQ(parallel_linker->get_conditions("s2"), 
+            sequential_linker->get_conditions("s2"));
+
+    for(ConditionSet::iterator it = s1.begin(); it != s1.end(); ++it) {
+        EXPECT_EQ(parallel_linker->get_linked_conditions("s1", "s2", *it),
+                sequential_linker->get_linked_conditions("s1", "s2", *it));
+    }
+}
+
+/*
+ * Yields a fixed list of conditions from its cursors and counts how many
+ * of them have been pulled.
+ */
+class PullCountingSolver : public QuerySolver {
+  public:
+    class Cursor : public ConditionCursor {
+      public:
+        Cursor(PullCountingSolver *solver) : _solver(solver), _index(0) { }
+
+        bool next(ConditionPtr& condition) {
+            if(_index == _solver->results.size()) {
+                return false;
+            }
+
+            ++_solver->pulls;
+            condition = _solver->results[_index++];
+            return true;
+        }
+
+      private:
+        PullCountingSolver  *_solver;
+        size_t              _index;
+    };
+
+    PullCountingSolver() : results(), pulls(0) { }
+
+    ConditionSet solve_left(SimpleCondition *right) {
+        return solve_right(right);
+    }
+
+    ConditionSet solve_right(SimpleCondition *left) {
+        ConditionSet result;
+        for(size_t i = 0; i < results.size(); ++i) {
+            result.insert(results[i]);
+        }
+        pulls += results.size();
+        return result;
+    }
+
+    ConditionCursorPtr cursor_right(SimpleCondition *left) {
+        return ConditionCursorPtr(new Cursor(this));
+    }
+
+    ConditionCursorPtr cursor_left(SimpleCondition *right) {
+        return ConditionCursorPtr(new Cursor(this));
+    }
+
+    bool validate(SimpleCondition *left, SimpleCondition *right) {
+        return false;
+    }
+
+    std::vector<ConditionPtr>   results;
+    size_t                      pulls;
+};
+
+TEST(QueryProcessorTest, EarlyStopTest) {
+    std::string source = "proc test { x = 1; y = 2; z = 3; w = 4; }";
+    SimpleParser parser(new IteratorTokenizer<
+            std::string::iterator>(source.begin(), source.end()));
+    SimpleRoot ast = parser.parse_program();
+
+    PredicateTable pred_table;
+    pred_table["s"] = PredicatePtr(new SimpleStatementPredicate(ast));
+    PredicatePtr wildcard_pred(new SimpleWildCardPredicate(ast));
+
+    PullCountingSolver *counter = new PullCountingSolver();
+    std::shared_ptr<QuerySolver> solver(counter);
+
+    StatementAst *statement = ast.get_proc("test")->get_statement();
+    while(statement != NULL) {
+        counter->results.push_back(new SimpleStatementCondition(statement));
+        statement = statement->next();
+    }
+
+    ClausePtr clause(new SimplePqlClause(solver,
+                new SimplePqlConditionTerm(counter->results[0]),
+                new SimplePqlVariableTerm("s")));
+
+    // an existential qvar only needs a single result
+    std::shared_ptr<SimpleQueryLinker> linker1(new SimpleQueryLinker());
+    QueryProcessor processor1(linker1, pred_table, wildcard_pred);
+    processor1.set_existential("s");
+    processor1.solve_clause(clause.get());
+
+    EXPECT_EQ(1u, counter->pulls);
+    EXPECT_EQ(ConditionSet(counter->results[0]), linker1->get_conditions("s"));
+
+    // a restricted qvar needs no more results than it has conditions
+    counter->pulls = 0;
+    std::shared_ptr<SimpleQueryLinker> linker2(new SimpleQueryLinker());
+    QueryProcessor processor2(linker2, pred_table, wildcard_pred);
+
+    ConditionSet restricted;
+    restricted.insert(counter->results[0]);
+    restricted.insert(counter->results[1]);
+    processor2.set_qvar("s", restricted);
+    processor2.solve_clause(clause.get());
+
+    EXPECT_EQ(2u, counter->pulls);
+    EXPECT_EQ(restricted, linker2->get_conditions("s"));
+
+    // otherwise every result is needed
+    counter->pulls = 0;
+    std::shared_ptr<SimpleQueryLinker> linker3(new SimpleQueryLinker());
+    QueryProcessor processor3(linker3, pred_table, wildcard_pred);
+    processor3.solve_clause(clause.get());
+
+    EXPECT_EQ(4u, counter->pulls);
+    EXPECT_EQ(4u, linker3->get_conditions("s").get_size());
+}
+
 }
 }
@@ -0,0 +1,189 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/result_cache.h"
+#include "kb_fixture.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+static const char *CACHE_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    while x {\n"
+    "        y = x + 2;\n"
+    "        call p; }\n"
+    "    z = y * x; }\n"
+    "proc p {\n"
+    "    x = 2; }\n";
+
+class ResultCacheTest : public KnowledgeBaseTest {
+  protected:
+    ResultCacheTest() : KnowledgeBaseTest(CACHE_PROGRAM) { }
+
+    void SetUp() {
+        KnowledgeBaseTest::SetUp();
+        cache.reset(new QueryResultCache());
+    }
+
+    void configure(QueryEvaluator& evaluator) {
+        evaluator.set_solver_names(kb->get_solver_table());
+        evaluator.set_result_cache(cache, kb->get_generation());
+    }
+
+    std::string canonical(const std::string& query) {
+        PqlQuerySet query_set = kb->parse_query(query);
+        return canonical_query(query_set, solver_names());
+    }
+
+    std::map<QuerySolver*, std::string> solver_names() {
+        std::map<QuerySolver*, std::string> names;
+        const SolverTable& solvers = kb->get_solver_table();
+        for(SolverTable::const_iterator it = solvers.begin(); 
+                it != solvers.end(); ++it)
+        {
+            names[it->second.get()] = it->first;
+        }
+        return names;
+    }
+
+    std::shared_ptr<QueryResultCache> cache;
+};
+
+TEST_F(ResultCacheTest, CanonicalTest) {
+    std::string key = canonical(
+            "assign a; variable v; Select a such that Modifies(a, v) "
+            "and Uses(a, v)");
+    EXPECT_FALSE(key.empty());
+
+    // renamed synonyms and reordered clauses
+    EXPECT_EQ(key, canonical(
+            "variable var; assign assn; Select assn such that Uses(assn, var) "
+            "and Modifies(assn, var)"));
+
+    // different selector, relation or predicate
+    EXPECT_NE(key, canonical(
+            "assign a; variable v; Select v such that Modifies(a, v) "
+            "and Uses(a, v)"));
+    EXPECT_NE(key, canonical(
+            "assign a; variable v; Select a such that Modifies(a, v) "
+            "and Modifies(a, v)"));
+    EXPECT_NE(key, canonical(
+            "stmt a; variable v; Select a such that Modifies(a, v) "
+            "and Uses(a, v)"));
+
+    // the same shapes joined on different synonyms
+    EXPECT_NE(canonical(
+            "stmt s1, s2, s3; Select s1 such that Follows(s1, s2) "
+            "and Follows(s2, s3)"), 
+        canonical(
+            "stmt s1, s2, s3; Select s1 such that Follows(s2, s1) "
+            "and Follows(s1, s3)"));
+
+    // patterns are told apart by their expressions
+    EXPECT_EQ(canonical("assign a; Select a pattern a(_, _\"x\"_)"),
+            canonical("assign b; Select b pattern b(_, _\"x\"_)"));
+    EXPECT_NE(canonical("assign a; Select a pattern a(_, _\"x\"_)"),
+            canonical("assign a; Select a pattern a(_, _\"y\"_)"));
+    EXPECT_NE(canonical("assign a; Select a pattern a(_, \"x\")"),
+            canonical("assign a; Select a pattern a(_, _\"x\"_)"));
+}
+
+TEST_F(ResultCacheTest, HitTest) {
+    QueryResult result1 = evaluate(
+            "stmt s; variable v; Select s such that Parent(s, 4) "
+            "and Uses(s, v)");
+    EXPECT_EQ(0u, cache->get_stats().hits);
+    EXPECT_EQ(1u, cache->get_stats().misses);
+    EXPECT_EQ(1u, cache->get_num_entries());
+
+    QueryResult result2 = evaluate(
+            "variable x; stmt p; Select p such that Uses(p, x) "
+            "and Parent(p, 4)");
+    EXPECT_EQ(1u, cache->get_stats().hits);
+    EXPECT_EQ(result1.conditions, result2.conditions);
+
+    QueryResult result3 = evaluate(
+            "stmt s; variable v; Select s such that Parent(s, 3) "
+            "and Uses(s, v)");
+    EXPECT_EQ(1u, cache->get_stats().hits);
+    EXPECT_EQ(2u, cache->get_stats().misses);
+    EXPECT_EQ(2u, cache->get_num_entries());
+    EXPECT_EQ(result1.conditions, result3.conditions);
+}
+
+TEST_F(ResultCacheTest, EvictionTest) {
+    QueryResult result;
+    size_t size = QueryResultCache::estimate_size("key1", result);
+
+    QueryResultCache cache(2 * size);
+    cache.insert(1, "key1", result);
+    cache.insert(1, "key2", result);
+
+    // key1 becomes the most recently used entry
+    EXPECT_TRUE(cache.lookup(1, "key1", result));
+
+    cache.insert(1, "key3", result);
+    EXPECT_EQ(2u, cache.get_num_entries());
+    EXPECT_EQ(1u, cache.get_stats().evictions);
+    EXPECT_LE(cache.get_memory(), cache.get_budget());
+
+    EXPECT_TRUE(cache.lookup(1, "key1", result));
+    EXPECT_FALSE(cache.lookup(1, "key2", result));
+    EXPECT_TRUE(cache.lookup(1, "key3", result));
+
+    // too large to be cached at all
+    cache.set_budget(size / 2);
+    EXPECT_EQ(0u, cache.get_num_entries());
+    cache.insert(1, "key4", result);
+    EXPECT_FALSE(cache.lookup(1, "key4", result));
+}
+
+TEST_F(ResultCacheTest, InvalidationTest) {
+    evaluate("assign a; Select a such that Modifies(a, \"x\")");
+    EXPECT_EQ(1u, cache->get_num_entries());
+
+    // the same query on a new program
+    kb = create_knowledge_base(CACHE_PROGRAM);
+    QueryResult result = evaluate(
+            "assign a; Select a such that Modifies(a, \"x\")");
+    EXPECT_EQ(0u, cache->get_stats().hits);
+    EXPECT_EQ(1u, cache->get_stats().invalidations);
+    EXPECT_EQ(1u, cache->get_num_entries());
+
+    // results have to refer to the conditions of the new program
+    LineTable line_table = kb->get_line_table();
+    ConditionSet expected;
+    expected.insert(new SimpleStatementCondition(line_table[1]));
+    expected.insert(new SimpleStatementCondition(line_table[6]));
+    EXPECT_EQ(expected, result.conditions);
+
+    cache->invalidate();
+    EXPECT_EQ(0u, cache->get_num_entries());
+    EXPECT_EQ(0u, cache->get_memory());
+}
+
+} // namespace test
+} // namespace simple
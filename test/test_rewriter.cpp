@@ -0,0 +1,148 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "impl/query.h"
+#include "impl/rewriter.h"
+#include "kb_fixture.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+static const char *REWRITER_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    while x {\n"
+    "        y = x + 2;\n"
+    "        call p; }\n"
+    "    if y {\n"
+    "        z = y; } else {\n"
+    "        x = z; } }\n"
+    "proc p {\n"
+    "    x = 2; }\n";
+
+class RewriterTest : public KnowledgeBaseTest {
+  protected:
+    RewriterTest() : KnowledgeBaseTest(REWRITER_PROGRAM) { }
+};
+
+TEST_F(RewriterTest, UnsatisfiableTest) {
+    PqlQuerySet query1 = kb->parse_query(
+            "stmt s; Select s such that Follows(s, s)");
+    EXPECT_TRUE(query1.is_unsatisfiable);
+    EXPECT_TRUE(evaluate(query1).conditions.is_empty());
+
+    PqlQuerySet query2 = kb->parse_query(
+            "assign a; stmt s; Select BOOLEAN such that Parent(a, s)");
+    EXPECT_TRUE(query2.is_unsatisfiable);
+    EXPECT_FALSE(evaluate(query2).is_true);
+
+    PqlQuerySet query3 = kb->parse_query(
+            "stmt s1, s2; Select s1 such that Follows(s1, s2) and Parent*(s2, s1)");
+    EXPECT_FALSE(query3.is_unsatisfiable);
+
+    PqlQuerySet query4 = kb->parse_query(
+            "stmt s1, s2; Select s1 such that Follows(s1, s2) and Follows*(s2, s1)");
+    EXPECT_TRUE(query4.is_unsatisfiable);
+
+    PqlQuerySet query5 = kb->parse_query(
+            "Select BOOLEAN such that Parent*(2, 2)");
+    EXPECT_TRUE(query5.is_unsatisfiable);
+
+    PqlQuerySet query6 = kb->parse_query(
+            "variable v; Select v such that Modifies(v, _)");
+    EXPECT_TRUE(query6.is_unsatisfiable);
+
+    // Next* and Affects may relate a statement to itself
+    PqlQuerySet query7 = kb->parse_query(
+            "stmt s; Select s such that Next*(s, s)");
+    EXPECT_FALSE(query7.is_unsatisfiable);
+    EXPECT_EQ(evaluate(query7).conditions, statements({2, 3, 4}));
+
+    PqlQuerySet query8 = kb->parse_query(
+            "while w; Select w such that Parent(w, _)");
+    EXPECT_FALSE(query8.is_unsatisfiable);
+    EXPECT_EQ(evaluate(query8).conditions, statements({2}));
+}
+
+TEST_F(RewriterTest, ImpliedTest) {
+    PqlQuerySet query1 = kb->parse_query(
+            "stmt s1, s2; Select s1 such that Follows(s1, s2) and Follows*(s1, s2)");
+    ASSERT_EQ(query1.clauses.size(), (size_t) 1);
+    EXPECT_EQ(query1.clauses.begin()->get()->get_solver(),
+            kb->get_solver_table().at("follows").get());
+    EXPECT_EQ(evaluate(query1).conditions, statements({1, 2, 3}));
+
+    PqlQuerySet query2 = kb->parse_query(
+            "stmt s; Select s such that Follows(s, _) and Follows(s, 5)");
+    EXPECT_EQ(query2.clauses.size(), (size_t) 1);
+    EXPECT_EQ(evaluate(query2).conditions, statements({2}));
+
+    PqlQuerySet query3 = kb->parse_query(
+            "assign a; variable v; Select a such that Modifies(a, v) "
+            "pattern a(v, _)");
+    EXPECT_EQ(query3.clauses.size(), (size_t) 1);
+    EXPECT_EQ(evaluate(query3).conditions, statements({1, 3, 6, 7, 8}));
+
+    // Follows*(s, 5) does not imply Follows(s, 5)
+    PqlQuerySet query4 = kb->parse_query(
+            "stmt s; Select s such that Follows*(s, 5) and Follows(s, 5)");
+    EXPECT_EQ(query4.clauses.size(), (size_t) 1);
+
+    PqlQuerySet query5 = kb->parse_query(
+            "stmt s; Select s such that Follows*(s, 5) and Follows(s, _)");
+    EXPECT_EQ(query5.clauses.size(), (size_t) 2);
+    EXPECT_EQ(evaluate(query5).conditions, statements({1, 2}));
+}
+
+TEST_F(RewriterTest, WithTest) {
+    PqlQuerySet query1 = kb->parse_query(
+            "stmt s; assign a; Select s with s.stmt# = a.stmt# "
+            "and a.stmt# = s.stmt#");
+    EXPECT_EQ(query1.clauses.size(), (size_t) 1);
+    EXPECT_EQ(evaluate(query1).conditions, statements({1, 3, 6, 7, 8}));
+
+    PqlQuerySet query2 = kb->parse_query(
+            "while w; Select w with w.stmt# = w.stmt#");
+    EXPECT_EQ(query2.clauses.size(), (size_t) 0);
+    EXPECT_EQ(evaluate(query2).conditions, statements({2}));
+}
+
+TEST_F(RewriterTest, StatsTest) {
+    QueryRewriter rewriter = QueryRewriter::create_default(
+            kb->get_solver_table());
+
+    PqlQuerySet query = kb->parse_query(
+            "stmt s1, s2; Select s1 such that Follows(s1, s2)");
+    query.clauses.insert(ClausePtr(new SimplePqlClause(
+                    kb->get_solver_table().at("ifollows"),
+                    new SimplePqlVariableTerm("s1"),
+                    new SimplePqlWildcardTerm())));
+
+    RewriteStats stats = rewriter.rewrite(query);
+    EXPECT_EQ(stats.clauses_dropped, (size_t) 1);
+    EXPECT_EQ(stats.clauses_merged, (size_t) 0);
+    EXPECT_FALSE(stats.unsatisfiable);
+    EXPECT_EQ(query.clauses.size(), (size_t) 1);
+}
+
+} // namespace test
+} // namespace simple
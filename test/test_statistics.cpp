@@ -0,0 +1,140 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <string>
+#include "gtest/gtest.h"
+#include "impl/statistics.h"
+#include "kb_fixture.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+static const char *STATISTICS_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    call p;\n"
+    "    while x {\n"
+    "        y = x + 2; }\n"
+    "    z = y; }\n"
+    "proc p {\n"
+    "    x = 2; }\n";
+
+class StatisticsTest : public KnowledgeBaseTest {
+  protected:
+    StatisticsTest() : KnowledgeBaseTest(STATISTICS_PROGRAM) { }
+};
+
+TEST_F(StatisticsTest, RelationTest) {
+    const StatisticsCatalog& catalog = kb->get_statistics();
+
+    const RelationStatistics& follows = catalog.get_relation("follows");
+    EXPECT_EQ(follows.pair_count, (size_t) 3);
+    EXPECT_EQ(follows.distinct_left, (size_t) 3);
+    EXPECT_EQ(follows.distinct_right, (size_t) 3);
+    EXPECT_EQ(follows.left_degrees.size(), (size_t) 1);
+    EXPECT_EQ(follows.left_degrees.at(1), (size_t) 3);
+
+    const RelationStatistics& ifollows = catalog.get_relation("ifollows");
+    EXPECT_EQ(ifollows.pair_count, (size_t) 6);
+    EXPECT_EQ(ifollows.max_left_degree(), (size_t) 3);
+    EXPECT_EQ(ifollows.max_right_degree(), (size_t) 3);
+    EXPECT_EQ(ifollows.left_degrees.at(2), (size_t) 1);
+    EXPECT_DOUBLE_EQ(ifollows.average_left_degree(), 2);
+
+    const RelationStatistics& modifies = catalog.get_relation("modifies");
+    EXPECT_EQ(modifies.pair_count, (size_t) 10);
+    EXPECT_EQ(modifies.distinct_left, (size_t) 8);
+    EXPECT_EQ(modifies.distinct_right, (size_t) 3);
+    EXPECT_EQ(modifies.right_degrees.at(5), (size_t) 1);
+    EXPECT_EQ(modifies.max_left_degree(), (size_t) 3);
+
+    EXPECT_EQ(catalog.get_relation("calls").pair_count, (size_t) 1);
+    EXPECT_EQ(catalog.get_relation("parent").pair_count, (size_t) 1);
+
+    EXPECT_TRUE(catalog.has_relation("affectsbip"));
+    EXPECT_EQ(catalog.get_relation_names().size(), 
+            kb->get_solver_table().size());
+
+    EXPECT_FALSE(catalog.has_relation("sibling"));
+    EXPECT_THROW(catalog.get_relation("sibling"), StatisticsError);
+}
+
+TEST_F(StatisticsTest, IndexTest) {
+    const StatisticsCatalog& catalog = kb->get_statistics();
+    const char *names[] = { 
+        "follows", "parent", "modifies", "uses", "calls", "icalls" };
+
+    // the relations counted from an index agree with solving them
+    for(size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+        RelationStatistics expected = collect_relation_statistics(
+                kb->get_solver_table().at(names[i]).get(), 
+                kb->get_condition_pool());
+        const RelationStatistics& actual = catalog.get_relation(names[i]);
+
+        EXPECT_EQ(expected.pair_count, actual.pair_count) << names[i];
+        EXPECT_EQ(expected.distinct_left, actual.distinct_left) << names[i];
+        EXPECT_EQ(expected.distinct_right, actual.distinct_right) << names[i];
+        EXPECT_EQ(expected.left_degrees, actual.left_degrees) << names[i];
+        EXPECT_EQ(expected.right_degrees, actual.right_degrees) << names[i];
+    }
+}
+
+TEST_F(StatisticsTest, DomainTest) {
+    const StatisticsCatalog& catalog = kb->get_statistics();
+
+    EXPECT_EQ(catalog.get_domain_size("procedure"), (size_t) 2);
+    EXPECT_EQ(catalog.get_domain_size("statement"), (size_t) 6);
+    EXPECT_EQ(catalog.get_domain_size("assignment"), (size_t) 4);
+    EXPECT_EQ(catalog.get_domain_size("while"), (size_t) 1);
+    EXPECT_EQ(catalog.get_domain_size("call"), (size_t) 1);
+    EXPECT_EQ(catalog.get_domain_size("variable"), (size_t) 3);
+    EXPECT_EQ(catalog.get_domain_size("constant"), (size_t) 2);
+    EXPECT_THROW(catalog.get_domain_size("stmtLst"), StatisticsError);
+
+    EXPECT_EQ(catalog.get_call_depth(), (size_t) 2);
+}
+
+TEST_F(StatisticsTest, JsonTest) {
+    std::string json = kb->get_statistics().to_json();
+
+    EXPECT_EQ(json.find("{\"call_depth\": 2, \"relations\": {"), (size_t) 0);
+    EXPECT_NE(json.find("\"follows\": {\"pairs\": 3, \"distinct_left\": 3, "
+                "\"distinct_right\": 3"), std::string::npos);
+    EXPECT_NE(json.find("\"left_degrees\": {\"1\": 1, \"2\": 1, \"3\": 1}"),
+            std::string::npos);
+    EXPECT_NE(json.find("\"domains\": {\"assignment\": 4, "), std::string::npos);
+}
+
+TEST_F(StatisticsTest, ExistenceTest) {
+    const StatisticsCatalog& catalog = kb->get_statistics();
+    const SolverTable& solvers = kb->get_solver_table();
+
+    for(SolverTable::const_iterator it = solvers.begin(); 
+            it != solvers.end(); ++it)
+    {
+        EXPECT_EQ(it->second->has_any(), 
+                catalog.get_relation(it->first).pair_count > 0) << it->first;
+    }
+}
+
+} // namespace test
+} // namespace simple
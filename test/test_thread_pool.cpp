@@ -0,0 +1,131 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/thread_pool.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+class CountingTask : public ThreadPoolTask {
+  public:
+    CountingTask(std::atomic<int> *counter) : _counter(counter) { }
+
+    void run() {
+        ++(*_counter);
+    }
+
+  private:
+    std::atomic<int> *_counter;
+};
+
+class FailingTask : public ThreadPoolTask {
+  public:
+    void run() {
+        throw std::runtime_error("task failed");
+    }
+};
+
+class NestedTask : public ThreadPoolTask {
+  public:
+    NestedTask(WorkStealingPool *pool, std::atomic<int> *counter) :
+        _pool(pool), _counter(counter)
+    { }
+
+    void run() {
+        CountingTask task1(_counter);
+        CountingTask task2(_counter);
+
+        std::vector<ThreadPoolTask*> tasks;
+        tasks.push_back(&task1);
+        tasks.push_back(&task2);
+
+        _pool->run_all(tasks);
+    }
+
+  private:
+    WorkStealingPool *_pool;
+    std::atomic<int> *_counter;
+};
+
+TEST(ThreadPoolTest, RunAllTest) {
+    WorkStealingPool pool(4);
+    EXPECT_EQ(pool.get_num_workers(), (size_t) 4);
+
+    std::atomic<int> counter(0);
+    std::vector<std::unique_ptr<CountingTask> > owned;
+    std::vector<ThreadPoolTask*> tasks;
+
+    for(int i = 0; i < 1000; ++i) {
+        owned.push_back(std::unique_ptr<CountingTask>(new CountingTask(&counter)));
+        tasks.push_back(owned.back().get());
+    }
+
+    pool.run_all(tasks);
+    EXPECT_EQ(counter.load(), 1000);
+
+    pool.run_all(tasks);
+    EXPECT_EQ(counter.load(), 2000);
+
+    pool.run_all(std::vector<ThreadPoolTask*>());
+    EXPECT_EQ(counter.load(), 2000);
+}
+
+TEST(ThreadPoolTest, ExceptionTest) {
+    WorkStealingPool pool(2);
+
+    std::atomic<int> counter(0);
+    CountingTask task1(&counter);
+    FailingTask task2;
+    CountingTask task3(&counter);
+
+    std::vector<ThreadPoolTask*> tasks;
+    tasks.push_back(&task1);
+    tasks.push_back(&task2);
+    tasks.push_back(&task3);
+
+    EXPECT_THROW(pool.run_all(tasks), std::runtime_error);
+
+    // the rest of the batch still runs to completion
+    EXPECT_EQ(counter.load(), 2);
+}
+
+TEST(ThreadPoolTest, NestedTest) {
+    WorkStealingPool pool(1);
+
+    std::atomic<int> counter(0);
+    NestedTask task1(&pool, &counter);
+    NestedTask task2(&pool, &counter);
+
+    std::vector<ThreadPoolTask*> tasks;
+    tasks.push_back(&task1);
+    tasks.push_back(&task2);
+
+    pool.run_all(tasks);
+    EXPECT_EQ(counter.load(), 4);
+}
+
+}
+}
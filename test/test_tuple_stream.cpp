@@ -0,0 +1,235 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/ast.h"
+#include "impl/condition.h"
+#include "impl/evaluator.h"
+#include "impl/knowledge_base.h"
+#include "impl/linker.h"
+#include "impl/parser/pql_parser.h"
+#include "impl/tuple_stream.h"
+#include "simple/util/query_utils.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+using namespace simple::parser;
+using namespace simple::util;
+
+static const char *TUPLE_PROGRAM =
+    "proc main {\n"
+    "    x = 1;\n"
+    "    y = x + 2;\n"
+    "    call helper;\n"
+    "    while y {\n"
+    "        x = y; } }\n"
+    "proc helper {\n"
+    "    z = x; }\n";
+
+/*
+ * Counts the rows and remembers only the last one, the way a writer
+ * that streams to a file would.
+ */
+class CountingTupleWriter : public TupleWriter {
+  public:
+    CountingTupleWriter() : count(0), last_row() { }
+
+    void write_row(const std::vector<ConditionPtr>& row) {
+        ++count;
+        last_row = row;
+    }
+
+    size_t count;
+    std::vector<ConditionPtr> last_row;
+};
+
+static std::string stream_query(SimpleKnowledgeBase& kb, 
+        const std::string& query, size_t& count)
+{
+    QueryEvaluator evaluator(kb.get_wildcard_predicate());
+    PqlQuerySet query_set = kb.parse_query(query);
+
+    std::stringstream out;
+    StreamTupleWriter writer(out);
+    QueryResult result = evaluator.evaluate(query_set, &writer);
+
+    EXPECT_TRUE(result.tuples.empty());
+    count = result.tuple_count;
+
+    // statements and procedures are ordered by node, not by line or name
+    std::vector<std::string> lines;
+    std::string line;
+    while(std::getline(out, line)) {
+        lines.push_back(line);
+    }
+    std::sort(lines.begin(), lines.end());
+
+    std::string sorted;
+    for(size_t i = 0; i < lines.size(); ++i) {
+        sorted += lines[i] + "\n";
+    }
+    return sorted;
+}
+
+TEST(TupleStreamTest, ParserTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(TUPLE_PROGRAM);
+
+    PqlQuerySet query = kb->parse_query(
+            "assign a; variable v; Select <a, v> such that Modifies(a, v)");
+    PqlTupleSelector *selector = 
+        selector_cast<PqlTupleSelector>(query.selector.get());
+
+    ASSERT_TRUE(selector != NULL);
+    EXPECT_EQ(selector->get_tuples(), 
+            std::vector<std::string>({ "a", "v" }));
+
+    EXPECT_THROW(kb->parse_query("assign a; Select <a, b>"), PqlParserError);
+    EXPECT_THROW(kb->parse_query("assign a; Select <a b>"), std::exception);
+}
+
+TEST(TupleStreamTest, StreamTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(TUPLE_PROGRAM);
+    size_t count;
+
+    EXPECT_EQ(stream_query(*kb, 
+                "assign a; variable v; Select <a, v> such that Modifies(a, v)",
+                count),
+            "1 x\n2 y\n5 x\n6 z\n");
+    EXPECT_EQ(count, (size_t) 4);
+
+    EXPECT_EQ(stream_query(*kb, 
+                "call c; procedure p; Select <c, p, c> "
+                "with c.procName = p.procName",
+                count),
+            "3 helper 3\n");
+    EXPECT_EQ(count, (size_t) 1);
+
+    // unrelated variables give the cross product
+    EXPECT_EQ(stream_query(*kb, 
+                "procedure p; while w; Select <w, p>", count),
+            "4 helper\n4 main\n");
+    EXPECT_EQ(count, (size_t) 2);
+
+    EXPECT_EQ(stream_query(*kb, 
+                "assign a; variable v; Select <a, v> such that Uses(a, v) "
+                "with v.varName = \"w\"", count),
+            "");
+    EXPECT_EQ(count, (size_t) 0);
+}
+
+TEST(TupleStreamTest, ResultTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(TUPLE_PROGRAM);
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+
+    // without a writer the rows are collected in the result
+    PqlQuerySet query = kb->parse_query(
+            "assign a; variable v; Select <a, v> such that Uses(a, v)");
+    QueryResult result = evaluator.evaluate(query);
+
+    EXPECT_TRUE(result.is_true);
+    EXPECT_EQ(result.tuple_count, (size_t) 3);
+    EXPECT_EQ(result.tuples.size(), (size_t) 3);
+
+    CountingTupleWriter writer;
+    QueryResult streamed = evaluator.evaluate(query, &writer);
+
+    EXPECT_TRUE(streamed.is_true);
+    EXPECT_EQ(writer.count, (size_t) 3);
+    ASSERT_EQ(writer.last_row.size(), (size_t) 2);
+    EXPECT_EQ(result.tuples.count(ConditionTuplePtr(new SimpleConditionTuple(
+                        writer.last_row[0], 
+                        new SimpleConditionTuple(writer.last_row[1])))), 
+            (size_t) 1);
+}
+
+TEST(TupleStreamTest, LinkerTest) {
+    SimpleAssignmentAst stat1, stat2, stat3;
+
+    ConditionPtr condition11(new SimpleStatementCondition(&stat1));
+    ConditionPtr condition12(new SimpleStatementCondition(&stat2));
+    ConditionPtr condition13(new SimpleStatementCondition(&stat3));
+    ConditionPtr condition21(new SimpleVariableCondition(SimpleVariable("a")));
+    ConditionPtr condition22(new SimpleVariableCondition(SimpleVariable("b")));
+    ConditionPtr condition31(new SimpleConstantCondition(SimpleConstant(1)));
+    ConditionPtr condition32(new SimpleConstantCondition(SimpleConstant(2)));
+
+    ConditionSet x, y, z;
+    x.insert(condition11);
+    x.insert(condition12);
+    x.insert(condition13);
+    y.insert(condition21);
+    y.insert(condition22);
+    z.insert(condition31);
+    z.insert(condition32);
+
+    SimpleQueryLinker linker;
+    linker.update_results("x", x);
+    linker.update_results("y", y);
+    linker.update_results("z", z);
+
+    std::vector<ConditionPair> links_xy;
+    links_xy.push_back(ConditionPair(condition11, condition21));
+    links_xy.push_back(ConditionPair(condition12, condition21));
+    links_xy.push_back(ConditionPair(condition13, condition22));
+    linker.update_links("x", "y", links_xy);
+
+    std::vector<ConditionPair> links_yz;
+    links_yz.push_back(ConditionPair(condition21, condition31));
+    links_yz.push_back(ConditionPair(condition22, condition32));
+    linker.update_links("y", "z", links_yz);
+
+    std::vector<ConditionPair> links_xz;
+    links_xz.push_back(ConditionPair(condition11, condition31));
+    links_xz.push_back(ConditionPair(condition13, condition32));
+    linker.update_links("x", "z", links_xz);
+
+    // (stat2, a) has no link to a constant in z any more
+    EXPECT_FALSE(linker.get_conditions("x").has_element(condition12));
+
+    std::vector<std::string> xyz({ "x", "y", "z" });
+
+    TupleList tuples;
+    TupleListWriter list_writer(tuples);
+    EXPECT_EQ(TupleProducer(&linker, xyz).produce(&list_writer), (size_t) 2);
+    EXPECT_EQ(tuples, linker.make_tuples(xyz));
+
+    // z is linked to x as well as to y
+    CountingTupleWriter writer;
+    EXPECT_EQ(TupleProducer(&linker, 
+                std::vector<std::string>({ "y", "x", "z" })).produce(&writer), 
+            (size_t) 2);
+
+    // a repeated variable is bound once
+    EXPECT_EQ(TupleProducer(&linker, 
+                std::vector<std::string>({ "y", "y" })).produce(&writer), 
+            (size_t) 2);
+    EXPECT_EQ(writer.last_row[0], writer.last_row[1]);
+}
+
+}
+}
@@ -0,0 +1,235 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/attribute_index.h"
+#include "impl/condition.h"
+#include "impl/evaluator.h"
+#include "impl/knowledge_base.h"
+#include "impl/parser/pql_parser.h"
+#include "impl/profiler.h"
+#include "impl/solvers/memoized.h"
+#include "impl/solvers/with.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+using namespace simple::parser;
+
+static const char *WITH_PROGRAM =
+    "proc main {\n"
+    "    x = 2 + y;\n"
+    "    call helper;\n"
+    "    while x {\n"
+    "        z = x + 5;\n"
+    "        call x; } }\n"
+    "proc helper {\n"
+    "    y = 3; }\n"
+    "proc x {\n"
+    "    helper = 2; }\n";
+
+static ConditionSet statements(SimpleKnowledgeBase& kb, 
+        const std::vector<int>& lines) 
+{
+    LineTable line_table = kb.get_line_table();
+
+    ConditionSet result;
+    for(size_t i = 0; i < lines.size(); ++i) {
+        result.insert(new SimpleStatementCondition(line_table[lines[i]]));
+    }
+    return result;
+}
+
+static ConditionSet procs(SimpleKnowledgeBase& kb, 
+        const std::vector<std::string>& names)
+{
+    ConditionSet result;
+    for(size_t i = 0; i < names.size(); ++i) {
+        result.insert(new SimpleProcCondition(kb.get_ast().get_proc(names[i])));
+    }
+    return result;
+}
+
+TEST(WithTest, ConstantConditionTest) {
+    ConditionSet constants;
+    constants.insert(new SimpleConstantCondition(SimpleConstant(2)));
+    constants.insert(new SimpleConstantCondition(SimpleConstant(5)));
+    constants.insert(new SimpleConstantCondition(SimpleConstant(2)));
+    constants.insert(new SimpleVariableCondition(SimpleVariable("x")));
+
+    EXPECT_EQ(constants.get_size(), (size_t) 3);
+    EXPECT_TRUE(constants.has_element(
+                new SimpleConstantCondition(SimpleConstant(5))));
+    EXPECT_FALSE(constants.has_element(
+                new SimpleConstantCondition(SimpleConstant(3))));
+}
+
+TEST(WithTest, IndexTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(WITH_PROGRAM);
+    AttributeIndex index(kb->get_ast());
+    LineTable line_table = kb->get_line_table();
+
+    ConditionSet helper_procs;
+    helper_procs.insert(new SimpleProcCondition(
+                kb->get_ast().get_proc("helper")));
+    helper_procs.insert(new SimpleStatementCondition(line_table[2]));
+    EXPECT_EQ(index.lookup(ATTR_PROC_NAME, "helper"), helper_procs);
+
+    EXPECT_EQ(index.lookup(ATTR_STMT_NO, "4"), 
+            statements(*kb, std::vector<int>({ 4 })));
+    EXPECT_EQ(index.lookup(ATTR_VALUE, "2"), ConditionSet(
+                new SimpleConstantCondition(SimpleConstant(2))));
+    EXPECT_EQ(index.lookup(ATTR_VAR_NAME, "z"), ConditionSet(
+                new SimpleVariableCondition(SimpleVariable("z"))));
+
+    EXPECT_TRUE(index.lookup(ATTR_VALUE, "4").is_empty());
+    EXPECT_TRUE(index.lookup(ATTR_VAR_NAME, "main").is_empty());
+    EXPECT_TRUE(index.lookup(ATTR_STMT_NO, "8").is_empty());
+
+    std::string key;
+    SimpleStatementCondition call(line_table[5]);
+    EXPECT_TRUE(index.get_attribute(ATTR_PROC_NAME, &call, key));
+    EXPECT_EQ(key, "x");
+    EXPECT_TRUE(index.get_attribute(ATTR_STMT_NO, &call, key));
+    EXPECT_EQ(key, "5");
+
+    SimpleStatementCondition assign(line_table[1]);
+    EXPECT_FALSE(index.get_attribute(ATTR_PROC_NAME, &assign, key));
+    EXPECT_FALSE(index.get_attribute(ATTR_VALUE, &assign, key));
+}
+
+TEST(WithTest, SolverTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(WITH_PROGRAM);
+    WithSolver solver(kb->get_attribute_index(), ATTR_STMT_NO, ATTR_VALUE);
+    LineTable line_table = kb->get_line_table();
+
+    SimpleStatementCondition statement(line_table[5]);
+    SimpleConstantCondition five(SimpleConstant(5));
+    SimpleConstantCondition three(SimpleConstant(3));
+
+    EXPECT_TRUE(solver.validate(&statement, &five));
+    EXPECT_FALSE(solver.validate(&statement, &three));
+    EXPECT_FALSE(solver.validate(&five, &statement));
+
+    EXPECT_EQ(solver.solve_right(&statement), ConditionSet(
+                new SimpleConstantCondition(SimpleConstant(5))));
+    EXPECT_EQ(solver.solve_left(&three), 
+            statements(*kb, std::vector<int>({ 3 })));
+    EXPECT_TRUE(solver.solve_right(
+                new SimpleStatementCondition(line_table[1])).is_empty());
+}
+
+TEST(WithTest, KeyedTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(WITH_PROGRAM);
+    std::shared_ptr<QuerySolver> solver(new WithSolver(
+                kb->get_attribute_index(), ATTR_STMT_NO, ATTR_VALUE));
+
+    // wrappers hand out the keyed solver they wrap
+    CountingSolver counting(solver.get());
+    MemoizedSolver memoized(solver, kb->get_condition_pool());
+    EXPECT_EQ(solver->as_keyed(), counting.as_keyed());
+    EXPECT_EQ(solver->as_keyed(), memoized.as_keyed());
+    EXPECT_TRUE(kb->get_solver_table().at("follows")->as_keyed() == NULL);
+
+    // so profiling still joins with clauses by their keys
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+    evaluator.set_profiling(true);
+
+    PqlQuerySet query = kb->parse_query(
+            "stmt s; constant c; Select s with s.stmt# = c.value");
+    QueryResult result = evaluator.evaluate(query);
+    EXPECT_EQ(result.conditions, 
+            statements(*kb, std::vector<int>({ 2, 3, 5 })));
+    EXPECT_NE(result.profile.find("\"validate\": 0, "), std::string::npos);
+}
+
+TEST(WithTest, QueryTest) {
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(WITH_PROGRAM);
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+
+    PqlQuerySet query1 = kb->parse_query(
+            "procedure p; variable v; Select p with p.procName = v.varName");
+    EXPECT_EQ(evaluator.evaluate(query1).conditions, 
+            procs(*kb, std::vector<std::string>({ "helper", "x" })));
+
+    PqlQuerySet query2 = kb->parse_query(
+            "stmt s; constant c; Select s with s.stmt# = c.value");
+    EXPECT_EQ(evaluator.evaluate(query2).conditions, 
+            statements(*kb, std::vector<int>({ 2, 3, 5 })));
+
+    PqlQuerySet query3 = kb->parse_query(
+            "constant c; Select c with c.value = 5");
+    EXPECT_EQ(evaluator.evaluate(query3).conditions, ConditionSet(
+                new SimpleConstantCondition(SimpleConstant(5))));
+
+    PqlQuerySet query4 = kb->parse_query(
+            "call c; Select c with c.procName = \"helper\"");
+    EXPECT_EQ(evaluator.evaluate(query4).conditions, 
+            statements(*kb, std::vector<int>({ 2 })));
+
+    PqlQuerySet query5 = kb->parse_query(
+            "call c; procedure p; Select c with c.procName = p.procName");
+    EXPECT_EQ(evaluator.evaluate(query5).conditions, 
+            statements(*kb, std::vector<int>({ 2, 5 })));
+
+    PqlQuerySet query6 = kb->parse_query(
+            "prog_line n; Select n with n = 6");
+    EXPECT_EQ(evaluator.evaluate(query6).conditions, 
+            statements(*kb, std::vector<int>({ 6 })));
+
+    PqlQuerySet query7 = kb->parse_query(
+            "assign a; variable v; Select a such that Modifies(a, v) "
+            "with v.varName = \"y\"");
+    EXPECT_EQ(evaluator.evaluate(query7).conditions, 
+            statements(*kb, std::vector<int>({ 6 })));
+
+    PqlQuerySet query8 = kb->parse_query(
+            "stmt s; constant c; Select s with s.stmt# = c.value "
+            "and c.value = 5");
+    EXPECT_EQ(evaluator.evaluate(query8).conditions, 
+            statements(*kb, std::vector<int>({ 5 })));
+
+    PqlQuerySet query9 = kb->parse_query("Select BOOLEAN with 3 = 3");
+    EXPECT_TRUE(evaluator.evaluate(query9).is_true);
+
+    PqlQuerySet query10 = kb->parse_query(
+            "Select BOOLEAN with \"x\" = \"y\"");
+    EXPECT_FALSE(evaluator.evaluate(query10).is_true);
+
+    EXPECT_THROW(kb->parse_query(
+                "procedure p; Select p with p.varName = \"x\""),
+            PqlParserError);
+    EXPECT_THROW(kb->parse_query(
+                "procedure p; constant c; Select p with p.procName = c.value"),
+            PqlParserError);
+    EXPECT_THROW(kb->parse_query("variable v; Select v with v = 1"),
+            PqlParserError);
+    EXPECT_THROW(kb->parse_query("stmt s; Select s with s.stmt = 1"),
+            std::exception);
+}
+
+}
+}
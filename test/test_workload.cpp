@@ -0,0 +1,110 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "impl/knowledge_base.h"
+#include "impl/evaluator.h"
+#include "test/workload.h"
+
+namespace simple {
+namespace test {
+
+using namespace simple;
+using namespace simple::impl;
+
+TEST(WorkloadTest, ProgramTest) {
+    WorkloadParams params;
+    params.num_procs = 6;
+    params.statements_per_proc = 40;
+    params.max_nesting_depth = 3;
+    params.container_ratio = 0.3;
+
+    WorkloadGenerator generator(params);
+    std::string program = generator.generate_program();
+
+    EXPECT_EQ(generator.get_num_statements(), 240);
+
+    // the same parameters always give the same program
+    WorkloadGenerator generator2(params);
+    EXPECT_EQ(generator2.generate_program(), program);
+
+    params.seed += 1;
+    WorkloadGenerator generator3(params);
+    EXPECT_NE(generator3.generate_program(), program);
+
+    std::shared_ptr<SimpleKnowledgeBase> kb = create_knowledge_base(program);
+
+    // statements are numbered 1 to N in program order
+    const LineTable& lines = kb->get_line_table();
+    EXPECT_EQ(lines.size(), (size_t) 240);
+    EXPECT_EQ(lines.begin()->first, 1);
+    EXPECT_EQ(lines.rbegin()->first, 240);
+
+    for(int i = 0; i < params.num_procs; ++i) {
+        EXPECT_TRUE(kb->get_ast().get_proc(generator.proc_name(i)) != NULL);
+    }
+}
+
+TEST(WorkloadTest, QueryTest) {
+    WorkloadParams params;
+    params.num_procs = 5;
+    params.statements_per_proc = 30;
+
+    WorkloadGenerator generator(params);
+    std::shared_ptr<SimpleKnowledgeBase> kb = 
+        create_knowledge_base(generator.generate_program());
+
+    std::vector<std::string> queries = generator.generate_queries();
+    EXPECT_EQ(queries.size(), (size_t) params.num_queries);
+
+    // every relation appears in the mix
+    const std::vector<std::string>& relations = 
+        WorkloadGenerator::relation_names();
+    for(std::vector<std::string>::const_iterator it = relations.begin();
+            it != relations.end(); ++it)
+    {
+        bool found = false;
+        for(size_t i = 0; i < queries.size(); ++i) {
+            if(queries[i].find(" " + *it + "(") != std::string::npos) {
+                found = true;
+            }
+        }
+        EXPECT_TRUE(found) << *it;
+    }
+
+    QueryEvaluator evaluator(kb->get_wildcard_predicate());
+    int num_true = 0;
+
+    for(size_t i = 0; i < queries.size(); ++i) {
+        PqlQuerySet query = kb->parse_query(queries[i]);
+        QueryResult result = evaluator.evaluate(query);
+
+        EXPECT_EQ(result.status, QUERY_OK) << queries[i];
+        if(result.is_true) {
+            ++num_true;
+        }
+    }
+
+    // a query mix where nothing matches would not measure much
+    EXPECT_GT(num_true, (int) queries.size() / 4);
+}
+
+}
+}
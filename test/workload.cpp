@@ -0,0 +1,437 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include "test/workload.h"
+
+namespace simple {
+namespace test {
+
+/*
+ * Clause forms in the query mix. The first nine follow the
+ * solve_clause() specializations of the query processor, the last one
+ * chains two clauses over a shared synonym.
+ */
+enum ClauseForm {
+    FORM_SYN_SYN,
+    FORM_SYN_LIT,
+    FORM_LIT_SYN,
+    FORM_SYN_WILD,
+    FORM_WILD_SYN,
+    FORM_LIT_LIT,
+    FORM_LIT_WILD,
+    FORM_WILD_LIT,
+    FORM_WILD_WILD,
+    FORM_CHAIN,
+    NUM_FORMS
+};
+
+static const char *FORM_NAMES[NUM_FORMS] = {
+    "syn-syn", "syn-lit", "lit-syn", "syn-wild", "wild-syn",
+    "lit-lit", "lit-wild", "wild-lit", "wild-wild", "chain"
+};
+
+// largest body of a single container, before nesting
+const int MAX_CONTAINER_BODY = 10;
+
+WorkloadParams::WorkloadParams() :
+    seed(3201), 
+    num_procs(10), 
+    statements_per_proc(100),
+    max_nesting_depth(3),
+    container_ratio(0.2), 
+    while_ratio(0.5),
+    num_variables(50),
+    call_fan_out(2),
+    call_depth(3),
+    num_queries(100)
+{ }
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadParams& params) :
+    _params(params), _rng(params.seed), _line(0), 
+    _pending_calls(0), _pending_budget(0),
+    _proc_levels(), _statements()
+{ 
+    if(_params.num_procs < 1) {
+        _params.num_procs = 1;
+    }
+    if(_params.statements_per_proc < 1) {
+        _params.statements_per_proc = 1;
+    }
+    if(_params.num_variables < 1) {
+        _params.num_variables = 1;
+    }
+    if(_params.call_depth < 1) {
+        _params.call_depth = 1;
+    }
+}
+
+const std::vector<std::string>& WorkloadGenerator::relation_names() {
+    static std::vector<std::string> names;
+
+    if(names.empty()) {
+        names.push_back("Follows");
+        names.push_back("Follows*");
+        names.push_back("Parent");
+        names.push_back("Parent*");
+        names.push_back("Modifies");
+        names.push_back("Uses");
+        names.push_back("Calls");
+        names.push_back("Calls*");
+        names.push_back("Next");
+        names.push_back("Next*");
+    }
+
+    return names;
+}
+
+std::string WorkloadGenerator::generate_program() {
+    _rng.seed(_params.seed);
+    _line = 0;
+    _statements.clear();
+    _proc_levels.clear();
+
+    // Split the procedures into call levels. A procedure only calls 
+    // procedures of deeper levels, so the call graph is acyclic and at
+    // most call_depth levels deep.
+    for(int i = 0; i < _params.num_procs; ++i) {
+        _proc_levels.push_back((int) ((long) i * _params.call_depth / 
+                    _params.num_procs));
+    }
+
+    std::vector<std::string> lines;
+    for(int i = 0; i < _params.num_procs; ++i) {
+        generate_proc(i, lines);
+    }
+
+    std::string program;
+    for(std::vector<std::string>::iterator it = lines.begin();
+            it != lines.end(); ++it)
+    {
+        program += *it;
+        program += " \n";
+    }
+    return program;
+}
+
+void WorkloadGenerator::generate_proc(int index, std::vector<std::string>& lines) {
+    bool has_callee = false;
+    for(int i = index + 1; i < _params.num_procs; ++i) {
+        if(_proc_levels[i] > _proc_levels[index]) {
+            has_callee = true;
+            break;
+        }
+    }
+
+    _pending_calls = has_callee ? _params.call_fan_out : 0;
+    _pending_budget = _params.statements_per_proc;
+
+    lines.push_back("proc " + proc_name(index) + " {");
+    generate_statement_list(index, _params.statements_per_proc, 1, lines);
+    lines.back() += " }";
+}
+
+void WorkloadGenerator::generate_statement_list(int proc, int budget, int depth,
+        std::vector<std::string>& lines)
+{
+    while(budget > 0) {
+        int line = ++_line;
+        --_pending_budget;
+        --budget;
+
+        bool can_nest = depth <= _params.max_nesting_depth && budget >= 2;
+
+        if(can_nest && random_bool(_params.container_ratio)) {
+            int max_body = budget < MAX_CONTAINER_BODY ? budget : MAX_CONTAINER_BODY;
+            std::string var = variable_name(random_int(_params.num_variables));
+
+            if(random_bool(_params.while_ratio)) {
+                int body = 1 + random_int(max_body);
+                _statements.push_back(StatementInfo(line, 'w'));
+
+                lines.push_back(indent(depth) + "while " + var + " {");
+                generate_statement_list(proc, body, depth + 1, lines);
+                lines.back() += " }";
+
+                budget -= body;
+            } else {
+                int body = 2 + random_int(max_body - 1);
+                int then_size = 1 + random_int(body - 1);
+                _statements.push_back(StatementInfo(line, 'i'));
+
+                lines.push_back(indent(depth) + "if " + var + " {");
+                generate_statement_list(proc, then_size, depth + 1, lines);
+                lines.back() += " } else {";
+                generate_statement_list(proc, body - then_size, depth + 1, lines);
+                lines.back() += " }";
+
+                budget -= body;
+            }
+        } else if(_pending_calls > 0 && 
+                random_int(_pending_budget + 1) < _pending_calls) 
+        {
+            // callees are the procedures on deeper levels, which form a 
+            // suffix of the procedure list
+            int first_callee = proc + 1;
+            while(_proc_levels[first_callee] <= _proc_levels[proc]) {
+                ++first_callee;
+            }
+
+            int callee = first_callee + 
+                random_int(_params.num_procs - first_callee);
+
+            --_pending_calls;
+            _statements.push_back(StatementInfo(line, 'c'));
+            lines.push_back(indent(depth) + "call " + proc_name(callee) + ";");
+        } else {
+            std::string var = variable_name(random_int(_params.num_variables));
+
+            _statements.push_back(StatementInfo(line, 'a'));
+            lines.push_back(indent(depth) + var + " = " + generate_expr() + ";");
+        }
+    }
+}
+
+std::string WorkloadGenerator::generate_expr() {
+    static const char operators[] = { '+', '-', '*' };
+
+    int num_terms = 1 + random_int(4);
+    std::string expr;
+
+    for(int i = 0; i < num_terms; ++i) {
+        if(i > 0) {
+            expr += " ";
+            expr += operators[random_int(3)];
+            expr += " ";
+        }
+
+        if(random_bool(0.7)) {
+            expr += variable_name(random_int(_params.num_variables));
+        } else {
+            std::stringstream constant;
+            constant << random_int(100);
+            expr += constant.str();
+        }
+    }
+
+    return expr;
+}
+
+std::string WorkloadGenerator::indent(int depth) {
+    return std::string(depth * 4, ' ');
+}
+
+int WorkloadGenerator::random_int(int bound) {
+    if(bound <= 0) {
+        return 0;
+    }
+    return (int) (_rng() % (unsigned int) bound);
+}
+
+bool WorkloadGenerator::random_bool(double probability) {
+    return _rng() < probability * _rng.max();
+}
+
+int WorkloadGenerator::get_num_statements() const {
+    return _line;
+}
+
+std::string WorkloadGenerator::proc_name(int index) const {
+    std::stringstream out;
+    out << "p" << index;
+    return out.str();
+}
+
+std::string WorkloadGenerator::variable_name(int index) const {
+    std::stringstream out;
+    out << "v" << index;
+    return out.str();
+}
+
+std::vector<std::string> WorkloadGenerator::generate_queries() {
+    std::vector<WorkloadQuery> mix = generate_query_mix();
+    std::vector<std::string> queries;
+
+    for(std::vector<WorkloadQuery>::iterator it = mix.begin();
+            it != mix.end(); ++it)
+    {
+        queries.push_back(it->text);
+    }
+
+    return queries;
+}
+
+std::vector<WorkloadQuery> WorkloadGenerator::generate_query_mix() {
+    _rng.seed(_params.seed + 1);
+
+    const std::vector<std::string>& relations = relation_names();
+    std::vector<WorkloadQuery> queries;
+
+    for(int i = 0; i < _params.num_queries; ++i) {
+        const std::string& relation = relations[i % relations.size()];
+        int form = (i / relations.size()) % NUM_FORMS;
+
+        queries.push_back(WorkloadQuery(relation, FORM_NAMES[form],
+                    generate_query(relation, form)));
+    }
+
+    return queries;
+}
+
+/*
+ * Line number of a random statement of the given kind, 's' for any.
+ * Falls back to any statement if there is no statement of that kind.
+ */
+std::string WorkloadGenerator::random_line(char kind) {
+    std::stringstream out;
+
+    if(kind != 's') {
+        for(int attempt = 0; attempt < 16; ++attempt) {
+            StatementInfo& info = _statements[random_int(_statements.size())];
+            if(info.kind == kind) {
+                out << info.line;
+                return out.str();
+            }
+        }
+    }
+
+    out << _statements[random_int(_statements.size())].line;
+    return out.str();
+}
+
+static bool is_statement_relation(const std::string& relation) {
+    return relation.find("Follows") == 0 || relation.find("Parent") == 0 ||
+        relation.find("Next") == 0;
+}
+
+/*
+ * Declared type of a synonym for one side of the relation.
+ */
+std::string WorkloadGenerator::random_declaration(
+        const std::string& relation, bool left)
+{
+    static const char *statement_types[] = { 
+        "stmt", "assign", "while", "if", "call", "prog_line" 
+    };
+    static const char *container_types[] = { "stmt", "while", "if" };
+
+    if(relation.find("Calls") == 0) {
+        return "procedure";
+    } else if(!is_statement_relation(relation)) {
+        // Modifies and Uses
+        if(!left) {
+            return "variable";
+        } else if(random_bool(0.3)) {
+            return "procedure";
+        } else {
+            return random_bool(0.5) ? "assign" : "stmt";
+        }
+    } else if(left && relation.find("Parent") == 0) {
+        return container_types[random_int(3)];
+    } else {
+        return statement_types[random_int(6)];
+    }
+}
+
+/*
+ * A literal for one side of the relation: a quoted procedure or
+ * variable name, or a statement number.
+ */
+std::string WorkloadGenerator::random_literal(
+        const std::string& relation, bool left)
+{
+    static const char *container_kinds = "wi";
+
+    if(relation.find("Calls") == 0) {
+        return "\"" + proc_name(random_int(_params.num_procs)) + "\"";
+    } else if(!is_statement_relation(relation)) {
+        if(!left) {
+            return "\"" + variable_name(random_int(_params.num_variables)) + "\"";
+        } else if(random_bool(0.3)) {
+            return "\"" + proc_name(random_int(_params.num_procs)) + "\"";
+        } else {
+            return random_line('s');
+        }
+    } else if(left && relation.find("Parent") == 0) {
+        return random_line(container_kinds[random_int(2)]);
+    } else {
+        return random_line('s');
+    }
+}
+
+std::string WorkloadGenerator::generate_query(const std::string& relation, 
+        int form)
+{
+    bool left_syn = form == FORM_SYN_SYN || form == FORM_SYN_LIT || 
+        form == FORM_SYN_WILD || form == FORM_CHAIN;
+    bool right_syn = form == FORM_SYN_SYN || form == FORM_LIT_SYN || 
+        form == FORM_WILD_SYN || form == FORM_CHAIN;
+    bool left_wild = form == FORM_WILD_SYN || form == FORM_WILD_LIT || 
+        form == FORM_WILD_WILD;
+    bool right_wild = form == FORM_SYN_WILD || form == FORM_LIT_WILD || 
+        form == FORM_WILD_WILD;
+
+    std::string declarations;
+    std::string left;
+    std::string right;
+    std::string selected = "BOOLEAN";
+
+    if(left_syn) {
+        declarations += random_declaration(relation, true) + " a; ";
+        left = "a";
+        selected = "a";
+    } else if(left_wild) {
+        left = "_";
+    } else {
+        left = random_literal(relation, true);
+    }
+
+    if(right_syn) {
+        declarations += random_declaration(relation, false) + " b; ";
+        right = "b";
+        if(!left_syn) {
+            selected = "b";
+        }
+    } else if(right_wild) {
+        right = "_";
+    } else {
+        right = random_literal(relation, false);
+    }
+
+    std::string clause = relation + "(" + left + ", " + right + ")";
+    std::string query;
+
+    if(form != FORM_CHAIN) {
+        query = declarations + "Select " + selected + " such that " + clause;
+    } else if(relation.find("Calls") == 0) {
+        // a second clause on the right synonym, to exercise the linker
+        query = declarations + "procedure c; Select c such that " + 
+            clause + " and " + relation + "(b, c)";
+    } else if(!is_statement_relation(relation)) {
+        query = declarations + "stmt c; Select c such that " + 
+            clause + " and Uses(c, b)";
+    } else {
+        query = declarations + "stmt c; Select c such that " + 
+            clause + " and Follows*(b, c)";
+    }
+
+    return query;
+}
+
+} // namespace test
+} // namespace simple
@@ -0,0 +1,147 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace simple {
+namespace test {
+
+/*
+ * Size parameters of a synthetic SIMPLE program.
+ */
+struct WorkloadParams {
+  public:
+    WorkloadParams();
+
+    unsigned int seed;
+
+    int num_procs;
+    int statements_per_proc;
+
+    // maximum number of nested containers
+    int max_nesting_depth;
+
+    // fraction of statements that open a while or if container
+    double container_ratio;
+
+    // fraction of the containers that are while loops, the rest are ifs
+    double while_ratio;
+
+    int num_variables;
+
+    // number of call statements in every procedure that can call down
+    int call_fan_out;
+
+    // number of levels in the call graph; calls only go to deeper levels
+    int call_depth;
+
+    // number of queries in the generated query mix
+    int num_queries;
+};
+
+/*
+ * One query of the generated mix, labelled with the relation and the
+ * clause form it exercises, e.g. "Follows*" and "syn-lit".
+ */
+struct WorkloadQuery {
+  public:
+    WorkloadQuery(const std::string& relation, const std::string& form,
+            const std::string& text) :
+        relation(relation), form(form), text(text)
+    { }
+
+    std::string relation;
+    std::string form;
+    std::string text;
+};
+
+/*
+ * Generates a valid SIMPLE program from a set of size parameters, plus a
+ * matching mix of PQL queries over every relation and every clause form.
+ *
+ * The output only depends on the parameters: the generator draws from a
+ * seeded mt19937 and does not use the platform specific distributions, 
+ * so the same seed gives the same workload everywhere.
+ *
+ * The program is laid out one statement per line with closing braces on
+ * the line of the last statement, so that statement numbers run from 1
+ * to get_num_statements() in program order.
+ */
+class WorkloadGenerator {
+  public:
+    WorkloadGenerator(const WorkloadParams& params);
+
+    std::string generate_program();
+
+    /*
+     * Queries referring to the program generated last. Every query is a
+     * single line containing the declarations and the Select clause.
+     */
+    std::vector<std::string> generate_queries();
+
+    /*
+     * The same queries as generate_queries(), with their labels.
+     */
+    std::vector<WorkloadQuery> generate_query_mix();
+
+    int get_num_statements() const;
+
+    std::string proc_name(int index) const;
+    std::string variable_name(int index) const;
+
+    static const std::vector<std::string>& relation_names();
+
+  private:
+    struct StatementInfo {
+        StatementInfo(int line, char kind) : line(line), kind(kind) { }
+
+        int line;
+
+        // 'a'ssignment, 'w'hile, 'i'f or 'c'all
+        char kind;
+    };
+
+    void generate_proc(int index, std::vector<std::string>& lines);
+    void generate_statement_list(int proc, int budget, int depth,
+            std::vector<std::string>& lines);
+    std::string generate_expr();
+    std::string indent(int depth);
+
+    int random_int(int bound);
+    bool random_bool(double probability);
+
+    std::string random_line(char kind);
+    std::string random_declaration(const std::string& relation, bool left);
+    std::string random_literal(const std::string& relation, bool left);
+    std::string generate_query(const std::string& relation, int form);
+
+    WorkloadParams      _params;
+    std::mt19937        _rng;
+    int                 _line;
+    int                 _pending_calls;
+    int                 _pending_budget;
+    std::vector<int>    _proc_levels;
+    std::vector<StatementInfo> _statements;
+};
+
+} // namespace test
+} // namespace simple
@@ -0,0 +1,126 @@
+/*
+ * CS3201 Simple Static Analyzer
+ * Copyright (C) 2011 Soares Chen Ruo Fei
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "test/workload.h"
+
+using namespace simple::test;
+
+static void print_usage(const char *program) {
+    WorkloadParams defaults;
+
+    std::cerr << "usage: " << program << " [options] PROGRAM_FILE QUERY_FILE\n"
+        << "\n"
+        << "Write a synthetic SIMPLE program to PROGRAM_FILE and a matching\n"
+        << "PQL query mix, one query per line, to QUERY_FILE.\n"
+        << "\n"
+        << "  --seed N             random seed (" << defaults.seed << ")\n"
+        << "  --procs N            number of procedures (" 
+            << defaults.num_procs << ")\n"
+        << "  --statements N       statements per procedure (" 
+            << defaults.statements_per_proc << ")\n"
+        << "  --depth N            maximum nesting depth (" 
+            << defaults.max_nesting_depth << ")\n"
+        << "  --container-ratio F  fraction of while/if statements (" 
+            << defaults.container_ratio << ")\n"
+        << "  --while-ratio F      fraction of containers that are while (" 
+            << defaults.while_ratio << ")\n"
+        << "  --variables N        size of the variable pool (" 
+            << defaults.num_variables << ")\n"
+        << "  --fan-out N          calls per procedure (" 
+            << defaults.call_fan_out << ")\n"
+        << "  --call-depth N       levels in the call graph (" 
+            << defaults.call_depth << ")\n"
+        << "  --queries N          number of queries (" 
+            << defaults.num_queries << ")\n";
+}
+
+int main(int argc, char **argv) {
+    WorkloadParams params;
+    std::vector<const char*> files;
+
+    for(int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+
+        if(strncmp(arg, "--", 2) != 0) {
+            files.push_back(arg);
+            continue;
+        }
+
+        if(i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+
+        if(strcmp(arg, "--seed") == 0) {
+            params.seed = strtoul(value, NULL, 10);
+        } else if(strcmp(arg, "--procs") == 0) {
+            params.num_procs = atoi(value);
+        } else if(strcmp(arg, "--statements") == 0) {
+            params.statements_per_proc = atoi(value);
+        } else if(strcmp(arg, "--depth") == 0) {
+            params.max_nesting_depth = atoi(value);
+        } else if(strcmp(arg, "--container-ratio") == 0) {
+            params.container_ratio = atof(value);
+        } else if(strcmp(arg, "--while-ratio") == 0) {
+            params.while_ratio = atof(value);
+        } else if(strcmp(arg, "--variables") == 0) {
+            params.num_variables = atoi(value);
+        } else if(strcmp(arg, "--fan-out") == 0) {
+            params.call_fan_out = atoi(value);
+        } else if(strcmp(arg, "--call-depth") == 0) {
+            params.call_depth = atoi(value);
+        } else if(strcmp(arg, "--queries") == 0) {
+            params.num_queries = atoi(value);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(files.size() != 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    WorkloadGenerator generator(params);
+
+    std::ofstream program_file(files[0]);
+    program_file << generator.generate_program();
+
+    std::ofstream query_file(files[1]);
+    std::vector<std::string> queries = generator.generate_queries();
+    for(std::vector<std::string>::iterator it = queries.begin();
+            it != queries.end(); ++it)
+    {
+        query_file << *it << "\n";
+    }
+
+    if(!program_file || !query_file) {
+        std::cerr << "failed to write output files\n";
+        return 1;
+    }
+
+    std::cerr << generator.get_num_statements() << " statements, "
+        << queries.size() << " queries\n";
+    return 0;
+}